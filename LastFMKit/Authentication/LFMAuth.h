@@ -34,6 +34,8 @@ NS_ASSUME_NONNULL_BEGIN
  authentication service. In order to make any calls to api methods requiring authentication (you will see a helpful: "🔒: Authentication Required" message in the function's description to remind you), this class must be used.
  
  @note If you want to use this class for storing credentials - which it will do automatically -, you must have keychain accessibilty turned on in your app's capabilities page.
+ 
+ The API key, shared secret and session may be read and changed from any thread. Reading them never takes `LFMAuth`'s lock, so signing requests on many threads at once doesn't contend on it.
  */
 NS_SWIFT_NAME(Auth)
 @interface LFMAuth : NSObject
@@ -96,20 +98,24 @@ typedef void (^LFMAuthCallback)(NSError * _Nullable error, LFMSession * _Nullabl
  
  @warning This property MUST be set before ANY calls are made to ANY method on this class otherwise an exception will be raised.
  */
-@property(strong, nonatomic) NSString *apiKey;
+@property(copy) NSString *apiKey;
 
 /**
  Your "Shared secret" obtained from Last.fm.
  
  @warning This property MUST be set before ANY calls are made to ANY method on this class otherwise an exception will be raised.
  */
-@property(strong, nonatomic) NSString *apiSecret;
+@property(copy) NSString *apiSecret;
 
 /** A boolean value indicating whether the user has authenticated or not. */
 @property(nonatomic, readonly) BOOL userHasAuthenticated;
 
-/** The `LFMSession` object obtained by a successful call to `getSessionWithUsername:password:callback`. This object will automatically be set every app launch once one successful call has been made to the aformentioned method. */
-@property(strong, nonatomic, readonly, nullable) LFMSession *session;
+/**
+ The `LFMSession` object obtained by a successful call to `getSessionWithUsername:password:callback`. This object will automatically be set every app launch once one successful call has been made to the aformentioned method.
+ 
+ @note  The session is read from the keychain in the background as soon as the `sharedInstance` is first used - eg. when the `apiKey` is set at launch - so that requests which don't need it aren't held up. Reading this property before the keychain has answered waits for it.
+ */
+@property(strong, readonly, nullable) LFMSession *session;
 
 - (instancetype) __attribute__((unavailable("Please use `sharedInstance` instead."))) init;
 
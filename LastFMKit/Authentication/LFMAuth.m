@@ -27,10 +27,102 @@
 #import <CommonCrypto/CommonDigest.h>
 #import "LFMSession.h"
 #import "LFMKit+Protected.h"
-#import "LFMError.h"
+#import "LFMClient.h"
 
-@implementation LFMAuth {
+/** Parameters up to this many are sorted on the stack. */
+static const NSUInteger LFMSignatureStackParameterCount = 512;
+
+/** The query items are retained by the array being signed, so the parameters don't need to be. */
+typedef struct {
+    __unsafe_unretained NSString *name;
+    __unsafe_unretained NSString *value;
+    NSUInteger position;
+} LFMSignatureParameter;
+
+/**
+ Orders parameters by name, comparing code units rather than going through the locale, as the API specifies. Parameters with the same name stay in the order they were given in.
+ */
+static int LFMSignatureParameterCompare(const void *first, const void *second) {
+    const LFMSignatureParameter *a = first, *b = second;
+    NSComparisonResult result = [a->name compare:b->name options:NSLiteralSearch];
+    
+    if (result != NSOrderedSame) return result == NSOrderedAscending ? -1 : 1;
+    
+    return a->position < b->position ? -1 : 1;
+}
+
+/** Feeds the UTF-8 of `string` to the digest, straight from the string's storage when it is already UTF-8 and through a small buffer when it isn't. */
+static void LFMSignatureUpdate(CC_MD5_CTX *context, NSString *string) {
+    CFStringRef cfString = (__bridge CFStringRef)string;
+    const char *bytes = CFStringGetCStringPtr(cfString, kCFStringEncodingUTF8);
+    
+    if (bytes != NULL) {
+        CC_MD5_Update(context, bytes, (CC_LONG)strlen(bytes));
+        return;
+    }
+    
+    UInt8 buffer[256];
+    CFIndex length = CFStringGetLength(cfString);
+    
+    for (CFIndex location = 0; location < length;) {
+        CFIndex usedLength = 0;
+        CFIndex converted = CFStringGetBytes(cfString, CFRangeMake(location, length - location), kCFStringEncodingUTF8, 0, false, buffer, sizeof(buffer), &usedLength);
+        
+        if (converted == 0) break;
+        
+        CC_MD5_Update(context, buffer, (CC_LONG)usedLength);
+        location += converted;
+    }
+}
+
+static NSString *LFMSignatureHexString(const unsigned char digest[CC_MD5_DIGEST_LENGTH]) {
+    static const char hexDigits[] = "0123456789ABCDEF";
+    char hex[CC_MD5_DIGEST_LENGTH * 2];
+    
+    for (NSUInteger i = 0; i < CC_MD5_DIGEST_LENGTH; i++) {
+        hex[i * 2] = hexDigits[digest[i] >> 4];
+        hex[i * 2 + 1] = hexDigits[digest[i] & 0x0F];
+    }
+    
+    return [[NSString alloc] initWithBytes:hex length:sizeof(hex) encoding:NSASCIIStringEncoding];
+}
+
+/**
+ Everything `LFMAuth` hands out to requests, as of one moment. A snapshot is never changed once it has been published; changing a credential publishes a modified copy.
+ */
+@interface LFMCredentials : NSObject <NSCopying> {
+    @package
+    NSString *_apiKey;
+    NSString *_apiSecret;
     LFMSession *_session;
+    BOOL _sessionWasSet;
+}
+
+@end
+
+@implementation LFMCredentials
+
+- (id)copyWithZone:(NSZone *)zone {
+    LFMCredentials *credentials = [[LFMCredentials alloc] init];
+    credentials->_apiKey = _apiKey;
+    credentials->_apiSecret = _apiSecret;
+    credentials->_session = _session;
+    credentials->_sessionWasSet = _sessionWasSet;
+    return credentials;
+}
+
+@end
+
+@interface LFMAuth ()
+
+/** The current snapshot. Atomic, so a reader gets it retained without taking `LFMAuth`'s lock; the runtime guards the load with one of its striped spinlocks, held only for the retain. */
+@property(atomic, strong) LFMCredentials *credentials;
+
+@end
+
+@implementation LFMAuth {
+    dispatch_group_t _sessionLoading;
+    dispatch_queue_t _keychainQueue;
 }
 
 + (LFMAuth *)sharedInstance {
@@ -49,38 +141,68 @@
     self = [super init];
     
     if (self)  {
-        [self setSession:[LFMSession loadFromKeychain]];
+        _credentials = [[LFMCredentials alloc] init];
+        
+        _sessionLoading = dispatch_group_create();
+        _keychainQueue = dispatch_queue_create("fm.last.kit.keychain", dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0));
+        
+        // The keychain is slow enough to hold up the first request if it is read here; most requests don't need a session, so only those that do wait for it.
+        dispatch_group_async(_sessionLoading, _keychainQueue, ^{
+            LFMSession *session = [LFMSession loadFromKeychain];
+            
+            [self updateCredentials:^(LFMCredentials *credentials) {
+                if (!credentials->_sessionWasSet) credentials->_session = session;
+            }];
+        });
     }
     
     return self;
 }
 
 - (BOOL)removeSession {
-    if ([_session removeFromKeychain]) {
-        _session = nil;
-        return YES;
+    LFMSession *session = self.session;
+    
+    if (session == nil) return NO;
+    
+    __block BOOL removed;
+    dispatch_sync(_keychainQueue, ^{
+        removed = [session removeFromKeychain];
+    });
+    
+    if (removed) {
+        [self updateCredentials:^(LFMCredentials *credentials) {
+            if (credentials->_session == session) credentials->_session = nil;
+        }];
     }
-    return NO;
+    
+    return removed;
 }
 
 - (void)setSession:(LFMSession *)session {
-    _session = session;
-    [session saveInKeychain];
+    [self updateCredentials:^(LFMCredentials *credentials) {
+        credentials->_session = session;
+        credentials->_sessionWasSet = YES;
+    }];
+    
+    // Queued behind the load, so a session read from the keychain can't overwrite this one.
+    dispatch_async(_keychainQueue, ^{
+        [session saveInKeychain];
+    });
 }
 
 - (LFMSession *)session {
-    return _session;
+    dispatch_group_wait(_sessionLoading, DISPATCH_TIME_FOREVER);
+    
+    return [self credentials]->_session;
 }
 
 - (BOOL)userHasAuthenticated {
-    return _session != nil;
+    return self.session != nil;
 }
 
 - (NSURLSessionDataTask *)getSessionWithUsername:(NSString *)username
                                         password:(NSString *)password
                                         callback:(LFMAuthCallback)block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
     NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
     NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
     
@@ -98,12 +220,8 @@
     
     __weak __typeof__(self) weakSelf = self;
     
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil) return block(error, nil);
-        
-        if (!lfm_error_validate(data, &error)) return block(error, nil);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
+    NSURLSessionDataTask *dataTask = [[LFMClient sharedClient] dataTaskWithRequest:request callback:^(NSError *error, NSDictionary *responseDictionary) {
+        if (error != nil) return block(error, nil);
         
         LFMSession *session = [[LFMSession alloc] initFromDictionary:[responseDictionary objectForKey:@"session"]];
         [weakSelf setSession:session];
@@ -111,60 +229,94 @@
         block(error, session);
     }];
     
-    [dataTask resume];
-    
     return dataTask;
 }
 
 - (NSURLQueryItem *)signatureItemForQueryItems:(NSArray<NSURLQueryItem *> *)queryItems {
-    NSMutableString *signature = [NSMutableString string];
-    NSMutableDictionary *parameters = [NSMutableDictionary dictionary];
+    NSUInteger count = queryItems.count;
+    
+    // A scrobble of 50 tracks has 400 or so parameters; anything bigger than the stack buffer is rare enough to go to the heap.
+    LFMSignatureParameter stackParameters[LFMSignatureStackParameterCount];
+    LFMSignatureParameter *parameters = count <= LFMSignatureStackParameterCount ? stackParameters : (LFMSignatureParameter *)malloc(count * sizeof(LFMSignatureParameter));
+    NSUInteger parameterCount = 0;
     
     for (NSURLQueryItem *item in queryItems) {
         if (item.value == nil) continue;
         if ([item.name isEqualToString:@"format"]) continue; // Format argument causes the api to regect the signature.
-        parameters[item.name] = item.value;
+        
+        parameters[parameterCount] = (LFMSignatureParameter){item.name, item.value, parameterCount};
+        parameterCount++;
     }
     
-    NSArray *alphebetisedKeys = [[parameters allKeys] sortedArrayUsingSelector:@selector(localizedCaseInsensitiveCompare:)];
+    qsort(parameters, parameterCount, sizeof(LFMSignatureParameter), LFMSignatureParameterCompare);
+    
+    CC_MD5_CTX context;
+    CC_MD5_Init(&context);
     
-    for (NSString *key in alphebetisedKeys) {
-        NSString *value = parameters[key];
+    for (NSUInteger i = 0; i < parameterCount; i++) {
+        // A parameter given more than once is signed with the value given last.
+        if (i + 1 < parameterCount && [parameters[i].name isEqualToString:parameters[i + 1].name]) continue;
         
-        [signature appendFormat:@"%@%@", key, value];
+        LFMSignatureUpdate(&context, parameters[i].name);
+        LFMSignatureUpdate(&context, parameters[i].value);
     }
     
-    [signature appendString:self.apiSecret];
+    LFMSignatureUpdate(&context, self.apiSecret);
+    
+    if (parameters != stackParameters) free(parameters);
     
-    return [NSURLQueryItem queryItemWithName:@"api_sig" value:md5(signature)];
+    unsigned char digest[CC_MD5_DIGEST_LENGTH];
+    CC_MD5_Final(digest, &context);
+    
+    return [NSURLQueryItem queryItemWithName:@"api_sig" value:LFMSignatureHexString(digest)];
 }
 
 - (NSArray<NSURLQueryItem *> *)appendingSignatureItemToQueryItems:(NSArray<NSURLQueryItem *> *)queryItems {
     return [queryItems arrayByAddingObject:[self signatureItemForQueryItems:queryItems]];
 }
 
+- (void)setApiSecret:(NSString *)apiSecret {
+    apiSecret = [apiSecret copy];
+    
+    [self updateCredentials:^(LFMCredentials *credentials) {
+        credentials->_apiSecret = apiSecret;
+    }];
+}
+
 - (NSString *)apiSecret {
-    NSAssert(_apiSecret != nil, @"Shared secret must be set before any calls to this class are made.");
-    return _apiSecret;
+    NSString *apiSecret = [self credentials]->_apiSecret;
+    NSAssert(apiSecret != nil, @"Shared secret must be set before any calls to this class are made.");
+    return apiSecret;
+}
+
+- (void)setApiKey:(NSString *)apiKey {
+    apiKey = [apiKey copy];
+    
+    [self updateCredentials:^(LFMCredentials *credentials) {
+        credentials->_apiKey = apiKey;
+    }];
 }
 
 - (NSString *)apiKey {
-    NSAssert(_apiKey != nil, @"API key must be set before any calls to this class are made.");
-    return _apiKey;
-}
-
-NSString* md5(NSString *string) {
-    const char *cStr = [string UTF8String];
-    unsigned char result[CC_MD5_DIGEST_LENGTH];
-    CC_MD5( cStr, (CC_LONG)strlen(cStr), result );
-    
-    return [NSString stringWithFormat:
-            @"%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X",
-            result[0], result[1], result[2], result[3],
-            result[4], result[5], result[6], result[7],
-            result[8], result[9], result[10], result[11],
-            result[12], result[13], result[14], result[15]
-            ];
+    NSString *apiKey = [self credentials]->_apiKey;
+    NSAssert(apiKey != nil, @"API key must be set before any calls to this class are made.");
+    return apiKey;
+}
+
+#pragma mark - Private
+
+/**
+ Publishes a copy of the current snapshot with the changes `block` makes to it. Writers are serialised; readers carry on with whichever snapshot they loaded.
+ 
+ The replaced snapshot is freed once the last reader holding it lets go of it.
+ */
+- (void)updateCredentials:(void (^)(LFMCredentials *credentials))block {
+    @synchronized (self) {
+        LFMCredentials *credentials = [self.credentials copy];
+        block(credentials);
+        
+        self.credentials = credentials;
+    }
 }
 
 @end
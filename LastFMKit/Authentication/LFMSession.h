@@ -50,6 +50,19 @@ NS_SWIFT_NAME(Session)
  */
 + (nullable LFMSession *)sharedSession NS_SWIFT_NAME(shared());
 
+/**
+ Initialises a session from a key that has already been obtained, eg. one a server stored when the user authenticated. Use this with `LFMSessionRegistry` to act for several users at once; the shared session is unaffected.
+ 
+ @param sessionKey          The user's session key.
+ @param userName            The authenticated user's username.
+ @param userIsSubscriber    Whether or not the user is a subscriber.
+ 
+ @return   An `LFMSession` object.
+ */
+- (instancetype)initWithSessionKey:(NSString *)sessionKey
+                          userName:(NSString *)userName
+                  userIsSubscriber:(BOOL)userIsSubscriber NS_SWIFT_NAME(init(key:userName:userIsSubscriber:));
+
 - (instancetype) __attribute__((unavailable("Please use `sharedSession` instead."))) init;
 
 + (instancetype) __attribute__((unavailable("Please use `sharedSession` instead."))) new;
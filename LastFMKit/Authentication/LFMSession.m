@@ -43,9 +43,13 @@
     if (self) {
         NSString *name = [dictionary objectForKey:@"name"];
         NSString *key = [dictionary objectForKey:@"key"];
-        NSUInteger subscriber = [[dictionary objectForKey:@"subscriber"] unsignedIntegerValue];
+        id subscriberValue = [dictionary objectForKey:@"subscriber"];
+        NSUInteger subscriber = 0;
         
-        if (name != nil && key != nil && !isnan(subscriber)) {
+        // `subscriber` may be left out, in which case the user isn't a subscriber. Only a value that is sent but isn't a number is rejected.
+        BOOL subscriberIsValid = subscriberValue == nil || subscriberValue == [NSNull null] || LFMParseUnsignedInteger(subscriberValue, &subscriber);
+        
+        if (name != nil && key != nil && subscriberIsValid) {
             _userName = name;
             _sessionKey = key;
             _userIsSubscriber = subscriber;
@@ -57,6 +61,18 @@
     return nil;
 }
 
+- (instancetype)initWithSessionKey:(NSString *)sessionKey userName:(NSString *)userName userIsSubscriber:(BOOL)userIsSubscriber {
+    self = [super init];
+    
+    if (self) {
+        _sessionKey = [sessionKey copy];
+        _userName = [userName copy];
+        _userIsSubscriber = userIsSubscriber;
+    }
+    
+    return self;
+}
+
 - (NSString *)userName {
     return _userName;
 }
@@ -108,12 +124,10 @@
     }
 #pragma clang diagnostic pop
     
-    OSStatus status;
-    BOOL exists = ([LFMSession loadFromKeychain] != nil);
+    // Updating tells us whether the item exists, so there's no need to read - and unarchive - it first.
+    OSStatus status = SecItemUpdate((__bridge CFDictionaryRef)queryDictionary, (__bridge CFDictionaryRef)updateDictionary);
     
-    if (exists) {
-        status = SecItemUpdate((__bridge CFDictionaryRef)queryDictionary, (__bridge CFDictionaryRef)updateDictionary);
-    } else {
+    if (status == errSecItemNotFound) {
         [queryDictionary addEntriesFromDictionary:updateDictionary];
         status = SecItemAdd((__bridge CFDictionaryRef)queryDictionary, NULL);
     }
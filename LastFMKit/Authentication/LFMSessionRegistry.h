@@ -0,0 +1,68 @@
+//
+//  LFMSessionRegistry.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+@class LFMSession;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Holds the sessions of any amount of users, keyed by user name, for processes that act for many users at once - eg. a service that scrobbles on its users' behalf. Pass a session from the registry to the `forSession:` variants of the authenticated methods on `LFMTrackProvider`; `LFMAuth` and the shared session are not involved.
+ 
+ Looking a session up never waits for other lookups or for sessions being added or removed: the sessions are kept in immutable dictionaries spread over a fixed number of shards, and a change copies and replaces the one shard it affects. This makes lookups cheap and changes comparatively expensive, which suits sessions that are added once and read on every request.
+ */
+NS_SWIFT_NAME(SessionRegistry)
+@interface LFMSessionRegistry : NSObject
+
+/**
+ Looks up the session of a user.
+ 
+ @param userName    The user's username, exactly as the session was registered with.
+ 
+ @return   The user's session, or `nil` if none has been registered.
+ */
+- (nullable LFMSession *)sessionForUserName:(NSString *)userName NS_SWIFT_NAME(session(forUserName:));
+
+/**
+ Registers a session under its `userName`, replacing any session previously registered for that user.
+ 
+ @param session The session to register.
+ */
+- (void)setSession:(LFMSession *)session NS_SWIFT_NAME(set(_:));
+
+/**
+ Removes the session of a user, if any has been registered.
+ 
+ @param userName    The user's username.
+ */
+- (void)removeSessionForUserName:(NSString *)userName NS_SWIFT_NAME(removeSession(forUserName:));
+
+/** The amount of sessions registered. */
+@property(readonly) NSUInteger count;
+
+@end
+
+NS_ASSUME_NONNULL_END
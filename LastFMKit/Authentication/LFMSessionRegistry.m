@@ -0,0 +1,111 @@
+//
+//  LFMSessionRegistry.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMSessionRegistry.h"
+#import "LFMSession.h"
+
+/** The amount of shards sessions are spread over. Must be a power of two. */
+static const NSUInteger LFMSessionRegistryShardCount = 64;
+
+/**
+ The sessions of the users whose names hash to one shard. The dictionary is never mutated, only replaced, so a reader can keep using the one it got for as long as it likes.
+ */
+@interface LFMSessionShard : NSObject
+
+@property(atomic, copy) NSDictionary<NSString *, LFMSession *> *sessions;
+
+@end
+
+@implementation LFMSessionShard
+
+@end
+
+@implementation LFMSessionRegistry {
+    NSArray<LFMSessionShard *> *_shards;
+}
+
+- (instancetype)init {
+    self = [super init];
+    
+    if (self) {
+        NSMutableArray<LFMSessionShard *> *shards = [NSMutableArray arrayWithCapacity:LFMSessionRegistryShardCount];
+        
+        for (NSUInteger i = 0; i < LFMSessionRegistryShardCount; i++) {
+            LFMSessionShard *shard = [[LFMSessionShard alloc] init];
+            shard.sessions = @{};
+            [shards addObject:shard];
+        }
+        
+        _shards = [shards copy];
+    }
+    
+    return self;
+}
+
+- (LFMSession *)sessionForUserName:(NSString *)userName {
+    return [[self shardForUserName:userName].sessions objectForKey:userName];
+}
+
+- (void)setSession:(LFMSession *)session {
+    NSAssert(session.userName != nil, @"Only sessions with a user name can be registered.");
+    
+    LFMSessionShard *shard = [self shardForUserName:session.userName];
+    
+    @synchronized (shard) {
+        NSMutableDictionary<NSString *, LFMSession *> *sessions = [shard.sessions mutableCopy];
+        sessions[session.userName] = session;
+        shard.sessions = sessions;
+    }
+}
+
+- (void)removeSessionForUserName:(NSString *)userName {
+    LFMSessionShard *shard = [self shardForUserName:userName];
+    
+    @synchronized (shard) {
+        if ([shard.sessions objectForKey:userName] == nil) return;
+        
+        NSMutableDictionary<NSString *, LFMSession *> *sessions = [shard.sessions mutableCopy];
+        [sessions removeObjectForKey:userName];
+        shard.sessions = sessions;
+    }
+}
+
+- (NSUInteger)count {
+    NSUInteger count = 0;
+    
+    for (LFMSessionShard *shard in _shards) {
+        count += shard.sessions.count;
+    }
+    
+    return count;
+}
+
+#pragma mark - Private
+
+- (LFMSessionShard *)shardForUserName:(NSString *)userName {
+    return _shards[userName.hash & (LFMSessionRegistryShardCount - 1)];
+}
+
+@end
@@ -25,7 +25,7 @@
 
 #import <Foundation/Foundation.h>
 
-@class LFMTag, LFMTopTag, LFMAlbum, LFMSearchQuery;
+@class LFMTag, LFMTopTag, LFMAlbum, LFMSearchQuery, LFMSession;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -52,6 +52,23 @@ NS_SWIFT_NAME(AlbumProvider)
                     byArtistNamed:(NSString *)albumArtist
                          callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(add(tags:to:by:callback:));
 
+/**
+ Tags an album on behalf of the user of `session`.
+ 
+ @param tags        An array of user supplied tags to apply to this album. Accepts a maximum of 10 tags. An exception will be raised if more than 10 tags are passed in.
+ @param albumName   The name of the album.
+ @param albumArtist The name of the album's artist.
+ @param session     The session of the user applying the tags.
+ @param block       The callback block containing an optional `NSError` if the request fails. Regardless of the success of the operation, this block will be called.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
++ (NSURLSessionDataTask *)addTags:(NSArray <LFMTag *> *)tags
+                     toAlbumNamed:(NSString *)albumName
+                    byArtistNamed:(NSString *)albumArtist
+                       forSession:(LFMSession *)session
+                         callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(add(tags:to:by:session:callback:));
+
 /**
  Removes a user's tag from an album.
  
@@ -69,6 +86,23 @@ NS_SWIFT_NAME(AlbumProvider)
                       byArtistNamed:(NSString *)albumArtist
                            callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(remove(tag:from:by:callback:));
 
+/**
+ Removes a tag the user of `session` applied to an album.
+ 
+ @param tag         A single user tag to remove from this album.
+ @param albumName   The name of the album.
+ @param albumArtist The name of the album's artist.
+ @param session     The session of the user who applied the tag.
+ @param block       The callback block containing an optional `NSError` if the request fails. Regardless of the success of the operation, this block will be called.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
++ (NSURLSessionDataTask *)removeTag:(LFMTag *)tag
+                     fromAlbumNamed:(NSString *)albumName
+                      byArtistNamed:(NSString *)albumArtist
+                         forSession:(LFMSession *)session
+                           callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(remove(tag:from:by:session:callback:));
+
 /**
  Retrieves the metadata and tracklist for an album on Last.fm using the album name or MusicBrainzID.
  
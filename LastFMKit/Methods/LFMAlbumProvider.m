@@ -25,9 +25,8 @@
 
 #import "LFMAlbumProvider.h"
 #import "LFMTag.h"
-#import "LFMAuth.h"
 #import "LFMSession.h"
-#import "LFMError.h"
+#import "LFMClient.h"
 #import "LFMAlbum.h"
 #import "LFMKit+Protected.h"
 #import "LFMTopTag.h"
@@ -39,6 +38,14 @@
                      toAlbumNamed:(NSString *)albumName
                     byArtistNamed:(NSString *)albumArtist
                          callback:(void (^)(NSError * _Nullable))block {
+    return [self addTags:tags toAlbumNamed:albumName byArtistNamed:albumArtist forSession:[LFMSession sharedSession] callback:block];
+}
+
++ (NSURLSessionDataTask *)addTags:(NSArray<LFMTag *> *)tags
+                     toAlbumNamed:(NSString *)albumName
+                    byArtistNamed:(NSString *)albumArtist
+                       forSession:(LFMSession *)session
+                         callback:(void (^)(NSError * _Nullable))block {
     NSAssert(tags.count <= 10, @"This method call accepts a maximum of 10 tags.");
     
     NSMutableString *tagString = [NSMutableString string];
@@ -46,74 +53,22 @@
         [tagString appendFormat:@"%@%@", (idx == 0 ? @"" : @","), obj.name];
     }];
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"album.addTags"],
-                            [NSURLQueryItem queryItemWithName:@"album" value:albumName],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:albumArtist],
-                            [NSURLQueryItem queryItemWithName:@"tags" value:tagString],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey],
-                            [NSURLQueryItem queryItemWithName:@"sk" value:[LFMSession sharedSession].sessionKey]];
-    components.queryItems = [[LFMAuth sharedInstance] appendingSignatureItemToQueryItems:queryItems];
-    
-    NSData *data = [components.query dataUsingEncoding:NSUTF8StringEncoding];
-    
-    [request setHTTPMethod:@"POST"];
-    [request setHTTPBody:data];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (block == nil) return;
-        if (error != nil || data == nil) return block(error);
-        
-        lfm_error_validate(data, &error);
-        
-        block(error);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointAlbumAddTags, LFMParameters(albumName, albumArtist, tagString), session.sessionKey, LFMEndpointStatusCallback(block));
 }
 
 + (NSURLSessionDataTask *)removeTag:(LFMTag *)tag
                      fromAlbumNamed:(NSString *)albumName
                       byArtistNamed:(NSString *)albumArtist
                            callback:(void (^)(NSError * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"album.removeTag"],
-                            [NSURLQueryItem queryItemWithName:@"album" value:albumName],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:albumArtist],
-                            [NSURLQueryItem queryItemWithName:@"tag" value:tag.name],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey],
-                            [NSURLQueryItem queryItemWithName:@"sk" value:[LFMSession sharedSession].sessionKey]];
-    components.queryItems = [[LFMAuth sharedInstance] appendingSignatureItemToQueryItems:queryItems];
+    return [self removeTag:tag fromAlbumNamed:albumName byArtistNamed:albumArtist forSession:[LFMSession sharedSession] callback:block];
+}
 
-    NSData *data = [components.query dataUsingEncoding:NSUTF8StringEncoding];
-    
-    [request setHTTPMethod:@"POST"];
-    [request setHTTPBody:data];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (block == nil) return;
-        if (error != nil || data == nil) return block(error);
-        
-        lfm_error_validate(data, &error);
-        
-        block(error);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
++ (NSURLSessionDataTask *)removeTag:(LFMTag *)tag
+                     fromAlbumNamed:(NSString *)albumName
+                      byArtistNamed:(NSString *)albumArtist
+                         forSession:(LFMSession *)session
+                           callback:(void (^)(NSError * _Nullable))block {
+    return LFMEndpointDataTask(LFMEndpointAlbumRemoveTag, LFMParameters(albumName, albumArtist, tag.name), session.sessionKey, LFMEndpointStatusCallback(block));
 }
 
 + (NSURLSessionDataTask *)getInfoOnAlbumNamed:(NSString *)albumName
@@ -125,35 +80,22 @@
                                      callback:(void (^)(NSError * _Nullable, LFMAlbum * _Nullable))block {
     NSAssert((albumName != nil && albumArtist != nil) || (mbid != nil), @"Either the albumName and the albumArtist or the mbid parameter must be set.");
     
-    NSURLSession *session = [NSURLSession sharedSession];
+    NSURLRequest *request = LFMEndpointRequest(LFMEndpointAlbumGetInfo, LFMParameters(albumName, albumArtist, mbid, @(autoCorrect), userName, code), nil);
     
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"album.getInfo"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"album" value:albumName],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:albumArtist],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
-                            [NSURLQueryItem queryItemWithName:@"autocorrect" value:[NSString stringWithFormat:@"%d", autoCorrect]],
-                            [NSURLQueryItem queryItemWithName:@"username" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"lang" value:code],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    components.queryItems = queryItems;
+    LFMClient *client = [LFMClient sharedClient];
     
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
+    // Per-user and translated details aren't catalogued.
+    LFMAlbum *cataloguedModel = userName == nil && code == nil ? [client.catalogue albumNamed:albumName byArtistNamed:albumArtist withMusicBrainzId:mbid] : nil;
     
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, nil);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        LFMAlbum *album = [[LFMAlbum alloc] initFromDictionary:[responseDictionary objectForKey:@"album"]];
-        
-        block(error, album);
-    }];
+    if (cataloguedModel != nil) {
+        return [client dataTaskWithRequest:request answeredWithBlock:^(NSError *error) {
+            block(error, error == nil ? cataloguedModel : nil);
+        }];
+    }
     
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTaskWithRequest(LFMEndpointAlbumGetInfo, request, ^(NSError *error, LFMAlbum *album, id query) {
+        block(error, album);
+    });
 }
 
 + (NSURLSessionDataTask *)getTagsForAlbumNamed:(NSString *)albumName
@@ -166,41 +108,9 @@
     
     NSAssert((albumName != nil && albumArtist != nil) || (mbid != nil), @"Either the albumName and the albumArtist or the mbid parameter must be set.");
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"album.getTags"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"album" value:albumName],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:albumArtist],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
-                            [NSURLQueryItem queryItemWithName:@"autocorrect" value:[NSString stringWithFormat:@"%d", autoCorrect]],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey],
-                            [NSURLQueryItem queryItemWithName:@"sk" value:[LFMSession sharedSession].sessionKey]];
-    
-    components.queryItems = [LFMSession sharedSession].sessionKey == nil ? queryItems : [[LFMAuth sharedInstance] appendingSignatureItemToQueryItems:queryItems];
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[]);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        NSMutableArray <LFMTag *> *tags = [NSMutableArray array];
-        
-        for (NSDictionary *tagDictionary in [responseDictionary objectForKey:@"tags"]) {
-            LFMTag *tag = [[LFMTag alloc] initFromDictionary:tagDictionary];
-            tag == nil ?: [tags addObject:tag];
-        }
-        
+    return LFMEndpointDataTask(LFMEndpointAlbumGetTags, LFMParameters(albumName, albumArtist, mbid, @(autoCorrect), userName), [LFMSession sharedSession].sessionKey, ^(NSError *error, NSArray<LFMTag *> *tags, id query) {
         block(error, tags);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)getTopTagsForAlbumNamed:(NSString *)albumName
@@ -210,79 +120,16 @@
                                          callback:(void (^)(NSError * _Nullable, NSArray<LFMTopTag *> * _Nonnull))block {
     NSAssert((albumName != nil && albumArtist != nil) || (mbid != nil), @"Either the albumName and the albumArtist or the mbid parameter must be set.");
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"album.getTopTags"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"album" value:albumName],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:albumArtist],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
-                            [NSURLQueryItem queryItemWithName:@"autocorrect" value:[NSString stringWithFormat:@"%d", autoCorrect]],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[]);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        NSMutableArray <LFMTopTag *> *tags = [NSMutableArray array];
-        
-        for (NSDictionary *tagDictionary in [[responseDictionary objectForKey:@"toptags"] objectForKey:@"tag"]) {
-            LFMTopTag *tag = [[LFMTopTag alloc] initFromDictionary:tagDictionary];
-            tag == nil ?: [tags addObject:tag];
-        }
-        
+    return LFMEndpointDataTask(LFMEndpointAlbumGetTopTags, LFMParameters(albumName, albumArtist, mbid, @(autoCorrect)), nil, ^(NSError *error, NSArray<LFMTopTag *> *tags, id query) {
         block(error, tags);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)searchForAlbumNamed:(NSString *)albumName
                                  itemsPerPage:(NSUInteger)limit
                                        onPage:(NSUInteger)page
                                      callback:(void (^)(NSError * _Nullable, NSArray<LFMAlbum *> * _Nonnull, LFMSearchQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"album.search"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"album" value:albumName],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"results"];
-        
-        LFMSearchQuery *searchQuery = [[LFMSearchQuery alloc] initFromDictionary:responseDictionary];
-        
-        NSMutableArray <LFMAlbum *> *albums = [NSMutableArray array];
-        
-        for (NSDictionary *albumDictionary in [[responseDictionary objectForKey:@"albummatches"] objectForKey:@"album"]) {
-            LFMAlbum *album = [[LFMAlbum alloc] initFromDictionary:albumDictionary];
-            album == nil ?: [albums addObject:album];
-        }
-        
-        block(error, albums, searchQuery);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointAlbumSearch, LFMParameters(albumName, @(limit), @(page)), nil, block);
 }
 
 @end
@@ -25,7 +25,7 @@
 
 #import <Foundation/Foundation.h>
 
-@class LFMTag, LFMTopTag, LFMArtist, LFMAlbum, LFMQuery, LFMSearchQuery, LFMTrack;
+@class LFMTag, LFMTopTag, LFMArtist, LFMAlbum, LFMQuery, LFMSearchQuery, LFMTrack, LFMSession;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -50,6 +50,21 @@ NS_SWIFT_NAME(ArtistProvider)
                     toArtistNamed:(NSString *)artistName
                          callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(add(tags:to:callback:));
 
+/**
+ Tags an artist on behalf of the user of `session`.
+ 
+ @param tags        An array of user supplied tags to apply to this artist. Accepts a maximum of 10 tags. An exception will be raised if more than 10 tags are passed in.
+ @param artistName  The name of the artist.
+ @param session     The session of the user applying the tags.
+ @param block       The callback block containing an optional `NSError` if the request fails. Regardless of the success of the operation, this block will be called.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
++ (NSURLSessionDataTask *)addTags:(NSArray <LFMTag *> *)tags
+                    toArtistNamed:(NSString *)artistName
+                       forSession:(LFMSession *)session
+                         callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(add(tags:to:session:callback:));
+
 /**
  Removes a user's tag from an artist.
  
@@ -65,6 +80,21 @@ NS_SWIFT_NAME(ArtistProvider)
                     fromArtistNamed:(NSString *)artistName
                            callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(remove(tag:from:callback:));
 
+/**
+ Removes a tag the user of `session` applied to an artist.
+ 
+ @param tag         A single user tag to remove from this artist.
+ @param artistName  The name of the artist.
+ @param session     The session of the user who applied the tag.
+ @param block       The callback block containing an optional `NSError` if the request fails. Regardless of the success of the operation, this block will be called.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
++ (NSURLSessionDataTask *)removeTag:(LFMTag *)tag
+                    fromArtistNamed:(NSString *)artistName
+                         forSession:(LFMSession *)session
+                           callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(remove(tag:from:session:callback:));
+
 /**
  Retrieves corrections based on common misspellings of artist names.
  
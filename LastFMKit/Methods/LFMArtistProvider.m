@@ -24,10 +24,9 @@
 //
 
 #import "LFMArtistProvider.h"
-#import "LFMError.h"
+#import "LFMClient.h"
 #import "LFMTag.h"
 #import "LFMArtist.h"
-#import "LFMAuth.h"
 #import "LFMSession.h"
 #import "LFMKit+Protected.h"
 #import "LFMTopTag.h"
@@ -38,6 +37,13 @@
 + (NSURLSessionDataTask *)addTags:(NSArray *)tags
                     toArtistNamed:(NSString *)artistName
                          callback:(void (^)(NSError * _Nullable))block {
+    return [self addTags:tags toArtistNamed:artistName forSession:[LFMSession sharedSession] callback:block];
+}
+
++ (NSURLSessionDataTask *)addTags:(NSArray *)tags
+                    toArtistNamed:(NSString *)artistName
+                       forSession:(LFMSession *)session
+                         callback:(void (^)(NSError * _Nullable))block {
     NSAssert(tags.count <= 10, @"This method call accepts a maximum of 10 tags.");
     
     NSMutableString *tagString = [NSMutableString string];
@@ -45,100 +51,27 @@
         [tagString appendFormat:@"%@%@", (idx == 0 ? @"" : @","), obj.name];
     }];
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"artist.addTags"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"tags" value:tagString],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey],
-                            [NSURLQueryItem queryItemWithName:@"sk" value:[LFMSession sharedSession].sessionKey]];
-    components.queryItems = [[LFMAuth sharedInstance] appendingSignatureItemToQueryItems:queryItems];
-    
-    NSData *data = [components.query dataUsingEncoding:NSUTF8StringEncoding];
-    
-    [request setHTTPMethod:@"POST"];
-    [request setHTTPBody:data];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (block == nil) return;
-        if (error != nil || data == nil) return block(error);
-        
-        lfm_error_validate(data, &error);
-        
-        block(error);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointArtistAddTags, LFMParameters(artistName, tagString), session.sessionKey, LFMEndpointStatusCallback(block));
 }
 
 + (NSURLSessionDataTask *)removeTag:(LFMTag *)tag
                     fromArtistNamed:(NSString *)artistName
                            callback:(void (^)(NSError * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"artist.removeTag"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"tag" value:tag.name],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey],
-                            [NSURLQueryItem queryItemWithName:@"sk" value:[LFMSession sharedSession].sessionKey]];
-    components.queryItems = [[LFMAuth sharedInstance] appendingSignatureItemToQueryItems:queryItems];
-    
-    NSData *data = [components.query dataUsingEncoding:NSUTF8StringEncoding];
-    
-    [request setHTTPMethod:@"POST"];
-    [request setHTTPBody:data];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (block == nil) return;
-        if (error != nil || data == nil) return block(error);
-        
-        lfm_error_validate(data, &error);
-        
-        block(error);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return [self removeTag:tag fromArtistNamed:artistName forSession:[LFMSession sharedSession] callback:block];
+}
+
++ (NSURLSessionDataTask *)removeTag:(LFMTag *)tag
+                    fromArtistNamed:(NSString *)artistName
+                         forSession:(LFMSession *)session
+                           callback:(void (^)(NSError * _Nullable))block {
+    return LFMEndpointDataTask(LFMEndpointArtistRemoveTag, LFMParameters(artistName, tag.name), session.sessionKey, LFMEndpointStatusCallback(block));
 }
 
 + (NSURLSessionDataTask *)getCorrectionForMisspeltArtistName:(NSString *)artistName
                                                     callback:(void (^)(NSError * _Nullable, LFMArtist * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"artist.getCorrection"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (block == nil) return;
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, nil);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        LFMArtist *artist = [[LFMArtist alloc] initFromDictionary:[[[responseDictionary objectForKey:@"corrections"] objectForKey:@"correction"] objectForKey:@"artist"]];
-        
+    return LFMEndpointDataTask(LFMEndpointArtistGetCorrection, LFMParameters(artistName), nil, block == nil ? nil : ^(NSError *error, LFMArtist *artist, id query) {
         block(error, artist);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)getInfoOnArtistNamed:(NSString *)artistName
@@ -149,34 +82,22 @@
                                       callback:(void (^)(NSError * _Nullable, LFMArtist * _Nullable))block {
     NSAssert(artistName != nil || mbid != nil, @"Either the artistName or the mbid parameter must be set.");
     
-    NSURLSession *session = [NSURLSession sharedSession];
+    NSURLRequest *request = LFMEndpointRequest(LFMEndpointArtistGetInfo, LFMParameters(artistName, mbid, @(autoCorrect), userName, code), nil);
     
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"artist.getInfo"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
-                            [NSURLQueryItem queryItemWithName:@"autocorrect" value:[NSString stringWithFormat:@"%d", autoCorrect]],
-                            [NSURLQueryItem queryItemWithName:@"username" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"lang" value:code],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    components.queryItems = queryItems;
+    LFMClient *client = [LFMClient sharedClient];
     
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
+    // Per-user and translated details aren't catalogued.
+    LFMArtist *cataloguedModel = userName == nil && code == nil ? [client.catalogue artistNamed:artistName withMusicBrainzId:mbid] : nil;
     
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, nil);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        LFMArtist *artist = [[LFMArtist alloc] initFromDictionary:[responseDictionary objectForKey:@"artist"]];
-        
-        block(error, artist);
-    }];
+    if (cataloguedModel != nil) {
+        return [client dataTaskWithRequest:request answeredWithBlock:^(NSError *error) {
+            block(error, error == nil ? cataloguedModel : nil);
+        }];
+    }
     
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTaskWithRequest(LFMEndpointArtistGetInfo, request, ^(NSError *error, LFMArtist *artist, id query) {
+        block(error, artist);
+    });
 }
 
 + (NSURLSessionDataTask *)getArtistsSimilarToArtistNamed:(NSString *)artistName
@@ -186,38 +107,9 @@
                                                 callback:(void (^)(NSError * _Nullable, NSArray<LFMArtist *> * _Nonnull))block {
     NSAssert(artistName != nil || mbid != nil, @"Either the artistName or the mbid parameter must be set.");
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"artist.getSimilar"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
-                            [NSURLQueryItem queryItemWithName:@"autocorrect" value:[NSString stringWithFormat:@"%d", autoCorrect]],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[]);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        NSMutableArray<LFMArtist *> *artists = [NSMutableArray array];
-        
-        for (NSDictionary *artistDictionary in [[responseDictionary objectForKey:@"similarartists"] objectForKey:@"artist"]) {
-            LFMArtist *artist = [[LFMArtist alloc] initFromDictionary:artistDictionary];
-            artist == nil ?: [artists addObject:artist];
-        }
-        
+    return LFMEndpointDataTask(LFMEndpointArtistGetSimilar, LFMParameters(artistName, mbid, @(autoCorrect), @(limit)), nil, ^(NSError *error, NSArray<LFMArtist *> *artists, id query) {
         block(error, artists);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)getTagsForArtistNamed:(NSString *)artistName
@@ -229,40 +121,9 @@
     
     NSAssert(artistName != nil || mbid != nil, @"Either the artistName or the mbid parameter must be set.");
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"artist.getTags"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
-                            [NSURLQueryItem queryItemWithName:@"autocorrect" value:[NSString stringWithFormat:@"%d", autoCorrect]],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey],
-                            [NSURLQueryItem queryItemWithName:@"sk" value:[LFMSession sharedSession].sessionKey]];
-    
-    components.queryItems = [LFMSession sharedSession].sessionKey == nil ? queryItems : [[LFMAuth sharedInstance] appendingSignatureItemToQueryItems:queryItems];
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[]);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        NSMutableArray <LFMTag *> *tags = [NSMutableArray array];
-        
-        for (NSDictionary *tagDictionary in [[responseDictionary objectForKey:@"tags"] objectForKey:@"tag"]) {
-            LFMTag *tag = [[LFMTag alloc] initFromDictionary:tagDictionary];
-            tag == nil ?: [tags addObject:tag];
-        }
-        
+    return LFMEndpointDataTask(LFMEndpointArtistGetTags, LFMParameters(artistName, mbid, @(autoCorrect), userName), [LFMSession sharedSession].sessionKey, ^(NSError *error, NSArray<LFMTag *> *tags, id query) {
         block(error, tags);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)getTopAlbumsForArtistNamed:(NSString *)artistName
@@ -273,43 +134,7 @@
                                             callback:(void (^)(NSError * _Nullable, NSArray<LFMAlbum *> * _Nonnull, LFMQuery * _Nullable))block {
     NSAssert(artistName != nil || mbid != nil, @"Either the artistName or the mbid parameter must be set.");
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"artist.getTopAlbums"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"autocorrect" value:[NSString stringWithFormat:@"%d", autoCorrect]],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        NSMutableArray<LFMAlbum *> *albums = [NSMutableArray array];
-        
-        for (NSDictionary *albumDictionary in [[responseDictionary objectForKey:@"topalbums"] objectForKey:@"album"]) {
-            LFMAlbum *album = [[LFMAlbum alloc] initFromDictionary:albumDictionary];
-            album == nil ?: [albums addObject:album];
-        }
-        
-        NSDictionary *attributesDictionary = [[responseDictionary objectForKey:@"topalbums"] objectForKey:@"@attr"];
-        
-        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:attributesDictionary];
-        
-        block(error, albums, query);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointArtistGetTopAlbums, LFMParameters(artistName, mbid, @(page), @(limit), @(autoCorrect)), nil, block);
 }
 
 + (NSURLSessionDataTask *)getTopTracksForArtistNamed:(NSString *)artistName
@@ -320,43 +145,7 @@
                                             callback:(void (^)(NSError * _Nullable, NSArray<LFMTrack *> * _Nonnull, LFMQuery * _Nullable))block {
     NSAssert(artistName != nil || mbid != nil, @"Either the artistName or the mbid parameter must be set.");
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"artist.getTopTracks"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"autocorrect" value:[NSString stringWithFormat:@"%d", autoCorrect]],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        NSMutableArray<LFMTrack *> *tracks = [NSMutableArray array];
-        
-        for (NSDictionary *trackDictionary in [[responseDictionary objectForKey:@"toptracks"] objectForKey:@"track"]) {
-            LFMTrack *track = [[LFMTrack alloc] initFromDictionary:trackDictionary];
-            track == nil ?: [tracks addObject:track];
-        }
-        
-        NSDictionary *attributesDictionary = [[responseDictionary objectForKey:@"toptracks"] objectForKey:@"@attr"];
-        
-        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:attributesDictionary];
-        
-        block(error, tracks, query);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointArtistGetTopTracks, LFMParameters(artistName, mbid, @(page), @(limit), @(autoCorrect)), nil, block);
 }
 
 + (NSURLSessionDataTask *)getTopTagsForArtistNamed:(NSString *)artistName
@@ -365,79 +154,16 @@
                                           callback:(void (^)(NSError * _Nullable, NSArray <LFMTopTag *> * _Nonnull))block {
     NSAssert(artistName != nil || mbid != nil, @"Either the artistName or the mbid parameter must be set.");
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"artist.getTopTags"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
-                            [NSURLQueryItem queryItemWithName:@"autocorrect" value:[NSString stringWithFormat:@"%d", autoCorrect]],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[]);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        NSMutableArray <LFMTopTag *> *tags = [NSMutableArray array];
-        
-        for (NSDictionary *tagDictionary in [[responseDictionary objectForKey:@"toptags"] objectForKey:@"tag"]) {
-            LFMTopTag *tag = [[LFMTopTag alloc] initFromDictionary:tagDictionary];
-            tag == nil ?: [tags addObject:tag];
-        }
-        
+    return LFMEndpointDataTask(LFMEndpointArtistGetTopTags, LFMParameters(artistName, mbid, @(autoCorrect)), nil, ^(NSError *error, NSArray<LFMTopTag *> *tags, id query) {
         block(error, tags);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)searchForArtistNamed:(NSString *)artistName
                                   itemsPerPage:(NSUInteger)limit
                                         onPage:(NSUInteger)page
                                       callback:(void (^)(NSError * _Nullable, NSArray <LFMArtist *> * _Nonnull, LFMSearchQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"artist.search"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"results"];
-        
-        LFMSearchQuery *searchQuery = [[LFMSearchQuery alloc] initFromDictionary:responseDictionary];
-        
-        NSMutableArray <LFMArtist *> *artists = [NSMutableArray array];
-        
-        for (NSDictionary *artistDictionary in [[responseDictionary objectForKey:@"artistmatches"] objectForKey:@"artist"]) {
-            LFMArtist *artist = [[LFMArtist alloc] initFromDictionary:artistDictionary];
-            artist == nil ?: [artists addObject:artist];
-        }
-        
-        block(error, artists, searchQuery);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointArtistSearch, LFMParameters(artistName, @(limit), @(page)), nil, block);
 }
 
-
 @end
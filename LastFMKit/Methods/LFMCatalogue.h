@@ -0,0 +1,100 @@
+//
+//  LFMCatalogue.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+@class LFMArtist, LFMAlbum, LFMTrack;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A read-only, on-disk catalogue of artists, albums and tracks that `getInfo` calls are answered from before going to the network. Use it to ship information about popular entities with your app.
+ 
+ The catalogue is a snapshot (see `LFMSnapshot`) preceded by two hash indexes: one by normalised name - ignoring case, width and surrounding whitespace, and including the artist's name for albums and tracks - and one by MusicBrainz id. Catalogues are memory-mapped and nothing is read up front, so opening one takes the same time however many entries it has; a lookup reads a few index slots and decodes the one record it finds.
+ 
+ @note  Lookups made with a user name or a language code, which change the response, always go to the network.
+ */
+NS_SWIFT_NAME(Catalogue)
+@interface LFMCatalogue : NSObject
+
+/**
+ Builds a catalogue.
+ 
+ @param objects The artists, albums and tracks in the catalogue. Tracks are indexed by name only if they have an artist. Entries that share a name or MusicBrainz id are found in the order they appear in.
+ 
+ @return   The catalogue, which can be written to disk as is.
+ */
++ (NSData *)dataWithObjects:(NSArray *)objects NS_SWIFT_NAME(data(with:));
+
+/**
+ Initialises a catalogue from previously built data. Only the headers are validated.
+ 
+ @param data    The catalogue. It isn't copied, so memory-mapped data stays mapped.
+ @param error   On return, an `NSFileReadCorruptFileError` error if the data isn't a catalogue or was written by a different version of the format.
+ 
+ @return   An `LFMCatalogue` object, or `nil` if the data couldn't be read.
+ */
+- (nullable instancetype)initWithData:(NSData *)data error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+/**
+ Initialises a catalogue by mapping a file into memory.
+ 
+ @param URL     The location of the catalogue.
+ @param error   On return, an error if the file couldn't be mapped or isn't a catalogue.
+ 
+ @return   An `LFMCatalogue` object, or `nil` if the file couldn't be read.
+ */
+- (nullable instancetype)initWithContentsOfURL:(NSURL *)URL error:(NSError **)error NS_SWIFT_NAME(init(contentsOf:));
+
+/** The amount of entries in the catalogue. */
+@property(nonatomic, readonly) NSUInteger count;
+
+/**
+ Looks up an artist, by MusicBrainz id if one is given and otherwise by name.
+ 
+ @return   A newly decoded artist, or `nil` if the catalogue doesn't have it.
+ */
+- (nullable LFMArtist *)artistNamed:(nullable NSString *)artistName withMusicBrainzId:(nullable NSString *)mbid NS_SWIFT_NAME(artist(named:mbid:));
+
+/**
+ Looks up an album, by MusicBrainz id if one is given and otherwise by its name and its artist's name.
+ 
+ @return   A newly decoded album, or `nil` if the catalogue doesn't have it.
+ */
+- (nullable LFMAlbum *)albumNamed:(nullable NSString *)albumName byArtistNamed:(nullable NSString *)artistName withMusicBrainzId:(nullable NSString *)mbid NS_SWIFT_NAME(album(named:by:mbid:));
+
+/**
+ Looks up a track, by MusicBrainz id if one is given and otherwise by its name and its artist's name.
+ 
+ @return   A newly decoded track, or `nil` if the catalogue doesn't have it.
+ */
+- (nullable LFMTrack *)trackNamed:(nullable NSString *)trackName byArtistNamed:(nullable NSString *)artistName withMusicBrainzId:(nullable NSString *)mbid NS_SWIFT_NAME(track(named:by:mbid:));
+
+- (instancetype) __unavailable init;
++ (instancetype) __unavailable new;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,315 @@
+//
+//  LFMCatalogue.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMCatalogue.h"
+#import "LFMKit+Protected.h"
+
+/*
+ Layout, all integers little endian:
+ 
+     0   "LFMC"
+     4   uint16 format version
+     6   uint16 reserved, 0
+     8   uint32 amount of slots in the name index, a power of two
+    12   uint32 amount of slots in the MusicBrainz id index, a power of two
+    16   uint64 offset of the snapshot holding the entries
+    24   the name index, then the MusicBrainz id index, each slot a uint64 hash of the key - 0 if the slot is empty - a uint32 entry index plus one and a uint32 reserved
+         the snapshot, to the end of the data
+ 
+ Both indexes are open addressed with linear probing and are never more than half full. Keys that collide are told apart by decoding the entry and comparing it with what was looked up.
+ */
+static const uint8_t LFMCatalogueMagic[4] = {'L', 'F', 'M', 'C'};
+static const uint16_t LFMCatalogueFormatVersion = 1;
+static const NSUInteger LFMCatalogueHeaderLength = 24;
+static const NSUInteger LFMCatalogueSlotLength = 16;
+
+typedef struct {
+    uint64_t hash;
+    uint32_t entry;
+    uint32_t reserved;
+} LFMCatalogueSlot;
+
+static NSError *LFMCatalogueCorruptError(NSString *reason) {
+    return [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError userInfo:@{NSLocalizedDescriptionKey : reason}];
+}
+
+/** FNV-1a of the key's UTF-8. 0 marks an empty slot, so it is never returned. */
+static uint64_t LFMCatalogueHash(NSString *key) {
+    const char *bytes = key.UTF8String;
+    uint64_t hash = 14695981039346656037ULL;
+    
+    for (; *bytes != '\0'; bytes++) {
+        hash ^= (uint8_t)*bytes;
+        hash *= 1099511628211ULL;
+    }
+    
+    return hash == 0 ? 1 : hash;
+}
+
+static NSString *LFMCatalogueNameKey(NSString *kind, NSString * _Nullable artistName, NSString *name) {
+    if (artistName == nil) return [NSString stringWithFormat:@"%@\x1f%@", kind, LFMNormalizedName(name)];
+    
+    return [NSString stringWithFormat:@"%@\x1f%@\x1f%@", kind, LFMNormalizedName(artistName), LFMNormalizedName(name)];
+}
+
+static NSString *LFMCatalogueMusicBrainzKey(NSString *kind, NSString *mbid) {
+    return [NSString stringWithFormat:@"%@\x1f%@", kind, mbid.lowercaseString];
+}
+
+/** The kind, artist and name an entry is filed under, or `NO` if it can't be filed by name. */
+static BOOL LFMCatalogueDescribeEntry(id object, NSString * _Nonnull * _Nonnull kind, NSString * _Nullable * _Nonnull artistName, NSString * _Nullable * _Nonnull name) {
+    if ([object isKindOfClass:[LFMArtist class]]) {
+        *kind = @"artist";
+        *artistName = nil;
+        *name = [object name];
+    } else if ([object isKindOfClass:[LFMAlbum class]]) {
+        *kind = @"album";
+        *artistName = [(LFMAlbum *)object artist];
+        *name = [object name];
+    } else if ([object isKindOfClass:[LFMTrack class]]) {
+        *kind = @"track";
+        *artistName = [(LFMTrack *)object artist].name;
+        *name = [object name];
+        
+        return *artistName != nil;
+    } else {
+        return NO;
+    }
+    
+    return YES;
+}
+
+/** Files `entry` under `hash` in the first free slot, so entries are found in the order they were filed in. */
+static void LFMCatalogueInsert(LFMCatalogueSlot *slots, NSUInteger slotCount, uint64_t hash, NSUInteger entry) {
+    NSUInteger slot = (NSUInteger)(hash & (slotCount - 1));
+    
+    while (slots[slot].hash != 0) {
+        slot = (slot + 1) & (slotCount - 1);
+    }
+    
+    slots[slot].hash = CFSwapInt64HostToLittle(hash);
+    slots[slot].entry = CFSwapInt32HostToLittle((uint32_t)entry + 1);
+}
+
+static NSUInteger LFMCatalogueSlotCount(NSUInteger keyCount) {
+    NSUInteger slotCount = 1;
+    while (slotCount < keyCount * 2) slotCount <<= 1;
+    return slotCount;
+}
+
+static BOOL LFMIsPowerOfTwo(uint64_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+@implementation LFMCatalogue {
+    NSData *_data;
+    LFMSnapshot *_snapshot;
+    const uint8_t *_nameIndex;
+    NSUInteger _nameSlotCount;
+    const uint8_t *_musicBrainzIndex;
+    NSUInteger _musicBrainzSlotCount;
+}
+
++ (NSData *)dataWithObjects:(NSArray *)objects {
+    NSAssert(objects.count < UINT32_MAX, @"Catalogues are limited to 4 billion entries.");
+    
+    uint64_t *nameHashes = (uint64_t *)calloc(MAX(objects.count, 1), sizeof(uint64_t));
+    uint64_t *musicBrainzHashes = (uint64_t *)calloc(MAX(objects.count, 1), sizeof(uint64_t));
+    NSUInteger nameCount = 0, musicBrainzCount = 0;
+    
+    for (NSUInteger i = 0; i < objects.count; i++) @autoreleasepool {
+        NSString *kind = nil, *artistName = nil, *name = nil;
+        id object = objects[i];
+        
+        NSAssert([object isKindOfClass:[LFMArtist class]] || [object isKindOfClass:[LFMAlbum class]] || [object isKindOfClass:[LFMTrack class]], @"Only artists, albums and tracks can be part of a catalogue.");
+        
+        if (LFMCatalogueDescribeEntry(object, &kind, &artistName, &name)) {
+            nameHashes[i] = LFMCatalogueHash(LFMCatalogueNameKey(kind, artistName, name));
+            nameCount++;
+        }
+        
+        NSString *mbid = [object mbid];
+        
+        if (mbid.length > 0) {
+            musicBrainzHashes[i] = LFMCatalogueHash(LFMCatalogueMusicBrainzKey(kind, mbid));
+            musicBrainzCount++;
+        }
+    }
+    
+    NSUInteger nameSlotCount = LFMCatalogueSlotCount(nameCount);
+    NSUInteger musicBrainzSlotCount = LFMCatalogueSlotCount(musicBrainzCount);
+    NSUInteger snapshotOffset = LFMCatalogueHeaderLength + (nameSlotCount + musicBrainzSlotCount) * LFMCatalogueSlotLength;
+    
+    NSMutableData *data = [NSMutableData dataWithLength:snapshotOffset];
+    uint8_t *bytes = data.mutableBytes;
+    
+    memcpy(bytes, LFMCatalogueMagic, sizeof(LFMCatalogueMagic));
+    
+    uint16_t version = CFSwapInt16HostToLittle(LFMCatalogueFormatVersion);
+    uint32_t nameSlots = CFSwapInt32HostToLittle((uint32_t)nameSlotCount);
+    uint32_t musicBrainzSlots = CFSwapInt32HostToLittle((uint32_t)musicBrainzSlotCount);
+    uint64_t offset = CFSwapInt64HostToLittle(snapshotOffset);
+    
+    memcpy(bytes + 4, &version, sizeof(version));
+    memcpy(bytes + 8, &nameSlots, sizeof(nameSlots));
+    memcpy(bytes + 12, &musicBrainzSlots, sizeof(musicBrainzSlots));
+    memcpy(bytes + 16, &offset, sizeof(offset));
+    
+    LFMCatalogueSlot *nameIndex = (LFMCatalogueSlot *)(bytes + LFMCatalogueHeaderLength);
+    LFMCatalogueSlot *musicBrainzIndex = nameIndex + nameSlotCount;
+    
+    for (NSUInteger i = 0; i < objects.count; i++) {
+        if (nameHashes[i] != 0) LFMCatalogueInsert(nameIndex, nameSlotCount, nameHashes[i], i);
+        if (musicBrainzHashes[i] != 0) LFMCatalogueInsert(musicBrainzIndex, musicBrainzSlotCount, musicBrainzHashes[i], i);
+    }
+    
+    free(nameHashes);
+    free(musicBrainzHashes);
+    
+    [data appendData:[LFMSnapshot dataWithObjects:objects]];
+    
+    return data;
+}
+
+- (instancetype)initWithData:(NSData *)data error:(NSError **)error {
+    self = [super init];
+    
+    if (self) {
+        const uint8_t *bytes = data.bytes;
+        
+        if (data.length < LFMCatalogueHeaderLength || memcmp(bytes, LFMCatalogueMagic, sizeof(LFMCatalogueMagic)) != 0) {
+            if (error != NULL) *error = LFMCatalogueCorruptError(@"The data isn't a catalogue.");
+            return nil;
+        }
+        
+        uint16_t version;
+        uint32_t nameSlotCount, musicBrainzSlotCount;
+        uint64_t snapshotOffset;
+        
+        memcpy(&version, bytes + 4, sizeof(version));
+        memcpy(&nameSlotCount, bytes + 8, sizeof(nameSlotCount));
+        memcpy(&musicBrainzSlotCount, bytes + 12, sizeof(musicBrainzSlotCount));
+        memcpy(&snapshotOffset, bytes + 16, sizeof(snapshotOffset));
+        
+        version = CFSwapInt16LittleToHost(version);
+        nameSlotCount = CFSwapInt32LittleToHost(nameSlotCount);
+        musicBrainzSlotCount = CFSwapInt32LittleToHost(musicBrainzSlotCount);
+        snapshotOffset = CFSwapInt64LittleToHost(snapshotOffset);
+        
+        if (version != LFMCatalogueFormatVersion) {
+            if (error != NULL) *error = LFMCatalogueCorruptError([NSString stringWithFormat:@"The catalogue was written in version %u of the format, which this version of LastFMKit can't read.", version]);
+            return nil;
+        }
+        
+        uint64_t indexesEnd = LFMCatalogueHeaderLength + ((uint64_t)nameSlotCount + musicBrainzSlotCount) * LFMCatalogueSlotLength;
+        
+        if (!LFMIsPowerOfTwo(nameSlotCount) || !LFMIsPowerOfTwo(musicBrainzSlotCount) || snapshotOffset < indexesEnd || snapshotOffset > data.length) {
+            if (error != NULL) *error = LFMCatalogueCorruptError(@"The catalogue has been cut short.");
+            return nil;
+        }
+        
+        // The snapshot points into the catalogue's data rather than copying it, so a mapped file stays mapped.
+        NSData *snapshotData = [NSData dataWithBytesNoCopy:(void *)(bytes + snapshotOffset) length:data.length - (NSUInteger)snapshotOffset freeWhenDone:NO];
+        
+        _snapshot = [[LFMSnapshot alloc] initWithData:snapshotData error:error];
+        if (_snapshot == nil) return nil;
+        
+        _data = data;
+        _nameIndex = bytes + LFMCatalogueHeaderLength;
+        _nameSlotCount = nameSlotCount;
+        _musicBrainzIndex = _nameIndex + (NSUInteger)nameSlotCount * LFMCatalogueSlotLength;
+        _musicBrainzSlotCount = musicBrainzSlotCount;
+    }
+    
+    return self;
+}
+
+- (instancetype)initWithContentsOfURL:(NSURL *)URL error:(NSError **)error {
+    NSData *data = [NSData dataWithContentsOfURL:URL options:NSDataReadingMappedAlways error:error];
+    return data == nil ? nil : [self initWithData:data error:error];
+}
+
+- (NSUInteger)count {
+    return _snapshot.count;
+}
+
+- (LFMArtist *)artistNamed:(NSString *)artistName withMusicBrainzId:(NSString *)mbid {
+    return [self entryOfClass:[LFMArtist class] kind:@"artist" artistName:nil name:artistName mbid:mbid];
+}
+
+- (LFMAlbum *)albumNamed:(NSString *)albumName byArtistNamed:(NSString *)artistName withMusicBrainzId:(NSString *)mbid {
+    return [self entryOfClass:[LFMAlbum class] kind:@"album" artistName:artistName name:albumName mbid:mbid];
+}
+
+- (LFMTrack *)trackNamed:(NSString *)trackName byArtistNamed:(NSString *)artistName withMusicBrainzId:(NSString *)mbid {
+    return [self entryOfClass:[LFMTrack class] kind:@"track" artistName:artistName name:trackName mbid:mbid];
+}
+
+#pragma mark - Private
+
+- (id)entryOfClass:(Class)entryClass kind:(NSString *)kind artistName:(NSString *)artistName name:(NSString *)name mbid:(NSString *)mbid {
+    if (mbid.length > 0) {
+        return [self entryInIndex:_musicBrainzIndex slotCount:_musicBrainzSlotCount hash:LFMCatalogueHash(LFMCatalogueMusicBrainzKey(kind, mbid)) matching:^BOOL(id entry) {
+            return [entry isKindOfClass:entryClass] && [[entry mbid] caseInsensitiveCompare:mbid] == NSOrderedSame;
+        }];
+    }
+    
+    if (name == nil || (artistName == nil && entryClass != [LFMArtist class])) return nil;
+    
+    NSString *normalizedName = LFMNormalizedName(name);
+    NSString *normalizedArtistName = artistName == nil ? nil : LFMNormalizedName(artistName);
+    
+    return [self entryInIndex:_nameIndex slotCount:_nameSlotCount hash:LFMCatalogueHash(LFMCatalogueNameKey(kind, artistName, name)) matching:^BOOL(id entry) {
+        NSString *entryKind = nil, *entryArtistName = nil, *entryName = nil;
+        
+        if (![entry isKindOfClass:entryClass] || !LFMCatalogueDescribeEntry(entry, &entryKind, &entryArtistName, &entryName)) return NO;
+        if (![LFMNormalizedName(entryName) isEqualToString:normalizedName]) return NO;
+        
+        return normalizedArtistName == nil || [LFMNormalizedName(entryArtistName) isEqualToString:normalizedArtistName];
+    }];
+}
+
+- (id)entryInIndex:(const uint8_t *)index slotCount:(NSUInteger)slotCount hash:(uint64_t)hash matching:(BOOL (^)(id entry))matches {
+    NSUInteger slot = (NSUInteger)(hash & (slotCount - 1));
+    
+    // Bounded, in case a corrupt index has no empty slot to stop at.
+    for (NSUInteger probes = 0; probes < slotCount; probes++, slot = (slot + 1) & (slotCount - 1)) {
+        LFMCatalogueSlot entrySlot;
+        memcpy(&entrySlot, index + slot * LFMCatalogueSlotLength, sizeof(entrySlot));
+        
+        uint64_t slotHash = CFSwapInt64LittleToHost(entrySlot.hash);
+        uint32_t entry = CFSwapInt32LittleToHost(entrySlot.entry);
+        
+        if (slotHash == 0) break;
+        if (slotHash != hash || entry == 0 || entry > _snapshot.count) continue;
+        
+        id object = [_snapshot objectAtIndex:entry - 1];
+        if (object != nil && matches(object)) return object;
+    }
+    
+    return nil;
+}
+
+@end
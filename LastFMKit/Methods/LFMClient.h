@@ -0,0 +1,129 @@
+//
+//  LFMClient.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+@class LFMResponseCache, LFMRateLimiter, LFMRequestScheduler, LFMCatalogue;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ This class owns the `NSURLSession` that every call to the Last.fm API is made through. All providers route their requests through the `sharedClient`, which by default uses its own session created from `[NSURLSessionConfiguration defaultSessionConfiguration]` so Last.fm traffic does not have to compete with the rest of your app's networking on `[NSURLSession sharedSession]`.
+ 
+ Identical read-only requests made while one is already outstanding - for example, several views asking for the same artist at once - are coalesced: only one request goes out and every caller is called back with its result. Each caller is still handed a task of its own: cancelling it only cancels that caller's callback, and the request itself is cancelled once every caller waiting on it has cancelled.
+ 
+ The `NSURLSessionDataTask` a provider returns stands for the whole request, however many times it is sent. It isn't a task of the client's session: each attempt is sent on a task of its own, so the returned task reports no response or progress. It is already running when it is returned and completes once its callback has been called, so there is no need to resume it, and `-resume` and `-suspend` do nothing. Cancelling the returned task cancels the attempt in progress, stops any retry from being sent and calls the callback with an `NSURLErrorCancelled` error.
+ 
+ If you want to tune connection limits, timeouts or the delegate queue - or route requests through a custom `NSURLProtocol` for testing - create a client with your own configuration and set it as the shared client before making any calls.
+ */
+NS_SWIFT_NAME(Client)
+@interface LFMClient : NSObject
+
+/**
+ The client all providers use to make requests to the Last.fm API.
+ */
++ (LFMClient *)sharedClient NS_SWIFT_NAME(shared());
+
+/**
+ Replaces the shared client. Requests that have already been started will finish on the client they were started on.
+ 
+ @param client  The client all subsequent requests will be made through.
+ */
++ (void)setSharedClient:(LFMClient *)client NS_SWIFT_NAME(setShared(_:));
+
+/**
+ Initialises a new `LFMClient` object with its own `NSURLSession`.
+ 
+ @param configuration   The configuration used to create the session. Use this to set properties such as `HTTPMaximumConnectionsPerHost`, `timeoutIntervalForRequest` or `protocolClasses`. The configuration is copied, so changes made to it afterwards have no effect.
+ @param queue           The operation queue the session's completion handlers - and therefore every provider's callback - are called on. Pass `nil` to have the session create a serial queue.
+ 
+ @return   An `LFMClient` object.
+ */
+- (instancetype)initWithSessionConfiguration:(NSURLSessionConfiguration *)configuration
+                               delegateQueue:(nullable NSOperationQueue *)queue NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(configuration:delegateQueue:));
+
+/**
+ Initialises a new `LFMClient` object with its own `NSURLSession` that calls back on a serial queue created by the session.
+ 
+ @param configuration   The configuration used to create the session.
+ 
+ @return   An `LFMClient` object.
+ */
+- (instancetype)initWithSessionConfiguration:(NSURLSessionConfiguration *)configuration NS_SWIFT_NAME(init(configuration:));
+
+/** The session every request made through this client is sent on. */
+@property(strong, nonatomic, readonly) NSURLSession *session;
+
+/**
+ The cache responses to read-only methods are looked up in before a request is sent. The shared client uses a cache that keeps 256 responses in memory and persists responses to the user's caches directory. Set to `nil` to send every request to the network.
+ 
+ @note  When a response is served from the cache nothing is sent; the callback is still called on the session's delegate queue.
+ */
+@property(strong, nullable) LFMResponseCache *responseCache;
+
+/**
+ The catalogue `getInfo` calls on artists, albums and tracks are looked up in before the response cache and the network. Defaults to `nil`.
+ 
+ @note  When an entity is found in the catalogue nothing is sent, as with responses served from the cache.
+ */
+@property(strong, nullable) LFMCatalogue *catalogue;
+
+/**
+ The rate limiter requests wait on before they are sent to the network. The shared client uses a limiter that allows 5 requests per second per API key with bursts of up to 5, in line with Last.fm's published limits. Set to `nil` to send requests as soon as they are made.
+ 
+ @note  Cancelling the returned `NSURLSessionDataTask` while a request is waiting for its turn stops it from being sent.
+ */
+@property(strong, nullable) LFMRateLimiter *rateLimiter;
+
+/**
+ The scheduler that decides the order requests are sent to the network in and how many run at once. The shared client uses a scheduler with the default limits, so that searches and scrobbles aren't held up behind bulk requests. Set to `nil` to start every request as soon as it is made.
+ 
+ @note  Requests served from the response cache or coalesced with an outstanding request don't take a slot.
+ */
+@property(strong, nullable) LFMRequestScheduler *requestScheduler;
+
+/**
+ The amount of times a request that failed with a transient error is retried before the error is passed to the callback. Transient errors are Last.fm's "Rate limit exceeded" (29), "Service offline" (11) and "Temporary error" (16), and HTTP 429 responses. Defaults to 3. Set to 0 to disable retries.
+ 
+ @note  Cancelling the task a provider returned while a retry is waiting out its back off stops the retry from being sent; the callback is called with an `NSURLErrorCancelled` error.
+ */
+@property(assign) NSUInteger maximumRetryCount;
+
+/**
+ The delay before the first retry of a failed request. Each subsequent retry waits twice as long as the one before, give or take a random amount so that clients that failed together don't retry together. A `Retry-After` header sent with an HTTP 429 response takes precedence. Defaults to 1 second.
+ */
+@property(assign) NSTimeInterval retryDelay;
+
+/**
+ Cancels all outstanding requests and invalidates the underlying session. The client can not be used after this method has been called.
+ */
+- (void)invalidateAndCancel;
+
+- (instancetype) __unavailable init;
++ (instancetype) __unavailable new;
+
+@end
+
+NS_ASSUME_NONNULL_END
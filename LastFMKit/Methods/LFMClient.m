@@ -0,0 +1,860 @@
+//
+//  LFMClient.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMClient.h"
+#import "LFMKit+Protected.h"
+#import "LFMError.h"
+#import "LFMJSONStreamDecoder.h"
+
+/**
+ The task callers are handed for a request made through the client. It stands for the request as a whole - however many attempts it takes, or if it is answered without being sent at all - so it isn't a task of the session: every attempt is sent on a session task of its own, and nothing is left on the session once the request has finished.
+ 
+ The request is underway as soon as it has been made, so `-resume` and `-suspend` do nothing. The task is running until the callback has been called, and completed after. Cancelling a running task calls its cancellation handler, which stops the work being done for the request, and then the callback with an `NSURLErrorCancelled` error, on the session's delegate queue.
+ */
+@interface LFMRequestTask : NSURLSessionDataTask {
+    @package
+    dispatch_block_t _cancellationHandler; // Must be set before the task is handed out. Guarded by `self`.
+}
+
+@end
+
+@implementation LFMRequestTask {
+    NSURLRequest *_request;
+    NSOperationQueue *_delegateQueue;
+    NSUInteger _taskIdentifier;
+    LFMResponseCallback _callback; // Guarded by `self`, as are the ivars below.
+    NSURLSessionTaskState _state;
+    NSError *_error;
+    NSString *_taskDescription;
+    float _priority;
+}
+
+- (instancetype)initWithRequest:(NSURLRequest *)request delegateQueue:(NSOperationQueue *)queue callback:(LFMResponseCallback)block {
+    self = [super init];
+    
+    if (self) {
+        _request = request;
+        _delegateQueue = queue;
+        // Request tasks aren't tasks of a session, so they aren't numbered by one.
+        static NSUInteger nextTaskIdentifier = 1;
+        @synchronized ([LFMRequestTask class]) {
+            _taskIdentifier = nextTaskIdentifier++;
+        }
+        _callback = [block copy];
+        _state = NSURLSessionTaskStateRunning;
+        _priority = NSURLSessionTaskPriorityDefault;
+    }
+    
+    return self;
+}
+
+/**
+ Calls the callback, unless it has already been called. A task that has been cancelled finishes with a cancellation error whatever the outcome of the request.
+ */
+- (void)finishWithError:(NSError *)error responseDictionary:(NSDictionary *)responseDictionary {
+    LFMResponseCallback callback = nil;
+    
+    @synchronized (self) {
+        if (_state == NSURLSessionTaskStateCompleted) return;
+        
+        if (_state == NSURLSessionTaskStateCanceling) {
+            error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+            responseDictionary = nil;
+        }
+        
+        _state = NSURLSessionTaskStateCompleted;
+        _error = error;
+        callback = _callback;
+        _callback = nil;
+        // The handler usually leads back to this task through the request it cancels; letting go of it breaks the cycle.
+        _cancellationHandler = nil;
+    }
+    
+    if (callback != nil) callback(error, responseDictionary);
+}
+
+- (void)cancel {
+    dispatch_block_t cancellationHandler = nil;
+    
+    @synchronized (self) {
+        if (_state != NSURLSessionTaskStateRunning) return;
+        
+        _state = NSURLSessionTaskStateCanceling;
+        cancellationHandler = _cancellationHandler;
+        _cancellationHandler = nil;
+    }
+    
+    if (cancellationHandler != nil) cancellationHandler();
+    
+    [_delegateQueue addOperationWithBlock:^{
+        [self finishWithError:nil responseDictionary:nil];
+    }];
+}
+
+- (void)resume {
+    // Started when the request was made.
+}
+
+- (void)suspend {
+    // Attempts can't be paused part way through; cancel the task instead.
+}
+
+- (NSURLSessionTaskState)state {
+    @synchronized (self) {
+        return _state;
+    }
+}
+
+- (NSError *)error {
+    @synchronized (self) {
+        return _error;
+    }
+}
+
+- (NSUInteger)taskIdentifier {
+    return _taskIdentifier;
+}
+
+- (NSURLRequest *)originalRequest {
+    return _request;
+}
+
+- (NSURLRequest *)currentRequest {
+    return _request;
+}
+
+- (NSURLResponse *)response {
+    return nil;
+}
+
+- (int64_t)countOfBytesReceived {
+    return 0;
+}
+
+- (int64_t)countOfBytesSent {
+    return 0;
+}
+
+- (int64_t)countOfBytesExpectedToSend {
+    return 0;
+}
+
+- (int64_t)countOfBytesExpectedToReceive {
+    return NSURLSessionTransferSizeUnknown;
+}
+
+- (NSString *)taskDescription {
+    @synchronized (self) {
+        return _taskDescription;
+    }
+}
+
+- (void)setTaskDescription:(NSString *)taskDescription {
+    @synchronized (self) {
+        _taskDescription = [taskDescription copy];
+    }
+}
+
+- (float)priority {
+    @synchronized (self) {
+        return _priority;
+    }
+}
+
+- (void)setPriority:(float)priority {
+    @synchronized (self) {
+        _priority = priority;
+    }
+}
+
+@end
+
+@class LFMRetryableRequest;
+
+/**
+ A request that is waiting on the network or the response cache. Callers that make an identical request while it is outstanding are handed a task of their own, attached to it, instead of sending another one; the request is only cancelled once every one of those tasks has been.
+ */
+@interface LFMInFlightRequest : NSObject {
+    @package
+    LFMRetryableRequest *_retryableRequest;
+    NSMutableArray<LFMRequestTask *> *_requestTasks; // Guarded by the client's `_inFlightRequests`.
+}
+
+@end
+
+@implementation LFMInFlightRequest
+
+@end
+
+/**
+ A streamed response: the decoder its body is fed through as it arrives and the block called once it is complete.
+ */
+@interface LFMStreamedResponse : NSObject {
+    @package
+    LFMJSONStreamDecoder *_decoder;
+    NSError *_decodingError;
+    void (^_completion)(NSURLResponse *response, NSError *error, id root, NSUInteger itemCount);
+}
+
+@end
+
+@implementation LFMStreamedResponse
+
+@end
+
+/**
+ A request that may be sent more than once. Cancelling it cancels the attempt in progress and stops any more from being sent.
+ */
+@interface LFMRetryableRequest : NSObject {
+    @package
+    NSURLRequest *_request;
+    LFMRequestTicket *_ticket;
+    void (^_completion)(NSError *error, NSDictionary *responseDictionary, NSData *data);
+    NSURLSessionDataTask *_attemptDataTask; // Guarded by `self`, as is `_cancelled`.
+    BOOL _cancelled;
+}
+
+@end
+
+@implementation LFMRetryableRequest
+
+/**
+ Makes `dataTask` the attempt that cancelling the request cancels.
+ 
+ @return   `NO` if the request has already been cancelled, in which case the attempt mustn't be sent.
+ */
+- (BOOL)beginAttempt:(NSURLSessionDataTask *)dataTask {
+    @synchronized (self) {
+        if (_cancelled) return NO;
+        _attemptDataTask = dataTask;
+        return YES;
+    }
+}
+
+- (BOOL)isCancelled {
+    @synchronized (self) {
+        return _cancelled;
+    }
+}
+
+- (void)cancel {
+    NSURLSessionDataTask *attemptDataTask = nil;
+    
+    @synchronized (self) {
+        _cancelled = YES;
+        attemptDataTask = _attemptDataTask;
+    }
+    
+    [attemptDataTask cancel];
+}
+
+@end
+
+/**
+ The session delegate. Tasks created with a completion handler never reach it; tasks created for streamed responses are routed to their decoder by task identifier.
+ */
+@interface LFMSessionDelegate : NSObject <NSURLSessionDataDelegate> {
+    @package
+    NSMutableDictionary<NSNumber *, LFMStreamedResponse *> *_streamedResponses;
+}
+
+@end
+
+@implementation LFMSessionDelegate
+
+- (instancetype)init {
+    self = [super init];
+    
+    if (self) {
+        _streamedResponses = [NSMutableDictionary dictionary];
+    }
+    
+    return self;
+}
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
+    LFMStreamedResponse *streamedResponse = nil;
+    
+    @synchronized (_streamedResponses) {
+        streamedResponse = _streamedResponses[@(dataTask.taskIdentifier)];
+    }
+    
+    if (streamedResponse == nil || streamedResponse->_decodingError != nil) return;
+    
+    NSError *error = nil;
+    
+    if (![streamedResponse->_decoder appendData:data error:&error]) {
+        streamedResponse->_decodingError = error;
+        [dataTask cancel];
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
+    LFMStreamedResponse *streamedResponse = nil;
+    
+    @synchronized (_streamedResponses) {
+        streamedResponse = _streamedResponses[@(task.taskIdentifier)];
+        [_streamedResponses removeObjectForKey:@(task.taskIdentifier)];
+    }
+    
+    if (streamedResponse == nil) return;
+    
+    id root = nil;
+    
+    if (streamedResponse->_decodingError != nil) {
+        error = streamedResponse->_decodingError;
+    } else if (error == nil) {
+        root = [streamedResponse->_decoder finishDecodingWithError:&error];
+    }
+    
+    streamedResponse->_completion(task.response, error, root, streamedResponse->_decoder.itemCount);
+}
+
+@end
+
+/**
+ Whether a request that failed with `error` is worth sending again.
+ */
+static BOOL LFMErrorIsTransient(NSError *error, NSHTTPURLResponse *response) {
+    if (response.statusCode == 429) return YES;
+    if (![error.domain isEqualToString:@"fm.last.kit.error"]) return NO;
+    
+    return error.code == 29 || error.code == 11 || error.code == 16;
+}
+
+/**
+ A parameter a request is made with, from the query for `GET` requests or the body for signed `POST` requests.
+ */
+static NSString *LFMRequestParameter(NSURLRequest *request, NSString *name) {
+    NSURLComponents *components = [NSURLComponents componentsWithURL:request.URL resolvingAgainstBaseURL:NO];
+    
+    if (request.HTTPBody != nil) {
+        components.percentEncodedQuery = [[NSString alloc] initWithData:request.HTTPBody encoding:NSUTF8StringEncoding];
+    }
+    
+    for (NSURLQueryItem *item in components.queryItems) {
+        if ([item.name isEqualToString:name]) return item.value;
+    }
+    
+    return nil;
+}
+
+@implementation LFMClient {
+    NSURLSession *_session;
+    LFMSessionDelegate *_sessionDelegate;
+    LFMResponseCache *_responseCache;
+    LFMCatalogue *_catalogue;
+    LFMRateLimiter *_rateLimiter;
+    LFMRequestScheduler *_requestScheduler;
+    NSUInteger _maximumRetryCount;
+    NSTimeInterval _retryDelay;
+    BOOL _invalidated;
+    NSMutableDictionary<NSString *, LFMInFlightRequest *> *_inFlightRequests;
+}
+
+static LFMClient *sharedClient;
+
++ (LFMClient *)sharedClient {
+    @synchronized (self) {
+        if (sharedClient == nil) {
+            NSString *cachesDirectory = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+            
+            sharedClient = [[LFMClient alloc] initWithSessionConfiguration:[NSURLSessionConfiguration defaultSessionConfiguration]];
+            sharedClient.responseCache = [[LFMResponseCache alloc] initWithMemoryCapacity:256 diskPath:[cachesDirectory stringByAppendingPathComponent:@"fm.last.kit.responses"]];
+            sharedClient.rateLimiter = [[LFMRateLimiter alloc] initWithRequestsPerSecond:5 burst:5];
+            sharedClient.requestScheduler = [[LFMRequestScheduler alloc] init];
+        }
+        return sharedClient;
+    }
+}
+
++ (void)setSharedClient:(LFMClient *)client {
+    NSAssert(client != nil, @"The shared client can not be set to nil.");
+    @synchronized (self) {
+        sharedClient = client;
+    }
+}
+
+- (instancetype)initWithSessionConfiguration:(NSURLSessionConfiguration *)configuration
+                               delegateQueue:(NSOperationQueue *)queue {
+    self = [super init];
+    
+    if (self) {
+        _sessionDelegate = [[LFMSessionDelegate alloc] init];
+        _session = [NSURLSession sessionWithConfiguration:configuration delegate:_sessionDelegate delegateQueue:queue];
+        _inFlightRequests = [NSMutableDictionary dictionary];
+        _maximumRetryCount = 3;
+        _retryDelay = 1;
+    }
+    
+    return self;
+}
+
+- (instancetype)initWithSessionConfiguration:(NSURLSessionConfiguration *)configuration {
+    return [self initWithSessionConfiguration:configuration delegateQueue:nil];
+}
+
+- (NSURLSession *)session {
+    return _session;
+}
+
+- (LFMResponseCache *)responseCache {
+    @synchronized (self) {
+        return _responseCache;
+    }
+}
+
+- (void)setResponseCache:(LFMResponseCache *)responseCache {
+    @synchronized (self) {
+        _responseCache = responseCache;
+    }
+}
+
+- (LFMCatalogue *)catalogue {
+    @synchronized (self) {
+        return _catalogue;
+    }
+}
+
+- (void)setCatalogue:(LFMCatalogue *)catalogue {
+    @synchronized (self) {
+        _catalogue = catalogue;
+    }
+}
+
+- (LFMRateLimiter *)rateLimiter {
+    @synchronized (self) {
+        return _rateLimiter;
+    }
+}
+
+- (void)setRateLimiter:(LFMRateLimiter *)rateLimiter {
+    @synchronized (self) {
+        _rateLimiter = rateLimiter;
+    }
+}
+
+- (LFMRequestScheduler *)requestScheduler {
+    @synchronized (self) {
+        return _requestScheduler;
+    }
+}
+
+- (void)setRequestScheduler:(LFMRequestScheduler *)requestScheduler {
+    @synchronized (self) {
+        _requestScheduler = requestScheduler;
+    }
+}
+
+- (NSUInteger)maximumRetryCount {
+    @synchronized (self) {
+        return _maximumRetryCount;
+    }
+}
+
+- (void)setMaximumRetryCount:(NSUInteger)maximumRetryCount {
+    @synchronized (self) {
+        _maximumRetryCount = maximumRetryCount;
+    }
+}
+
+- (NSTimeInterval)retryDelay {
+    @synchronized (self) {
+        return _retryDelay;
+    }
+}
+
+- (void)setRetryDelay:(NSTimeInterval)retryDelay {
+    @synchronized (self) {
+        _retryDelay = retryDelay;
+    }
+}
+
+- (void)invalidateAndCancel {
+    @synchronized (self) {
+        _invalidated = YES;
+    }
+    [_session invalidateAndCancel];
+}
+
++ (NSString *)keyForRequest:(NSURLRequest *)request method:(NSString * *)method {
+    if (![request.HTTPMethod isEqualToString:@"GET"]) return nil;
+    
+    NSURLComponents *components = [NSURLComponents componentsWithURL:request.URL resolvingAgainstBaseURL:NO];
+    NSMutableArray<NSURLQueryItem *> *queryItems = [NSMutableArray arrayWithCapacity:components.queryItems.count];
+    NSString *methodName = nil;
+    
+    for (NSURLQueryItem *item in components.queryItems) {
+        if (item.value == nil) continue;
+        if ([item.name isEqualToString:@"api_sig"]) continue; // Derived from every other parameter.
+        if ([item.name isEqualToString:@"method"]) methodName = item.value;
+        [queryItems addObject:item];
+    }
+    
+    if (methodName == nil) return nil;
+    
+    [queryItems sortUsingComparator:^NSComparisonResult(NSURLQueryItem *item1, NSURLQueryItem *item2) {
+        NSComparisonResult result = [item1.name compare:item2.name options:NSLiteralSearch];
+        return result != NSOrderedSame ? result : [item1.value compare:item2.value options:NSLiteralSearch];
+    }];
+    
+    // Length prefixes keep the key unambiguous whatever characters the values contain.
+    NSMutableString *key = [NSMutableString string];
+    for (NSURLQueryItem *item in queryItems) {
+        [key appendFormat:@"%tu:%@%tu:%@", item.name.length, item.name, item.value.length, item.value];
+    }
+    
+    *method = methodName;
+    return key;
+}
+
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request callback:(LFMResponseCallback)block {
+    NSString *method = nil;
+    NSString *key = [LFMClient keyForRequest:request method:&method];
+    
+    if (key == nil) {
+        LFMRequestTicket *ticket = [self.requestScheduler ticketForRequestToMethod:LFMRequestParameter(request, @"method")];
+        LFMRequestTask *requestTask = [[LFMRequestTask alloc] initWithRequest:request delegateQueue:_session.delegateQueue callback:block];
+        LFMRetryableRequest *retryableRequest = [self retryableRequestWithRequest:request ticket:ticket completion:^(NSError *error, NSDictionary *responseDictionary, NSData *data) {
+            [requestTask finishWithError:error responseDictionary:responseDictionary];
+        }];
+        
+        requestTask->_cancellationHandler = ^{
+            [retryableRequest cancel];
+        };
+        
+        [self sendAttempt:0 ofRequest:retryableRequest];
+        
+        return requestTask;
+    }
+    
+    LFMResponseCache *responseCache = self.responseCache;
+    LFMInFlightRequest *inFlightRequest = nil;
+    LFMRequestTask *requestTask = nil;
+    LFMRetryableRequest *retryableRequest = nil;
+    
+    @synchronized (_inFlightRequests) {
+        inFlightRequest = _inFlightRequests[key];
+        
+        if (inFlightRequest != nil) return [self requestTaskWithRequest:request attachedToInFlightRequest:inFlightRequest forKey:key callback:block];
+        
+        LFMRequestTicket *ticket = [self.requestScheduler ticketForRequestToMethod:method];
+        
+        inFlightRequest = [[LFMInFlightRequest alloc] init];
+        inFlightRequest->_requestTasks = [NSMutableArray array];
+        
+        // The in-flight request owns the retryable request, so the completion mustn't hold on to it in turn.
+        __weak LFMInFlightRequest *weakInFlightRequest = inFlightRequest;
+        
+        retryableRequest = [self retryableRequestWithRequest:request ticket:ticket completion:^(NSError *error, NSDictionary *responseDictionary, NSData *data) {
+            if (error == nil) [responseCache storeResponse:responseDictionary data:data forKey:key method:method];
+            
+            [self finishInFlightRequest:weakInFlightRequest forKey:key error:error responseDictionary:responseDictionary];
+        }];
+        
+        inFlightRequest->_retryableRequest = retryableRequest;
+        requestTask = [self requestTaskWithRequest:request attachedToInFlightRequest:inFlightRequest forKey:key callback:block];
+        
+        _inFlightRequests[key] = inFlightRequest;
+    }
+    
+    if (responseCache == nil || [responseCache timeToLiveForMethod:method] <= 0) {
+        [self sendAttempt:0 ofRequest:retryableRequest];
+        return requestTask;
+    }
+    
+    NSOperationQueue *queue = _session.delegateQueue;
+    
+    [responseCache lookupResponseForKey:key callback:^(NSDictionary *responseDictionary) {
+        if (responseDictionary == nil) return [self sendAttempt:0 ofRequest:retryableRequest];
+        
+        // Nothing is sent, so the callbacks are delivered on the same queue the session would have used.
+        [queue addOperationWithBlock:^{
+            [self finishInFlightRequest:inFlightRequest forKey:key error:nil responseDictionary:responseDictionary];
+        }];
+    }];
+    
+    return requestTask;
+}
+
+/**
+ Creates the task a caller is handed for an in-flight request. Cancelling it detaches only that caller; the in-flight request is cancelled, and stops being one that later callers can join, once every task attached to it has been cancelled.
+ 
+ @note Must be called while holding the `_inFlightRequests` lock.
+ */
+- (LFMRequestTask *)requestTaskWithRequest:(NSURLRequest *)request
+                 attachedToInFlightRequest:(LFMInFlightRequest *)inFlightRequest
+                                    forKey:(NSString *)key
+                                  callback:(LFMResponseCallback)block {
+    LFMRequestTask *requestTask = [[LFMRequestTask alloc] initWithRequest:request delegateQueue:_session.delegateQueue callback:block];
+    __weak LFMRequestTask *weakRequestTask = requestTask;
+    __weak LFMInFlightRequest *weakInFlightRequest = inFlightRequest;
+    
+    requestTask->_cancellationHandler = ^{
+        [self detachRequestTask:weakRequestTask fromInFlightRequest:weakInFlightRequest forKey:key];
+    };
+    
+    [inFlightRequest->_requestTasks addObject:requestTask];
+    
+    return requestTask;
+}
+
+/**
+ Detaches a cancelled caller's task from an in-flight request, cancelling the request if no other caller is still waiting on it.
+ */
+- (void)detachRequestTask:(LFMRequestTask *)requestTask fromInFlightRequest:(LFMInFlightRequest *)inFlightRequest forKey:(NSString *)key {
+    if (requestTask == nil || inFlightRequest == nil) return;
+    
+    @synchronized (_inFlightRequests) {
+        NSUInteger index = [inFlightRequest->_requestTasks indexOfObjectIdenticalTo:requestTask];
+        
+        // Already handed the outcome of the request.
+        if (index == NSNotFound) return;
+        
+        [inFlightRequest->_requestTasks removeObjectAtIndex:index];
+        
+        if (inFlightRequest->_requestTasks.count > 0) return;
+        
+        if (_inFlightRequests[key] == inFlightRequest) [_inFlightRequests removeObjectForKey:key];
+    }
+    
+    [inFlightRequest->_retryableRequest cancel];
+}
+
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request answeredWithBlock:(void (^)(NSError *))block {
+    LFMRequestTask *requestTask = [[LFMRequestTask alloc] initWithRequest:request delegateQueue:_session.delegateQueue callback:^(NSError *error, NSDictionary *responseDictionary) {
+        block(error);
+    }];
+    
+    [_session.delegateQueue addOperationWithBlock:^{
+        [requestTask finishWithError:nil responseDictionary:nil];
+    }];
+    
+    return requestTask;
+}
+
+/**
+ Creates a request that may be retried. Nothing is sent until `-sendAttempt:ofRequest:` is called; `completion` is called once, with the outcome of the last attempt.
+ */
+- (LFMRetryableRequest *)retryableRequestWithRequest:(NSURLRequest *)request
+                                              ticket:(LFMRequestTicket *)ticket
+                                          completion:(void (^)(NSError *error, NSDictionary *responseDictionary, NSData *data))completion {
+    LFMRetryableRequest *retryableRequest = [[LFMRetryableRequest alloc] init];
+    retryableRequest->_request = request;
+    retryableRequest->_ticket = ticket;
+    retryableRequest->_completion = [completion copy];
+    
+    return retryableRequest;
+}
+
+/**
+ Calls a request's completion with a cancellation error on the session's delegate queue, where it would have been called had the attempt been sent.
+ */
+- (void)finishCancelledRequest:(LFMRetryableRequest *)retryableRequest {
+    NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    
+    [_session.delegateQueue addOperationWithBlock:^{
+        retryableRequest->_completion(error, nil, nil);
+    }];
+}
+
+/**
+ Sends one attempt at a request, unless the request has been cancelled. If the attempt fails with a transient error and retries remain, the completion is held back and another attempt is sent on a new task once the back off has passed.
+ */
+- (void)sendAttempt:(NSUInteger)attempt ofRequest:(LFMRetryableRequest *)retryableRequest {
+    LFMRequestTicket *ticket = retryableRequest->_ticket;
+    void (^completion)(NSError *, NSDictionary *, NSData *) = retryableRequest->_completion;
+    __block __weak NSURLSessionDataTask *weakDataTask = nil;
+    
+    NSURLSessionDataTask *dataTask = [_session dataTaskWithRequest:retryableRequest->_request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        if (weakDataTask != nil) [ticket dataTaskDidComplete:weakDataTask];
+        
+        NSDictionary *responseDictionary = nil;
+        
+        if (error == nil && data == nil) {
+            error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorBadServerResponse userInfo:nil];
+        } else if (error == nil) {
+            lfm_error_validate(data, &responseDictionary, &error);
+        }
+        
+        if (error == nil) return completion(nil, responseDictionary, data);
+        
+        BOOL retrying = [self retryRequest:retryableRequest afterAttempt:attempt failedWithError:error response:response usingBlock:^{
+            [self sendAttempt:attempt + 1 ofRequest:retryableRequest];
+        }];
+        
+        if (!retrying) completion(error, nil, nil);
+    }];
+    
+    weakDataTask = dataTask;
+    
+    if (![retryableRequest beginAttempt:dataTask]) return [self finishCancelledRequest:retryableRequest];
+    
+    [self startDataTask:dataTask ticket:ticket];
+}
+
+/**
+ Decides whether a failed attempt is sent again. If it is, the rate limiter is paused for rate limit errors and `block` is called once the back off has passed. If the request was cancelled or the client invalidated in the meantime, the request's completion is called with a cancellation error instead.
+ 
+ @return   `YES` if the attempt will be followed by another or by a cancellation error, `NO` if the error should be passed on.
+ */
+- (BOOL)retryRequest:(LFMRetryableRequest *)retryableRequest
+        afterAttempt:(NSUInteger)attempt
+     failedWithError:(NSError *)error
+            response:(NSURLResponse *)response
+          usingBlock:(dispatch_block_t)block {
+    NSURLRequest *request = retryableRequest->_request;
+    NSHTTPURLResponse *HTTPResponse = [response isKindOfClass:[NSHTTPURLResponse class]] ? (NSHTTPURLResponse *)response : nil;
+    
+    if (attempt >= self.maximumRetryCount || !LFMErrorIsTransient(error, HTTPResponse)) return NO;
+    
+    BOOL rateLimited = HTTPResponse.statusCode == 429 || error.code == 29;
+    NSTimeInterval delay = self.retryDelay * pow(2, attempt) * (0.75 + arc4random_uniform(501) / 1000.0);
+    id retryAfter = HTTPResponse.allHeaderFields[@"Retry-After"];
+    
+    if ([retryAfter respondsToSelector:@selector(doubleValue)] && [retryAfter doubleValue] > 0) {
+        delay = [retryAfter doubleValue];
+    }
+    
+    if (rateLimited) [self.rateLimiter pauseAPIKey:LFMRequestParameter(request, @"api_key") forTimeInterval:delay];
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        BOOL invalidated = NO;
+        @synchronized (self) {
+            invalidated = self->_invalidated;
+        }
+        
+        // A session can't create tasks once it has been invalidated.
+        if (invalidated || [retryableRequest isCancelled]) return [self finishCancelledRequest:retryableRequest];
+        
+        block();
+    });
+    
+    return YES;
+}
+
+- (NSURLSessionDataTask *)streamingDataTaskWithRequest:(NSURLRequest *)request
+                                              itemPath:(NSArray<NSString *> *)itemPath
+                                           itemHandler:(void (^)(id))itemHandler
+                                              callback:(LFMResponseCallback)block {
+    LFMRequestTicket *ticket = [self.requestScheduler ticketForRequestToMethod:LFMRequestParameter(request, @"method")];
+    LFMRequestTask *requestTask = [[LFMRequestTask alloc] initWithRequest:request delegateQueue:_session.delegateQueue callback:block];
+    LFMRetryableRequest *retryableRequest = [self retryableRequestWithRequest:request ticket:ticket completion:^(NSError *error, NSDictionary *responseDictionary, NSData *data) {
+        [requestTask finishWithError:error responseDictionary:responseDictionary];
+    }];
+    
+    requestTask->_cancellationHandler = ^{
+        [retryableRequest cancel];
+    };
+    
+    [self sendStreamingAttempt:0 ofRequest:retryableRequest itemPath:itemPath itemHandler:itemHandler];
+    
+    return requestTask;
+}
+
+/**
+ Sends one attempt at a streamed request, unless the request has been cancelled. Attempts are only repeated if they failed before any items were handed out.
+ */
+- (void)sendStreamingAttempt:(NSUInteger)attempt
+                   ofRequest:(LFMRetryableRequest *)retryableRequest
+                    itemPath:(NSArray<NSString *> *)itemPath
+                 itemHandler:(void (^)(id))itemHandler {
+    LFMRequestTicket *ticket = retryableRequest->_ticket;
+    void (^completion)(NSError *, NSDictionary *, NSData *) = retryableRequest->_completion;
+    NSURLSessionDataTask *dataTask = [_session dataTaskWithRequest:retryableRequest->_request];
+    __weak NSURLSessionDataTask *weakDataTask = dataTask;
+    
+    LFMStreamedResponse *streamedResponse = [[LFMStreamedResponse alloc] init];
+    streamedResponse->_decoder = [[LFMJSONStreamDecoder alloc] initWithItemPath:itemPath itemHandler:itemHandler];
+    streamedResponse->_completion = ^(NSURLResponse *response, NSError *error, id root, NSUInteger itemCount) {
+        if (weakDataTask != nil) [ticket dataTaskDidComplete:weakDataTask];
+        
+        if (error == nil) lfm_error_validate_object(root, &error);
+        if (error == nil) return completion(nil, root, nil);
+        
+        // Once items have been handed out the request can't be repeated without handing them out twice.
+        BOOL retrying = itemCount == 0 && [self retryRequest:retryableRequest afterAttempt:attempt failedWithError:error response:response usingBlock:^{
+            [self sendStreamingAttempt:attempt + 1 ofRequest:retryableRequest itemPath:itemPath itemHandler:itemHandler];
+        }];
+        
+        if (!retrying) completion(error, nil, nil);
+    };
+    
+    if (![retryableRequest beginAttempt:dataTask]) return [self finishCancelledRequest:retryableRequest];
+    
+    @synchronized (_sessionDelegate->_streamedResponses) {
+        _sessionDelegate->_streamedResponses[@(dataTask.taskIdentifier)] = streamedResponse;
+    }
+    
+    [self startDataTask:dataTask ticket:ticket];
+}
+
+/**
+ Resumes a data task once the scheduler has a slot for it and the rate limiter allows it to be sent. Tasks cancelled while they were waiting are not resumed.
+ */
+- (void)startDataTask:(NSURLSessionDataTask *)dataTask ticket:(LFMRequestTicket *)ticket {
+    LFMRateLimiter *rateLimiter = self.rateLimiter;
+    
+    dispatch_block_t resume = ^{
+        if (dataTask.state == NSURLSessionTaskStateSuspended) {
+            [dataTask resume];
+        } else {
+            [ticket dataTaskDidComplete:dataTask];
+        }
+    };
+    
+    dispatch_block_t acquireToken = ^{
+        if (rateLimiter == nil) return resume();
+        [rateLimiter acquireTokenForAPIKey:LFMRequestParameter(dataTask.originalRequest, @"api_key") isCancelled:^BOOL{
+            return dataTask.state != NSURLSessionTaskStateSuspended;
+        } handler:resume];
+    };
+    
+    if (ticket == nil) return acquireToken();
+    
+    [ticket scheduleDataTask:dataTask handler:acquireToken];
+}
+
+/**
+ Hands the outcome of an in-flight request to every task still attached to it. The request is only forgotten if it is still the one outstanding for `key`: once every caller has cancelled, an identical request may already have taken its place.
+ */
+- (void)finishInFlightRequest:(LFMInFlightRequest *)inFlightRequest forKey:(NSString *)key error:(NSError *)error responseDictionary:(NSDictionary *)responseDictionary {
+    if (inFlightRequest == nil) return;
+    
+    NSArray<LFMRequestTask *> *requestTasks = nil;
+    
+    @synchronized (_inFlightRequests) {
+        requestTasks = [inFlightRequest->_requestTasks copy];
+        [inFlightRequest->_requestTasks removeAllObjects];
+        
+        if (_inFlightRequests[key] == inFlightRequest) [_inFlightRequests removeObjectForKey:key];
+    }
+    
+    for (LFMRequestTask *requestTask in requestTasks) {
+        [requestTask finishWithError:error responseDictionary:responseDictionary];
+    }
+}
+
+@end
@@ -24,12 +24,11 @@
 //
 
 #import "LFMGeoProvider.h"
-#import "LFMAuth.h"
 #import "LFMArtist.h"
 #import "LFMQuery.h"
 #import "LFMTrack.h"
 #import "LFMKit+Protected.h"
-#import "LFMError.h"
+#import "LFMClient.h"
 
 @implementation LFMGeoProvider
 
@@ -37,40 +36,7 @@
                                     itemsPerPage:(NSUInteger)limit
                                           onPage:(NSUInteger)page
                                         callback:(void (^)(NSError * _Nullable, NSArray<LFMArtist *> * _Nonnull, LFMQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"geo.getTopArtists"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"country" value:country],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"topartists"];
-        
-        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:[responseDictionary objectForKey:@"@attr"]];
-        
-        NSMutableArray <LFMArtist *> *artists = [NSMutableArray array];
-        
-        for (NSDictionary *artistDictionary in [responseDictionary objectForKey:@"artist"]) {
-            LFMArtist *artist = [[LFMArtist alloc] initFromDictionary:artistDictionary];
-            artist == nil ?: [artists addObject:artist];
-        }
-        
-        block(error, artists, query);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointGeoGetTopArtists, LFMParameters(country, @(limit), @(page)), nil, block);
 }
 
 + (NSURLSessionDataTask *)getTopTracksInCountry:(NSString *)country
@@ -78,41 +44,7 @@
                                    itemsPerPage:(NSUInteger)limit
                                          onPage:(NSUInteger)page
                                        callback:(void (^)(NSError * _Nullable, NSArray<LFMTrack *> * _Nonnull, LFMQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"geo.getTopTracks"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"location" value:province],
-                            [NSURLQueryItem queryItemWithName:@"country" value:country],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"toptracks"];
-        
-        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:[responseDictionary objectForKey:@"@attr"]];
-        
-        NSMutableArray <LFMTrack *> *tracks = [NSMutableArray array];
-        
-        for (NSDictionary *trackDictionary in [responseDictionary objectForKey:@"track"]) {
-            LFMTrack *track = [[LFMTrack alloc] initFromDictionary:trackDictionary];
-            track == nil ?: [tracks addObject:track];
-        }
-        
-        block(error, tracks, query);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointGeoGetTopTracks, LFMParameters(province, country, @(limit), @(page)), nil, block);
 }
 
 @end
@@ -0,0 +1,83 @@
+//
+//  LFMHistoryExporter.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+@class LFMScrobbleTrack;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ This class exports a user's entire scrobble history from `user.getRecentTracks`, oldest scrobble first.
+ 
+ The end of the export is pinned to the time it starts, so scrobbles made while it runs don't shift the pages. Once the first page has revealed how many pages there are, the remaining pages are fetched concurrently - up to `maximumConcurrentRequests` at a time and no faster than `requestsPerSecond` - and handed over in time order as soon as every older page has been.
+ 
+ If a checkpoint path is given, the newest second handed over - and how many of its scrobbles were - is recorded after every page, so an interrupted export resumes where it stopped. Once an export completes, running it again with the same checkpoint only fetches the scrobbles made since, which makes it suitable for mirroring users incrementally.
+ */
+NS_SWIFT_NAME(HistoryExporter)
+@interface LFMHistoryExporter : NSObject
+
+/**
+ Initialises a new `LFMHistoryExporter` object.
+ 
+ @param userName        The user whose scrobbles are to be exported.
+ @param checkpointPath  The file progress is recorded in, or `nil` to always export the whole history.
+ 
+ @return   An `LFMHistoryExporter` object.
+ */
+- (instancetype)initWithUserName:(NSString *)userName checkpointPath:(nullable NSString *)checkpointPath NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(userName:checkpointPath:));
+
+/** The user whose scrobbles are exported. */
+@property(copy, nonatomic, readonly) NSString *userName;
+
+/** The file progress is recorded in, if any. */
+@property(copy, nonatomic, readonly, nullable) NSString *checkpointPath;
+
+/** The maximum amount of pages fetched at once. Defaults to 4. */
+@property(nonatomic) NSUInteger maximumConcurrentRequests;
+
+/** The maximum amount of pages requested per second. Defaults to 5, the average rate Last.fm allows per API key. */
+@property(nonatomic) double requestsPerSecond;
+
+/** The amount of scrobbles fetched per page, up to 200. Defaults to 200. */
+@property(nonatomic) NSUInteger itemsPerPage;
+
+/**
+ Starts exporting. Only one export may run on an exporter at a time.
+ 
+ @param pageHandler The block called with each page of scrobbles, oldest first. Calls are made one at a time on a private serial queue and the checkpoint is only updated once the block returns, so a page being handled when the process dies is handed over again on resume.
+ @param completion  The callback block containing an optional `NSError` if a page couldn't be fetched or the export was cancelled.
+ 
+ @return   An `NSProgress` object counting scrobbles handed over. Cancelling it cancels every page in flight.
+ */
+- (NSProgress *)exportWithPageHandler:(void (^)(NSArray<LFMScrobbleTrack *> *scrobbles))pageHandler
+                           completion:(void (^_Nullable)(NSError * _Nullable error))completion NS_SWIFT_NAME(export(pageHandler:completion:));
+
+- (instancetype) __unavailable init;
++ (instancetype) __unavailable new;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,341 @@
+//
+//  LFMHistoryExporter.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMHistoryExporter.h"
+#import "LFMKit+Protected.h"
+#import "LFMScrobbleTrack.h"
+
+static NSString * const LFMCheckpointUserKey = @"user";
+static NSString * const LFMCheckpointLastTimestampKey = @"lastTimestamp";
+static NSString * const LFMCheckpointLastTimestampCountKey = @"lastTimestampCount";
+static NSString * const LFMCheckpointEndTimestampKey = @"endTimestamp";
+static NSString * const LFMCheckpointFinishedKey = @"finished";
+
+/** How many pages may be fetched ahead of the oldest page that hasn't been handed over yet, per concurrent request. Bounds how much is held in memory while a slow page holds the others up. */
+static const NSUInteger LFMReorderWindowFactor = 4;
+
+@implementation LFMHistoryExporter {
+    NSString *_userName;
+    NSString *_checkpointPath;
+    NSUInteger _maximumConcurrentRequests;
+    double _requestsPerSecond;
+    NSUInteger _itemsPerPage;
+    dispatch_queue_t _queue;
+    
+    // The state of the running export. Only touched on `_queue`.
+    BOOL _exporting;
+    NSProgress *_progress;
+    void (^_pageHandler)(NSArray<LFMScrobbleTrack *> *);
+    void (^_completion)(NSError *);
+    long long _startTimestamp;
+    long long _endTimestamp;
+    long long _lastTimestamp;
+    NSUInteger _lastTimestampCount; // How many of the scrobbles handed over were made in the second of `_lastTimestamp`.
+    NSUInteger _skipCount; // How many scrobbles from the second the export resumes in were handed over before it was interrupted.
+    NSUInteger _pageCount;
+    NSUInteger _nextPageToRequest; // Pages are requested and handed over from the last, oldest, page down to the first.
+    NSUInteger _nextPageToDeliver;
+    NSUInteger _requestsInFlight;
+    NSMutableDictionary<NSNumber *, NSArray<LFMScrobbleTrack *> *> *_pages;
+    NSMutableDictionary<NSNumber *, NSURLSessionDataTask *> *_dataTasks;
+    CFAbsoluteTime _nextRequestTime;
+    BOOL _waitingForRateLimit;
+}
+
+- (instancetype)initWithUserName:(NSString *)userName checkpointPath:(NSString *)checkpointPath {
+    self = [super init];
+    
+    if (self) {
+        _userName = [userName copy];
+        _checkpointPath = [checkpointPath copy];
+        _maximumConcurrentRequests = 4;
+        _requestsPerSecond = 5;
+        _itemsPerPage = 200;
+        _queue = dispatch_queue_create("fm.last.kit.history-exporter", DISPATCH_QUEUE_SERIAL);
+    }
+    
+    return self;
+}
+
+- (NSString *)userName {
+    return _userName;
+}
+
+- (NSString *)checkpointPath {
+    return _checkpointPath;
+}
+
+- (NSUInteger)maximumConcurrentRequests {
+    return _maximumConcurrentRequests;
+}
+
+- (void)setMaximumConcurrentRequests:(NSUInteger)maximumConcurrentRequests {
+    NSAssert(maximumConcurrentRequests > 0, @"At least one request must be allowed in flight.");
+    _maximumConcurrentRequests = maximumConcurrentRequests;
+}
+
+- (double)requestsPerSecond {
+    return _requestsPerSecond;
+}
+
+- (void)setRequestsPerSecond:(double)requestsPerSecond {
+    NSAssert(requestsPerSecond > 0, @"The request rate must be positive.");
+    _requestsPerSecond = requestsPerSecond;
+}
+
+- (NSUInteger)itemsPerPage {
+    return _itemsPerPage;
+}
+
+- (void)setItemsPerPage:(NSUInteger)itemsPerPage {
+    NSAssert(itemsPerPage > 0 && itemsPerPage <= 200, @"Last.fm returns between 1 and 200 scrobbles per page.");
+    _itemsPerPage = itemsPerPage;
+}
+
+- (NSProgress *)exportWithPageHandler:(void (^)(NSArray<LFMScrobbleTrack *> * _Nonnull))pageHandler
+                           completion:(void (^)(NSError * _Nullable))completion {
+    // Not +discreteProgressWithTotalUnitCount:, which is unavailable before iOS 9 and macOS 10.11.
+    NSProgress *progress = [[NSProgress alloc] initWithParent:nil userInfo:nil];
+    progress.totalUnitCount = -1;
+    
+    __weak LFMHistoryExporter *weakSelf = self;
+    progress.cancellationHandler = ^{
+        LFMHistoryExporter *exporter = weakSelf;
+        if (exporter == nil) return;
+        
+        dispatch_async(exporter->_queue, ^{
+            if (exporter->_progress != progress) return;
+            [exporter finishWithError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]];
+        });
+    };
+    
+    dispatch_async(_queue, ^{
+        NSAssert(!self->_exporting, @"Only one export may run at a time.");
+        
+        // Cancelled before the export started; the cancellation handler had no export to stop.
+        if (progress.isCancelled) {
+            if (completion != nil) completion([NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]);
+            return;
+        }
+        
+        self->_exporting = YES;
+        self->_progress = progress;
+        self->_pageHandler = pageHandler;
+        self->_completion = completion;
+        self->_pages = [NSMutableDictionary dictionary];
+        self->_dataTasks = [NSMutableDictionary dictionary];
+        self->_requestsInFlight = 0;
+        self->_pageCount = 0;
+        
+        [self readCheckpoint];
+        [self writeCheckpointFinished:NO];
+        [self requestPage:1];
+    });
+    
+    return progress;
+}
+
+#pragma mark - Checkpoints
+
+- (void)readCheckpoint {
+    NSDictionary *checkpoint = _checkpointPath == nil ? nil : [NSDictionary dictionaryWithContentsOfFile:_checkpointPath];
+    
+    if (![[checkpoint objectForKey:LFMCheckpointUserKey] isEqualToString:_userName]) checkpoint = nil;
+    
+    BOOL finished = [[checkpoint objectForKey:LFMCheckpointFinishedKey] boolValue];
+    NSNumber *endTimestamp = [checkpoint objectForKey:LFMCheckpointEndTimestampKey];
+    
+    _lastTimestamp = [[checkpoint objectForKey:LFMCheckpointLastTimestampKey] longLongValue];
+    _lastTimestampCount = [[checkpoint objectForKey:LFMCheckpointLastTimestampCountKey] unsignedIntegerValue];
+    // Scrobbles can share a second, and those of the newest second handed over may straddle a page boundary. That second is fetched again and the scrobbles already handed over from it are skipped.
+    _startTimestamp = _lastTimestamp;
+    _skipCount = _lastTimestampCount;
+    // An interrupted export keeps its original end so that page boundaries don't move; a finished one picks up everything since.
+    _endTimestamp = (!finished && endTimestamp != nil) ? endTimestamp.longLongValue : (long long)[[NSDate date] timeIntervalSince1970];
+}
+
+- (void)writeCheckpointFinished:(BOOL)finished {
+    if (_checkpointPath == nil) return;
+    
+    NSDictionary *checkpoint = @{LFMCheckpointUserKey: _userName,
+                                 LFMCheckpointLastTimestampKey: @(_lastTimestamp),
+                                 LFMCheckpointLastTimestampCountKey: @(_lastTimestampCount),
+                                 LFMCheckpointEndTimestampKey: @(_endTimestamp),
+                                 LFMCheckpointFinishedKey: @(finished)};
+    
+    [checkpoint writeToFile:_checkpointPath atomically:YES];
+}
+
+#pragma mark - Fetching
+
+- (void)requestPage:(NSUInteger)page {
+    NSURLRequest *request = LFMEndpointRequest(LFMEndpointUserGetRecentTracks, LFMParameters(_userName, @(_itemsPerPage), @(page), @"1", @(_startTimestamp), @(_endTimestamp)), nil);
+    NSProgress *progress = _progress;
+    
+    _requestsInFlight++;
+    _nextRequestTime = MAX(_nextRequestTime, CFAbsoluteTimeGetCurrent()) + 1.0 / _requestsPerSecond;
+    
+    __block NSURLSessionDataTask *dataTask = nil;
+    
+    // An export is bulk work; it mustn't hold up requests the user is waiting on.
+    [LFMRequestScheduler performRequestsWithPriority:LFMRequestPriorityBackground usingBlock:^{
+        dataTask = [[LFMClient sharedClient] dataTaskWithRequest:request callback:^(NSError *error, NSDictionary *responseObject) {
+            NSDictionary *responseDictionary = [responseObject objectForKey:@"recenttracks"];
+            LFMQuery *query = [[LFMQuery alloc] initFromDictionary:[responseDictionary objectForKey:@"@attr"]];
+            NSMutableArray<LFMScrobbleTrack *> *scrobbles = [NSMutableArray array];
+            
+            for (NSDictionary *trackDictionary in [responseDictionary objectForKey:@"track"]) {
+                // The track that is playing right now has no date and isn't a scrobble yet.
+                NSTimeInterval timestamp = 0;
+                
+                if (!LFMParseTimestamp([[trackDictionary objectForKey:@"date"] objectForKey:@"uts"], &timestamp)) continue;
+                
+                LFMTrack *track = [[LFMTrack alloc] initFromDictionary:trackDictionary];
+                if (track == nil) continue;
+                
+                NSDate *date = [NSDate dateWithTimeIntervalSince1970:timestamp];
+                [scrobbles addObject:[[LFMScrobbleTrack alloc] initFromTrack:track withTimestamp:date chosenByUser:YES]];
+            }
+            
+            dispatch_async(self->_queue, ^{
+                if (self->_progress != progress) return;
+                [self receivePage:page scrobbles:scrobbles query:query error:error];
+            });
+        }];
+    }];
+    
+    _dataTasks[@(page)] = dataTask;
+}
+
+- (void)receivePage:(NSUInteger)page scrobbles:(NSArray<LFMScrobbleTrack *> *)scrobbles query:(LFMQuery *)query error:(NSError *)error {
+    _requestsInFlight--;
+    [_dataTasks removeObjectForKey:@(page)];
+    
+    if (error != nil) return [self finishWithError:error];
+    
+    if (page == 1) {
+        NSUInteger itemsPerPage = MAX(query.itemsPerPage, 1);
+        
+        _pageCount = MAX((query.totalResults + itemsPerPage - 1) / itemsPerPage, 1);
+        _nextPageToRequest = _pageCount;
+        _nextPageToDeliver = _pageCount;
+        _progress.totalUnitCount = query.totalResults;
+    }
+    
+    // Pages come newest first; they're handed over oldest first.
+    _pages[@(page)] = [[scrobbles reverseObjectEnumerator] allObjects];
+    
+    [self deliverPages];
+    [self requestPages];
+}
+
+- (void)requestPages {
+    while (_exporting &&
+           _nextPageToRequest > 1 &&
+           _requestsInFlight < _maximumConcurrentRequests &&
+           _nextPageToDeliver - _nextPageToRequest < _maximumConcurrentRequests * LFMReorderWindowFactor)
+    {
+        CFAbsoluteTime delay = _nextRequestTime - CFAbsoluteTimeGetCurrent();
+        
+        if (delay > 0) {
+            if (_waitingForRateLimit) return;
+            _waitingForRateLimit = YES;
+            
+            NSProgress *progress = _progress;
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), _queue, ^{
+                if (self->_progress != progress) return;
+                self->_waitingForRateLimit = NO;
+                [self requestPages];
+            });
+            return;
+        }
+        
+        // Page 1 was requested first, to find out how many pages there are.
+        if (_pages[@(_nextPageToRequest)] == nil) [self requestPage:_nextPageToRequest];
+        _nextPageToRequest--;
+    }
+}
+
+- (void)deliverPages {
+    NSArray<LFMScrobbleTrack *> *scrobbles = nil;
+    
+    while (_exporting && _nextPageToDeliver > 0 && (scrobbles = _pages[@(_nextPageToDeliver)]) != nil) {
+        [_pages removeObjectForKey:@(_nextPageToDeliver)];
+        _nextPageToDeliver--;
+        
+        NSArray<LFMScrobbleTrack *> *unexportedScrobbles = [self unexportedScrobblesInPage:scrobbles];
+        if (unexportedScrobbles.count > 0) _pageHandler(unexportedScrobbles);
+        
+        _progress.completedUnitCount += scrobbles.count;
+        [self writeCheckpointFinished:_nextPageToDeliver == 0];
+    }
+    
+    if (_exporting && _pageCount > 0 && _nextPageToDeliver == 0) [self finishWithError:nil];
+}
+
+/** Drops the scrobbles an interrupted export already handed over, and records the newest second handed over. `scrobbles` are oldest first. */
+- (NSArray<LFMScrobbleTrack *> *)unexportedScrobblesInPage:(NSArray<LFMScrobbleTrack *> *)scrobbles {
+    NSMutableArray<LFMScrobbleTrack *> *unexportedScrobbles = [NSMutableArray arrayWithCapacity:scrobbles.count];
+    
+    for (LFMScrobbleTrack *scrobble in scrobbles) {
+        long long timestamp = (long long)scrobble.timestamp.timeIntervalSince1970;
+        
+        if (_skipCount > 0 && timestamp == _startTimestamp) {
+            _skipCount--;
+            continue;
+        }
+        
+        if (timestamp > _lastTimestamp) {
+            _lastTimestamp = timestamp;
+            _lastTimestampCount = 0;
+        }
+        
+        if (timestamp == _lastTimestamp) _lastTimestampCount++;
+        [unexportedScrobbles addObject:scrobble];
+    }
+    
+    return unexportedScrobbles;
+}
+
+- (void)finishWithError:(NSError *)error {
+    if (!_exporting) return;
+    
+    void (^completion)(NSError *) = _completion;
+    
+    [_dataTasks.allValues makeObjectsPerformSelector:@selector(cancel)];
+    
+    _exporting = NO;
+    _progress.cancellationHandler = nil;
+    _progress = nil;
+    _pageHandler = nil;
+    _completion = nil;
+    _pages = nil;
+    _dataTasks = nil;
+    _waitingForRateLimit = NO;
+    
+    if (completion != nil) completion(error);
+}
+
+@end
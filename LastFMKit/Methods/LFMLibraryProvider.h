@@ -50,6 +50,25 @@ NS_SWIFT_NAME(LibraryProvider)
                                           onPage:(NSUInteger)page
                                         callback:(void(^)(NSError * _Nullable, NSArray<LFMArtist *> *, LFMQuery * _Nullable))block;
 
+/**
+ Retrieves a page of the artists in a user's library, handing each artist over as soon as it has been downloaded rather than once the whole page has. Artists are decoded while the response arrives and never held together in memory, which makes this suitable for large pages.
+ 
+ @note  Unlike other requests, streamed requests are not cached or coalesced.
+ 
+ @param userName        The user whose library is to be fetched.
+ @param limit           The maximum number of artists to be returned by each page.
+ @param page            The page of results to be fetched. Start page is 1.
+ @param artistHandler   The block each `LFMArtist` is passed to, in order, on the client's delegate queue.
+ @param block           The callback block containing an optional `NSError` if the request fails and an `LFMQuery` object if it succeeds. It is called after the last artist has been handed over.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
++ (NSURLSessionDataTask *)streamArtistsForUserNamed:(NSString *)userName
+                                       itemsPerPage:(NSUInteger)limit
+                                             onPage:(NSUInteger)page
+                                      artistHandler:(void(^)(LFMArtist *))artistHandler
+                                           callback:(void(^)(NSError * _Nullable, LFMQuery * _Nullable))block;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -25,10 +25,9 @@
 
 #import "LFMLibraryProvider.h"
 #import "LFMArtist.h"
-#import "LFMError.h"
+#import "LFMClient.h"
 #import "LFMQuery.h"
 #import "LFMKit+Protected.h"
-#import "LFMAuth.h"
 
 @implementation LFMLibraryProvider
 
@@ -36,39 +35,28 @@
                                     itemsPerPage:(NSUInteger)limit
                                           onPage:(NSUInteger)page
                                         callback:(void (^)(NSError * _Nullable, NSArray<LFMArtist *> * _Nonnull, LFMQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"library.getArtists"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
+    return LFMEndpointDataTask(LFMEndpointLibraryGetArtists, LFMParameters(userName, @(limit), @(page)), nil, block);
+}
+
++ (NSURLSessionDataTask *)streamArtistsForUserNamed:(NSString *)userName
+                                       itemsPerPage:(NSUInteger)limit
+                                             onPage:(NSUInteger)page
+                                      artistHandler:(void (^)(LFMArtist * _Nonnull))artistHandler
+                                           callback:(void (^)(NSError * _Nullable, LFMQuery * _Nullable))block {
+    NSURLRequest *request = LFMEndpointRequest(LFMEndpointLibraryGetArtists, LFMParameters(userName, @(limit), @(page)), nil);
     
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
+    NSURLSessionDataTask *dataTask = [[LFMClient sharedClient] streamingDataTaskWithRequest:request itemPath:LFMEndpointModelPath(LFMEndpointLibraryGetArtists) itemHandler:^(NSDictionary *artistDictionary) {
+        LFMArtist *artist = [artistDictionary isKindOfClass:[NSDictionary class]] ? [[LFMArtist alloc] initFromDictionary:artistDictionary] : nil;
+        artist == nil ?: artistHandler(artist);
+    } callback:^(NSError *error, NSDictionary *responseDictionary) {
+        if (error != nil) return block(error, nil);
         
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"artists"];
+        id query = nil;
+        LFMEndpointDecodeResponse(LFMEndpointLibraryGetArtists, responseDictionary, &query);
         
-        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:[responseDictionary objectForKey:@"@attr"]];
-        
-        NSMutableArray <LFMArtist *> *artists = [NSMutableArray array];
-        
-        for (NSDictionary *artistDictionary in [responseDictionary objectForKey:@"artist"]) {
-            LFMArtist *artist = [[LFMArtist alloc] initFromDictionary:artistDictionary];
-            artist == nil ?: [artists addObject:artist];
-        }
-        
-        block(error, artists, query);
+        block(error, query);
     }];
     
-    [dataTask resume];
-    
     return dataTask;
 }
 
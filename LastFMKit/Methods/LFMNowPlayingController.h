@@ -0,0 +1,110 @@
+//
+//  LFMNowPlayingController.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+@class LFMSession;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Sends `track.updateNowPlaying` requests on behalf of a player whose state can change faster than it is worth telling Last.fm about, eg. while the user skips through a playlist.
+ 
+ Only the latest state of each session is kept. The first update after a quiet period is sent straight away; updates made within `minimumInterval` of the last one sent replace each other, and only the last of them is sent once the interval has passed. The callbacks of updates that are replaced before they are sent are called with an `NSURLErrorCancelled` error.
+ 
+ Scrobbling a track through `LFMTrackProvider` - directly or by draining an `LFMScrobbleQueue` - discards an update for that track which hasn't been sent yet, so a track that has finished is never reported as playing after it has been scrobbled.
+ */
+NS_SWIFT_NAME(NowPlayingController)
+@interface LFMNowPlayingController : NSObject
+
+/**
+ The controller shared by the whole app. It sends at most one update every 2 seconds.
+ */
++ (LFMNowPlayingController *)sharedController NS_SWIFT_NAME(shared());
+
+/**
+ Initialises a new `LFMNowPlayingController` object.
+ 
+ @param minimumInterval The shortest time, in seconds, between two updates sent for the same session.
+ 
+ @return   An `LFMNowPlayingController` object.
+ */
+- (instancetype)initWithMinimumInterval:(NSTimeInterval)minimumInterval NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(minimumInterval:));
+
+/** The shortest time, in seconds, between two updates sent for the same session. Changes apply from the next update that is scheduled. */
+@property(assign) NSTimeInterval minimumInterval;
+
+/**
+ Notifies Last.fm that the user of the current session has started listening to a track, once the controller's interval allows it.
+ 
+ @note  🔒: Authentication Required.
+ 
+ @param trackName   The name of the track.
+ @param artistName  The name of the track's artist.
+ @param albumName   The name of the track's album, if any.
+ @param trackNumber The position of the track on said album, if any.
+ @param albumArtist The artist of the album, if different to that of the track.
+ @param duration    The duration of the track, in seconds.
+ @param mbid        The MusicBrainzID for the track.
+ @param block       The callback block containing an optional `NSError` if the request fails, or an `NSURLErrorCancelled` error if the update was superseded before it was sent. Regardless of the success of the operation, this block will be called.
+ */
+- (void)updateNowPlayingWithTrackNamed:(NSString *)trackName
+                         byArtistNamed:(NSString *)artistName
+                          onAlbumNamed:(nullable NSString *)albumName
+                       positionInAlbum:(nullable NSNumber *)trackNumber
+                  withAlbumArtistNamed:(nullable NSString *)albumArtist
+                         trackDuration:(nullable NSNumber *)duration
+                         musicBrainzId:(nullable NSString *)mbid
+                              callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(updateNowPlaying(track:by:on:position:albumArtist:duration:mbid:callback:));
+
+/**
+ Notifies Last.fm that the user of `session` has started listening to a track, once the controller's interval allows it. Updates for different sessions are coalesced independently of each other, so use this rather than the method above when acting for more than one user, eg. sessions kept in an `LFMSessionRegistry`.
+ 
+ @param trackName   The name of the track.
+ @param artistName  The name of the track's artist.
+ @param albumName   The name of the track's album, if any.
+ @param trackNumber The position of the track on said album, if any.
+ @param albumArtist The artist of the album, if different to that of the track.
+ @param duration    The duration of the track, in seconds.
+ @param mbid        The MusicBrainzID for the track.
+ @param session     The session of the user who is listening.
+ @param block       The callback block containing an optional `NSError` if the request fails, or an `NSURLErrorCancelled` error if the update was superseded before it was sent. Regardless of the success of the operation, this block will be called.
+ */
+- (void)updateNowPlayingWithTrackNamed:(NSString *)trackName
+                         byArtistNamed:(NSString *)artistName
+                          onAlbumNamed:(nullable NSString *)albumName
+                       positionInAlbum:(nullable NSNumber *)trackNumber
+                  withAlbumArtistNamed:(nullable NSString *)albumArtist
+                         trackDuration:(nullable NSNumber *)duration
+                         musicBrainzId:(nullable NSString *)mbid
+                            forSession:(LFMSession *)session
+                              callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(updateNowPlaying(track:by:on:position:albumArtist:duration:mbid:session:callback:));
+
+- (instancetype) __unavailable init;
++ (instancetype) __unavailable new;
+
+@end
+
+NS_ASSUME_NONNULL_END
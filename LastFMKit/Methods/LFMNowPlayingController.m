@@ -0,0 +1,272 @@
+//
+//  LFMNowPlayingController.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMNowPlayingController.h"
+#import "LFMKit+Protected.h"
+#import "LFMTrackProvider.h"
+#import "LFMScrobbleTrack.h"
+#import "LFMSession.h"
+
+/** Every controller that is alive, so that scrobbles can discard their pending updates. */
+static NSHashTable<LFMNowPlayingController *> *LFMNowPlayingControllers;
+
+/**
+ An update that is waiting to be sent.
+ */
+@interface LFMNowPlayingUpdate : NSObject {
+    @package
+    NSString *_trackName;
+    NSString *_artistName;
+    NSString *_albumName;
+    NSNumber *_trackNumber;
+    NSString *_albumArtist;
+    NSNumber *_duration;
+    NSString *_mbid;
+    NSString *_sessionKey;
+    void (^_callback)(NSError *);
+}
+
+@end
+
+@implementation LFMNowPlayingUpdate
+
+/** Whether the update is for one of `tracks`. Names are compared the way the identity map compares them. */
+- (BOOL)isForOneOfTracks:(NSArray<LFMScrobbleTrack *> *)tracks {
+    NSString *trackName = LFMNormalizedName(_trackName);
+    NSString *artistName = LFMNormalizedName(_artistName);
+    
+    for (LFMScrobbleTrack *track in tracks) {
+        if (track.artist.name == nil) continue;
+        
+        if ([LFMNormalizedName(track.name) isEqualToString:trackName] &&
+            [LFMNormalizedName(track.artist.name) isEqualToString:artistName]) return YES;
+    }
+    
+    return NO;
+}
+
+@end
+
+/**
+ The latest state of one session, and when it was last sent.
+ */
+@interface LFMNowPlayingState : NSObject {
+    @package
+    LFMNowPlayingUpdate *_pendingUpdate;
+    CFAbsoluteTime _lastSentTime;
+    BOOL _flushScheduled;
+}
+
+@end
+
+@implementation LFMNowPlayingState
+
+@end
+
+/**
+ Calls the callback of an update that will never be sent on the shared client's delegate queue, where it would have been called had the update been sent.
+ */
+static void LFMCancelUpdate(LFMNowPlayingUpdate *update) {
+    if (update == nil || update->_callback == nil) return;
+    
+    void (^callback)(NSError *) = update->_callback;
+    NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    
+    [[LFMClient sharedClient].session.delegateQueue addOperationWithBlock:^{
+        callback(error);
+    }];
+}
+
+@implementation LFMNowPlayingController {
+    NSTimeInterval _minimumInterval;
+    NSMutableDictionary<NSString *, LFMNowPlayingState *> *_states;
+    dispatch_queue_t _queue;
+}
+
++ (LFMNowPlayingController *)sharedController {
+    static LFMNowPlayingController *sharedController;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedController = [[LFMNowPlayingController alloc] initWithMinimumInterval:2];
+    });
+    return sharedController;
+}
+
++ (void)tracksWillBeScrobbled:(NSArray<LFMScrobbleTrack *> *)tracks sessionKey:(NSString *)sessionKey {
+    NSArray<LFMNowPlayingController *> *controllers;
+    
+    @synchronized ([LFMNowPlayingController class]) {
+        controllers = LFMNowPlayingControllers.allObjects;
+    }
+    
+    for (LFMNowPlayingController *controller in controllers) {
+        [controller discardUpdateForTracks:tracks sessionKey:sessionKey];
+    }
+}
+
+- (instancetype)initWithMinimumInterval:(NSTimeInterval)minimumInterval {
+    NSAssert(minimumInterval >= 0, @"The interval can not be negative.");
+    
+    self = [super init];
+    
+    if (self) {
+        _minimumInterval = minimumInterval;
+        _states = [NSMutableDictionary dictionary];
+        _queue = dispatch_queue_create("fm.last.kit.now-playing", DISPATCH_QUEUE_SERIAL);
+        
+        @synchronized ([LFMNowPlayingController class]) {
+            if (LFMNowPlayingControllers == nil) LFMNowPlayingControllers = [NSHashTable weakObjectsHashTable];
+            [LFMNowPlayingControllers addObject:self];
+        }
+    }
+    
+    return self;
+}
+
+- (NSTimeInterval)minimumInterval {
+    @synchronized (self) {
+        return _minimumInterval;
+    }
+}
+
+- (void)setMinimumInterval:(NSTimeInterval)minimumInterval {
+    NSAssert(minimumInterval >= 0, @"The interval can not be negative.");
+    
+    @synchronized (self) {
+        _minimumInterval = minimumInterval;
+    }
+}
+
+- (void)updateNowPlayingWithTrackNamed:(NSString *)trackName
+                         byArtistNamed:(NSString *)artistName
+                          onAlbumNamed:(NSString *)albumName
+                       positionInAlbum:(NSNumber *)trackNumber
+                  withAlbumArtistNamed:(NSString *)albumArtist
+                         trackDuration:(NSNumber *)duration
+                         musicBrainzId:(NSString *)mbid
+                              callback:(void (^)(NSError * _Nullable))block {
+    [self updateNowPlayingWithTrackNamed:trackName
+                           byArtistNamed:artistName
+                            onAlbumNamed:albumName
+                         positionInAlbum:trackNumber
+                    withAlbumArtistNamed:albumArtist
+                           trackDuration:duration
+                           musicBrainzId:mbid
+                              forSession:[LFMSession sharedSession]
+                                callback:block];
+}
+
+- (void)updateNowPlayingWithTrackNamed:(NSString *)trackName
+                         byArtistNamed:(NSString *)artistName
+                          onAlbumNamed:(NSString *)albumName
+                       positionInAlbum:(NSNumber *)trackNumber
+                  withAlbumArtistNamed:(NSString *)albumArtist
+                         trackDuration:(NSNumber *)duration
+                         musicBrainzId:(NSString *)mbid
+                            forSession:(LFMSession *)session
+                              callback:(void (^)(NSError * _Nullable))block {
+    LFMNowPlayingUpdate *update = [[LFMNowPlayingUpdate alloc] init];
+    update->_trackName = [trackName copy];
+    update->_artistName = [artistName copy];
+    update->_albumName = [albumName copy];
+    update->_trackNumber = trackNumber;
+    update->_albumArtist = [albumArtist copy];
+    update->_duration = duration;
+    update->_mbid = [mbid copy];
+    update->_sessionKey = session.sessionKey;
+    update->_callback = [block copy];
+    
+    NSString *key = update->_sessionKey ?: @"";
+    LFMNowPlayingUpdate *supersededUpdate;
+    
+    @synchronized (self) {
+        LFMNowPlayingState *state = _states[key];
+        
+        if (state == nil) {
+            state = [[LFMNowPlayingState alloc] init];
+            _states[key] = state;
+        }
+        
+        supersededUpdate = state->_pendingUpdate;
+        state->_pendingUpdate = update;
+        
+        if (!state->_flushScheduled) {
+            state->_flushScheduled = YES;
+            
+            NSTimeInterval delay = MAX(0, state->_lastSentTime + _minimumInterval - CFAbsoluteTimeGetCurrent());
+            
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), _queue, ^{
+                [self flushSessionKey:key];
+            });
+        }
+    }
+    
+    LFMCancelUpdate(supersededUpdate);
+}
+
+#pragma mark - Private
+
+- (void)flushSessionKey:(NSString *)key {
+    LFMNowPlayingUpdate *update;
+    
+    @synchronized (self) {
+        LFMNowPlayingState *state = _states[key];
+        state->_flushScheduled = NO;
+        
+        // Discarded by a scrobble since the flush was scheduled.
+        if (state->_pendingUpdate == nil) return;
+        
+        update = state->_pendingUpdate;
+        state->_pendingUpdate = nil;
+        state->_lastSentTime = CFAbsoluteTimeGetCurrent();
+    }
+    
+    [LFMTrackProvider updateNowPlayingWithTrackNamed:update->_trackName
+                                       byArtistNamed:update->_artistName
+                                        onAlbumNamed:update->_albumName
+                                     positionInAlbum:update->_trackNumber
+                                withAlbumArtistNamed:update->_albumArtist
+                                       trackDuration:update->_duration
+                                       musicBrainzId:update->_mbid
+                                          sessionKey:update->_sessionKey
+                                            callback:update->_callback];
+}
+
+- (void)discardUpdateForTracks:(NSArray<LFMScrobbleTrack *> *)tracks sessionKey:(NSString *)sessionKey {
+    LFMNowPlayingUpdate *discardedUpdate;
+    
+    @synchronized (self) {
+        LFMNowPlayingState *state = _states[sessionKey ?: @""];
+        
+        if (state != nil && [state->_pendingUpdate isForOneOfTracks:tracks]) {
+            discardedUpdate = state->_pendingUpdate;
+            state->_pendingUpdate = nil;
+        }
+    }
+    
+    LFMCancelUpdate(discardedUpdate);
+}
+
+@end
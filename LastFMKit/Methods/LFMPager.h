@@ -0,0 +1,96 @@
+//
+//  LFMPager.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+@class LFMQuery;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The callback a page fetcher must call once a page has been retrieved. This has the same signature as the callbacks of every paginated provider method, so it can be passed straight through.
+ */
+typedef void (^LFMPageCallback)(NSError * _Nullable error, NSArray *items, LFMQuery * _Nullable query) NS_SWIFT_NAME(PageCallback);
+
+/**
+ Starts the request for a single page.
+ 
+ @param page        The page to be fetched. Pages start at 1.
+ @param callback    The block to be called with the page's items and its `LFMQuery`.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request, used to cancel it.
+ */
+typedef NSURLSessionDataTask * _Nullable (^LFMPageFetcher)(NSUInteger page, LFMPageCallback callback) NS_SWIFT_NAME(PageFetcher);
+
+/**
+ This class streams the items of a paginated Last.fm API method page by page, so that long lists - such as a user's entire loved tracks history - can be pulled without driving page numbers by hand.
+ 
+ The first page is fetched on its own to find out how many pages there are. After that, up to `prefetchLimit` pages are fetched ahead of the page being consumed, so the next page is normally already on its way - or has arrived - by the time it is asked for. No more than `prefetchLimit` pages are ever held in memory, and no pages past `LFMQuery.totalResults` are requested.
+ */
+NS_SWIFT_NAME(Pager)
+@interface LFMPager<__covariant ObjectType> : NSObject
+
+/**
+ Initialises a new `LFMPager` object.
+ 
+ @param prefetchLimit   The maximum amount of pages requested ahead of the page being consumed. Must be at least 1.
+ @param fetcher         The block used to request each page, eg. by calling `+[LFMUserProvider getTracksLovedByUserNamed:itemsPerPage:onPage:callback:]`.
+ 
+ @return   An `LFMPager` object.
+ */
+- (instancetype)initWithPrefetchLimit:(NSUInteger)prefetchLimit pageFetcher:(LFMPageFetcher)fetcher NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(prefetchLimit:fetcher:));
+
+/** The maximum amount of pages requested ahead of the page being consumed. */
+@property(nonatomic, readonly) NSUInteger prefetchLimit;
+
+/** The pagination information returned with the first page, or `nil` if it hasn't arrived yet. */
+@property(strong, readonly, nullable) LFMQuery *query;
+
+/**
+ Retrieves the next page of items. Pages are always delivered in order. If the page has already been prefetched the block is called immediately, otherwise it's called once the page arrives. Only one page may be asked for at a time.
+ 
+ @param block   The callback block containing an optional `NSError` if the page couldn't be fetched, and the page's items. `items` is `nil` once every page has been delivered, or after an error or cancellation.
+ */
+- (void)nextPageWithCallback:(void (^)(NSError * _Nullable error, NSArray<ObjectType> * _Nullable items))block NS_SWIFT_NAME(nextPage(callback:));
+
+/**
+ Calls a block for every item, in order, moving on to the next page once all of a page's items have been enumerated.
+ 
+ @param block       The block called for each item. Set `stop` to `YES` to stop enumerating and cancel any pages that have been prefetched.
+ @param completion  The callback block called once enumeration has finished, containing an optional `NSError` if a page couldn't be fetched.
+ */
+- (void)enumerateItemsUsingBlock:(void (^)(ObjectType item, BOOL *stop))block completion:(void (^_Nullable)(NSError * _Nullable error))completion NS_SWIFT_NAME(enumerateItems(using:completion:));
+
+/**
+ Cancels every page that is in flight and discards those that have been prefetched. A pending call to `nextPageWithCallback:` is called with an `NSURLErrorCancelled` error.
+ */
+- (void)cancel;
+
+- (instancetype) __unavailable init;
++ (instancetype) __unavailable new;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,207 @@
+//
+//  LFMPager.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMPager.h"
+#import "LFMQuery.h"
+
+@implementation LFMPager {
+    NSUInteger _prefetchLimit;
+    LFMPageFetcher _fetcher;
+    LFMQuery *_query;
+    NSUInteger _pageCount; // `NSUIntegerMax` until the first page has arrived.
+    NSUInteger _nextPageToRequest;
+    NSUInteger _nextPageToDeliver;
+    NSMutableDictionary<NSNumber *, id> *_pages; // Prefetched items, or the `NSError` the page failed with.
+    NSMutableDictionary<NSNumber *, NSURLSessionDataTask *> *_dataTasks;
+    void (^_waitingCallback)(NSError *, NSArray *);
+    NSError *_finalError;
+}
+
+- (instancetype)initWithPrefetchLimit:(NSUInteger)prefetchLimit pageFetcher:(LFMPageFetcher)fetcher {
+    NSAssert(prefetchLimit > 0, @"At least one page must be allowed to be prefetched.");
+    
+    self = [super init];
+    
+    if (self) {
+        _prefetchLimit = prefetchLimit;
+        _fetcher = [fetcher copy];
+        _pageCount = NSUIntegerMax;
+        _nextPageToRequest = 1;
+        _nextPageToDeliver = 1;
+        _pages = [NSMutableDictionary dictionary];
+        _dataTasks = [NSMutableDictionary dictionary];
+    }
+    
+    return self;
+}
+
+- (NSUInteger)prefetchLimit {
+    return _prefetchLimit;
+}
+
+- (LFMQuery *)query {
+    @synchronized (self) {
+        return _query;
+    }
+}
+
+- (void)nextPageWithCallback:(void (^)(NSError * _Nullable, NSArray * _Nullable))block {
+    @synchronized (self) {
+        NSAssert(_waitingCallback == nil, @"Only one page may be asked for at a time.");
+        _waitingCallback = [block copy];
+    }
+    
+    [self fillWindow];
+    [self deliverIfPossible];
+}
+
+- (void)enumerateItemsUsingBlock:(void (^)(id _Nonnull, BOOL * _Nonnull))block completion:(void (^)(NSError * _Nullable))completion {
+    [self nextPageWithCallback:^(NSError *error, NSArray *items) {
+        if (items == nil) {
+            if (completion != nil) completion(error);
+            return;
+        }
+        
+        BOOL stop = NO;
+        
+        for (id item in items) {
+            block(item, &stop);
+            if (stop) break;
+        }
+        
+        if (stop) {
+            [self cancel];
+            if (completion != nil) completion(nil);
+            return;
+        }
+        
+        [self enumerateItemsUsingBlock:block completion:completion];
+    }];
+}
+
+- (void)cancel {
+    NSArray<NSURLSessionDataTask *> *dataTasks = nil;
+    
+    @synchronized (self) {
+        if (_finalError == nil) _finalError = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+        
+        dataTasks = _dataTasks.allValues;
+        [_dataTasks removeAllObjects];
+        [_pages removeAllObjects];
+    }
+    
+    [dataTasks makeObjectsPerformSelector:@selector(cancel)];
+    [self deliverIfPossible];
+}
+
+#pragma mark - Private
+
+/**
+ Requests pages until `prefetchLimit` pages are in flight or waiting to be consumed. Until the first page has arrived it's the only one requested, because the amount of pages isn't known.
+ */
+- (void)fillWindow {
+    NSMutableIndexSet *pages = [NSMutableIndexSet indexSet];
+    
+    @synchronized (self) {
+        while (_finalError == nil &&
+               _nextPageToRequest <= _pageCount &&
+               _nextPageToRequest - _nextPageToDeliver < _prefetchLimit &&
+               (_pageCount != NSUIntegerMax || _nextPageToRequest == 1))
+        {
+            [pages addIndex:_nextPageToRequest++];
+        }
+    }
+    
+    [pages enumerateIndexesUsingBlock:^(NSUInteger page, BOOL *stop) {
+        NSURLSessionDataTask *dataTask = self->_fetcher(page, ^(NSError *error, NSArray *items, LFMQuery *query) {
+            [self receivePage:page error:error items:items query:query];
+        });
+        
+        @synchronized (self) {
+            // The page may already have arrived - eg. from the response cache - in which case there's nothing left to cancel.
+            if (dataTask != nil && page >= self->_nextPageToDeliver && self->_pages[@(page)] == nil && self->_finalError == nil) {
+                self->_dataTasks[@(page)] = dataTask;
+            }
+        }
+    }];
+}
+
+- (void)receivePage:(NSUInteger)page error:(NSError *)error items:(NSArray *)items query:(LFMQuery *)query {
+    @synchronized (self) {
+        [_dataTasks removeObjectForKey:@(page)];
+        
+        if (_finalError != nil) return;
+        
+        if (error == nil && _query == nil && query != nil) {
+            _query = query;
+            _pageCount = query.itemsPerPage == 0 ? 0 : (query.totalResults + query.itemsPerPage - 1) / query.itemsPerPage;
+        } else if (error == nil && page == 1) {
+            _pageCount = items.count == 0 ? 0 : 1;
+        }
+        
+        // An empty page means the results ran out early, eg. because items were removed while paging.
+        if (error == nil && items.count == 0) _pageCount = MIN(_pageCount, page - 1);
+        
+        _pages[@(page)] = error ?: items;
+    }
+    
+    [self fillWindow];
+    [self deliverIfPossible];
+}
+
+- (void)deliverIfPossible {
+    void (^callback)(NSError *, NSArray *) = nil;
+    NSError *error = nil;
+    NSArray *items = nil;
+    
+    @synchronized (self) {
+        if (_waitingCallback == nil) return;
+        
+        id page = _pages[@(_nextPageToDeliver)];
+        
+        if (_finalError != nil) {
+            error = _finalError.code == NSURLErrorCancelled ? _finalError : nil;
+        } else if (_nextPageToDeliver > _pageCount) {
+            // Every page has been delivered.
+        } else if ([page isKindOfClass:[NSError class]]) {
+            error = _finalError = page;
+            [_pages removeAllObjects];
+        } else if (page != nil) {
+            items = page;
+            [_pages removeObjectForKey:@(_nextPageToDeliver++)];
+        } else {
+            return;
+        }
+        
+        callback = _waitingCallback;
+        _waitingCallback = nil;
+    }
+    
+    if (items != nil) [self fillWindow];
+    
+    callback(error, items);
+}
+
+@end
@@ -0,0 +1,68 @@
+//
+//  LFMRateLimiter.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A token bucket scheduler that requests are started through so that an app stays under Last.fm's request rate limit rather than running into error 29 ("Rate limit exceeded") and having to retry.
+ 
+ Each API key has its own bucket. A bucket holds up to `burst` tokens and is refilled at `requestsPerSecond`; every request takes a token before it is started and waits for one if the bucket is empty. When Last.fm reports that the limit has been exceeded anyway, the key's bucket is paused until the back off has passed so that other requests don't make matters worse.
+ */
+NS_SWIFT_NAME(RateLimiter)
+@interface LFMRateLimiter : NSObject
+
+/**
+ Initialises a new `LFMRateLimiter` object.
+ 
+ @param requestsPerSecond   The rate used for API keys that haven't been given one of their own.
+ @param burst               The amount of requests that can be started at once after a quiet period, for API keys that haven't been given one of their own. Must be at least 1.
+ 
+ @return   An `LFMRateLimiter` object.
+ */
+- (instancetype)initWithRequestsPerSecond:(double)requestsPerSecond burst:(NSUInteger)burst NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(requestsPerSecond:burst:));
+
+/** The rate used for API keys that haven't been given one of their own. */
+@property(nonatomic, readonly) double requestsPerSecond;
+
+/** The burst size used for API keys that haven't been given one of their own. */
+@property(nonatomic, readonly) NSUInteger burst;
+
+/**
+ Sets the rate requests made with an API key are started at.
+ 
+ @param requestsPerSecond   The sustained amount of requests per second.
+ @param burst               The amount of requests that can be started at once after a quiet period. Must be at least 1.
+ @param apiKey              The API key the rate applies to.
+ */
+- (void)setRequestsPerSecond:(double)requestsPerSecond burst:(NSUInteger)burst forAPIKey:(NSString *)apiKey NS_SWIFT_NAME(setRequestsPerSecond(_:burst:for:));
+
+- (instancetype) __unavailable init;
++ (instancetype) __unavailable new;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,225 @@
+//
+//  LFMRateLimiter.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMRateLimiter.h"
+#import "LFMKit+Protected.h"
+
+/**
+ A request waiting for a token.
+ */
+@interface LFMTokenWaiter : NSObject {
+    @package
+    BOOL (^_isCancelled)(void);
+    dispatch_block_t _handler;
+}
+
+@end
+
+@implementation LFMTokenWaiter
+
+@end
+
+/**
+ The tokens available to one API key, and the requests waiting for them.
+ */
+@interface LFMTokenBucket : NSObject {
+    @package
+    double _requestsPerSecond;
+    double _capacity;
+    double _tokens;
+    CFAbsoluteTime _lastRefillTime;
+    CFAbsoluteTime _pausedUntil;
+    NSMutableArray<LFMTokenWaiter *> *_waiters;
+    BOOL _drainScheduled;
+}
+
+@end
+
+@implementation LFMTokenBucket
+
+- (void)refill {
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    
+    // Nothing accrues while paused.
+    if (now > _pausedUntil) {
+        CFAbsoluteTime elapsed = now - MAX(_lastRefillTime, _pausedUntil);
+        _tokens = MIN(_capacity, _tokens + MAX(0, elapsed) * _requestsPerSecond);
+    }
+
+    _lastRefillTime = now;
+}
+
+/** How long until the next token can be taken. */
+- (NSTimeInterval)delayUntilNextToken {
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    
+    if (now < _pausedUntil) return _pausedUntil - now + 1.0 / _requestsPerSecond;
+    
+    return MAX(0, (1 - _tokens) / _requestsPerSecond);
+}
+
+@end
+
+@implementation LFMRateLimiter {
+    double _requestsPerSecond;
+    NSUInteger _burst;
+    NSMutableDictionary<NSString *, LFMTokenBucket *> *_buckets;
+    dispatch_queue_t _queue;
+}
+
+- (instancetype)initWithRequestsPerSecond:(double)requestsPerSecond burst:(NSUInteger)burst {
+    NSAssert(requestsPerSecond > 0 && burst > 0, @"The rate must be positive and at least one request must be allowed at once.");
+    
+    self = [super init];
+    
+    if (self) {
+        _requestsPerSecond = requestsPerSecond;
+        _burst = burst;
+        _buckets = [NSMutableDictionary dictionary];
+        _queue = dispatch_queue_create("fm.last.kit.rate-limiter", DISPATCH_QUEUE_SERIAL);
+    }
+    
+    return self;
+}
+
+- (double)requestsPerSecond {
+    return _requestsPerSecond;
+}
+
+- (NSUInteger)burst {
+    return _burst;
+}
+
+- (void)setRequestsPerSecond:(double)requestsPerSecond burst:(NSUInteger)burst forAPIKey:(NSString *)apiKey {
+    NSAssert(requestsPerSecond > 0 && burst > 0, @"The rate must be positive and at least one request must be allowed at once.");
+    
+    @synchronized (self) {
+        LFMTokenBucket *bucket = [self bucketForAPIKey:apiKey];
+        [bucket refill];
+        
+        bucket->_requestsPerSecond = requestsPerSecond;
+        bucket->_capacity = burst;
+        bucket->_tokens = MIN(bucket->_tokens, burst);
+    }
+}
+
+- (void)acquireTokenForAPIKey:(NSString *)apiKey handler:(dispatch_block_t)handler {
+    [self acquireTokenForAPIKey:apiKey isCancelled:nil handler:handler];
+}
+
+- (void)acquireTokenForAPIKey:(NSString *)apiKey isCancelled:(BOOL (^)(void))isCancelled handler:(dispatch_block_t)handler {
+    if (isCancelled != nil && isCancelled()) return handler();
+    
+    @synchronized (self) {
+        LFMTokenBucket *bucket = [self bucketForAPIKey:apiKey ?: @""];
+        [bucket refill];
+        
+        if (bucket->_waiters.count > 0 || bucket->_tokens < 1 || CFAbsoluteTimeGetCurrent() < bucket->_pausedUntil) {
+            LFMTokenWaiter *waiter = [[LFMTokenWaiter alloc] init];
+            waiter->_isCancelled = [isCancelled copy];
+            waiter->_handler = [handler copy];
+            
+            [bucket->_waiters addObject:waiter];
+            [self scheduleDrainOfBucket:bucket];
+            return;
+        }
+        
+        bucket->_tokens -= 1;
+    }
+    
+    handler();
+}
+
+- (void)pauseAPIKey:(NSString *)apiKey forTimeInterval:(NSTimeInterval)interval {
+    @synchronized (self) {
+        LFMTokenBucket *bucket = [self bucketForAPIKey:apiKey ?: @""];
+        [bucket refill];
+        
+        // Whatever was saved up was evidently too much; start again from empty once the pause is over.
+        bucket->_tokens = 0;
+        bucket->_pausedUntil = MAX(bucket->_pausedUntil, CFAbsoluteTimeGetCurrent() + interval);
+    }
+}
+
+#pragma mark - Private
+
+- (LFMTokenBucket *)bucketForAPIKey:(NSString *)apiKey {
+    LFMTokenBucket *bucket = _buckets[apiKey];
+    
+    if (bucket == nil) {
+        bucket = [[LFMTokenBucket alloc] init];
+        bucket->_requestsPerSecond = _requestsPerSecond;
+        bucket->_capacity = _burst;
+        bucket->_tokens = _burst;
+        bucket->_lastRefillTime = CFAbsoluteTimeGetCurrent();
+        bucket->_waiters = [NSMutableArray array];
+        _buckets[apiKey] = bucket;
+    }
+    
+    return bucket;
+}
+
+/** Must be called with the lock held. */
+- (void)scheduleDrainOfBucket:(LFMTokenBucket *)bucket {
+    if (bucket->_drainScheduled) return;
+    bucket->_drainScheduled = YES;
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)([bucket delayUntilNextToken] * NSEC_PER_SEC)), _queue, ^{
+        [self drainBucket:bucket];
+    });
+}
+
+- (void)drainBucket:(LFMTokenBucket *)bucket {
+    NSMutableArray<dispatch_block_t> *handlers = [NSMutableArray array];
+    
+    @synchronized (self) {
+        bucket->_drainScheduled = NO;
+        [bucket refill];
+        
+        // Requests cancelled while they waited are let go without a token, so that superseded requests don't use up the rate.
+        NSIndexSet *cancelled = [bucket->_waiters indexesOfObjectsPassingTest:^BOOL(LFMTokenWaiter *waiter, NSUInteger idx, BOOL *stop) {
+            return waiter->_isCancelled != nil && waiter->_isCancelled();
+        }];
+        
+        [[bucket->_waiters objectsAtIndexes:cancelled] enumerateObjectsUsingBlock:^(LFMTokenWaiter *waiter, NSUInteger idx, BOOL *stop) {
+            [handlers addObject:waiter->_handler];
+        }];
+        [bucket->_waiters removeObjectsAtIndexes:cancelled];
+        
+        while (bucket->_waiters.count > 0 && bucket->_tokens >= 1 && CFAbsoluteTimeGetCurrent() >= bucket->_pausedUntil) {
+            bucket->_tokens -= 1;
+            [handlers addObject:bucket->_waiters.firstObject->_handler];
+            [bucket->_waiters removeObjectAtIndex:0];
+        }
+        
+        if (bucket->_waiters.count > 0) [self scheduleDrainOfBucket:bucket];
+    }
+    
+    for (dispatch_block_t handler in handlers) {
+        handler();
+    }
+}
+
+@end
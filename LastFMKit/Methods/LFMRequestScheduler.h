@@ -0,0 +1,118 @@
+//
+//  LFMRequestScheduler.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The classes requests are scheduled in. Queued requests of a higher class are always started before those of a lower one.
+ */
+typedef NS_ENUM(NSInteger, LFMRequestPriority) {
+    /** Requests a user is waiting on, such as searches and now playing updates. */
+    LFMRequestPriorityInteractive,
+    
+    /** Requests with no particular urgency. */
+    LFMRequestPriorityNormal,
+    
+    /** Bulk work such as prefetching or syncing history, which should only use what is left over. */
+    LFMRequestPriorityBackground
+} NS_SWIFT_NAME(RequestPriority);
+
+/**
+ Decides when requests made through an `LFMClient` are started, so that bulk background work can't hold up requests the user is waiting on.
+ 
+ Every request is put in one of three priority classes, each with its own concurrency limit. When a request finishes the next one is taken from the highest class that has requests queued; lower classes are not started while a higher class is waiting for a free slot. A request's class comes from the priority set for its method or, for requests made inside `+performRequestsWithPriority:usingBlock:`, from the block's priority.
+ 
+ Methods can also be set to cancel superseded requests: when such a method is called again, earlier requests to it that haven't completed are cancelled - queued ones without ever being sent. This suits type-ahead searches, where only the latest query is of interest.
+ 
+ @note  The shared client uses a scheduler with the default limits. Clients you create yourself start every request straight away unless a scheduler is set on their `requestScheduler` property.
+ */
+NS_SWIFT_NAME(RequestScheduler)
+@interface LFMRequestScheduler : NSObject
+
+/**
+ Initialises a new `LFMRequestScheduler` object that allows 4 interactive, 4 normal and 2 background requests at once. `auth.*`, `*.search` and the now playing, scrobble, love and unlove methods are interactive; every other method is normal.
+ 
+ @return   An `LFMRequestScheduler` object.
+ */
+- (instancetype)init NS_DESIGNATED_INITIALIZER;
+
+/**
+ Sets how many requests of a class can be running at once.
+ 
+ @param maximumConcurrentRequests   The maximum amount of running requests. Must be at least 1.
+ @param priority                    The class the limit applies to.
+ */
+- (void)setMaximumConcurrentRequests:(NSUInteger)maximumConcurrentRequests forPriority:(LFMRequestPriority)priority NS_SWIFT_NAME(setMaximumConcurrentRequests(_:for:));
+
+/**
+ Returns how many requests of a class can be running at once.
+ 
+ @param priority    The class.
+ */
+- (NSUInteger)maximumConcurrentRequestsForPriority:(LFMRequestPriority)priority NS_SWIFT_NAME(maximumConcurrentRequests(for:));
+
+/**
+ Sets the class requests to a method are scheduled in.
+ 
+ @param priority    The class.
+ @param method      The name of the Last.fm API method, eg. "chart.getTopArtists". A trailing "*" - eg. "chart.*" - sets the class of every method in the package that doesn't have one set explicitly.
+ */
+- (void)setPriority:(LFMRequestPriority)priority forMethod:(NSString *)method NS_SWIFT_NAME(setPriority(_:for:));
+
+/**
+ Returns the class requests to a method are scheduled in, taking package wide ("chart.*") entries into account.
+ 
+ @param method  The name of the Last.fm API method, eg. "artist.getInfo".
+ */
+- (LFMRequestPriority)priorityForMethod:(NSString *)method NS_SWIFT_NAME(priority(for:));
+
+/**
+ Sets whether a request to a method cancels earlier requests to the same method that haven't completed yet.
+ 
+ @param cancelsSupersededRequests   Whether earlier requests should be cancelled.
+ @param method                      The name of the Last.fm API method, eg. "track.search".
+ */
+- (void)setCancelsSupersededRequests:(BOOL)cancelsSupersededRequests forMethod:(NSString *)method NS_SWIFT_NAME(setCancelsSupersededRequests(_:for:));
+
+/**
+ Cancels every queued and running request of a class, for example to stop a background sync when the app is about to be suspended.
+ 
+ @param priority    The class of requests to cancel.
+ */
+- (void)cancelRequestsWithPriority:(LFMRequestPriority)priority NS_SWIFT_NAME(cancelRequests(with:));
+
+/**
+ Schedules every request made on the current thread for the duration of `block` in the given class, regardless of the class set for its method. Retries of these requests keep the class.
+ 
+ @param priority    The class.
+ @param block       The block that calls one or more providers.
+ */
++ (void)performRequestsWithPriority:(LFMRequestPriority)priority usingBlock:(void (NS_NOESCAPE ^)(void))block NS_SWIFT_NAME(performRequests(with:_:));
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,307 @@
+//
+//  LFMRequestScheduler.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMRequestScheduler.h"
+#import "LFMKit+Protected.h"
+
+static NSString * const LFMRequestPriorityThreadKey = @"fm.last.kit.request-priority";
+
+static const NSInteger LFMRequestPriorityCount = LFMRequestPriorityBackground + 1;
+
+@interface LFMRequestScheduler()
+
+- (void)scheduleDataTask:(NSURLSessionDataTask *)dataTask withTicket:(LFMRequestTicket *)ticket handler:(dispatch_block_t)handler;
+
+- (void)dataTaskDidComplete:(NSURLSessionDataTask *)dataTask;
+
+@end
+
+@interface LFMRequestTicket() {
+    @package
+    LFMRequestScheduler *_scheduler;
+    NSString *_method;
+    LFMRequestPriority _priority;
+    NSUInteger _sequence;
+}
+
+@end
+
+@implementation LFMRequestTicket
+
+- (void)scheduleDataTask:(NSURLSessionDataTask *)dataTask handler:(dispatch_block_t)handler {
+    [_scheduler scheduleDataTask:dataTask withTicket:self handler:handler];
+}
+
+- (void)dataTaskDidComplete:(NSURLSessionDataTask *)dataTask {
+    [_scheduler dataTaskDidComplete:dataTask];
+}
+
+@end
+
+/**
+ A data task that is waiting for, or holding, a slot in its class.
+ */
+@interface LFMScheduledDataTask : NSObject {
+    @package
+    NSURLSessionDataTask *_dataTask;
+    LFMRequestTicket *_ticket;
+    dispatch_block_t _handler;
+}
+
+@end
+
+@implementation LFMScheduledDataTask
+
+@end
+
+@implementation LFMRequestScheduler {
+    NSUInteger _maximumConcurrentRequests[LFMRequestPriorityCount];
+    NSMutableArray<LFMScheduledDataTask *> *_queued[LFMRequestPriorityCount];
+    NSMutableArray<LFMScheduledDataTask *> *_running[LFMRequestPriorityCount];
+    NSMutableDictionary<NSString *, NSNumber *> *_priorityTable;
+    NSMutableDictionary<NSString *, NSNumber *> *_sequences;
+}
+
+- (instancetype)init {
+    self = [super init];
+    
+    if (self) {
+        _maximumConcurrentRequests[LFMRequestPriorityInteractive] = 4;
+        _maximumConcurrentRequests[LFMRequestPriorityNormal] = 4;
+        _maximumConcurrentRequests[LFMRequestPriorityBackground] = 2;
+        
+        for (NSInteger priority = 0; priority < LFMRequestPriorityCount; priority++) {
+            _queued[priority] = [NSMutableArray array];
+            _running[priority] = [NSMutableArray array];
+        }
+        
+        _priorityTable = [@{@"auth.*": @(LFMRequestPriorityInteractive),
+                            @"track.updateNowPlaying": @(LFMRequestPriorityInteractive),
+                            @"track.scrobble": @(LFMRequestPriorityInteractive),
+                            @"track.love": @(LFMRequestPriorityInteractive),
+                            @"track.unlove": @(LFMRequestPriorityInteractive),
+                            @"track.search": @(LFMRequestPriorityInteractive),
+                            @"artist.search": @(LFMRequestPriorityInteractive),
+                            @"album.search": @(LFMRequestPriorityInteractive)} mutableCopy];
+        
+        // Methods are only added here once superseding has been turned on for them.
+        _sequences = [NSMutableDictionary dictionary];
+    }
+    
+    return self;
+}
+
+- (void)setMaximumConcurrentRequests:(NSUInteger)maximumConcurrentRequests forPriority:(LFMRequestPriority)priority {
+    NSAssert(maximumConcurrentRequests > 0, @"At least one request of every class must be allowed to run.");
+    
+    NSArray<dispatch_block_t> *handlers = nil;
+    
+    @synchronized (self) {
+        _maximumConcurrentRequests[priority] = maximumConcurrentRequests;
+        handlers = [self dequeueRunnableTasks];
+    }
+    
+    for (dispatch_block_t handler in handlers) {
+        handler();
+    }
+}
+
+- (NSUInteger)maximumConcurrentRequestsForPriority:(LFMRequestPriority)priority {
+    @synchronized (self) {
+        return _maximumConcurrentRequests[priority];
+    }
+}
+
+- (void)setPriority:(LFMRequestPriority)priority forMethod:(NSString *)method {
+    @synchronized (self) {
+        _priorityTable[method] = @(priority);
+    }
+}
+
+- (LFMRequestPriority)priorityForMethod:(NSString *)method {
+    @synchronized (self) {
+        NSNumber *priority = _priorityTable[method];
+        
+        if (priority == nil) {
+            NSRange separator = [method rangeOfString:@"."];
+            if (separator.location != NSNotFound) {
+                priority = _priorityTable[[[method substringToIndex:separator.location] stringByAppendingString:@".*"]];
+            }
+        }
+        
+        return priority != nil ? [priority integerValue] : LFMRequestPriorityNormal;
+    }
+}
+
+- (void)setCancelsSupersededRequests:(BOOL)cancelsSupersededRequests forMethod:(NSString *)method {
+    @synchronized (self) {
+        if (!cancelsSupersededRequests) {
+            [_sequences removeObjectForKey:method];
+        } else if (_sequences[method] == nil) {
+            _sequences[method] = @0;
+        }
+    }
+}
+
+- (void)cancelRequestsWithPriority:(LFMRequestPriority)priority {
+    NSMutableArray<NSURLSessionDataTask *> *dataTasks = [NSMutableArray array];
+    
+    @synchronized (self) {
+        for (LFMScheduledDataTask *scheduledTask in [_queued[priority] arrayByAddingObjectsFromArray:_running[priority]]) {
+            [dataTasks addObject:scheduledTask->_dataTask];
+        }
+    }
+    
+    [dataTasks makeObjectsPerformSelector:@selector(cancel)];
+}
+
++ (void)performRequestsWithPriority:(LFMRequestPriority)priority usingBlock:(void (NS_NOESCAPE ^)(void))block {
+    NSMutableDictionary *threadDictionary = [NSThread currentThread].threadDictionary;
+    id previousPriority = threadDictionary[LFMRequestPriorityThreadKey];
+    
+    threadDictionary[LFMRequestPriorityThreadKey] = @(priority);
+    block();
+    threadDictionary[LFMRequestPriorityThreadKey] = previousPriority;
+}
+
+#pragma mark - Scheduling
+
+- (LFMRequestTicket *)ticketForRequestToMethod:(NSString *)method {
+    NSNumber *priorityOverride = [NSThread currentThread].threadDictionary[LFMRequestPriorityThreadKey];
+    NSMutableArray<NSURLSessionDataTask *> *supersededTasks = [NSMutableArray array];
+    
+    LFMRequestTicket *ticket = [[LFMRequestTicket alloc] init];
+    ticket->_scheduler = self;
+    ticket->_method = [method copy];
+    ticket->_priority = priorityOverride != nil ? [priorityOverride integerValue] : (method != nil ? [self priorityForMethod:method] : LFMRequestPriorityNormal);
+    
+    @synchronized (self) {
+        NSNumber *sequence = method != nil ? _sequences[method] : nil;
+        
+        if (sequence != nil) {
+            ticket->_sequence = [sequence unsignedIntegerValue] + 1;
+            _sequences[method] = @(ticket->_sequence);
+            
+            for (NSInteger priority = 0; priority < LFMRequestPriorityCount; priority++) {
+                for (LFMScheduledDataTask *scheduledTask in [_queued[priority] arrayByAddingObjectsFromArray:_running[priority]]) {
+                    if ([scheduledTask->_ticket->_method isEqualToString:method]) [supersededTasks addObject:scheduledTask->_dataTask];
+                }
+            }
+        }
+    }
+    
+    // Cancelling calls the tasks' completion handlers, which take them out of the queue.
+    [supersededTasks makeObjectsPerformSelector:@selector(cancel)];
+    
+    return ticket;
+}
+
+- (void)scheduleDataTask:(NSURLSessionDataTask *)dataTask withTicket:(LFMRequestTicket *)ticket handler:(dispatch_block_t)handler {
+    NSArray<dispatch_block_t> *handlers = nil;
+    BOOL superseded = NO;
+    
+    switch (ticket->_priority) {
+        case LFMRequestPriorityInteractive:
+            dataTask.priority = NSURLSessionTaskPriorityHigh;
+            break;
+        case LFMRequestPriorityBackground:
+            dataTask.priority = NSURLSessionTaskPriorityLow;
+            break;
+        default:
+            break;
+    }
+    
+    @synchronized (self) {
+        NSNumber *sequence = ticket->_method != nil ? _sequences[ticket->_method] : nil;
+        
+        // A retry of a request that has since been superseded.
+        superseded = sequence != nil && ticket->_sequence < [sequence unsignedIntegerValue];
+        
+        if (!superseded) {
+            LFMScheduledDataTask *scheduledTask = [[LFMScheduledDataTask alloc] init];
+            scheduledTask->_dataTask = dataTask;
+            scheduledTask->_ticket = ticket;
+            scheduledTask->_handler = [handler copy];
+            
+            [_queued[ticket->_priority] addObject:scheduledTask];
+            handlers = [self dequeueRunnableTasks];
+        }
+    }
+    
+    if (superseded) return [dataTask cancel];
+    
+    for (dispatch_block_t runnableHandler in handlers) {
+        runnableHandler();
+    }
+}
+
+- (void)dataTaskDidComplete:(NSURLSessionDataTask *)dataTask {
+    NSArray<dispatch_block_t> *handlers = nil;
+    
+    @synchronized (self) {
+        for (NSInteger priority = 0; priority < LFMRequestPriorityCount; priority++) {
+            for (NSMutableArray<LFMScheduledDataTask *> *scheduledTasks in @[_running[priority], _queued[priority]]) {
+                NSUInteger index = [scheduledTasks indexOfObjectPassingTest:^BOOL(LFMScheduledDataTask *scheduledTask, NSUInteger idx, BOOL *stop) {
+                    return scheduledTask->_dataTask == dataTask;
+                }];
+                
+                if (index != NSNotFound) [scheduledTasks removeObjectAtIndex:index];
+            }
+        }
+        
+        handlers = [self dequeueRunnableTasks];
+    }
+    
+    for (dispatch_block_t handler in handlers) {
+        handler();
+    }
+}
+
+/**
+ Moves queued tasks into free slots, highest class first, and returns their handlers so they can be called once the lock has been released. Must be called with the lock held.
+ */
+- (NSArray<dispatch_block_t> *)dequeueRunnableTasks {
+    NSMutableArray<dispatch_block_t> *handlers = [NSMutableArray array];
+    
+    for (NSInteger priority = 0; priority < LFMRequestPriorityCount; priority++) {
+        NSMutableArray<LFMScheduledDataTask *> *queued = _queued[priority];
+        NSMutableArray<LFMScheduledDataTask *> *running = _running[priority];
+        
+        while (queued.count > 0 && running.count < _maximumConcurrentRequests[priority]) {
+            LFMScheduledDataTask *scheduledTask = queued.firstObject;
+            [queued removeObjectAtIndex:0];
+            [running addObject:scheduledTask];
+            [handlers addObject:scheduledTask->_handler];
+            scheduledTask->_handler = nil;
+        }
+        
+        // Lower classes wait until this one has caught up.
+        if (queued.count > 0) break;
+    }
+    
+    return handlers;
+}
+
+@end
@@ -0,0 +1,103 @@
+//
+//  LFMResponseCache.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A two-tier cache for responses to read-only Last.fm API methods. Responses are kept decoded in an in-memory least-recently-used list and, optionally, as raw bodies in an on-disk store so they survive app launches.
+ 
+ When the cache is created, expired responses are removed from the on-disk store and it is trimmed to `diskCapacity`. Whenever a write takes it over `diskCapacity`, expired responses are removed, followed by the least recently written ones, until it is back down to three quarters of its capacity.
+ 
+ Responses are keyed on the method name and every parameter sent with it (excluding the api signature, which is derived from the rest), so two calls only share a response when they would have made exactly the same request. Only `GET` requests for methods with a positive time to live are cached; writes such as scrobbling are never cached.
+ 
+ @note  The shared client uses a cache with the default time to live table. Clients you create yourself have no cache until one is set on their `responseCache` property.
+ */
+NS_SWIFT_NAME(ResponseCache)
+@interface LFMResponseCache : NSObject
+
+/**
+ Initialises a new `LFMResponseCache` object with the default time to live table: hours for `chart.*`, `geo.*` and `tag.*` methods, an hour for artist, album and track information, minutes for most `user.*` and `library.*` methods and seconds for `user.getRecentTracks`. Methods which return per-user tags are kept for a minute.
+ 
+ @param memoryCapacity  The maximum amount of responses kept in memory. When this is exceeded the least recently used response is evicted.
+ @param diskCapacity    The maximum amount of bytes the on-disk store may take up.
+ @param path            The directory responses are persisted to. Pass `nil` for a memory only cache.
+ 
+ @return   An `LFMResponseCache` object.
+ */
+- (instancetype)initWithMemoryCapacity:(NSUInteger)memoryCapacity diskCapacity:(NSUInteger)diskCapacity diskPath:(nullable NSString *)path NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(memoryCapacity:diskCapacity:diskPath:));
+
+/**
+ Initialises a new `LFMResponseCache` object with the default time to live table and a disk capacity of 20MB.
+ 
+ @param memoryCapacity  The maximum amount of responses kept in memory. When this is exceeded the least recently used response is evicted.
+ @param path            The directory responses are persisted to. Pass `nil` for a memory only cache.
+ 
+ @return   An `LFMResponseCache` object.
+ */
+- (instancetype)initWithMemoryCapacity:(NSUInteger)memoryCapacity diskPath:(nullable NSString *)path NS_SWIFT_NAME(init(memoryCapacity:diskPath:));
+
+/** The maximum amount of responses kept in memory. */
+@property(nonatomic, readonly) NSUInteger memoryCapacity;
+
+/** The maximum amount of bytes the on-disk store may take up. */
+@property(nonatomic, readonly) NSUInteger diskCapacity;
+
+/** The directory responses are persisted to, if any. */
+@property(copy, nonatomic, readonly, nullable) NSString *diskPath;
+
+/** The amount of requests that were answered by the cache. */
+@property(readonly) NSUInteger hitCount;
+
+/** The amount of cacheable requests that had to go to the network. */
+@property(readonly) NSUInteger missCount;
+
+/**
+ Sets how long responses to a method are kept for.
+ 
+ @param timeToLive  The amount of seconds a response is valid for. Pass 0 to stop caching the method.
+ @param method      The name of the Last.fm API method, eg. "artist.getInfo". A trailing "*" - eg. "chart.*" - sets the time to live for every method in the package that doesn't have one set explicitly.
+ */
+- (void)setTimeToLive:(NSTimeInterval)timeToLive forMethod:(NSString *)method NS_SWIFT_NAME(setTimeToLive(_:for:));
+
+/**
+ Returns how long responses to a method are kept for, taking package wide ("chart.*") entries into account.
+ 
+ @param method  The name of the Last.fm API method, eg. "artist.getInfo".
+ */
+- (NSTimeInterval)timeToLiveForMethod:(NSString *)method NS_SWIFT_NAME(timeToLive(for:));
+
+/**
+ Removes every response from memory and disk.
+ */
+- (void)removeAllResponses;
+
+- (instancetype) __unavailable init;
++ (instancetype) __unavailable new;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,392 @@
+//
+//  LFMResponseCache.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMResponseCache.h"
+#import <CommonCrypto/CommonDigest.h>
+#import "LFMKit+Protected.h"
+#import "LFMError.h"
+
+/** The default `diskCapacity`. */
+static const NSUInteger LFMResponseCacheDefaultDiskCapacity = 20 * 1024 * 1024;
+
+/** The fraction of `diskCapacity` the on-disk store is trimmed down to once a write takes it over, so that a full store isn't trimmed again on the very next write. */
+static const double LFMResponseCacheDiskTrimRatio = 0.75;
+
+/**
+ Reads the expiry time a response file starts with. Files too short to hold one are reported as expired.
+ */
+static CFAbsoluteTime LFMResponseCacheFileExpiryTime(NSString *path) {
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForReadingAtPath:path];
+    NSData *header = [fileHandle readDataOfLength:sizeof(CFAbsoluteTime)];
+    [fileHandle closeFile];
+    
+    CFAbsoluteTime expiryTime = 0;
+    if (header.length == sizeof(expiryTime)) [header getBytes:&expiryTime length:sizeof(expiryTime)];
+    
+    return expiryTime;
+}
+
+/**
+ A node in the cache's least-recently-used list. The list owns its nodes through `_next`, so `_previous` doesn't need to be retained.
+ */
+@interface LFMResponseCacheEntry : NSObject {
+    @package
+    NSString *_key;
+    NSDictionary *_responseDictionary;
+    CFAbsoluteTime _expiryTime;
+    LFMResponseCacheEntry *_next;
+    LFMResponseCacheEntry * __unsafe_unretained _previous;
+}
+
+@end
+
+@implementation LFMResponseCacheEntry
+
+@end
+
+@implementation LFMResponseCache {
+    NSUInteger _memoryCapacity;
+    NSUInteger _diskCapacity;
+    NSString *_diskPath;
+    NSMutableDictionary<NSString *, NSNumber *> *_timeToLiveTable;
+    NSMutableDictionary<NSString *, LFMResponseCacheEntry *> *_entries;
+    LFMResponseCacheEntry *_mostRecentlyUsed;
+    LFMResponseCacheEntry * __unsafe_unretained _leastRecentlyUsed;
+    NSUInteger _hitCount;
+    NSUInteger _missCount;
+    dispatch_queue_t _diskQueue;
+    unsigned long long _diskUsage; // Only touched on `_diskQueue`.
+}
+
+- (instancetype)initWithMemoryCapacity:(NSUInteger)memoryCapacity diskPath:(NSString *)path {
+    return [self initWithMemoryCapacity:memoryCapacity diskCapacity:LFMResponseCacheDefaultDiskCapacity diskPath:path];
+}
+
+- (instancetype)initWithMemoryCapacity:(NSUInteger)memoryCapacity diskCapacity:(NSUInteger)diskCapacity diskPath:(NSString *)path {
+    self = [super init];
+    
+    if (self) {
+        _memoryCapacity = memoryCapacity;
+        _diskCapacity = diskCapacity;
+        _diskPath = [path copy];
+        _entries = [NSMutableDictionary dictionary];
+        _diskQueue = dispatch_queue_create("fm.last.kit.cache.disk", DISPATCH_QUEUE_SERIAL);
+        _timeToLiveTable = [@{@"chart.*": @(3 * 60 * 60),
+                              @"geo.*": @(3 * 60 * 60),
+                              @"tag.*": @(6 * 60 * 60),
+                              @"artist.*": @(60 * 60),
+                              @"artist.getTags": @(60),
+                              @"album.*": @(60 * 60),
+                              @"album.getTags": @(60),
+                              @"track.*": @(60 * 60),
+                              @"track.getTags": @(60),
+                              @"user.*": @(5 * 60),
+                              @"user.getRecentTracks": @(10),
+                              @"user.getPersonalTags": @(60),
+                              @"library.*": @(5 * 60)} mutableCopy];
+        
+        if (_diskPath != nil) {
+            [[NSFileManager defaultManager] createDirectoryAtPath:_diskPath withIntermediateDirectories:YES attributes:nil error:nil];
+            
+            // Responses that expired while the app wasn't running are never looked up again, so they'd otherwise stay on disk.
+            dispatch_async(_diskQueue, ^{
+                [self sweepDiskTrimmingToSize:self->_diskCapacity];
+            });
+        }
+    }
+    
+    return self;
+}
+
+- (NSUInteger)memoryCapacity {
+    return _memoryCapacity;
+}
+
+- (NSUInteger)diskCapacity {
+    return _diskCapacity;
+}
+
+- (NSString *)diskPath {
+    return _diskPath;
+}
+
+- (NSUInteger)hitCount {
+    @synchronized (self) {
+        return _hitCount;
+    }
+}
+
+- (NSUInteger)missCount {
+    @synchronized (self) {
+        return _missCount;
+    }
+}
+
+- (void)setTimeToLive:(NSTimeInterval)timeToLive forMethod:(NSString *)method {
+    @synchronized (self) {
+        _timeToLiveTable[method] = @(timeToLive);
+    }
+}
+
+- (NSTimeInterval)timeToLiveForMethod:(NSString *)method {
+    @synchronized (self) {
+        NSNumber *timeToLive = _timeToLiveTable[method];
+        
+        if (timeToLive == nil) {
+            NSRange separator = [method rangeOfString:@"."];
+            if (separator.location != NSNotFound) {
+                timeToLive = _timeToLiveTable[[[method substringToIndex:separator.location] stringByAppendingString:@".*"]];
+            }
+        }
+        
+        return [timeToLive doubleValue];
+    }
+}
+
+- (void)removeAllResponses {
+    @synchronized (self) {
+        [_entries removeAllObjects];
+        _mostRecentlyUsed = nil;
+        _leastRecentlyUsed = nil;
+    }
+    
+    if (_diskPath == nil) return;
+    
+    NSString *path = _diskPath;
+    dispatch_async(_diskQueue, ^{
+        NSFileManager *fileManager = [NSFileManager defaultManager];
+        for (NSString *file in [fileManager contentsOfDirectoryAtPath:path error:nil]) {
+            [fileManager removeItemAtPath:[path stringByAppendingPathComponent:file] error:nil];
+        }
+        self->_diskUsage = 0;
+    });
+}
+
+#pragma mark - Lookup
+
+- (void)lookupResponseForKey:(NSString *)key callback:(void (^)(NSDictionary * _Nullable))block {
+    NSDictionary *responseDictionary = [self memoryResponseForKey:key];
+    
+    if (responseDictionary != nil || _diskPath == nil) {
+        [self recordHit:responseDictionary != nil];
+        return block(responseDictionary);
+    }
+    
+    NSString *path = [self diskPathForKey:key];
+    
+    dispatch_async(_diskQueue, ^{
+        NSDictionary *responseDictionary = nil;
+        NSData *file = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:nil];
+        CFAbsoluteTime expiryTime = 0;
+        
+        if (file.length > sizeof(expiryTime)) {
+            [file getBytes:&expiryTime length:sizeof(expiryTime)];
+            
+            if (expiryTime > CFAbsoluteTimeGetCurrent()) {
+                NSData *data = [file subdataWithRange:NSMakeRange(sizeof(expiryTime), file.length - sizeof(expiryTime))];
+                NSError *error = nil;
+                lfm_error_validate(data, &responseDictionary, &error);
+            } else if ([[NSFileManager defaultManager] removeItemAtPath:path error:nil]) {
+                self->_diskUsage -= MIN(self->_diskUsage, file.length);
+            }
+        }
+        
+        if (responseDictionary != nil) {
+            [self storeEntryWithKey:key responseDictionary:responseDictionary expiryTime:expiryTime];
+        }
+        
+        [self recordHit:responseDictionary != nil];
+        block(responseDictionary);
+    });
+}
+
+- (void)storeResponse:(NSDictionary *)responseDictionary data:(NSData *)data forKey:(NSString *)key method:(NSString *)method {
+    NSTimeInterval timeToLive = [self timeToLiveForMethod:method];
+    if (timeToLive <= 0) return;
+    
+    CFAbsoluteTime expiryTime = CFAbsoluteTimeGetCurrent() + timeToLive;
+    
+    [self storeEntryWithKey:key responseDictionary:responseDictionary expiryTime:expiryTime];
+    
+    if (_diskPath == nil) return;
+    
+    NSString *path = [self diskPathForKey:key];
+    
+    dispatch_async(_diskQueue, ^{
+        NSMutableData *file = [NSMutableData dataWithCapacity:sizeof(expiryTime) + data.length];
+        [file appendBytes:&expiryTime length:sizeof(expiryTime)];
+        [file appendData:data];
+        
+        unsigned long long replacedSize = [[[NSFileManager defaultManager] attributesOfItemAtPath:path error:nil] fileSize];
+        
+        if ([file writeToFile:path atomically:YES]) {
+            self->_diskUsage = self->_diskUsage - MIN(self->_diskUsage, replacedSize) + file.length;
+        }
+        
+        if (self->_diskUsage > self->_diskCapacity) {
+            [self sweepDiskTrimmingToSize:(unsigned long long)(self->_diskCapacity * LFMResponseCacheDiskTrimRatio)];
+        }
+    });
+}
+
+- (void)recordHit:(BOOL)hit {
+    @synchronized (self) {
+        hit ? _hitCount++ : _missCount++;
+    }
+}
+
+#pragma mark - Memory
+
+- (NSDictionary *)memoryResponseForKey:(NSString *)key {
+    @synchronized (self) {
+        LFMResponseCacheEntry *entry = _entries[key];
+        
+        if (entry == nil) return nil;
+        
+        if (entry->_expiryTime <= CFAbsoluteTimeGetCurrent()) {
+            [self removeEntry:entry];
+            return nil;
+        }
+        
+        [self removeEntry:entry];
+        [self insertEntry:entry];
+        
+        return entry->_responseDictionary;
+    }
+}
+
+- (void)storeEntryWithKey:(NSString *)key responseDictionary:(NSDictionary *)responseDictionary expiryTime:(CFAbsoluteTime)expiryTime {
+    if (_memoryCapacity == 0) return;
+    
+    LFMResponseCacheEntry *entry = [[LFMResponseCacheEntry alloc] init];
+    entry->_key = key;
+    entry->_responseDictionary = responseDictionary;
+    entry->_expiryTime = expiryTime;
+    
+    @synchronized (self) {
+        LFMResponseCacheEntry *existingEntry = _entries[key];
+        if (existingEntry != nil) [self removeEntry:existingEntry];
+        
+        [self insertEntry:entry];
+        
+        while (_entries.count > _memoryCapacity) {
+            [self removeEntry:_leastRecentlyUsed];
+        }
+    }
+}
+
+- (void)insertEntry:(LFMResponseCacheEntry *)entry {
+    entry->_next = _mostRecentlyUsed;
+    entry->_previous = nil;
+    
+    if (_mostRecentlyUsed != nil) _mostRecentlyUsed->_previous = entry;
+    _mostRecentlyUsed = entry;
+    if (_leastRecentlyUsed == nil) _leastRecentlyUsed = entry;
+    
+    _entries[entry->_key] = entry;
+}
+
+- (void)removeEntry:(LFMResponseCacheEntry *)entry {
+    LFMResponseCacheEntry *retainedEntry = entry; // Unlinking may release the last strong reference to the entry.
+    
+    if (retainedEntry->_previous != nil) {
+        retainedEntry->_previous->_next = retainedEntry->_next;
+    } else {
+        _mostRecentlyUsed = retainedEntry->_next;
+    }
+    
+    if (retainedEntry->_next != nil) {
+        retainedEntry->_next->_previous = retainedEntry->_previous;
+    } else {
+        _leastRecentlyUsed = retainedEntry->_previous;
+    }
+    
+    retainedEntry->_next = nil;
+    retainedEntry->_previous = nil;
+    
+    [_entries removeObjectForKey:retainedEntry->_key];
+}
+
+#pragma mark - Disk
+
+/**
+ Removes every expired response from disk and, if the rest take up more than `size` bytes, the least recently written of them until they don't. Recounts `_diskUsage` as it goes. Must be called on `_diskQueue`.
+ */
+- (void)sweepDiskTrimmingToSize:(unsigned long long)size {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSArray<NSString *> *keys = @[NSURLFileSizeKey, NSURLContentModificationDateKey];
+    NSArray<NSURL *> *files = [fileManager contentsOfDirectoryAtURL:[NSURL fileURLWithPath:_diskPath] includingPropertiesForKeys:keys options:NSDirectoryEnumerationSkipsHiddenFiles error:nil];
+    NSMutableArray<NSURL *> *unexpiredFiles = [NSMutableArray arrayWithCapacity:files.count];
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    unsigned long long usage = 0;
+    
+    for (NSURL *file in files) {
+        if (LFMResponseCacheFileExpiryTime(file.path) <= now) {
+            [fileManager removeItemAtURL:file error:nil];
+            continue;
+        }
+        
+        NSNumber *fileSize = nil;
+        [file getResourceValue:&fileSize forKey:NSURLFileSizeKey error:nil];
+        
+        usage += fileSize.unsignedLongLongValue;
+        [unexpiredFiles addObject:file];
+    }
+    
+    if (usage > size) {
+        [unexpiredFiles sortUsingComparator:^NSComparisonResult(NSURL *file1, NSURL *file2) {
+            NSDate *date1 = nil, *date2 = nil;
+            [file1 getResourceValue:&date1 forKey:NSURLContentModificationDateKey error:nil];
+            [file2 getResourceValue:&date2 forKey:NSURLContentModificationDateKey error:nil];
+            return [date1 compare:date2];
+        }];
+        
+        for (NSURL *file in unexpiredFiles) {
+            if (usage <= size) break;
+            
+            NSNumber *fileSize = nil;
+            [file getResourceValue:&fileSize forKey:NSURLFileSizeKey error:nil];
+            
+            if ([fileManager removeItemAtURL:file error:nil]) usage -= MIN(usage, fileSize.unsignedLongLongValue);
+        }
+    }
+    
+    _diskUsage = usage;
+}
+
+- (NSString *)diskPathForKey:(NSString *)key {
+    const char *string = [key UTF8String];
+    unsigned char digest[CC_MD5_DIGEST_LENGTH];
+    CC_MD5(string, (CC_LONG)strlen(string), digest);
+    
+    char hex[CC_MD5_DIGEST_LENGTH * 2 + 1];
+    for (NSUInteger i = 0; i < CC_MD5_DIGEST_LENGTH; i++) {
+        snprintf(hex + i * 2, 3, "%02x", digest[i]);
+    }
+    
+    return [_diskPath stringByAppendingPathComponent:[NSString stringWithUTF8String:hex]];
+}
+
+@end
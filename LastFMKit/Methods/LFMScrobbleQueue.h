@@ -0,0 +1,104 @@
+//
+//  LFMScrobbleQueue.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+@class LFMScrobbleTrack, LFMScrobbleResult;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A durable queue of scrobbles waiting to be sent to Last.fm. Use it so that plays made without connectivity aren't lost: enqueue every scrobble and drain the queue whenever the network is likely to be available, eg. on launch and when reachability changes.
+ 
+ Scrobbles are appended to a journal file. Appends are buffered and flushed to disk in groups a few milliseconds apart, so enqueueing is cheap enough to be done for tens of thousands of tracks a second; call `synchronizeWithError:` when a scrobble must be on disk before continuing. Each record carries a checksum, so a record torn by a crash is detected and discarded the next time the journal is opened.
+ 
+ Draining sends the oldest scrobbles in batches of 50, one batch at a time. Each batch is journaled as sent - and forced to disk - before it goes out, and as acknowledged before the next is sent. Acknowledged records are compacted out of the journal once enough of them have built up.
+ 
+ If the process dies, or the request fails without Last.fm answering, after a batch has been sent but before it was acknowledged, there is no telling whether Last.fm recorded it. The next drain reconciles that batch before anything else: it looks the batch's timestamps up in the user's recent tracks and only sends the scrobbles that aren't there. Scrobbles that were already recorded are acknowledged without being sent again, and have no result in the drain's callback.
+ 
+ @note  Only one `LFMScrobbleQueue` may use a journal at a time.
+ */
+NS_SWIFT_NAME(ScrobbleQueue)
+@interface LFMScrobbleQueue : NSObject
+
+/**
+ Opens - or creates - a journal and replays it to find the scrobbles that haven't been acknowledged yet.
+ 
+ @param path    The location of the journal file. Its directory must exist.
+ @param error   On return, the reason the journal couldn't be opened.
+ 
+ @return   An `LFMScrobbleQueue` object, or `nil` if the journal couldn't be opened.
+ */
+- (nullable instancetype)initWithJournalPath:(NSString *)path error:(NSError * _Nullable * _Nullable)error NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(journalPath:));
+
+/** The location of the journal file. */
+@property(copy, nonatomic, readonly) NSString *journalPath;
+
+/** The amount of scrobbles that haven't been acknowledged by Last.fm yet. */
+@property(readonly) NSUInteger count;
+
+/** Will be `YES` while scrobbles are being sent. */
+@property(readonly, getter=isDraining) BOOL draining;
+
+/**
+ Appends a scrobble to the journal.
+ 
+ @param track   The track to be scrobbled.
+ */
+- (void)enqueueTrack:(LFMScrobbleTrack *)track NS_SWIFT_NAME(enqueue(_:));
+
+/**
+ Appends scrobbles to the journal.
+ 
+ @param tracks  The tracks to be scrobbled, in the order they were played.
+ */
+- (void)enqueueTracks:(NSArray<LFMScrobbleTrack *> *)tracks NS_SWIFT_NAME(enqueue(_:));
+
+/**
+ Blocks until every scrobble enqueued so far has been written and flushed to disk.
+ 
+ If the journal can't be written - eg. because the disk is full - the scrobbles stay queued in memory and writing them is retried every second. They are only lost if the process exits before a retry succeeds.
+ 
+ @param error   On return, the reason the scrobbles couldn't be written.
+ 
+ @return   `YES` if every scrobble enqueued so far is on disk.
+ */
+- (BOOL)synchronizeWithError:(NSError * _Nullable * _Nullable)error NS_SWIFT_NAME(synchronize());
+
+/**
+ Sends every queued scrobble to Last.fm in batches of 50. Draining stops at the first batch that fails, leaving it and every scrobble after it in the queue. Scrobbles that are enqueued while the queue is draining are sent as part of the same drain.
+ 
+ @note  🔒: Authentication Required.
+ 
+ @param block   The callback block, called once the queue is empty or a batch has failed. It contains an optional `NSError` if a batch failed, and whether each scrobble that was sent was accepted or ignored. Ignored scrobbles are removed from the queue too; Last.fm won't accept them if they're sent again. If the queue is already draining, the block is called when that drain finishes.
+ */
+- (void)drainWithCallback:(void (^_Nullable)(NSError * _Nullable error, NSArray<LFMScrobbleResult *> *results))block NS_SWIFT_NAME(drain(callback:));
+
+- (instancetype) __unavailable init;
++ (instancetype) __unavailable new;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,743 @@
+//
+//  LFMScrobbleQueue.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMScrobbleQueue.h"
+#import <fcntl.h>
+#import <unistd.h>
+#import "LFMKit+Protected.h"
+#import "LFMTrackProvider.h"
+#import "LFMScrobbleTrack.h"
+
+/*
+ Journal layout. Integers are stored in host byte order.
+ 
+ header:    "LFMQ" u32 version
+ record:    u32 payload length, u32 checksum of type and payload, u8 type, payload
+ 
+ LFMJournalRecordTypeEnqueue payload:   u64 sequence, i64 unix timestamp, u32 duration, u32 position in album, u8 chosen by user,
+                                        then the track name, mbid and URL, artist name, mbid and URL, album name, artist, mbid and URL
+                                        as u32 length prefixed UTF-8 strings
+ LFMJournalRecordTypeAcknowledge payload: u64 sequence every scrobble up to and including has been acknowledged through
+ LFMJournalRecordTypeSend payload:      u64 sequence of the last scrobble in the batch about to be sent, or 0 once Last.fm has rejected it
+ */
+static const char LFMJournalMagic[4] = {'L', 'F', 'M', 'Q'};
+static const uint32_t LFMJournalVersion = 1;
+static const size_t LFMJournalHeaderLength = sizeof(LFMJournalMagic) + sizeof(uint32_t);
+static const size_t LFMJournalRecordHeaderLength = sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint8_t);
+
+typedef NS_ENUM(uint8_t, LFMJournalRecordType) {
+    LFMJournalRecordTypeEnqueue = 1,
+    LFMJournalRecordTypeAcknowledge = 2,
+    LFMJournalRecordTypeSend = 3
+};
+
+/** How long appends are buffered for before being flushed, so that bursts of enqueues share one `fsync`. */
+static const int64_t LFMJournalSyncDelay = 10 * NSEC_PER_MSEC;
+
+/** How long a flush that failed - eg. because the disk is full - waits before trying again. */
+static const int64_t LFMJournalRetryDelay = NSEC_PER_SEC;
+
+/** Acknowledged records are compacted out of the journal once there are at least this many and they outnumber the pending ones. */
+static const NSUInteger LFMJournalCompactionThreshold = 4096;
+
+static const NSUInteger LFMScrobbleQueueBatchSize = 50;
+
+/** The most plays `user.getRecentTracks` returns per page; a batch that is reconciled rarely spans more than one. */
+static const NSUInteger LFMScrobbleQueueReconciliationPageSize = 200;
+
+/** A scrobble that hasn't been acknowledged, located by the offset of its record in the journal. */
+typedef struct {
+    uint64_t sequence;
+    uint64_t offset;
+    uint32_t length;
+} LFMScrobbleQueueEntry;
+
+static uint32_t LFMJournalChecksum(uint8_t type, const uint8_t *bytes, size_t length) {
+    // FNV-1a: cheap, and only needs to catch torn or partially written records.
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ type) * 16777619u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void LFMJournalAppendRecord(NSMutableData *buffer, LFMJournalRecordType type, const void *payload, uint32_t length) {
+    uint32_t checksum = LFMJournalChecksum(type, payload, length);
+    [buffer appendBytes:&length length:sizeof(length)];
+    [buffer appendBytes:&checksum length:sizeof(checksum)];
+    [buffer appendBytes:&type length:sizeof(type)];
+    [buffer appendBytes:payload length:length];
+}
+
+static void LFMJournalAppendString(NSMutableData *payload, NSString *string) {
+    const char *bytes = string.UTF8String ?: "";
+    uint32_t length = (uint32_t)strlen(bytes);
+    [payload appendBytes:&length length:sizeof(length)];
+    [payload appendBytes:bytes length:length];
+}
+
+static NSString *LFMJournalReadString(const uint8_t **cursor, const uint8_t *end) {
+    uint32_t length = 0;
+    if (end - *cursor < (ptrdiff_t)sizeof(length)) return nil;
+    memcpy(&length, *cursor, sizeof(length));
+    *cursor += sizeof(length);
+    if (end - *cursor < (ptrdiff_t)length) return nil;
+    NSString *string = [[NSString alloc] initWithBytes:*cursor length:length encoding:NSUTF8StringEncoding];
+    *cursor += length;
+    return string;
+}
+
+static BOOL LFMJournalWrite(int fd, const void *bytes, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, bytes, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return NO;
+        }
+        bytes = (const uint8_t *)bytes + written;
+        length -= written;
+    }
+    return YES;
+}
+
+static BOOL LFMJournalFullSync(int fd) {
+#ifdef F_FULLFSYNC
+    if (fcntl(fd, F_FULLFSYNC) == 0) return YES;
+#endif
+    return fsync(fd) == 0;
+}
+
+/** Forces a rename in `path`'s directory to disk; until it is, a crash can bring back the file that was replaced. */
+static BOOL LFMJournalSyncDirectory(NSString *path) {
+    int fd = open(path.stringByDeletingLastPathComponent.fileSystemRepresentation, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NO;
+    
+    BOOL synced = LFMJournalFullSync(fd);
+    close(fd);
+    return synced;
+}
+
+static NSError *LFMJournalError(NSString *path) {
+    return [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSFilePathErrorKey: path}];
+}
+
+@implementation LFMScrobbleQueue {
+    NSString *_journalPath;
+    int _fd;
+    uint64_t _fileLength;
+    NSMutableData *_buffer;
+    uint64_t _nextSequence;
+    LFMScrobbleQueueEntry *_entries;
+    NSUInteger _head;
+    NSUInteger _entryCount;
+    NSUInteger _entryCapacity;
+    NSUInteger _acknowledgedRecordCount;
+    uint64_t _sentSequence; // The last scrobble of a batch that was sent but never acknowledged, or 0.
+    BOOL _syncScheduled;
+    BOOL _draining;
+    NSMutableArray *_drainCallbacks;
+    NSMutableArray<LFMScrobbleResult *> *_drainResults;
+    dispatch_queue_t _ioQueue;
+}
+
+- (instancetype)initWithJournalPath:(NSString *)path error:(NSError * _Nullable __autoreleasing *)error {
+    self = [super init];
+    
+    if (self) {
+        _journalPath = [path copy];
+        _buffer = [NSMutableData data];
+        _drainCallbacks = [NSMutableArray array];
+        _ioQueue = dispatch_queue_create("fm.last.kit.scrobble-queue.io", DISPATCH_QUEUE_SERIAL);
+        _nextSequence = 1;
+        _fd = open(_journalPath.fileSystemRepresentation, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        
+        if (_fd < 0 || ![self replay]) {
+            if (error != NULL) *error = LFMJournalError(_journalPath);
+            return nil;
+        }
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    if (_fd >= 0) {
+        // A last attempt, without the retry `flush:` would schedule; if it fails, whatever is still buffered is lost.
+        if (_buffer.length > 0 && LFMJournalWrite(_fd, _buffer.bytes, _buffer.length)) LFMJournalFullSync(_fd);
+        close(_fd);
+    }
+    free(_entries);
+}
+
+- (NSString *)journalPath {
+    return _journalPath;
+}
+
+- (NSUInteger)count {
+    @synchronized (self) {
+        return _entryCount - _head;
+    }
+}
+
+- (BOOL)isDraining {
+    @synchronized (self) {
+        return _draining;
+    }
+}
+
+#pragma mark - Replay
+
+- (BOOL)replay {
+    NSData *journal = [NSData dataWithContentsOfFile:_journalPath options:NSDataReadingMappedIfSafe error:nil];
+    
+    if (journal.length < LFMJournalHeaderLength) {
+        // A new journal, or one that died before its header was written.
+        if (ftruncate(_fd, 0) != 0) return NO;
+        
+        NSMutableData *header = [NSMutableData dataWithBytes:LFMJournalMagic length:sizeof(LFMJournalMagic)];
+        [header appendBytes:&LFMJournalVersion length:sizeof(LFMJournalVersion)];
+        
+        if (!LFMJournalWrite(_fd, header.bytes, header.length) || !LFMJournalFullSync(_fd)) return NO;
+        
+        _fileLength = header.length;
+        return YES;
+    }
+    
+    const uint8_t *bytes = journal.bytes;
+    uint32_t version = 0;
+    memcpy(&version, bytes + sizeof(LFMJournalMagic), sizeof(version));
+    
+    if (memcmp(bytes, LFMJournalMagic, sizeof(LFMJournalMagic)) != 0 || version != LFMJournalVersion) {
+        errno = EFTYPE;
+        return NO;
+    }
+    
+    uint64_t offset = LFMJournalHeaderLength;
+    uint64_t acknowledgedSequence = 0;
+    uint64_t sentSequence = 0;
+    
+    while (journal.length - offset >= LFMJournalRecordHeaderLength) {
+        uint32_t length, checksum;
+        uint8_t type;
+        memcpy(&length, bytes + offset, sizeof(length));
+        memcpy(&checksum, bytes + offset + sizeof(length), sizeof(checksum));
+        memcpy(&type, bytes + offset + sizeof(length) + sizeof(checksum), sizeof(type));
+        
+        const uint8_t *payload = bytes + offset + LFMJournalRecordHeaderLength;
+        
+        // A torn or corrupt record can only be the last one written before a crash; everything after it is discarded.
+        if (journal.length - offset - LFMJournalRecordHeaderLength < length) break;
+        if (length < sizeof(uint64_t) || LFMJournalChecksum(type, payload, length) != checksum) break;
+        
+        uint64_t sequence;
+        memcpy(&sequence, payload, sizeof(sequence));
+        
+        if (type == LFMJournalRecordTypeEnqueue) {
+            [self appendEntry:(LFMScrobbleQueueEntry){sequence, offset, length}];
+            _nextSequence = MAX(_nextSequence, sequence + 1);
+        } else if (type == LFMJournalRecordTypeAcknowledge) {
+            acknowledgedSequence = MAX(acknowledgedSequence, sequence);
+        } else if (type == LFMJournalRecordTypeSend) {
+            sentSequence = sequence;
+        }
+        
+        offset += LFMJournalRecordHeaderLength + length;
+    }
+    
+    // Scrobbles are always acknowledged oldest first, so everything up to the latest acknowledgement has been sent.
+    while (_head < _entryCount && _entries[_head].sequence <= acknowledgedSequence) {
+        _head++;
+    }
+    _acknowledgedRecordCount = _head;
+    
+    // A batch that was sent but never acknowledged may or may not have reached Last.fm; it is reconciled before it is sent again.
+    _sentSequence = sentSequence > acknowledgedSequence ? sentSequence : 0;
+    
+    if (offset < journal.length && ftruncate(_fd, offset) != 0) return NO;
+    
+    _fileLength = offset;
+    return YES;
+}
+
+- (void)appendEntry:(LFMScrobbleQueueEntry)entry {
+    if (_entryCount == _entryCapacity) {
+        _entryCapacity = MAX(_entryCapacity * 2, 1024);
+        _entries = reallocf(_entries, _entryCapacity * sizeof(LFMScrobbleQueueEntry));
+        NSAssert(_entries != NULL, @"Failed to grow the scrobble queue.");
+    }
+    _entries[_entryCount++] = entry;
+}
+
+#pragma mark - Enqueueing
+
+- (void)enqueueTrack:(LFMScrobbleTrack *)track {
+    [self enqueueTracks:@[track]];
+}
+
+- (void)enqueueTracks:(NSArray<LFMScrobbleTrack *> *)tracks {
+    NSMutableData *payload = [NSMutableData data];
+    
+    @synchronized (self) {
+        for (LFMScrobbleTrack *track in tracks) {
+            uint64_t sequence = _nextSequence++;
+            int64_t timestamp = (int64_t)track.timestamp.timeIntervalSince1970;
+            uint32_t duration = (uint32_t)track.duration;
+            uint32_t position = (uint32_t)track.positionInAlbum;
+            uint8_t chosenByUser = track.wasChosenByUser;
+            
+            payload.length = 0;
+            [payload appendBytes:&sequence length:sizeof(sequence)];
+            [payload appendBytes:&timestamp length:sizeof(timestamp)];
+            [payload appendBytes:&duration length:sizeof(duration)];
+            [payload appendBytes:&position length:sizeof(position)];
+            [payload appendBytes:&chosenByUser length:sizeof(chosenByUser)];
+            LFMJournalAppendString(payload, track.name);
+            LFMJournalAppendString(payload, track.mbid);
+            LFMJournalAppendString(payload, track.URL.absoluteString);
+            LFMJournalAppendString(payload, track.artist.name);
+            LFMJournalAppendString(payload, track.artist.mbid);
+            LFMJournalAppendString(payload, track.artist.URL.absoluteString);
+            LFMJournalAppendString(payload, track.album.name);
+            LFMJournalAppendString(payload, track.album.artist);
+            LFMJournalAppendString(payload, track.album.mbid);
+            LFMJournalAppendString(payload, track.album.URL.absoluteString);
+            
+            [self appendEntry:(LFMScrobbleQueueEntry){sequence, _fileLength + _buffer.length, (uint32_t)payload.length}];
+            LFMJournalAppendRecord(_buffer, LFMJournalRecordTypeEnqueue, payload.bytes, (uint32_t)payload.length);
+        }
+        
+        if (_syncScheduled) return;
+        _syncScheduled = YES;
+    }
+    
+    [self scheduleFlushAfter:LFMJournalSyncDelay];
+}
+
+- (BOOL)synchronizeWithError:(NSError * _Nullable __autoreleasing *)error {
+    __block BOOL synchronized = NO;
+    __block NSError *flushError = nil;
+    
+    dispatch_sync(_ioQueue, ^{
+        synchronized = [self flush:&flushError];
+    });
+    
+    if (!synchronized && error != NULL) *error = flushError;
+    return synchronized;
+}
+
+- (void)scheduleFlushAfter:(int64_t)delay {
+    __weak LFMScrobbleQueue *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, delay), _ioQueue, ^{
+        [weakSelf flush:nil];
+    });
+}
+
+/**
+ Writes every buffered record to the journal and forces it to disk. Only ever called on the io queue, or once nothing else can reach the queue.
+ 
+ If the records can't be written, whatever part of them reached the journal is cut off again and they go back in front of the buffer, so that the offsets entries were given still hold, and another flush is scheduled.
+ */
+- (BOOL)flush:(NSError **)error {
+    NSMutableData *buffer = nil;
+    uint64_t fileLength = 0;
+    
+    @synchronized (self) {
+        _syncScheduled = NO;
+        if (_buffer.length == 0) return YES;
+        
+        buffer = _buffer;
+        fileLength = _fileLength;
+        _buffer = [NSMutableData data];
+        _fileLength += buffer.length;
+    }
+    
+    if (LFMJournalWrite(_fd, buffer.bytes, buffer.length) && LFMJournalFullSync(_fd)) return YES;
+    
+    if (error != NULL) *error = LFMJournalError(_journalPath);
+    ftruncate(_fd, fileLength);
+    
+    @synchronized (self) {
+        [buffer appendData:_buffer];
+        _buffer = buffer;
+        _fileLength = fileLength;
+        
+        if (!_syncScheduled) {
+            _syncScheduled = YES;
+            [self scheduleFlushAfter:LFMJournalRetryDelay];
+        }
+    }
+    
+    return NO;
+}
+
+/**
+ Writes buffered records to the journal without waiting for them to reach the disk. Must be called on the io queue with the lock held. If the write fails the records stay buffered, and whatever part of them was written is cut off again.
+ */
+- (BOOL)writeBuffer {
+    if (_buffer.length == 0) return YES;
+    
+    if (!LFMJournalWrite(_fd, _buffer.bytes, _buffer.length)) {
+        int writeError = errno;
+        ftruncate(_fd, _fileLength);
+        errno = writeError;
+        return NO;
+    }
+    
+    _fileLength += _buffer.length;
+    _buffer = [NSMutableData data];
+    
+    return YES;
+}
+
+#pragma mark - Draining
+
+- (void)drainWithCallback:(void (^)(NSError * _Nullable, NSArray<LFMScrobbleResult *> * _Nonnull))block {
+    @synchronized (self) {
+        block == nil ?: [_drainCallbacks addObject:block];
+        
+        if (_draining) return;
+        
+        _draining = YES;
+        _drainResults = [NSMutableArray array];
+    }
+    
+    [self sendNextBatch];
+}
+
+- (void)sendNextBatch {
+    __block NSArray<LFMScrobbleTrack *> *tracks = nil;
+    __block uint64_t lastSequence = 0;
+    __block BOOL reconciling = NO;
+    __block NSError *error = nil;
+    
+    dispatch_sync(_ioQueue, ^{
+        @synchronized (self) {
+            // Records are read back from the journal, so everything buffered has to be written first; otherwise they would look unreadable and be acknowledged unsent.
+            if (![self writeBuffer]) {
+                error = LFMJournalError(self->_journalPath);
+                return;
+            }
+            
+            NSUInteger count = MIN(LFMScrobbleQueueBatchSize, self->_entryCount - self->_head);
+            NSMutableArray<LFMScrobbleTrack *> *batch = [NSMutableArray arrayWithCapacity:count];
+            
+            // A batch that is being reconciled is sent again without any scrobbles that were queued after it.
+            reconciling = self->_sentSequence != 0;
+            
+            for (NSUInteger i = self->_head; i < self->_head + count; i++) {
+                if (reconciling && self->_entries[i].sequence > self->_sentSequence) break;
+                
+                LFMScrobbleTrack *track = [self trackForEntry:self->_entries[i]];
+                track == nil ?: [batch addObject:track];
+                lastSequence = self->_entries[i].sequence;
+            }
+            
+            tracks = batch;
+        }
+    });
+    
+    if (error != nil || lastSequence == 0) return [self finishDrainingWithError:error];
+    
+    if (tracks.count == 0) {
+        // Every record in the batch is unreadable; there is nothing to send, so acknowledge them.
+        [self acknowledgeThroughSequence:lastSequence];
+        return [self sendNextBatch];
+    }
+    
+    NSString *userName = [LFMSession sharedSession].userName;
+    
+    // Without a session the batch can't be looked up, but it can't be scrobbled either.
+    if (!reconciling || userName == nil) return [self sendTracks:tracks throughSequence:lastSequence];
+    
+    [self reconcileTracks:tracks forUserNamed:userName onPage:1 recordedTimestamps:[NSMutableSet set] callback:^(NSError *error, NSArray<LFMScrobbleTrack *> *unrecordedTracks) {
+        if (error != nil) return [self finishDrainingWithError:error];
+        
+        [self sendTracks:unrecordedTracks throughSequence:lastSequence];
+    }];
+}
+
+/**
+ Journals a batch as sent, sends it and acknowledges it once Last.fm has responded. If the batch is empty - every scrobble in it had already been recorded - it is acknowledged straight away.
+ */
+- (void)sendTracks:(NSArray<LFMScrobbleTrack *> *)tracks throughSequence:(uint64_t)lastSequence {
+    if (tracks.count == 0) {
+        [self acknowledgeThroughSequence:lastSequence];
+        return [self sendNextBatch];
+    }
+    
+    NSError *error = nil;
+    
+    // The batch has to be on disk as sent before it goes out, so that a crash before it is acknowledged leads to it being reconciled rather than sent blindly.
+    if (![self journalSentSequence:lastSequence error:&error]) return [self finishDrainingWithError:error];
+    
+    [LFMTrackProvider scrobbleTracks:tracks maximumConcurrentBatches:1 callback:^(NSError * _Nullable error, NSArray<LFMScrobbleResult *> * _Nonnull results) {
+        if (error != nil) {
+            // Last.fm answered, so nothing in the batch was recorded and it needn't be reconciled before it is sent again. Any other failure - a timeout, a dropped connection - leaves that unknown.
+            if ([error.domain isEqualToString:@"fm.last.kit.error"]) [self journalSentSequence:0 error:nil];
+            
+            return [self finishDrainingWithError:error];
+        }
+        
+        [self acknowledgeThroughSequence:lastSequence];
+        
+        @synchronized (self) {
+            [self->_drainResults addObjectsFromArray:results];
+        }
+        
+        [self sendNextBatch];
+    }];
+}
+
+/**
+ Journals the batch ending with `sequence` as sent, or no batch as sent if `sequence` is 0, and forces the record to disk. If it can't be, it stays buffered and is retried.
+ 
+ @return   `YES` if the record is on disk.
+ */
+- (BOOL)journalSentSequence:(uint64_t)sequence error:(NSError **)error {
+    __block BOOL journaled = NO;
+    __block NSError *flushError = nil;
+    
+    dispatch_sync(_ioQueue, ^{
+        @synchronized (self) {
+            self->_sentSequence = sequence;
+            LFMJournalAppendRecord(self->_buffer, LFMJournalRecordTypeSend, &sequence, sizeof(sequence));
+        }
+        
+        journaled = [self flush:&flushError];
+    });
+    
+    if (!journaled && error != NULL) *error = flushError;
+    return journaled;
+}
+
+/**
+ Works out which scrobbles of a batch that was sent but never acknowledged Last.fm hasn't recorded, by looking for their timestamps among the plays on the user's profile between the batch's first and last. Scrobbles are matched on their timestamp alone, as Last.fm may have corrected the names they were sent with.
+ */
+- (void)reconcileTracks:(NSArray<LFMScrobbleTrack *> *)tracks
+           forUserNamed:(NSString *)userName
+                 onPage:(NSUInteger)page
+     recordedTimestamps:(NSMutableSet<NSNumber *> *)recordedTimestamps
+               callback:(void (^)(NSError *error, NSArray<LFMScrobbleTrack *> *unrecordedTracks))block {
+    int64_t startTimestamp = INT64_MAX;
+    int64_t endTimestamp = INT64_MIN;
+    
+    for (LFMScrobbleTrack *track in tracks) {
+        int64_t timestamp = (int64_t)track.timestamp.timeIntervalSince1970;
+        startTimestamp = MIN(startTimestamp, timestamp);
+        endTimestamp = MAX(endTimestamp, timestamp);
+    }
+    
+    NSURLRequest *request = LFMEndpointRequest(LFMEndpointUserGetRecentTracks, LFMParameters(userName, @(LFMScrobbleQueueReconciliationPageSize), @(page), @"1", @(startTimestamp), @(endTimestamp)), nil);
+    
+    [[LFMClient sharedClient] dataTaskWithRequest:request callback:^(NSError *error, NSDictionary *responseObject) {
+        if (error != nil) return block(error, @[]);
+        
+        NSDictionary *responseDictionary = [responseObject objectForKey:@"recenttracks"];
+        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:[responseDictionary objectForKey:@"@attr"]];
+        
+        for (NSDictionary *trackDictionary in [responseDictionary objectForKey:@"track"]) {
+            NSTimeInterval timestamp = 0;
+            
+            // The track that is playing right now has no date.
+            if (LFMParseTimestamp([[trackDictionary objectForKey:@"date"] objectForKey:@"uts"], &timestamp)) {
+                [recordedTimestamps addObject:@((int64_t)timestamp)];
+            }
+        }
+        
+        if (query != nil && page * MAX(query.itemsPerPage, 1) < query.totalResults) {
+            return [self reconcileTracks:tracks forUserNamed:userName onPage:page + 1 recordedTimestamps:recordedTimestamps callback:block];
+        }
+        
+        NSIndexSet *unrecordedIndexes = [tracks indexesOfObjectsPassingTest:^BOOL(LFMScrobbleTrack *track, NSUInteger idx, BOOL *stop) {
+            return ![recordedTimestamps containsObject:@((int64_t)track.timestamp.timeIntervalSince1970)];
+        }];
+        
+        block(nil, [tracks objectsAtIndexes:unrecordedIndexes]);
+    }];
+}
+
+- (void)acknowledgeThroughSequence:(uint64_t)sequence {
+    dispatch_sync(_ioQueue, ^{
+        @synchronized (self) {
+            if (self->_sentSequence <= sequence) self->_sentSequence = 0;
+            
+            while (self->_head < self->_entryCount && self->_entries[self->_head].sequence <= sequence) {
+                self->_head++;
+                self->_acknowledgedRecordCount++;
+            }
+            
+            LFMJournalAppendRecord(self->_buffer, LFMJournalRecordTypeAcknowledge, &sequence, sizeof(sequence));
+        }
+        
+        // The acknowledgement is forced to disk before the next batch goes out, keeping the window in which a crash causes a batch to be resent to one batch. If it can't be, it stays buffered and is retried; a crash before then only means the batch is sent again.
+        if ([self flush:nil]) [self compactIfNeeded];
+    });
+}
+
+- (void)finishDrainingWithError:(NSError *)error {
+    NSArray *callbacks = nil;
+    NSArray<LFMScrobbleResult *> *results = nil;
+    
+    @synchronized (self) {
+        callbacks = _drainCallbacks;
+        results = _drainResults;
+        _drainCallbacks = [NSMutableArray array];
+        _drainResults = nil;
+        _draining = NO;
+    }
+    
+    for (void (^callback)(NSError *, NSArray<LFMScrobbleResult *> *) in callbacks) {
+        callback(error, results);
+    }
+}
+
+- (LFMScrobbleTrack *)trackForEntry:(LFMScrobbleQueueEntry)entry {
+    NSMutableData *payload = [NSMutableData dataWithLength:entry.length];
+    
+    if (pread(_fd, payload.mutableBytes, entry.length, entry.offset + LFMJournalRecordHeaderLength) != entry.length) return nil;
+    
+    const uint8_t *cursor = payload.bytes;
+    const uint8_t *end = cursor + payload.length;
+    
+    uint64_t sequence;
+    int64_t timestamp;
+    uint32_t duration, position;
+    uint8_t chosenByUser;
+    
+    if (payload.length < sizeof(sequence) + sizeof(timestamp) + sizeof(duration) + sizeof(position) + sizeof(chosenByUser)) return nil;
+    
+    memcpy(&sequence, cursor, sizeof(sequence)); cursor += sizeof(sequence);
+    memcpy(&timestamp, cursor, sizeof(timestamp)); cursor += sizeof(timestamp);
+    memcpy(&duration, cursor, sizeof(duration)); cursor += sizeof(duration);
+    memcpy(&position, cursor, sizeof(position)); cursor += sizeof(position);
+    memcpy(&chosenByUser, cursor, sizeof(chosenByUser)); cursor += sizeof(chosenByUser);
+    
+    NSString *name = LFMJournalReadString(&cursor, end);
+    NSString *mbid = LFMJournalReadString(&cursor, end);
+    NSString *URLString = LFMJournalReadString(&cursor, end);
+    NSString *artistName = LFMJournalReadString(&cursor, end);
+    NSString *artistMBID = LFMJournalReadString(&cursor, end);
+    NSString *artistURLString = LFMJournalReadString(&cursor, end);
+    NSString *albumName = LFMJournalReadString(&cursor, end);
+    NSString *albumArtist = LFMJournalReadString(&cursor, end);
+    NSString *albumMBID = LFMJournalReadString(&cursor, end);
+    NSString *albumURLString = LFMJournalReadString(&cursor, end);
+    
+    if (albumURLString == nil || name.length == 0) return nil;
+    
+    LFMArtist *artist = artistName.length == 0 ? nil : [[LFMArtist alloc] initFromDictionary:@{@"name": artistName,
+                                                                                             @"mbid": artistMBID,
+                                                                                             @"url": artistURLString,
+                                                                                             @"streamable": @"0"}];
+    LFMAlbum *album = albumName.length == 0 ? nil : [[LFMAlbum alloc] initFromDictionary:@{@"name": albumName,
+                                                                                         @"artist": albumArtist,
+                                                                                         @"mbid": albumMBID,
+                                                                                         @"url": albumURLString,
+                                                                                         @"streamable": @"0"}];
+    NSURL *URL = [NSURL URLWithString:URLString] ?: [NSURL URLWithString:@"https://www.last.fm"];
+    
+    LFMTrack *track = [[LFMTrack alloc] initWithName:name
+                                              artist:artist
+                                       musicBrainzID:mbid
+                                               album:album
+                                     positionInAlbum:position
+                                                 URL:URL
+                                            duration:duration
+                                          streamable:NO
+                                                tags:@[]
+                                                wiki:nil
+                                           listeners:0
+                                           playCount:0];
+    
+    return [[LFMScrobbleTrack alloc] initFromTrack:track withTimestamp:[NSDate dateWithTimeIntervalSince1970:timestamp] chosenByUser:chosenByUser];
+}
+
+#pragma mark - Compaction
+
+/**
+ Rewrites the journal without acknowledged records once they make up most of it. Only ever called on the io queue with the buffer flushed.
+ */
+- (void)compactIfNeeded {
+    @synchronized (self) {
+        NSUInteger pendingCount = _entryCount - _head;
+        
+        if (_acknowledgedRecordCount == 0) return;
+        if (pendingCount > 0 && (_acknowledgedRecordCount < LFMJournalCompactionThreshold || _acknowledgedRecordCount < pendingCount)) return;
+        
+        // Records enqueued since the last flush are copied along with the rest, so they have to be in the old journal first.
+        if (![self writeBuffer]) return;
+        
+        NSString *temporaryPath = [_journalPath stringByAppendingString:@".compacting"];
+        int fd = open(temporaryPath.fileSystemRepresentation, O_RDWR | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) return;
+        
+        NSMutableData *journal = [NSMutableData dataWithBytes:LFMJournalMagic length:sizeof(LFMJournalMagic)];
+        [journal appendBytes:&LFMJournalVersion length:sizeof(LFMJournalVersion)];
+        
+        // Records are copied verbatim; only their offsets change.
+        LFMScrobbleQueueEntry *entries = malloc(MAX(pendingCount, 1) * sizeof(LFMScrobbleQueueEntry));
+        BOOL copied = entries != NULL;
+        
+        for (NSUInteger i = 0; copied && i < pendingCount; i++) {
+            LFMScrobbleQueueEntry entry = _entries[_head + i];
+            size_t length = LFMJournalRecordHeaderLength + entry.length;
+            NSUInteger offset = journal.length;
+            
+            journal.length += length;
+            copied = pread(_fd, (uint8_t *)journal.mutableBytes + offset, length, entry.offset) == (ssize_t)length;
+            entries[i] = (LFMScrobbleQueueEntry){entry.sequence, offset, entry.length};
+        }
+        
+        // Only pending records are copied, so a batch that is still out has to be journaled as sent again.
+        if (_sentSequence != 0) LFMJournalAppendRecord(journal, LFMJournalRecordTypeSend, &_sentSequence, sizeof(_sentSequence));
+        
+        copied = copied && LFMJournalWrite(fd, journal.bytes, journal.length) && LFMJournalFullSync(fd);
+        copied = copied && rename(temporaryPath.fileSystemRepresentation, _journalPath.fileSystemRepresentation) == 0;
+        
+        if (!copied) {
+            close(fd);
+            unlink(temporaryPath.fileSystemRepresentation);
+            free(entries);
+            return;
+        }
+        
+        // The new journal is in place either way; if the rename doesn't reach the disk, a crash brings back the old one, which replays to the same queue.
+        LFMJournalSyncDirectory(_journalPath);
+        
+        close(_fd);
+        free(_entries);
+        
+        _fd = fd;
+        _fileLength = journal.length;
+        _entries = entries;
+        _entryCount = pendingCount;
+        _entryCapacity = MAX(pendingCount, 1);
+        _head = 0;
+        _acknowledgedRecordCount = 0;
+    }
+}
+
+@end
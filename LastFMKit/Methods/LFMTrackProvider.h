@@ -25,7 +25,7 @@
 
 #import <Foundation/Foundation.h>
 
-@class LFMTrack, LFMSearchQuery, LFMScrobbleTrack, LFMTag, LFMTopTag;
+@class LFMTrack, LFMSearchQuery, LFMScrobbleTrack, LFMScrobbleResult, LFMTag, LFMTopTag, LFMSession;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -60,6 +60,31 @@ NS_SWIFT_NAME(TrackProvider)
                                            musicBrainzId:(nullable NSString *)mbid
                                                 callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(updateNowPlaying(track:by:on:position:albumArtist:duration:mbid:callback:));
 
+/**
+ Notifies Last.fm that the user of `session` has started listening to a track. Use this rather than the method above when acting for more than one user, eg. sessions kept in an `LFMSessionRegistry`.
+ 
+ @param trackName   The name of the track.
+ @param artistName  The name of the track's artist.
+ @param albumName   The name of the track's album, if any.
+ @param trackNumber The position of the track on said album, if any.
+ @param albumArtist The artist of the album, if different to that of the track.
+ @param duration    The duration of the track, in seconds.
+ @param mbid        The MusicBrainzID for the track.
+ @param session     The session of the user who is listening.
+ @param block       The callback block containing an optional `NSError` if the request fails. Regardless of the success of the operation, this block will be called.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
++ (NSURLSessionDataTask *)updateNowPlayingWithTrackNamed:(NSString *)trackName
+                                           byArtistNamed:(NSString *)artistName
+                                            onAlbumNamed:(nullable NSString *)albumName
+                                         positionInAlbum:(nullable NSNumber *)trackNumber
+                                    withAlbumArtistNamed:(nullable NSString *)albumArtist
+                                           trackDuration:(nullable NSNumber *)duration
+                                           musicBrainzId:(nullable NSString *)mbid
+                                              forSession:(LFMSession *)session
+                                                callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(updateNowPlaying(track:by:on:position:albumArtist:duration:mbid:session:callback:));
+
 /**
  Adds a track-play to a user's profile.
  
@@ -77,6 +102,51 @@ NS_SWIFT_NAME(TrackProvider)
 + (NSURLSessionDataTask *)scrobbleTracks:(NSArray <LFMScrobbleTrack *> *)tracks
                                 callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(scrobble(tracks:callback:));
 
+/**
+ Adds a track-play to the profile of the user of `session`.
+ 
+ @param tracks  The array of tracks to be scrobbled. The maximum amount of tracks that can be scrobbled at a time is 50. An exception will be raised if this limit is passed.
+ @param session The session of the user whose profile the tracks are added to.
+ @param block   The callback block containing an optional `NSError` if the request fails. Regardless of the success of the operation, this block will be called.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
++ (NSURLSessionDataTask *)scrobbleTracks:(NSArray <LFMScrobbleTrack *> *)tracks
+                              forSession:(LFMSession *)session
+                                callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(scrobble(tracks:session:callback:));
+
+/**
+ Adds any amount of track-plays to a user's profile. The tracks are split into batches of 50 - the most Last.fm accepts in one request - and up to `maximumConcurrentBatches` of them are sent at once, so large backfills aren't held up by one round trip per batch.
+ 
+ If a batch fails no further batches are started, but batches that are already in flight are allowed to finish. Last.fm orders scrobbles by their timestamps, so the order in which batches complete doesn't matter.
+ 
+ @note  🔒: Authentication Required.
+ 
+ @param tracks                      The tracks to be scrobbled.
+ @param maximumConcurrentBatches    The maximum amount of batches in flight at any one time. Must be at least 1.
+ @param block                       The callback block, called once every batch has completed. It contains an optional `NSError` - the first error any batch failed with - and whether each track was accepted or ignored, in the order the tracks were passed in. Tracks in batches that failed or were never sent have no result.
+ 
+ @return   An `NSProgress` object whose `completedUnitCount` is the amount of tracks Last.fm has responded to. Cancelling it cancels every batch in flight and stops further batches from being sent.
+ */
++ (NSProgress *)scrobbleTracks:(NSArray <LFMScrobbleTrack *> *)tracks
+      maximumConcurrentBatches:(NSUInteger)maximumConcurrentBatches
+                      callback:(void (^_Nullable)(NSError * _Nullable, NSArray<LFMScrobbleResult *> *))block NS_SWIFT_NAME(scrobble(tracks:maximumConcurrentBatches:callback:));
+
+/**
+ Adds any amount of track-plays to the profile of the user of `session`, in batches as described above.
+ 
+ @param tracks                      The tracks to be scrobbled.
+ @param maximumConcurrentBatches    The maximum amount of batches in flight at any one time. Must be at least 1.
+ @param session                     The session of the user whose profile the tracks are added to.
+ @param block                       The callback block, called once every batch has completed.
+ 
+ @return   An `NSProgress` object whose `completedUnitCount` is the amount of tracks Last.fm has responded to.
+ */
++ (NSProgress *)scrobbleTracks:(NSArray <LFMScrobbleTrack *> *)tracks
+      maximumConcurrentBatches:(NSUInteger)maximumConcurrentBatches
+                    forSession:(LFMSession *)session
+                      callback:(void (^_Nullable)(NSError * _Nullable, NSArray<LFMScrobbleResult *> *))block NS_SWIFT_NAME(scrobble(tracks:maximumConcurrentBatches:session:callback:));
+
 /**
  Loves a track for a user profile.
  
@@ -92,6 +162,21 @@ NS_SWIFT_NAME(TrackProvider)
                            byArtistNamed:(NSString *)artistName
                                 callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(love(track:by:callback:));
 
+/**
+ Loves a track for the user of `session`.
+ 
+ @param trackName   The name of the track.
+ @param artistName  The name of the track's artist.
+ @param session     The session of the user who loves the track.
+ @param block       The callback block containing an optional `NSError` if the request fails. Regardless of the success of the operation, this block will be called.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
++ (NSURLSessionDataTask *)loveTrackNamed:(NSString *)trackName
+                           byArtistNamed:(NSString *)artistName
+                              forSession:(LFMSession *)session
+                                callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(love(track:by:session:callback:));
+
 /**
  Un-loves a track for a user profile.
  
@@ -107,6 +192,21 @@ NS_SWIFT_NAME(TrackProvider)
                              byArtistNamed:(NSString *)artistName
                                   callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(unlove(track:by:callback:));
 
+/**
+ Un-loves a track for the user of `session`.
+ 
+ @param trackName   The name of the track.
+ @param artistName  The name of the track's artist.
+ @param session     The session of the user who no longer loves the track.
+ @param block       The callback block containing an optional `NSError` if the request fails. Regardless of the success of the operation, this block will be called.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
++ (NSURLSessionDataTask *)unloveTrackNamed:(NSString *)trackName
+                             byArtistNamed:(NSString *)artistName
+                                forSession:(LFMSession *)session
+                                  callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(unlove(track:by:session:callback:));
+
 /**
  Retrieves detailed information on a track using its name and artist or MusicBrainzID.
  
@@ -192,6 +292,23 @@ NS_SWIFT_NAME(TrackProvider)
                     byArtistNamed:(NSString *)artistName
                          callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(add(tags:to:by:callback:));
 
+/**
+ Tags a track on behalf of the user of `session`.
+ 
+ @param tags        An array of user supplied tags to apply to this track. Accepts a maximum of 10 tags. An exception will be raised if more than 10 tags are passed in.
+ @param trackName   The name of the track.
+ @param artistName  The name of the track's artist.
+ @param session     The session of the user applying the tags.
+ @param block       The callback block containing an optional `NSError` if the request fails. Regardless of the success of the operation, this block will be called.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
++ (NSURLSessionDataTask *)addTags:(NSArray <LFMTag *> *)tags
+                     toTrackNamed:(NSString *)trackName
+                    byArtistNamed:(NSString *)artistName
+                       forSession:(LFMSession *)session
+                         callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(add(tags:to:by:session:callback:));
+
 /**
  Removes a user's tag from a track.
  
@@ -209,6 +326,23 @@ NS_SWIFT_NAME(TrackProvider)
                       byArtistNamed:(NSString *)artistName
                            callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(remove(tag:from:by:callback:));
 
+/**
+ Removes a tag the user of `session` applied to a track.
+ 
+ @param tag         A single user tag to remove from this track.
+ @param trackName   The name of the track.
+ @param artistName  The name of the track's artist.
+ @param session     The session of the user who applied the tag.
+ @param block       The callback block containing an optional `NSError` if the request fails. Regardless of the success of the operation, this block will be called.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
++ (NSURLSessionDataTask *)removeTag:(LFMTag *)tag
+                     fromTrackNamed:(NSString *)trackName
+                      byArtistNamed:(NSString *)artistName
+                         forSession:(LFMSession *)session
+                           callback:(void (^_Nullable)(NSError * _Nullable))block NS_SWIFT_NAME(remove(tag:from:by:session:callback:));
+
 /**
  Retrieves the tags applied by an individual user to a track on Last.fm. If accessed as an authenticated service and a user parameter is not supplied then this service will return tags for the authenticated user.
  
@@ -25,39 +25,44 @@
 
 #import "LFMTrackProvider.h"
 #import "LFMKit+Protected.h"
-#import "LFMError.h"
+#import "LFMClient.h"
 #import "LFMAuth.h"
 #import "LFMTrack.h"
 #import "LFMSearchQuery.h"
 #import "LFMScrobbleTrack.h"
 #import "LFMTopTag.h"
+#import "LFMNowPlayingController.h"
 #import "LFMTag.h"
 
-@implementation LFMTrackProvider
+/** The maximum amount of tracks Last.fm accepts in a single `track.scrobble` request. */
+static const NSUInteger LFMScrobbleBatchSize = 50;
 
-+ (NSURLSessionDataTask *)updateNowPlayingWithTrackNamed:(NSString *)trackName
-                                           byArtistNamed:(NSString *)artistName
-                                            onAlbumNamed:(NSString *)albumName
-                                         positionInAlbum:(NSNumber *)trackNumber
-                                    withAlbumArtistNamed:(NSString *)albumArtist
-                                           trackDuration:(NSNumber *)duration
-                                           musicBrainzId:(NSString *)mbid callback:(void (^)(NSError * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
+/**
+ Builds the signed request for a single batch of at most 50 scrobbles made for the session with `sessionKey`.
+ */
+static NSURLRequest* LFMScrobbleRequest(NSArray<LFMScrobbleTrack *> *tracks, NSString *sessionKey) {
     NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
     NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
     
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"track.updateNowPlaying"],
-                            [NSURLQueryItem queryItemWithName:@"album" value:albumName],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"track" value:trackName],
-                            [NSURLQueryItem queryItemWithName:@"trackNumber" value:trackNumber.stringValue],
-                            [NSURLQueryItem queryItemWithName:@"duration" value:duration.stringValue],
-                            [NSURLQueryItem queryItemWithName:@"albumArtist" value:albumArtist],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
+    NSMutableArray *queryItems = [NSMutableArray arrayWithArray:@[
+                            [NSURLQueryItem queryItemWithName:@"method" value:@"track.scrobble"],
                             [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
                             [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey],
-                            [NSURLQueryItem queryItemWithName:@"sk" value:[LFMSession sharedSession].sessionKey]];
+                            [NSURLQueryItem queryItemWithName:@"sk" value:sessionKey]]];
+    
+    [tracks enumerateObjectsUsingBlock:^(LFMScrobbleTrack * _Nonnull track, NSUInteger idx, BOOL * _Nonnull stop) {
+        NSURLQueryItem *artistItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"artist[%tu]", idx] value:track.artist.name];
+        NSURLQueryItem *trackItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"track[%tu]", idx] value:track.name];
+        NSURLQueryItem *timestampItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"timestamp[%tu]", idx] value:[NSString stringWithFormat:@"%lld", (long long)track.timestamp.timeIntervalSince1970]];
+        NSURLQueryItem *albumItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"album[%tu]", idx] value:track.album.name];
+        NSURLQueryItem *chosenByUserItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"chosenByUser[%tu]", idx] value:[NSString stringWithFormat:@"%d", track.wasChosenByUser]];
+        NSURLQueryItem *positionInAlbumItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"trackNumber[%tu]", idx] value:[NSString stringWithFormat:@"%tu", track.positionInAlbum]];
+        NSURLQueryItem *mbidItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"mbid[%tu]", idx] value:track.mbid];
+        NSURLQueryItem *durationItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"duration[%tu]", idx] value:[NSString stringWithFormat:@"%tu", track.duration]];
+        
+        [queryItems addObjectsFromArray:@[artistItem, trackItem, timestampItem, albumItem, chosenByUserItem, positionInAlbumItem, mbidItem, durationItem]];
+    }];
+    
     components.queryItems = [[LFMAuth sharedInstance] appendingSignatureItemToQueryItems:queryItems];
     
     NSData *data = [components.query dataUsingEncoding:NSUTF8StringEncoding];
@@ -65,88 +70,234 @@
     [request setHTTPMethod:@"POST"];
     [request setHTTPBody:data];
     
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (block == nil) return;
-        if (error != nil || data == nil) return block(error);
-        
-        lfm_error_validate(data, &error);
-        
-        block(error);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return request;
 }
 
-+ (NSURLSessionDataTask *)loveTrackNamed:(NSString *)trackName
-                           byArtistNamed:(NSString *)artistName
-                                callback:(void (^)(NSError * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
+/**
+ Pairs every scrobble in a `track.scrobble` response with the track it was submitted for.
+ */
+static NSArray<LFMScrobbleResult *>* LFMScrobbleResults(NSArray<LFMScrobbleTrack *> *tracks, NSDictionary *responseDictionary) {
+    id scrobbles = [[responseDictionary objectForKey:@"scrobbles"] objectForKey:@"scrobble"];
     
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"track.love"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"track" value:trackName],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey],
-                            [NSURLQueryItem queryItemWithName:@"sk" value:[LFMSession sharedSession].sessionKey]];
-    components.queryItems = [[LFMAuth sharedInstance] appendingSignatureItemToQueryItems:queryItems];
+    // A batch of one track comes back as a single object rather than an array.
+    if ([scrobbles isKindOfClass:[NSDictionary class]]) scrobbles = @[scrobbles];
+    if (![scrobbles isKindOfClass:[NSArray class]]) return @[];
     
-    NSData *data = [components.query dataUsingEncoding:NSUTF8StringEncoding];
+    NSMutableArray<LFMScrobbleResult *> *results = [NSMutableArray arrayWithCapacity:tracks.count];
+    NSUInteger count = MIN([scrobbles count], tracks.count);
     
-    [request setHTTPMethod:@"POST"];
-    [request setHTTPBody:data];
+    for (NSUInteger i = 0; i < count; i++) {
+        LFMScrobbleResult *result = [[LFMScrobbleResult alloc] initWithTrack:tracks[i] fromDictionary:scrobbles[i]];
+        result == nil ?: [results addObject:result];
+    }
     
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (block == nil) return;
-        if (error != nil || data == nil) return block(error);
-        
-        lfm_error_validate(data, &error);
+    return results;
+}
+
+/**
+ Splits an unbounded amount of scrobbles into batches and keeps a fixed amount of them in flight until every batch has been submitted, one fails or the submission is cancelled.
+ */
+@interface LFMScrobbleSubmission : NSObject {
+    @package
+    NSArray<LFMScrobbleTrack *> *_tracks;
+    NSString *_sessionKey;
+    NSMutableArray *_results; // Results for each batch, or `NSNull` for batches that haven't succeeded.
+    NSMutableSet<NSURLSessionDataTask *> *_dataTasks;
+    NSUInteger _batchCount;
+    NSUInteger _nextBatch;
+    NSUInteger _batchesInFlight;
+    NSUInteger _maximumConcurrentBatches;
+    NSError *_error;
+    BOOL _finished;
+    NSProgress *_progress;
+    void (^_callback)(NSError * _Nullable, NSArray<LFMScrobbleResult *> *);
+}
+
+@end
+
+@implementation LFMScrobbleSubmission
+
+- (instancetype)initWithTracks:(NSArray<LFMScrobbleTrack *> *)tracks
+                    sessionKey:(NSString *)sessionKey
+      maximumConcurrentBatches:(NSUInteger)maximumConcurrentBatches
+                      callback:(void (^)(NSError * _Nullable, NSArray<LFMScrobbleResult *> *))block {
+    self = [super init];
+    
+    if (self) {
+        _tracks = [tracks copy];
+        _sessionKey = [sessionKey copy];
+        _batchCount = (_tracks.count + LFMScrobbleBatchSize - 1) / LFMScrobbleBatchSize;
+        _results = [NSMutableArray arrayWithCapacity:_batchCount];
+        _dataTasks = [NSMutableSet set];
+        _maximumConcurrentBatches = maximumConcurrentBatches;
+        _callback = block;
+        // Not +discreteProgressWithTotalUnitCount:, which is unavailable before iOS 9 and macOS 10.11. A nil parent keeps the progress from joining whichever progress happens to be current.
+        _progress = [[NSProgress alloc] initWithParent:nil userInfo:nil];
+        _progress.totalUnitCount = _tracks.count;
+        
+        for (NSUInteger i = 0; i < _batchCount; i++) {
+            [_results addObject:[NSNull null]];
+        }
         
-        block(error);
-    }];
-    
-    [dataTask resume];
+        NSMutableSet<NSURLSessionDataTask *> *dataTasks = _dataTasks;
+        _progress.cancellationHandler = ^{
+            @synchronized (dataTasks) {
+                [dataTasks makeObjectsPerformSelector:@selector(cancel)];
+            }
+        };
+    }
     
-    return dataTask;
+    return self;
 }
 
-+ (NSURLSessionDataTask *)unloveTrackNamed:(NSString *)trackName
-                             byArtistNamed:(NSString *)artistName
-                                  callback:(void (^)(NSError * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
+- (void)submitBatches {
+    NSMutableIndexSet *batches = [NSMutableIndexSet indexSet];
+    BOOL finished = NO;
+    
+    @synchronized (self) {
+        while (_error == nil && !_progress.isCancelled && _nextBatch < _batchCount && _batchesInFlight < _maximumConcurrentBatches) {
+            [batches addIndex:_nextBatch++];
+            _batchesInFlight++;
+        }
+        
+        if (_batchesInFlight == 0 && !_finished) {
+            finished = _finished = YES;
+        }
+    }
     
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
+    [batches enumerateIndexesUsingBlock:^(NSUInteger batch, BOOL * _Nonnull stop) {
+        [self submitBatch:batch];
+    }];
     
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"track.unlove"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"track" value:trackName],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey],
-                            [NSURLQueryItem queryItemWithName:@"sk" value:[LFMSession sharedSession].sessionKey]];
-    components.queryItems = [[LFMAuth sharedInstance] appendingSignatureItemToQueryItems:queryItems];
+    if (finished) [self finish];
+}
+
+- (void)submitBatch:(NSUInteger)batch {
+    NSRange range = NSMakeRange(batch * LFMScrobbleBatchSize, MIN(LFMScrobbleBatchSize, _tracks.count - batch * LFMScrobbleBatchSize));
+    NSArray<LFMScrobbleTrack *> *tracks = [_tracks subarrayWithRange:range];
+    __block NSURLSessionDataTask *dataTask = nil;
+    
+    @synchronized (_dataTasks) {
+        dataTask = [[LFMClient sharedClient] dataTaskWithRequest:LFMScrobbleRequest(tracks, _sessionKey) callback:^(NSError *error, NSDictionary *responseDictionary) {
+            @synchronized (self->_dataTasks) {
+                [self->_dataTasks removeObject:dataTask];
+                dataTask = nil;
+            }
+            
+            @synchronized (self) {
+                self->_batchesInFlight--;
+                
+                if (error != nil) {
+                    self->_error = self->_error ?: error;
+                } else {
+                    self->_results[batch] = LFMScrobbleResults(tracks, responseDictionary);
+                    self->_progress.completedUnitCount += tracks.count;
+                }
+            }
+            
+            [self submitBatches];
+        }];
+        
+        [_dataTasks addObject:dataTask];
+    }
+}
+
+- (void)finish {
+    NSMutableArray<LFMScrobbleResult *> *results = [NSMutableArray arrayWithCapacity:_tracks.count];
     
-    NSData *data = [components.query dataUsingEncoding:NSUTF8StringEncoding];
+    for (id batchResults in _results) {
+        if (batchResults != [NSNull null]) [results addObjectsFromArray:batchResults];
+    }
     
-    [request setHTTPMethod:@"POST"];
-    [request setHTTPBody:data];
+    _progress.cancellationHandler = nil;
     
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (block == nil) return;
-        if (error != nil || data == nil) return block(error);
-        
-        lfm_error_validate(data, &error);
-        
-        block(error);
-    }];
+    if (_error == nil && results.count < _tracks.count && _progress.isCancelled) {
+        _error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    }
     
-    [dataTask resume];
+    if (_callback == nil) return;
     
-    return dataTask;
+    _callback(_error, results);
+}
+
+@end
+
+@implementation LFMTrackProvider
+
++ (NSURLSessionDataTask *)updateNowPlayingWithTrackNamed:(NSString *)trackName
+                                           byArtistNamed:(NSString *)artistName
+                                            onAlbumNamed:(NSString *)albumName
+                                         positionInAlbum:(NSNumber *)trackNumber
+                                    withAlbumArtistNamed:(NSString *)albumArtist
+                                           trackDuration:(NSNumber *)duration
+                                           musicBrainzId:(NSString *)mbid callback:(void (^)(NSError * _Nullable))block {
+    return [self updateNowPlayingWithTrackNamed:trackName
+                                  byArtistNamed:artistName
+                                   onAlbumNamed:albumName
+                                positionInAlbum:trackNumber
+                           withAlbumArtistNamed:albumArtist
+                                  trackDuration:duration
+                                  musicBrainzId:mbid
+                                     sessionKey:[LFMSession sharedSession].sessionKey
+                                       callback:block];
+}
+
++ (NSURLSessionDataTask *)updateNowPlayingWithTrackNamed:(NSString *)trackName
+                                           byArtistNamed:(NSString *)artistName
+                                            onAlbumNamed:(NSString *)albumName
+                                         positionInAlbum:(NSNumber *)trackNumber
+                                    withAlbumArtistNamed:(NSString *)albumArtist
+                                           trackDuration:(NSNumber *)duration
+                                           musicBrainzId:(NSString *)mbid
+                                              forSession:(LFMSession *)session
+                                                callback:(void (^)(NSError * _Nullable))block {
+    return [self updateNowPlayingWithTrackNamed:trackName
+                                  byArtistNamed:artistName
+                                   onAlbumNamed:albumName
+                                positionInAlbum:trackNumber
+                           withAlbumArtistNamed:albumArtist
+                                  trackDuration:duration
+                                  musicBrainzId:mbid
+                                     sessionKey:session.sessionKey
+                                       callback:block];
+}
+
++ (NSURLSessionDataTask *)updateNowPlayingWithTrackNamed:(NSString *)trackName
+                                           byArtistNamed:(NSString *)artistName
+                                            onAlbumNamed:(NSString *)albumName
+                                         positionInAlbum:(NSNumber *)trackNumber
+                                    withAlbumArtistNamed:(NSString *)albumArtist
+                                           trackDuration:(NSNumber *)duration
+                                           musicBrainzId:(NSString *)mbid
+                                              sessionKey:(NSString *)sessionKey
+                                                callback:(void (^)(NSError * _Nullable))block {
+    return LFMEndpointDataTask(LFMEndpointTrackUpdateNowPlaying, LFMParameters(albumName, artistName, trackName, trackNumber, duration, albumArtist, mbid), sessionKey, LFMEndpointStatusCallback(block));
+}
+
++ (NSURLSessionDataTask *)loveTrackNamed:(NSString *)trackName
+                           byArtistNamed:(NSString *)artistName
+                                callback:(void (^)(NSError * _Nullable))block {
+    return [self loveTrackNamed:trackName byArtistNamed:artistName forSession:[LFMSession sharedSession] callback:block];
+}
+
++ (NSURLSessionDataTask *)loveTrackNamed:(NSString *)trackName
+                           byArtistNamed:(NSString *)artistName
+                              forSession:(LFMSession *)session
+                                callback:(void (^)(NSError * _Nullable))block {
+    return LFMEndpointDataTask(LFMEndpointTrackLove, LFMParameters(artistName, trackName), session.sessionKey, LFMEndpointStatusCallback(block));
+}
+
++ (NSURLSessionDataTask *)unloveTrackNamed:(NSString *)trackName
+                             byArtistNamed:(NSString *)artistName
+                                  callback:(void (^)(NSError * _Nullable))block {
+    return [self unloveTrackNamed:trackName byArtistNamed:artistName forSession:[LFMSession sharedSession] callback:block];
+}
+
++ (NSURLSessionDataTask *)unloveTrackNamed:(NSString *)trackName
+                             byArtistNamed:(NSString *)artistName
+                                forSession:(LFMSession *)session
+                                  callback:(void (^)(NSError * _Nullable))block {
+    return LFMEndpointDataTask(LFMEndpointTrackUnlove, LFMParameters(artistName, trackName), session.sessionKey, LFMEndpointStatusCallback(block));
 }
 
 + (NSURLSessionDataTask *)searchForTrackNamed:(NSString *)trackName
@@ -154,88 +305,46 @@
                                  itemsPerPage:(NSUInteger)limit
                                        onPage:(NSUInteger)page
                                      callback:(void (^)(NSError * _Nullable, NSArray<LFMTrack *> * _Nonnull, LFMSearchQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"track.search"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"track" value:trackName],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"results"];
-        
-        LFMSearchQuery *searchQuery = [[LFMSearchQuery alloc] initFromDictionary:responseDictionary];
-        
-        NSMutableArray <LFMTrack *> *tracks = [NSMutableArray array];
-        
-        for (NSDictionary *trackDictionary in [[responseDictionary objectForKey:@"trackmatches"] objectForKey:@"track"]) {
-            LFMTrack *track = [[LFMTrack alloc] initFromDictionary:trackDictionary];
-            track == nil ?: [tracks addObject:track];
-        }
-        
-        block(error, tracks, searchQuery);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointTrackSearch, LFMParameters(trackName, artistName, @(limit), @(page)), nil, block);
 }
 
 + (NSURLSessionDataTask *)scrobbleTracks:(NSArray<LFMScrobbleTrack *> *)tracks callback:(void (^)(NSError * _Nullable))block {
+    return [self scrobbleTracks:tracks forSession:[LFMSession sharedSession] callback:block];
+}
+
++ (NSURLSessionDataTask *)scrobbleTracks:(NSArray<LFMScrobbleTrack *> *)tracks forSession:(LFMSession *)session callback:(void (^)(NSError * _Nullable))block {
     NSAssert(tracks.count <= 50, @"There is a a maximum of 50 scrobbles per batch.");
-    NSURLSession *session = [NSURLSession sharedSession];
     
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
+    [LFMNowPlayingController tracksWillBeScrobbled:tracks sessionKey:session.sessionKey];
     
-    NSMutableArray *queryItems = [NSMutableArray arrayWithArray:@[
-                            [NSURLQueryItem queryItemWithName:@"method" value:@"track.scrobble"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey],
-                            [NSURLQueryItem queryItemWithName:@"sk" value:[LFMSession sharedSession].sessionKey]]];
-    
-    [tracks enumerateObjectsUsingBlock:^(LFMScrobbleTrack * _Nonnull track, NSUInteger idx, BOOL * _Nonnull stop) {
-        NSURLQueryItem *artistItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"artist[%tu]", idx] value:track.artist.name];
-        NSURLQueryItem *trackItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"track[%tu]", idx] value:track.name];
-        NSURLQueryItem *timestampItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"timestamp[%tu]", idx] value: [NSString stringWithFormat:@"%f", track.timestamp.timeIntervalSinceReferenceDate]];
-        NSURLQueryItem *albumItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"album[%tu]", idx] value:track.album.name];
-        NSURLQueryItem *chosenByUserItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"chosenByUser[%tu]", idx] value:[NSString stringWithFormat:@"%d", track.wasChosenByUser]];
-        NSURLQueryItem *positionInAlbumItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"trackNumber[%tu]", idx] value:[NSString stringWithFormat:@"%tu", track.positionInAlbum]];
-        NSURLQueryItem *mbidItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"mbid[%tu]", idx] value:track.mbid];
-        NSURLQueryItem *durationItem = [NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"duration[%tu]", idx] value:[NSString stringWithFormat:@"%tu", track.duration]];
+    NSURLSessionDataTask *dataTask = [[LFMClient sharedClient] dataTaskWithRequest:LFMScrobbleRequest(tracks, session.sessionKey) callback:^(NSError *error, NSDictionary *responseDictionary) {
+        if (block == nil) return;
         
-        [queryItems addObjectsFromArray:@[artistItem, trackItem, timestampItem, albumItem, chosenByUserItem, positionInAlbumItem, mbidItem, durationItem]];
+        block(error);
     }];
     
-    components.queryItems = [[LFMAuth sharedInstance] appendingSignatureItemToQueryItems:queryItems];
-    
-    NSData *data = [components.query dataUsingEncoding:NSUTF8StringEncoding];
+    return dataTask;
+}
+
++ (NSProgress *)scrobbleTracks:(NSArray<LFMScrobbleTrack *> *)tracks
+      maximumConcurrentBatches:(NSUInteger)maximumConcurrentBatches
+                      callback:(void (^)(NSError * _Nullable, NSArray<LFMScrobbleResult *> * _Nonnull))block {
+    return [self scrobbleTracks:tracks maximumConcurrentBatches:maximumConcurrentBatches forSession:[LFMSession sharedSession] callback:block];
+}
+
++ (NSProgress *)scrobbleTracks:(NSArray<LFMScrobbleTrack *> *)tracks
+      maximumConcurrentBatches:(NSUInteger)maximumConcurrentBatches
+                    forSession:(LFMSession *)session
+                      callback:(void (^)(NSError * _Nullable, NSArray<LFMScrobbleResult *> * _Nonnull))block {
+    NSAssert(maximumConcurrentBatches > 0, @"At least one batch must be allowed in flight.");
     
-    [request setHTTPMethod:@"POST"];
-    [request setHTTPBody:data];
+    [LFMNowPlayingController tracksWillBeScrobbled:tracks sessionKey:session.sessionKey];
     
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (block == nil) return;
-        if (error != nil || data == nil) return block(error);
-        
-        lfm_error_validate(data, &error);
-        
-        block(error);
-    }];
+    LFMScrobbleSubmission *submission = [[LFMScrobbleSubmission alloc] initWithTracks:tracks sessionKey:session.sessionKey maximumConcurrentBatches:maximumConcurrentBatches callback:block];
     
-    [dataTask resume];
+    [submission submitBatches];
     
-    return dataTask;
+    return submission->_progress;
 }
 
 + (NSURLSessionDataTask *)getTracksSimilarToTrackNamed:(NSString *)trackName
@@ -246,39 +355,9 @@
                                               callback:(void (^)(NSError * _Nullable, NSArray<LFMTrack *> * _Nonnull))block {
     NSAssert((trackName != nil && artistName != nil) || mbid != nil, @"Either the trackName and artistName or the mbid parameter must be set.");
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"track.getSimilar"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"track" value:trackName],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
-                            [NSURLQueryItem queryItemWithName:@"autocorrect" value:[NSString stringWithFormat:@"%d", autoCorrect]],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[]);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        NSMutableArray<LFMTrack *> *tracks = [NSMutableArray array];
-        
-        for (NSDictionary *trackDictionary in [[responseDictionary objectForKey:@"similartracks"] objectForKey:@"track"]) {
-            LFMTrack *track = [[LFMTrack alloc] initFromDictionary:trackDictionary];
-            track == nil ?: [tracks addObject:track];
-        }
-        
+    return LFMEndpointDataTask(LFMEndpointTrackGetSimilar, LFMParameters(artistName, trackName, mbid, @(autoCorrect), @(limit)), nil, ^(NSError *error, NSArray<LFMTrack *> *tracks, id query) {
         block(error, tracks);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)getInfoOnTrackNamed:(NSString *)trackName
@@ -289,70 +368,44 @@
                                      callback:(void (^)(NSError * _Nullable, LFMTrack * _Nullable))block {
     NSAssert((trackName != nil && artistName != nil) || mbid != nil, @"Either the trackName and artistName or the mbid parameter must be set.");
     
-    NSURLSession *session = [NSURLSession sharedSession];
+    NSURLRequest *request = LFMEndpointRequest(LFMEndpointTrackGetInfo, LFMParameters(artistName, trackName, mbid, @(autoCorrect), userName), nil);
     
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"track.getInfo"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"track" value:trackName],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
-                            [NSURLQueryItem queryItemWithName:@"autocorrect" value:[NSString stringWithFormat:@"%d", autoCorrect]],
-                            [NSURLQueryItem queryItemWithName:@"username" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    components.queryItems = queryItems;
+    LFMClient *client = [LFMClient sharedClient];
     
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, nil);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        LFMTrack *track = [[LFMTrack alloc] initFromDictionary:[responseDictionary objectForKey:@"track"]];
-        
-        block(error, track);
-    }];
+    // Per-user and translated details aren't catalogued.
+    LFMTrack *cataloguedModel = userName == nil ? [client.catalogue trackNamed:trackName byArtistNamed:artistName withMusicBrainzId:mbid] : nil;
     
-    [dataTask resume];
+    if (cataloguedModel != nil) {
+        return [client dataTaskWithRequest:request answeredWithBlock:^(NSError *error) {
+            block(error, error == nil ? cataloguedModel : nil);
+        }];
+    }
     
-    return dataTask;
+    return LFMEndpointDataTaskWithRequest(LFMEndpointTrackGetInfo, request, ^(NSError *error, LFMTrack *track, id query) {
+        block(error, track);
+    });
 }
 
 + (NSURLSessionDataTask *)getCorrectionForMisspelledTrackNamed:(NSString *)trackName
                                      withMisspelledArtistNamed:(NSString *)artistName
                                                       callback:(void (^)(NSError * _Nullable, LFMTrack * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"track.getCorrection"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"track" value:trackName],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, nil);
-        
-        NSDictionary *responseDictionary = [[[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"corrections"] objectForKey:@"correction"];
-        
-        LFMTrack *track = [[LFMTrack alloc] initFromDictionary:[responseDictionary objectForKey:@"track"]];
-        
+    return LFMEndpointDataTask(LFMEndpointTrackGetCorrection, LFMParameters(artistName, trackName), nil, ^(NSError *error, LFMTrack *track, id query) {
         block(error, track);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)addTags:(NSArray<LFMTag *> *)tags
                      toTrackNamed:(NSString *)trackName
                     byArtistNamed:(NSString *)artistName
                          callback:(void (^)(NSError * _Nullable))block {
+    return [self addTags:tags toTrackNamed:trackName byArtistNamed:artistName forSession:[LFMSession sharedSession] callback:block];
+}
+
++ (NSURLSessionDataTask *)addTags:(NSArray<LFMTag *> *)tags
+                     toTrackNamed:(NSString *)trackName
+                    byArtistNamed:(NSString *)artistName
+                       forSession:(LFMSession *)session
+                         callback:(void (^)(NSError * _Nullable))block {
     NSAssert(tags.count <= 10, @"This method call accepts a maximum of 10 tags.");
     
     NSMutableString *tagString = [NSMutableString string];
@@ -360,74 +413,22 @@
         [tagString appendFormat:@"%@%@", (idx == 0 ? @"" : @","), obj.name];
     }];
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"track.addTags"],
-                            [NSURLQueryItem queryItemWithName:@"track" value:trackName],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"tags" value:tagString],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey],
-                            [NSURLQueryItem queryItemWithName:@"sk" value:[LFMSession sharedSession].sessionKey]];
-    components.queryItems = [[LFMAuth sharedInstance] appendingSignatureItemToQueryItems:queryItems];
-    
-    NSData *data = [components.query dataUsingEncoding:NSUTF8StringEncoding];
-    
-    [request setHTTPMethod:@"POST"];
-    [request setHTTPBody:data];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (block == nil) return;
-        if (error != nil || data == nil) return block(error);
-        
-        lfm_error_validate(data, &error);
-        
-        block(error);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointTrackAddTags, LFMParameters(trackName, artistName, tagString), session.sessionKey, LFMEndpointStatusCallback(block));
 }
 
 + (NSURLSessionDataTask *)removeTag:(LFMTag *)tag
                      fromTrackNamed:(NSString *)trackName
                       byArtistNamed:(NSString *)artistName
                            callback:(void (^)(NSError * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"track.removeTag"],
-                            [NSURLQueryItem queryItemWithName:@"track" value:trackName],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"tag" value:tag.name],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey],
-                            [NSURLQueryItem queryItemWithName:@"sk" value:[LFMSession sharedSession].sessionKey]];
-    components.queryItems = [[LFMAuth sharedInstance] appendingSignatureItemToQueryItems:queryItems];
-    
-    NSData *data = [components.query dataUsingEncoding:NSUTF8StringEncoding];
-    
-    [request setHTTPMethod:@"POST"];
-    [request setHTTPBody:data];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (block == nil) return;
-        if (error != nil || data == nil) return block(error);
-        
-        lfm_error_validate(data, &error);
-        
-        block(error);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return [self removeTag:tag fromTrackNamed:trackName byArtistNamed:artistName forSession:[LFMSession sharedSession] callback:block];
+}
+
++ (NSURLSessionDataTask *)removeTag:(LFMTag *)tag
+                     fromTrackNamed:(NSString *)trackName
+                      byArtistNamed:(NSString *)artistName
+                         forSession:(LFMSession *)session
+                           callback:(void (^)(NSError * _Nullable))block {
+    return LFMEndpointDataTask(LFMEndpointTrackRemoveTag, LFMParameters(trackName, artistName, tag.name), session.sessionKey, LFMEndpointStatusCallback(block));
 }
 
 + (NSURLSessionDataTask *)getTagsForTrackNamed:(NSString *)trackName
@@ -440,41 +441,9 @@
     
     NSAssert((trackName != nil && artistName != nil) || (mbid != nil), @"Either the trackName and the artistName or the mbid parameter must be set.");
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"track.getTags"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"track" value:trackName],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
-                            [NSURLQueryItem queryItemWithName:@"autocorrect" value:[NSString stringWithFormat:@"%d", autoCorrect]],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey],
-                            [NSURLQueryItem queryItemWithName:@"sk" value:[LFMSession sharedSession].sessionKey]];
-    
-    components.queryItems = [LFMSession sharedSession].sessionKey == nil ? queryItems : [[LFMAuth sharedInstance] appendingSignatureItemToQueryItems:queryItems];
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[]);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        NSMutableArray <LFMTag *> *tags = [NSMutableArray array];
-        
-        for (NSDictionary *tagDictionary in [responseDictionary objectForKey:@"tags"]) {
-            LFMTag *tag = [[LFMTag alloc] initFromDictionary:tagDictionary];
-            tag == nil ?: [tags addObject:tag];
-        }
-        
+    return LFMEndpointDataTask(LFMEndpointTrackGetTags, LFMParameters(trackName, artistName, mbid, @(autoCorrect), userName), [LFMSession sharedSession].sessionKey, ^(NSError *error, NSArray<LFMTag *> *tags, id query) {
         block(error, tags);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)getTopTagsForTrackNamed:(NSString *)trackName
@@ -484,39 +453,9 @@
                                          callback:(void (^)(NSError * _Nullable, NSArray<LFMTopTag *> * _Nonnull))block {
     NSAssert((trackName != nil && artistName != nil) || (mbid != nil), @"Either the trackName and the artistName or the mbid parameter must be set.");
     
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"track.getTopTags"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"track" value:trackName],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"mbid" value:mbid],
-                            [NSURLQueryItem queryItemWithName:@"autocorrect" value:[NSString stringWithFormat:@"%d", autoCorrect]],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[]);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        NSMutableArray <LFMTopTag *> *tags = [NSMutableArray array];
-        
-        for (NSDictionary *tagDictionary in [[responseDictionary objectForKey:@"toptags"] objectForKey:@"tag"]) {
-            LFMTopTag *tag = [[LFMTopTag alloc] initFromDictionary:tagDictionary];
-            tag == nil ?: [tags addObject:tag];
-        }
-        
+    return LFMEndpointDataTask(LFMEndpointTrackGetTopTags, LFMParameters(trackName, artistName, mbid, @(autoCorrect)), nil, ^(NSError *error, NSArray<LFMTopTag *> *tags, id query) {
         block(error, tags);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 @end
@@ -27,7 +27,7 @@
 #import "LFMTaggingType.h"
 #import "LFMTimePeriod.h"
 
-@class LFMUser, LFMQuery, LFMTrack, LFMAlbum, LFMArtist, LFMTopTag, LFMChart;
+@class LFMUser, LFMQuery, LFMTrack, LFMAlbum, LFMArtist, LFMTopTag, LFMChart, LFMPager<ObjectType>;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -99,6 +99,19 @@ NS_SWIFT_NAME(UserProvider)
                                              onPage:(NSUInteger)page
                                            callback:(void(^)(NSError * _Nullable, NSArray<LFMTrack *> *, LFMQuery * _Nullable))block NS_SWIFT_NAME(getTracksLoved(by:limit:on:callback:));
 
+/**
+ Creates a pager that streams every track a user has loved, fetching pages ahead of the one being consumed.
+ 
+ @param userName        The user for whom to fetch the loved tracks.
+ @param limit           The amount of tracks fetched per page.
+ @param prefetchLimit   The maximum amount of pages requested ahead of the page being consumed.
+ 
+ @return   An `LFMPager` object. No requests are made until the first page is asked for.
+ */
++ (LFMPager<LFMTrack *> *)pagerForTracksLovedByUserNamed:(NSString *)userName
+                                            itemsPerPage:(NSUInteger)limit
+                                           prefetchLimit:(NSUInteger)prefetchLimit NS_SWIFT_NAME(tracksLovedPager(by:limit:prefetchLimit:));
+
 /**
  Retrieves items to which the user added personal tags.
  
@@ -137,6 +150,46 @@ NS_SWIFT_NAME(UserProvider)
                                             toEndDate:(nullable NSDate *)endDate
                                              callback:(void(^)(NSError * _Nullable, NSArray<LFMTrack *> *, LFMQuery * _Nullable))block NS_SWIFT_NAME(getRecentTracks(for:limit:on:from:to:callback:));
 
+/**
+ Retrieves a page of the recent tracks listened to by this user, handing each track over as soon as it has been downloaded rather than once the whole page has. Tracks are decoded while the response arrives and never held together in memory, which makes this suitable for large pages.
+ 
+ @note  Unlike other requests, streamed requests are not cached or coalesced.
+ 
+ @param userName        The user for whom to fetch recent tracks.
+ @param limit           The maximum number of items to be returned.
+ @param page            The page of results to be fetched. Start page is 1.
+ @param startDate       The earliest date from which to fetch tracks.
+ @param endDate         The latest date from which to fetch tracks.
+ @param trackHandler    The block each `LFMTrack` is passed to, in order, on the client's delegate queue.
+ @param block           The callback block containing an optional `NSError` if the request fails and an `LFMQuery` object if it succeeds. It is called after the last track has been handed over.
+ 
+ @return    The `NSURLSessionDataTask` object from the web request.
+ */
++ (NSURLSessionDataTask *)streamRecentTracksForUserNamed:(NSString *)userName
+                                            itemsPerPage:(NSUInteger)limit
+                                                  onPage:(NSUInteger)page
+                                           fromStartDate:(nullable NSDate *)startDate
+                                               toEndDate:(nullable NSDate *)endDate
+                                            trackHandler:(void(^)(LFMTrack *))trackHandler
+                                                callback:(void(^)(NSError * _Nullable, LFMQuery * _Nullable))block NS_SWIFT_NAME(streamRecentTracks(for:limit:on:from:to:trackHandler:callback:));
+
+/**
+ Creates a pager that streams the tracks a user has listened to, most recent first, fetching pages ahead of the one being consumed.
+ 
+ @param userName        The user for whom to fetch recent tracks.
+ @param limit           The amount of tracks fetched per page.
+ @param startDate       The earliest date from which to fetch tracks.
+ @param endDate         The latest date from which to fetch tracks. If `nil`, the time the pager was created is used so that tracks scrobbled while paging don't shift the pages.
+ @param prefetchLimit   The maximum amount of pages requested ahead of the page being consumed.
+ 
+ @return   An `LFMPager` object. No requests are made until the first page is asked for.
+ */
++ (LFMPager<LFMTrack *> *)pagerForRecentTracksForUserNamed:(NSString *)userName
+                                              itemsPerPage:(NSUInteger)limit
+                                             fromStartDate:(nullable NSDate *)startDate
+                                                 toEndDate:(nullable NSDate *)endDate
+                                             prefetchLimit:(NSUInteger)prefetchLimit NS_SWIFT_NAME(recentTracksPager(for:limit:from:to:prefetchLimit:));
+
 /**
  Retrieves the top albums listened to by a user. The period can be stipulated. Sends the overall chart by default.
  
@@ -24,46 +24,29 @@
 //
 
 #import "LFMUserProvider.h"
-#import "LFMAuth.h"
 #import "LFMSession.h"
 #import "LFMUser.h"
-#import "LFMError.h"
+#import "LFMClient.h"
 #import "LFMKit+Protected.h"
 #import "LFMTrack.h"
 #import "LFMAlbum.h"
 #import "LFMArtist.h"
 #import "LFMTopTag.h"
 #import "LFMChart.h"
+#import "LFMPager.h"
+
+/** The values of the `from` and `to` parameters of `user.getRecentTracks`, which are left out when there is no date. */
+static NSString *LFMRecentTracksTimestamp(NSDate *date) {
+    return date == nil ? nil : [NSString stringWithFormat:@"%lld", (long long)date.timeIntervalSince1970];
+}
 
 @implementation LFMUserProvider
 
 + (NSURLSessionDataTask *)getInfoOnUserNamed:(NSString *)userName
                                     callback:(void (^)(NSError * _Nullable, LFMUser * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getInfo"],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, nil);
-        
-        NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
-        
-        LFMUser *user = [[LFMUser alloc] initFromDictionary:[responseDictionary objectForKey:@"user"]];
-        
+    return LFMEndpointDataTask(LFMEndpointUserGetInfo, LFMParameters(userName), nil, ^(NSError *error, LFMUser *user, id query) {
         block(error, user);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)getFriendsOfUserNamed:(NSString *)userName
@@ -71,41 +54,7 @@
                                    itemsPerPage:(NSUInteger)limit
                                          onPage:(NSUInteger)page
                                        callback:(void (^)(NSError * _Nullable, NSArray<LFMUser *> * _Nonnull, LFMQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getFriends"],
-                            [NSURLQueryItem queryItemWithName:@"recenttracks" value:[NSString stringWithFormat:@"%d", includeRecents]],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"friends"];
-        
-        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:[responseDictionary objectForKey:@"@attr"]];
-        
-        NSMutableArray <LFMUser *> *users = [NSMutableArray array];
-        
-        for (NSDictionary *userDictionary in [responseDictionary objectForKey:@"user"]) {
-            LFMUser *user = [[LFMUser alloc] initFromDictionary:userDictionary];
-            user == nil ?: [users addObject:user];
-        }
-        
-        block(error, users, query);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointUserGetFriends, LFMParameters(@(includeRecents), @(limit), @(page), userName), nil, block);
 }
 
 + (NSURLSessionDataTask *)getTracksScrobbledByUserNamed:(NSString *)userName
@@ -114,82 +63,25 @@
                                           fromStartDate:(NSDate *)startDate
                                               toEndDate:(NSDate *)endDate
                                                callback:(void (^)(NSError * _Nullable, NSArray<LFMTrack *> * _Nonnull, LFMQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getArtistTracks"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"artist" value:artistName],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"startTimestamp" value:[NSString stringWithFormat:@"%f", startDate.timeIntervalSince1970]],
-                            [NSURLQueryItem queryItemWithName:@"endTimestamp" value:[NSString stringWithFormat:@"%f", endDate.timeIntervalSince1970]],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"artisttracks"];
-        
-        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:[responseDictionary objectForKey:@"@attr"]];
-        
-        NSMutableArray <LFMTrack *> *tracks = [NSMutableArray array];
-        
-        for (NSDictionary *trackDictionary in [responseDictionary objectForKey:@"track"]) {
-            LFMTrack *track = [[LFMTrack alloc] initFromDictionary:trackDictionary];
-            track == nil ?: [tracks addObject:track];
-        }
-        
-        block(error, tracks, query);
-    }];
-    
-    [dataTask resume];
+    NSString *startTimestamp = [NSString stringWithFormat:@"%f", startDate.timeIntervalSince1970];
+    NSString *endTimestamp = [NSString stringWithFormat:@"%f", endDate.timeIntervalSince1970];
     
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointUserGetArtistTracks, LFMParameters(userName, artistName, @(page), startTimestamp, endTimestamp), nil, block);
 }
 
 + (NSURLSessionDataTask *)getTracksLovedByUserNamed:(NSString *)userName
                                        itemsPerPage:(NSUInteger)limit
                                              onPage:(NSUInteger)page
                                            callback:(void (^)(NSError * _Nullable, NSArray<LFMTrack *> * _Nonnull, LFMQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getLovedTracks"],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"lovedtracks"];
-        
-        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:[responseDictionary objectForKey:@"@attr"]];
-        
-        NSMutableArray <LFMTrack *> *tracks = [NSMutableArray array];
-        
-        for (NSDictionary *trackDictionary in [responseDictionary objectForKey:@"track"]) {
-            LFMTrack *track = [[LFMTrack alloc] initFromDictionary:trackDictionary];
-            track == nil ?: [tracks addObject:track];
-        }
-        
-        block(error, tracks, query);
+    return LFMEndpointDataTask(LFMEndpointUserGetLovedTracks, LFMParameters(@(limit), @(page), userName), nil, block);
+}
+
++ (LFMPager<LFMTrack *> *)pagerForTracksLovedByUserNamed:(NSString *)userName
+                                            itemsPerPage:(NSUInteger)limit
+                                           prefetchLimit:(NSUInteger)prefetchLimit {
+    return [[LFMPager alloc] initWithPrefetchLimit:prefetchLimit pageFetcher:^NSURLSessionDataTask *(NSUInteger page, LFMPageCallback callback) {
+        return [LFMUserProvider getTracksLovedByUserNamed:userName itemsPerPage:limit onPage:page callback:callback];
     }];
-    
-    [dataTask resume];
-    
-    return dataTask;
 }
 
 + (NSURLSessionDataTask *)getItemsTaggedByUserNamed:(NSString *)userName
@@ -198,54 +90,28 @@
                                        itemsPerPage:(NSUInteger)limit
                                              onPage:(NSUInteger)page
                                            callback:(void (^)(NSError * _Nullable, NSArray * _Nonnull, LFMQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getPersonalTags"],
-                            [NSURLQueryItem queryItemWithName:@"tag" value:tagName],
-                            [NSURLQueryItem queryItemWithName:@"taggingtype" value:type],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"taggings"];
-        
-        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:[responseDictionary objectForKey:@"@attr"]];
-        
-        NSMutableArray *items = [NSMutableArray array];
-        
-        for (NSDictionary *itemDictionary in [[responseDictionary objectForKey:[NSString stringWithFormat:@"%@s", type]] objectForKey:type]) {
-            NSObject *item = nil;
-            
-            if ([type isEqualToString:LFMTaggingTypeTrack]) {
-                item = [[LFMTrack alloc] initFromDictionary:itemDictionary];
-            } else if ([type isEqualToString:LFMTaggingTypeAlbum]) {
-                item = [[LFMAlbum alloc] initFromDictionary:itemDictionary];
-            } else if ([type isEqualToString:LFMTaggingTypeArtist]) {
-                item = [[LFMArtist alloc] initFromDictionary:itemDictionary];
-            } else {
-                NSAssert(false, @"Unknown `type` parameter. Type must be either: `LFMTaggingTypeTrack`, `LFMTaggingTypeAlbum` or `LFMTaggingTypeArtist`");
-                return;
-            }
-            
-            item == nil ?: [items addObject:item];
+    return LFMEndpointDataTask(LFMEndpointUserGetPersonalTags, LFMParameters(tagName, type, @(limit), @(page), userName), nil, ^(NSError *error, NSDictionary *responseObject, LFMQuery *query) {
+        if (error != nil) return block(error, @[], nil);
+        
+        NSDictionary *responseDictionary = [responseObject objectForKey:@"taggings"];
+        
+        Class itemClass = nil;
+        
+        if ([type isEqualToString:LFMTaggingTypeTrack]) {
+            itemClass = [LFMTrack class];
+        } else if ([type isEqualToString:LFMTaggingTypeAlbum]) {
+            itemClass = [LFMAlbum class];
+        } else if ([type isEqualToString:LFMTaggingTypeArtist]) {
+            itemClass = [LFMArtist class];
+        } else {
+            NSAssert(false, @"Unknown `type` parameter. Type must be either: `LFMTaggingTypeTrack`, `LFMTaggingTypeAlbum` or `LFMTaggingTypeArtist`");
+            return;
         }
         
+        NSArray *items = LFMModelArray(itemClass, [[responseDictionary objectForKey:[NSString stringWithFormat:@"%@s", type]] objectForKey:type]);
+        
         block(error, items, query);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)getRecentTracksForUserNamed:(NSString *)userName
@@ -254,85 +120,51 @@
                                         fromStartDate:(NSDate *)startDate
                                             toEndDate:(NSDate *)endDate
                                              callback:(void (^)(NSError * _Nullable, NSArray<LFMTrack *> * _Nonnull, LFMQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getRecentTracks"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"extended" value:@"1"],
-                            [NSURLQueryItem queryItemWithName:@"startTimestamp" value:[NSString stringWithFormat:@"%f", startDate.timeIntervalSince1970]],
-                            [NSURLQueryItem queryItemWithName:@"endTimestamp" value:[NSString stringWithFormat:@"%f", endDate.timeIntervalSince1970]],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"recenttracks"];
-        
-        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:[responseDictionary objectForKey:@"@attr"]];
-        
-        NSMutableArray <LFMTrack *> *tracks = [NSMutableArray array];
-        
-        for (NSDictionary *trackDictionary in [responseDictionary objectForKey:@"track"]) {
-            LFMTrack *track = [[LFMTrack alloc] initFromDictionary:trackDictionary];
-            track == nil ?: [tracks addObject:track];
-        }
-        
-        block(error, tracks, query);
+    return LFMEndpointDataTask(LFMEndpointUserGetRecentTracks, LFMParameters(userName, @(limit), @(page), @"1", LFMRecentTracksTimestamp(startDate), LFMRecentTracksTimestamp(endDate)), nil, block);
+}
+
++ (NSURLSessionDataTask *)streamRecentTracksForUserNamed:(NSString *)userName
+                                            itemsPerPage:(NSUInteger)limit
+                                                  onPage:(NSUInteger)page
+                                           fromStartDate:(NSDate *)startDate
+                                               toEndDate:(NSDate *)endDate
+                                            trackHandler:(void (^)(LFMTrack * _Nonnull))trackHandler
+                                                callback:(void (^)(NSError * _Nullable, LFMQuery * _Nullable))block {
+    NSURLRequest *request = LFMEndpointRequest(LFMEndpointUserGetRecentTracks, LFMParameters(userName, @(limit), @(page), @"1", LFMRecentTracksTimestamp(startDate), LFMRecentTracksTimestamp(endDate)), nil);
+    
+    NSURLSessionDataTask *dataTask = [[LFMClient sharedClient] streamingDataTaskWithRequest:request itemPath:LFMEndpointModelPath(LFMEndpointUserGetRecentTracks) itemHandler:^(NSDictionary *trackDictionary) {
+        LFMTrack *track = [trackDictionary isKindOfClass:[NSDictionary class]] ? [[LFMTrack alloc] initFromDictionary:trackDictionary] : nil;
+        track == nil ?: trackHandler(track);
+    } callback:^(NSError *error, NSDictionary *responseDictionary) {
+        if (error != nil) return block(error, nil);
+        
+        id query = nil;
+        LFMEndpointDecodeResponse(LFMEndpointUserGetRecentTracks, responseDictionary, &query);
+        
+        block(error, query);
     }];
     
-    [dataTask resume];
-    
     return dataTask;
 }
 
++ (LFMPager<LFMTrack *> *)pagerForRecentTracksForUserNamed:(NSString *)userName
+                                              itemsPerPage:(NSUInteger)limit
+                                             fromStartDate:(NSDate *)startDate
+                                                 toEndDate:(NSDate *)endDate
+                                             prefetchLimit:(NSUInteger)prefetchLimit {
+    NSDate *pinnedEndDate = endDate ?: [NSDate date];
+    
+    return [[LFMPager alloc] initWithPrefetchLimit:prefetchLimit pageFetcher:^NSURLSessionDataTask *(NSUInteger page, LFMPageCallback callback) {
+        return [LFMUserProvider getRecentTracksForUserNamed:userName itemsPerPage:limit onPage:page fromStartDate:startDate toEndDate:pinnedEndDate callback:callback];
+    }];
+}
+
 + (NSURLSessionDataTask *)getTopAlbumsForUserNamed:(NSString *)userName
                                       itemsPerPage:(NSUInteger)limit
                                             onPage:(NSUInteger)page
                                         overPeriod:(LFMTimePeriod)period
                                           callback:(void (^)(NSError * _Nullable, NSArray<LFMAlbum *> * _Nonnull, LFMQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getTopAlbums"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"period" value:period],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"topalbums"];
-        
-        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:[responseDictionary objectForKey:@"@attr"]];
-        
-        NSMutableArray <LFMAlbum *> *albums = [NSMutableArray array];
-        
-        for (NSDictionary *albumDictionary in [responseDictionary objectForKey:@"album"]) {
-            LFMAlbum *album = [[LFMAlbum alloc] initFromDictionary:albumDictionary];
-            album == nil ?: [albums addObject:album];
-        }
-        
-        block(error, albums, query);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointUserGetTopAlbums, LFMParameters(userName, @(limit), @(page), period), nil, block);
 }
 
 + (NSURLSessionDataTask *)getTopArtistsForUserNamed:(NSString *)userName
@@ -340,41 +172,7 @@
                                              onPage:(NSUInteger)page
                                          overPeriod:(LFMTimePeriod)period
                                            callback:(void (^)(NSError * _Nullable, NSArray<LFMArtist *> * _Nonnull, LFMQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getTopArtists"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"period" value:period],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"topartists"];
-        
-        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:[responseDictionary objectForKey:@"@attr"]];
-        
-        NSMutableArray <LFMArtist *> *artists = [NSMutableArray array];
-        
-        for (NSDictionary *artistDictionary in [responseDictionary objectForKey:@"artist"]) {
-            LFMArtist *artist = [[LFMArtist alloc] initFromDictionary:artistDictionary];
-            artist == nil ?: [artists addObject:artist];
-        }
-        
-        block(error, artists, query);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointUserGetTopArtists, LFMParameters(userName, @(limit), @(page), period), nil, block);
 }
 
 + (NSURLSessionDataTask *)getTopTracksForUserNamed:(NSString *)userName
@@ -382,225 +180,58 @@
                                             onPage:(NSUInteger)page
                                         overPeriod:(LFMTimePeriod)period
                                           callback:(void (^)(NSError * _Nullable, NSArray<LFMTrack *> * _Nonnull, LFMQuery * _Nullable))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getTopTracks"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"page" value:[NSString stringWithFormat:@"%tu", page]],
-                            [NSURLQueryItem queryItemWithName:@"period" value:period],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[], nil);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"toptracks"];
-        
-        LFMQuery *query = [[LFMQuery alloc] initFromDictionary:[responseDictionary objectForKey:@"@attr"]];
-        
-        NSMutableArray <LFMTrack *> *tracks = [NSMutableArray array];
-        
-        for (NSDictionary *trackDictionary in [responseDictionary objectForKey:@"track"]) {
-            LFMTrack *track = [[LFMTrack alloc] initFromDictionary:trackDictionary];
-            track == nil ?: [tracks addObject:track];
-        }
-        
-        block(error, tracks, query);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    return LFMEndpointDataTask(LFMEndpointUserGetTopTracks, LFMParameters(userName, @(limit), @(page), period), nil, block);
 }
 
 + (NSURLSessionDataTask *)getTopTagsForUserNamed:(NSString *)userName
                                            limit:(NSUInteger)limit
                                         callback:(void (^)(NSError * _Nullable, NSArray<LFMTopTag *> * _Nonnull))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getTopTags"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"limit" value:[NSString stringWithFormat:@"%tu", limit]],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[]);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"toptags"];
-        
-        NSMutableArray <LFMTopTag *> *tags = [NSMutableArray array];
-        
-        for (NSDictionary *tagDictionary in [responseDictionary objectForKey:@"tag"]) {
-            LFMTopTag *tag = [[LFMTopTag alloc] initFromDictionary:tagDictionary];
-            tag == nil ?: [tags addObject:tag];
-        }
-        
+    return LFMEndpointDataTask(LFMEndpointUserGetTopTags, LFMParameters(userName, @(limit)), nil, ^(NSError *error, NSArray<LFMTopTag *> *tags, id query) {
         block(error, tags);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)getWeeklyAlbumChartForUserNamed:(NSString *)userName
                                             fromStartDate:(NSDate *)startDate
                                                 toEndDate:(NSDate *)endDate
                                                  callback:(void (^)(NSError * _Nullable, NSArray<LFMAlbum *> * _Nonnull))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getWeeklyAlbumChart"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"from" value:[NSString stringWithFormat:@"%f", startDate.timeIntervalSince1970]],
-                            [NSURLQueryItem queryItemWithName:@"to" value:[NSString stringWithFormat:@"%f", endDate.timeIntervalSince1970]],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
+    NSString *from = [NSString stringWithFormat:@"%f", startDate.timeIntervalSince1970];
+    NSString *to = [NSString stringWithFormat:@"%f", endDate.timeIntervalSince1970];
     
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[]);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"weeklyalbumchart"];
-        
-        NSMutableArray <LFMAlbum *> *albums = [NSMutableArray array];
-        
-        for (NSDictionary *albumDictionary in [responseDictionary objectForKey:@"album"]) {
-            LFMAlbum *album = [[LFMAlbum alloc] initFromDictionary:albumDictionary];
-            album == nil ?: [albums addObject:album];
-        }
-        
+    return LFMEndpointDataTask(LFMEndpointUserGetWeeklyAlbumChart, LFMParameters(userName, from, to), nil, ^(NSError *error, NSArray<LFMAlbum *> *albums, id query) {
         block(error, albums);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)getWeeklyArtistChartForUserNamed:(NSString *)userName
                                              fromStartDate:(NSDate *)startDate
                                                  toEndDate:(NSDate *)endDate
                                                   callback:(void (^)(NSError * _Nullable, NSArray<LFMArtist *> * _Nonnull))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getWeeklyArtistChart"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"from" value:[NSString stringWithFormat:@"%f", startDate.timeIntervalSince1970]],
-                            [NSURLQueryItem queryItemWithName:@"to" value:[NSString stringWithFormat:@"%f", endDate.timeIntervalSince1970]],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
+    NSString *from = [NSString stringWithFormat:@"%f", startDate.timeIntervalSince1970];
+    NSString *to = [NSString stringWithFormat:@"%f", endDate.timeIntervalSince1970];
     
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[]);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"weeklyartistchart"];
-        
-        NSMutableArray <LFMArtist *> *artists = [NSMutableArray array];
-        
-        for (NSDictionary *artistDictionary in [responseDictionary objectForKey:@"artist"]) {
-            LFMArtist *artist = [[LFMArtist alloc] initFromDictionary:artistDictionary];
-            artist == nil ?: [artists addObject:artist];
-        }
-        
+    return LFMEndpointDataTask(LFMEndpointUserGetWeeklyArtistChart, LFMParameters(userName, from, to), nil, ^(NSError *error, NSArray<LFMArtist *> *artists, id query) {
         block(error, artists);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)getWeeklyTrackChartForUserNamed:(NSString *)userName
                                             fromStartDate:(NSDate *)startDate
                                                 toEndDate:(NSDate *)endDate
                                                  callback:(void (^)(NSError * _Nullable, NSArray<LFMTrack *> * _Nonnull))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getWeeklyTrackChart"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"from" value:[NSString stringWithFormat:@"%f", startDate.timeIntervalSince1970]],
-                            [NSURLQueryItem queryItemWithName:@"to" value:[NSString stringWithFormat:@"%f", endDate.timeIntervalSince1970]],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
+    NSString *from = [NSString stringWithFormat:@"%f", startDate.timeIntervalSince1970];
+    NSString *to = [NSString stringWithFormat:@"%f", endDate.timeIntervalSince1970];
     
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[]);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"weeklytrackchart"];
-        
-        NSMutableArray <LFMTrack *> *tracks = [NSMutableArray array];
-        
-        for (NSDictionary *trackDictionary in [responseDictionary objectForKey:@"track"]) {
-            LFMTrack *track = [[LFMTrack alloc] initFromDictionary:trackDictionary];
-            track == nil ?: [tracks addObject:track];
-        }
-        
+    return LFMEndpointDataTask(LFMEndpointUserGetWeeklyTrackChart, LFMParameters(userName, from, to), nil, ^(NSError *error, NSArray<LFMTrack *> *tracks, id query) {
         block(error, tracks);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 + (NSURLSessionDataTask *)getWeeklyChartListForUserNamed:(NSString *)userName
                                                 callback:(void (^)(NSError * _Nullable, NSArray<LFMChart *> * _Nonnull))block {
-    NSURLSession *session = [NSURLSession sharedSession];
-    
-    NSURLComponents *components = [NSURLComponents componentsWithString:@"https://ws.audioscrobbler.com/2.0"];
-    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"user.getWeeklyChartList"],
-                            [NSURLQueryItem queryItemWithName:@"user" value:userName],
-                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
-                            [NSURLQueryItem queryItemWithName:@"api_key" value:[LFMAuth sharedInstance].apiKey]];
-    
-    components.queryItems = queryItems;
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
-    
-    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error != nil || data == nil || !lfm_error_validate(data, &error)) return block(error, @[]);
-        
-        NSDictionary *responseDictionary = [[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error] objectForKey:@"weeklychartlist"];
-        
-        NSMutableArray <LFMChart *> *charts = [NSMutableArray array];
-        
-        for (NSDictionary *chartDictionary in [responseDictionary objectForKey:@"chart"]) {
-            LFMChart *chart = [[LFMChart alloc] initFromDictionary:chartDictionary];
-            chart == nil ?: [charts addObject:chart];
-        }
-        
+    return LFMEndpointDataTask(LFMEndpointUserGetWeeklyChartList, LFMParameters(userName), nil, ^(NSError *error, NSArray<LFMChart *> *charts, id query) {
         block(error, charts);
-    }];
-    
-    [dataTask resume];
-    
-    return dataTask;
+    });
 }
 
 @end
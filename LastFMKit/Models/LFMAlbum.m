@@ -33,7 +33,7 @@
     NSString *_name;
     NSString *_artist;
     NSURL *_URL;
-    NSDictionary<LFMImageSize, NSURL *> *_images;
+    LFMImageSet *_imageSet;
     BOOL _streamable;
     NSString *_mbid;
     NSUInteger _listeners;
@@ -41,6 +41,11 @@
     NSArray <LFMTrack *> *_tracks;
     NSArray <LFMTag *> *_tags;
     LFMWiki *_wiki;
+    
+    // The parts of the response nested models are built from the first time they are asked for.
+    id _tracksJSON;
+    id _tagsJSON;
+    NSDictionary *_wikiJSON;
 }
 
 - (instancetype)initFromDictionary:(NSDictionary *)dictionary {
@@ -60,40 +65,26 @@
             streamableString != nil &&
             mbid != nil)
         {
-            NSDictionary *images = imageDictionaryFromArray([dictionary objectForKey:@"image"]);
+            LFMImageSet *imageSet = [LFMImageSet imageSetFromArray:[dictionary objectForKey:@"image"]];
             
             // Advanced variables that are only aquired on a `getInfo` call to Album.
-            NSUInteger listeners = [[dictionary objectForKey:@"listeners"] unsignedIntegerValue];
-            NSUInteger playCount = [[dictionary objectForKey:@"playcount"] unsignedIntegerValue];
-            NSMutableArray <LFMTrack *> *tracks = [NSMutableArray array];
-            
-            for (NSDictionary *trackDictionary in [[dictionary objectForKey:@"tracks"] objectForKey:@"track"]) {
-                LFMTrack *track = [[LFMTrack alloc] initFromDictionary:trackDictionary];
-                track == nil ?: [tracks addObject: track];
-            }
-            
-            NSMutableArray <LFMTag *> *tags = [NSMutableArray array];
-            
-            for (NSDictionary *tagDictionary in [[dictionary objectForKey:@"tags"] objectForKey:@"tag"]) {
-                LFMTag *tag = [[LFMTag alloc] initFromDictionary:tagDictionary];
-                tag == nil ?: [tags addObject: tag];
-            }
-            
-            LFMWiki *wiki = [[LFMWiki alloc] initFromDictionary:[dictionary objectForKey:@"wiki"]];
+            NSUInteger listeners = LFMUnsignedIntegerValue([dictionary objectForKey:@"listeners"]);
+            NSUInteger playCount = LFMUnsignedIntegerValue([dictionary objectForKey:@"playcount"]);
             
             _name = name;
-            _artist = artist;
+            _artist = artist.internedString;
             _URL = URL;
-            _images = images;
+            _imageSet = imageSet;
             _streamable = [streamableString boolValue];
             _mbid = mbid;
             _listeners = listeners;
             _playCount = playCount;
-            _tracks = tracks;
-            _tags = tags;
-            _wiki = wiki;
+            _tracksJSON = [[dictionary objectForKey:@"tracks"] objectForKey:@"track"];
+            _tagsJSON = [[dictionary objectForKey:@"tags"] objectForKey:@"tag"];
+            _wikiJSON = [dictionary objectForKey:@"wiki"];
             
-            return self;
+            LFMIdentityMap *identityMap = [LFMIdentityMap sharedMap];
+            return identityMap == nil ? self : [identityMap canonicalModel:self kind:@"album" name:[NSString stringWithFormat:@"%@\t%@", artist, name]];
         }
     }
     
@@ -113,7 +104,13 @@
 }
 
 - (NSDictionary<LFMImageSize,NSURL *> *)images {
-    return _images;
+    return self.imageSet.dictionary ?: @{};
+}
+
+- (LFMImageSet *)imageSet {
+    @synchronized (self) {
+        return _imageSet;
+    }
 }
 
 - (BOOL)isStreamable {
@@ -121,27 +118,129 @@
 }
 
 - (NSString *)mbid {
-    return _mbid;
+    @synchronized (self) {
+        return _mbid;
+    }
 }
 
 - (NSUInteger)listeners {
-    return _listeners;
+    @synchronized (self) {
+        return _listeners;
+    }
 }
 
 - (NSUInteger)playCount {
-    return _playCount;
+    @synchronized (self) {
+        return _playCount;
+    }
 }
 
 - (NSArray<LFMTrack *> *)tracks {
-    return _tracks;
+    id JSON = nil;
+    
+    @synchronized (self) {
+        if (_tracks != nil) return _tracks;
+        JSON = _tracksJSON;
+    }
+    
+    // Built without holding the lock: the tracks' artists go through the identity map, which may merge into - and so lock - them.
+    NSArray<LFMTrack *> *tracks = LFMModelArray([LFMTrack class], JSON);
+    
+    @synchronized (self) {
+        if (_tracks == nil && _tracksJSON == JSON) {
+            _tracks = tracks;
+            _tracksJSON = nil;
+        }
+        
+        return _tracks ?: tracks;
+    }
 }
 
 - (NSArray<LFMTag *> *)tags {
-    return _tags;
+    @synchronized (self) {
+        if (_tags == nil) {
+            _tags = LFMModelArray([LFMTag class], _tagsJSON);
+            _tagsJSON = nil;
+        }
+        
+        return _tags;
+    }
 }
 
 - (LFMWiki *)wiki {
-    return _wiki;
+    @synchronized (self) {
+        if (_wikiJSON != nil) {
+            _wiki = [[LFMWiki alloc] initFromDictionary:_wikiJSON];
+            _wikiJSON = nil;
+        }
+        
+        return _wiki;
+    }
+}
+
+#pragma mark - LFMIdentifiableModel
+
+- (void)mergeDetailsFromModel:(LFMAlbum *)album {
+    @synchronized (self) {
+        if (_mbid.length == 0) _mbid = album->_mbid;
+        if (album->_imageSet.count > _imageSet.count) _imageSet = album->_imageSet;
+        
+        // Statistics only come with `album.getInfo`, and are newer than the ones held.
+        if (album->_listeners > 0 || album->_playCount > 0) {
+            _listeners = album->_listeners;
+            _playCount = album->_playCount;
+        }
+        
+        if (album->_tracksJSON != nil) {
+            _tracks = nil;
+            _tracksJSON = album->_tracksJSON;
+        }
+        
+        if (album->_tagsJSON != nil) {
+            _tags = nil;
+            _tagsJSON = album->_tagsJSON;
+        }
+        
+        if (album->_wikiJSON != nil) _wikiJSON = album->_wikiJSON;
+    }
+}
+
+#pragma mark - LFMSnapshotCoding
+
+- (void)encodeWithSnapshotEncoder:(LFMSnapshotEncoder *)encoder {
+    [encoder encodeString:_name];
+    [encoder encodeString:_artist];
+    [encoder encodeURL:_URL];
+    [encoder encodeImages:self.imageSet];
+    [encoder encodeBool:_streamable];
+    [encoder encodeString:self.mbid];
+    [encoder encodeUnsignedInteger:self.listeners];
+    [encoder encodeUnsignedInteger:self.playCount];
+    [encoder encodeArrayOfObjects:self.tracks];
+    [encoder encodeArrayOfObjects:self.tags];
+    [encoder encodeObject:self.wiki];
+}
+
+- (instancetype)initWithSnapshotDecoder:(LFMSnapshotDecoder *)decoder {
+    self = [super init];
+    
+    if (self) {
+        _name = [decoder decodeString];
+        _artist = [decoder decodeString];
+        _URL = [decoder decodeURL];
+        _imageSet = [decoder decodeImages];
+        _streamable = [decoder decodeBool];
+        _mbid = [decoder decodeString];
+        _listeners = [decoder decodeUnsignedInteger];
+        _playCount = [decoder decodeUnsignedInteger];
+        _tracks = [decoder decodeArrayOfObjectsOfClass:[LFMTrack class]];
+        _tags = [decoder decodeArrayOfObjectsOfClass:[LFMTag class]];
+        _wiki = [decoder decodeObjectOfClass:[LFMWiki class]];
+        
+        if (_name == nil || _artist == nil || _URL == nil || _mbid == nil) return nil;
+    }
+    
+    return self;
 }
 
 @end
@@ -32,7 +32,7 @@
     NSString *_name;
     NSString *_mbid;
     NSURL *_URL;
-    NSDictionary<LFMImageSize, NSURL *> *_images;
+    LFMImageSet *_imageSet;
     BOOL _streamable;
     BOOL _onTour;
     NSUInteger _listeners;
@@ -40,6 +40,11 @@
     NSArray<LFMArtist *> *_similarArtists;
     NSArray <LFMTag *> *_tags;
     LFMWiki *_wiki;
+    
+    // The parts of the response nested models are built from the first time they are asked for.
+    id _similarArtistsJSON;
+    id _tagsJSON;
+    NSDictionary *_wikiJSON;
 }
 
 - (instancetype)initFromDictionary:(NSDictionary *)dictionary {
@@ -58,41 +63,26 @@
             streamableString != nil)
         {
             // Advanced variables that are only aquired on a `getInfo` call to Artist.
-            NSDictionary *images = imageDictionaryFromArray([dictionary objectForKey:@"image"]);
-            
-            NSMutableArray<LFMArtist *> *similarArtists = [NSMutableArray array];
-            
-            for (NSDictionary *similarArtistDictionary in [[dictionary objectForKey:@"similar"] objectForKey:@"artist"]) {
-                LFMArtist *artist = [[LFMArtist alloc] initFromDictionary:similarArtistDictionary];
-                artist == nil ?: [similarArtists addObject:artist];
-            }
-            
-            NSMutableArray<LFMTag *> *tags = [NSMutableArray array];
+            LFMImageSet *imageSet = [LFMImageSet imageSetFromArray:[dictionary objectForKey:@"image"]];
             
-            for (NSDictionary *tagDictionary in [[dictionary objectForKey:@"tags"] objectForKey:@"tag"]) {
-                LFMTag *tag = [[LFMTag alloc] initFromDictionary:tagDictionary];
-                tag == nil ?: [tags addObject:tag];
-            }
-            
-            NSUInteger listeners = [[[dictionary objectForKey:@"stats"] objectForKey:@"listeners"] unsignedIntegerValue];
-            NSUInteger playCount = [[[dictionary objectForKey:@"stats"] objectForKey:@"playcount"] unsignedIntegerValue];
+            NSUInteger listeners = LFMUnsignedIntegerValue([[dictionary objectForKey:@"stats"] objectForKey:@"listeners"]);
+            NSUInteger playCount = LFMUnsignedIntegerValue([[dictionary objectForKey:@"stats"] objectForKey:@"playcount"]);
             BOOL onTour = [[dictionary objectForKey:@"ontour"] boolValue];
             
-            LFMWiki *wiki = [[LFMWiki alloc] initFromDictionary:[dictionary objectForKey:@"bio"]];
-            
-            _name = name;
+            _name = name.internedString;
             _mbid = mbid;
             _URL = URL;
             _streamable = [streamableString boolValue];
-            _images = images;
-            _similarArtists = similarArtists;
-            _tags = tags;
+            _imageSet = imageSet;
+            _similarArtistsJSON = [[dictionary objectForKey:@"similar"] objectForKey:@"artist"];
+            _tagsJSON = [[dictionary objectForKey:@"tags"] objectForKey:@"tag"];
             _listeners = listeners;
             _playCount = playCount;
             _onTour = onTour;
-            _wiki = wiki;
+            _wikiJSON = [dictionary objectForKey:@"bio"];
             
-            return self;
+            LFMIdentityMap *identityMap = [LFMIdentityMap sharedMap];
+            return identityMap == nil ? self : [identityMap canonicalModel:self kind:@"artist" name:name];
         }
     }
     
@@ -104,7 +94,9 @@
 }
 
 - (NSString *)mbid {
-    return _mbid;
+    @synchronized (self) {
+        return _mbid;
+    }
 }
 
 - (NSURL *)URL {
@@ -112,7 +104,13 @@
 }
 
 - (NSDictionary<LFMImageSize,NSURL *> *)images {
-    return _images;
+    return self.imageSet.dictionary ?: @{};
+}
+
+- (LFMImageSet *)imageSet {
+    @synchronized (self) {
+        return _imageSet;
+    }
 }
 
 - (BOOL)isStreamable {
@@ -120,27 +118,144 @@
 }
 
 - (BOOL)isOnTour {
-    return _onTour;
+    @synchronized (self) {
+        return _onTour;
+    }
 }
 
 - (NSUInteger)listeners {
-    return _listeners;
+    @synchronized (self) {
+        return _listeners;
+    }
 }
 
 - (NSUInteger)playCount {
-    return _playCount;
+    @synchronized (self) {
+        return _playCount;
+    }
 }
 
 - (NSArray<LFMArtist *> *)similarArtists {
-    return _similarArtists;
+    id JSON = nil;
+    
+    @synchronized (self) {
+        if (_similarArtists != nil) return _similarArtists;
+        JSON = _similarArtistsJSON;
+    }
+    
+    // Built without holding the lock: similar artists go through the identity map, which may merge into - and so lock - other artists.
+    NSArray<LFMArtist *> *similarArtists = LFMModelArray([LFMArtist class], JSON);
+    
+    @synchronized (self) {
+        if (_similarArtists == nil && _similarArtistsJSON == JSON) {
+            _similarArtists = similarArtists;
+            _similarArtistsJSON = nil;
+        }
+        
+        return _similarArtists ?: similarArtists;
+    }
 }
 
 - (NSArray<LFMTag *> *)tags {
-    return _tags;
+    @synchronized (self) {
+        if (_tags == nil) {
+            _tags = LFMModelArray([LFMTag class], _tagsJSON);
+            _tagsJSON = nil;
+        }
+        
+        return _tags;
+    }
+}
+
+- (void)setTags:(NSArray<LFMTag *> *)tags {
+    @synchronized (self) {
+        _tags = tags;
+        _tagsJSON = nil;
+    }
 }
 
 - (LFMWiki *)wiki {
-    return _wiki;
+    @synchronized (self) {
+        if (_wikiJSON != nil) {
+            _wiki = [[LFMWiki alloc] initFromDictionary:_wikiJSON];
+            _wikiJSON = nil;
+        }
+        
+        return _wiki;
+    }
+}
+
+- (void)setWiki:(LFMWiki *)wiki {
+    @synchronized (self) {
+        _wiki = wiki;
+        _wikiJSON = nil;
+    }
+}
+
+#pragma mark - LFMIdentifiableModel
+
+- (void)mergeDetailsFromModel:(LFMArtist *)artist {
+    @synchronized (self) {
+        if (_mbid.length == 0) _mbid = artist->_mbid;
+        if (artist->_imageSet.count > _imageSet.count) _imageSet = artist->_imageSet;
+        
+        // Statistics and tour dates only come with `artist.getInfo`, and are newer than the ones held.
+        if (artist->_listeners > 0 || artist->_playCount > 0) {
+            _listeners = artist->_listeners;
+            _playCount = artist->_playCount;
+            _onTour = artist->_onTour;
+        }
+        
+        if (artist->_similarArtistsJSON != nil) {
+            _similarArtists = nil;
+            _similarArtistsJSON = artist->_similarArtistsJSON;
+        }
+        
+        if (artist->_tagsJSON != nil) {
+            _tags = nil;
+            _tagsJSON = artist->_tagsJSON;
+        }
+        
+        if (artist->_wikiJSON != nil) _wikiJSON = artist->_wikiJSON;
+    }
+}
+
+#pragma mark - LFMSnapshotCoding
+
+- (void)encodeWithSnapshotEncoder:(LFMSnapshotEncoder *)encoder {
+    [encoder encodeString:_name];
+    [encoder encodeString:self.mbid];
+    [encoder encodeURL:_URL];
+    [encoder encodeImages:self.imageSet];
+    [encoder encodeBool:_streamable];
+    [encoder encodeBool:self.isOnTour];
+    [encoder encodeUnsignedInteger:self.listeners];
+    [encoder encodeUnsignedInteger:self.playCount];
+    [encoder encodeArrayOfObjects:self.similarArtists];
+    [encoder encodeArrayOfObjects:self.tags];
+    [encoder encodeObject:self.wiki];
+}
+
+- (instancetype)initWithSnapshotDecoder:(LFMSnapshotDecoder *)decoder {
+    self = [super init];
+    
+    if (self) {
+        _name = [decoder decodeString];
+        _mbid = [decoder decodeString];
+        _URL = [decoder decodeURL];
+        _imageSet = [decoder decodeImages];
+        _streamable = [decoder decodeBool];
+        _onTour = [decoder decodeBool];
+        _listeners = [decoder decodeUnsignedInteger];
+        _playCount = [decoder decodeUnsignedInteger];
+        _similarArtists = [decoder decodeArrayOfObjectsOfClass:[LFMArtist class]];
+        _tags = [decoder decodeArrayOfObjectsOfClass:[LFMTag class]];
+        _wiki = [decoder decodeObjectOfClass:[LFMWiki class]];
+        
+        if (_name == nil || _mbid == nil || _URL == nil) return nil;
+    }
+    
+    return self;
 }
 
 @end
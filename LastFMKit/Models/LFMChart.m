@@ -35,10 +35,9 @@
     self = [super init];
     
     if (self) {
-        NSTimeInterval startDateInterval = [[dictionary objectForKey:@"from"] doubleValue];
-        NSTimeInterval endDateInterval = [[dictionary objectForKey:@"to"] integerValue];
+        NSTimeInterval startDateInterval, endDateInterval;
         
-        if (!isnan(startDateInterval) && !isnan(endDateInterval)) {
+        if (LFMParseTimestamp([dictionary objectForKey:@"from"], &startDateInterval) && LFMParseTimestamp([dictionary objectForKey:@"to"], &endDateInterval)) {
             _startDate = [NSDate dateWithTimeIntervalSince1970:startDateInterval];
             _endDate = [NSDate dateWithTimeIntervalSince1970:endDateInterval];
             
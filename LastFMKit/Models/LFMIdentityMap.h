@@ -0,0 +1,66 @@
+//
+//  LFMIdentityMap.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Keeps one shared instance of every artist and album that is alive in the process. While a map is set as the `sharedMap`, decoding an artist or album that is already alive returns the existing instance instead of a duplicate, so the artist on every row of a `user.getRecentTracks` page - and on every later page - is the same object, and memory grows with the amount of different artists and albums rather than with the amount of rows.
+ 
+ Artists and albums are identified by their MusicBrainz id and, for those that Last.fm sends without one, by their name (and their artist's name, for albums), ignoring case. Two entities with the same name but different MusicBrainz ids are kept apart.
+ 
+ When an entity is decoded again from a more detailed response - for example `artist.getInfo` after `user.getTopArtists` - the details are merged into the shared instance: a MusicBrainz id it was missing, more image sizes, statistics, tags, similar artists, album tracks and wikis. Objects you already hold therefore gain details when another part of your app loads them.
+ 
+ @note  The map only holds instances weakly; an entity that nothing else references any more is forgotten.
+ */
+NS_SWIFT_NAME(IdentityMap)
+@interface LFMIdentityMap : NSObject
+
+/**
+ The map artists and albums are looked up in as they are decoded. Defaults to `nil`, in which case every response is decoded into its own instances.
+ */
++ (nullable LFMIdentityMap *)sharedMap NS_SWIFT_NAME(shared());
+
+/**
+ Replaces the shared map. Instances from the previous map are unaffected, but won't be shared with ones decoded from then on.
+ 
+ @param map The map to use, or `nil` to stop sharing instances.
+ */
++ (void)setSharedMap:(nullable LFMIdentityMap *)map NS_SWIFT_NAME(setShared(_:));
+
+- (instancetype)init NS_DESIGNATED_INITIALIZER;
+
+/** The amount of different artists and albums currently in the map. */
+@property(readonly) NSUInteger count;
+
+/**
+ Forgets every instance. Entities decoded afterwards get new instances, even if the old ones are still alive.
+ */
+- (void)removeAllObjects;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,106 @@
+//
+//  LFMIdentityMap.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMIdentityMap.h"
+#import "LFMKit+Protected.h"
+
+@implementation LFMIdentityMap {
+    NSMapTable<NSString *, id<LFMIdentifiableModel>> *_models;
+}
+
+static LFMIdentityMap *sharedMap;
+
++ (LFMIdentityMap *)sharedMap {
+    @synchronized (self) {
+        return sharedMap;
+    }
+}
+
++ (void)setSharedMap:(LFMIdentityMap *)map {
+    @synchronized (self) {
+        sharedMap = map;
+    }
+}
+
+- (instancetype)init {
+    self = [super init];
+    
+    if (self) {
+        _models = [NSMapTable strongToWeakObjectsMapTable];
+    }
+    
+    return self;
+}
+
+- (NSUInteger)count {
+    @synchronized (self) {
+        // Entities are filed under both their MusicBrainz id and their name.
+        NSHashTable *models = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+        
+        for (id model in _models.objectEnumerator) {
+            [models addObject:model];
+        }
+        
+        return models.count;
+    }
+}
+
+- (void)removeAllObjects {
+    @synchronized (self) {
+        [_models removeAllObjects];
+    }
+}
+
+- (id)canonicalModel:(id<LFMIdentifiableModel>)model kind:(NSString *)kind name:(NSString *)name {
+    NSString *mbid = model.mbid;
+    NSString *mbidKey = mbid.length > 0 ? [NSString stringWithFormat:@"%@/mbid/%@", kind, mbid] : nil;
+    NSString *nameKey = [NSString stringWithFormat:@"%@/name/%@", kind, LFMNormalizedName(name)];
+    id<LFMIdentifiableModel> existing = nil;
+    
+    @synchronized (self) {
+        if (mbidKey != nil) existing = [_models objectForKey:mbidKey];
+        
+        if (existing == nil) {
+            id<LFMIdentifiableModel> namesake = [_models objectForKey:nameKey];
+            
+            // Different MusicBrainz ids under one name are different entities, like the several bands called Nirvana.
+            if (mbidKey == nil || namesake.mbid.length == 0 || [namesake.mbid isEqualToString:mbid]) existing = namesake;
+        }
+        
+        id<LFMIdentifiableModel> canonical = existing ?: model;
+        
+        if (mbidKey != nil) [_models setObject:canonical forKey:mbidKey];
+        if (existing != nil || [_models objectForKey:nameKey] == nil) [_models setObject:canonical forKey:nameKey];
+    }
+    
+    if (existing == nil) return model;
+    
+    // Merged outside of the lock so that decoding on other threads isn't held up while details are copied.
+    [existing mergeDetailsFromModel:model];
+    
+    return existing;
+}
+
+@end
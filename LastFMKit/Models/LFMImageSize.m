@@ -24,6 +24,7 @@
 //
 
 #import "LFMImageSize.h"
+#import "NSString+Interning.h"
 
 LFMImageSize const LFMImageSizeSmall = @"small";
 LFMImageSize const LFMImageSizeMedium = @"medium";
@@ -31,17 +32,51 @@ LFMImageSize const LFMImageSizeLarge = @"large";
 LFMImageSize const LFMImageSizeExtraLarge = @"extralarge";
 LFMImageSize const LFMImageSizeMega = @"mega";
 
+/**
+ Returns the constant for a size sent by Last.fm, so that every images dictionary shares the same keys instead of each holding its own copies.
+ */
+static LFMImageSize LFMImageSizeConstant(NSString *size) {
+    static NSArray<LFMImageSize> *sizes;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sizes = @[LFMImageSizeSmall, LFMImageSizeMedium, LFMImageSizeLarge, LFMImageSizeExtraLarge, LFMImageSizeMega];
+    });
+    
+    for (LFMImageSize constant in sizes) {
+        if ([constant isEqualToString:size]) return constant;
+    }
+    
+    return size.internedString;
+}
+
 NSDictionary <LFMImageSize, NSURL*>* imageDictionaryFromArray(NSArray *array) {
-    NSMutableDictionary<LFMImageSize, NSURL *> *images = [NSMutableDictionary dictionary];
+    if (![array isKindOfClass:[NSArray class]] || array.count == 0) return @{};
+    
+    // Last.fm sends at most one image per size, so the dictionary can be created in one go at exactly the right size.
+    NSUInteger capacity = array.count;
+    __strong id *sizes = (__strong id *)calloc(capacity, sizeof(id));
+    __strong id *URLs = (__strong id *)calloc(capacity, sizeof(id));
+    NSUInteger count = 0;
     
     for (NSDictionary *imageDictionary in array) {
         NSURL *URL = [NSURL URLWithString:[imageDictionary objectForKey:@"#text"]];
-        LFMImageSize size = [imageDictionary objectForKey:@"size"];
+        NSString *size = [imageDictionary objectForKey:@"size"];
         
         if (URL != nil && size != nil) {
-            images[size] = URL;
+            sizes[count] = LFMImageSizeConstant(size);
+            URLs[count] = URL;
+            count++;
         }
     }
     
+    NSDictionary<LFMImageSize, NSURL *> *images = [NSDictionary dictionaryWithObjects:URLs forKeys:sizes count:count];
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        sizes[i] = nil;
+        URLs[i] = nil;
+    }
+    free(sizes);
+    free(URLs);
+    
     return images;
 }
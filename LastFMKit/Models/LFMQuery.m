@@ -33,9 +33,14 @@
 }
 
 - (instancetype)initFromDictionary:(NSDictionary *)dictionary {
-    NSUInteger currentPage = [[dictionary objectForKey:@"page"] unsignedIntegerValue];
-    NSUInteger totalResults = [[dictionary objectForKey:@"total"] unsignedIntegerValue];
-    NSUInteger itemsPerPage = [[dictionary objectForKey:@"perPage"] unsignedIntegerValue];
+    NSUInteger currentPage, totalResults, itemsPerPage;
+    
+    if (!LFMParseUnsignedInteger([dictionary objectForKey:@"page"], &currentPage) ||
+        !LFMParseUnsignedInteger([dictionary objectForKey:@"total"], &totalResults) ||
+        !LFMParseUnsignedInteger([dictionary objectForKey:@"perPage"], &itemsPerPage))
+    {
+        return nil;
+    }
     
     return [[LFMQuery alloc] initWithPage:currentPage totalResults:totalResults itemsPerPage:itemsPerPage];
 }
@@ -44,19 +49,13 @@
                 totalResults:(NSUInteger)totalResults
                 itemsPerPage:(NSUInteger)itemsPerPage {
     self = [super init];
-    if (self &&
-        !isnan(currentPage) &&
-        !isnan(totalResults) &&
-        !isnan(itemsPerPage))
-    {
+    if (self) {
         _currentPage = currentPage;
         _totalResults = totalResults;
         _itemsPerPage = itemsPerPage;
-        
-        return self;
     }
     
-    return nil;
+    return self;
 }
 
 - (NSUInteger)currentPage {
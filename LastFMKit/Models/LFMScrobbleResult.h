@@ -0,0 +1,67 @@
+//
+//  LFMScrobbleResult.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+@class LFMScrobbleTrack;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The reasons Last.fm gives for ignoring a scrobble.
+ */
+typedef NS_ENUM(NSInteger, LFMScrobbleIgnoredReason) {
+    LFMScrobbleIgnoredReasonNone = 0,
+    LFMScrobbleIgnoredReasonArtistIgnored = 1,
+    LFMScrobbleIgnoredReasonTrackIgnored = 2,
+    LFMScrobbleIgnoredReasonTimestampTooOld = 3,
+    LFMScrobbleIgnoredReasonTimestampTooNew = 4,
+    LFMScrobbleIgnoredReasonDailyScrobbleLimitExceeded = 5
+} NS_SWIFT_NAME(ScrobbleIgnoredReason);
+
+/**
+ This class represents the outcome of scrobbling a single track.
+ */
+NS_SWIFT_NAME(ScrobbleResult)
+@interface LFMScrobbleResult : NSObject
+
+/** The track that was submitted. */
+@property(strong, nonatomic, readonly) LFMScrobbleTrack *track;
+
+/** Will be `YES` if Last.fm added the scrobble to the user's profile, or `NO` if it was ignored. */
+@property(nonatomic, readonly, getter=wasAccepted) BOOL accepted;
+
+/** Why the scrobble was ignored. Will be `LFMScrobbleIgnoredReasonNone` if the scrobble was accepted. */
+@property(nonatomic, readonly) LFMScrobbleIgnoredReason ignoredReason;
+
+/** Last.fm's description of why the scrobble was ignored, if it was. */
+@property(strong, nonatomic, readonly, nullable) NSString *ignoredMessage;
+
+- (instancetype) __unavailable init;
++ (instancetype) __unavailable new;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,72 @@
+//
+//  LFMScrobbleResult.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMScrobbleResult.h"
+#import "LFMScrobbleTrack.h"
+#import "LFMNumberParsing.h"
+
+@implementation LFMScrobbleResult {
+    LFMScrobbleTrack *_track;
+    LFMScrobbleIgnoredReason _ignoredReason;
+    NSString *_ignoredMessage;
+}
+
+- (instancetype)initWithTrack:(LFMScrobbleTrack *)track fromDictionary:(NSDictionary *)dictionary {
+    self = [super init];
+    
+    if (self) {
+        NSDictionary *ignoredMessage = [dictionary objectForKey:@"ignoredMessage"];
+        
+        if (ignoredMessage != nil) {
+            NSString *message = [ignoredMessage objectForKey:@"#text"];
+            
+            _track = track;
+            _ignoredReason = LFMUnsignedIntegerValue([ignoredMessage objectForKey:@"code"]);
+            _ignoredMessage = _ignoredReason == LFMScrobbleIgnoredReasonNone || message.length == 0 ? nil : message;
+            
+            return self;
+        }
+    }
+    
+    return nil;
+}
+
+- (LFMScrobbleTrack *)track {
+    return _track;
+}
+
+- (BOOL)wasAccepted {
+    return _ignoredReason == LFMScrobbleIgnoredReasonNone;
+}
+
+- (LFMScrobbleIgnoredReason)ignoredReason {
+    return _ignoredReason;
+}
+
+- (NSString *)ignoredMessage {
+    return _ignoredMessage;
+}
+
+@end
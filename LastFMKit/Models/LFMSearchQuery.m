@@ -32,9 +32,14 @@
 
 - (instancetype)initFromDictionary:(NSDictionary *)dictionary {
     NSString *searchQuery = [[dictionary objectForKey:@"opensearch:Query"] objectForKey:@"searchTerms"];
-    NSUInteger currentPage = [[[dictionary objectForKey:@"opensearch:Query"] objectForKey:@"startPage"] unsignedIntegerValue];
-    NSUInteger totalResults = [[dictionary objectForKey:@"opensearch:totalResults"] unsignedIntegerValue];
-    NSUInteger itemsPerPage = [[dictionary objectForKey:@"opensearch:itemsPerPage"] unsignedIntegerValue];
+    NSUInteger currentPage, totalResults, itemsPerPage;
+    
+    if (!LFMParseUnsignedInteger([[dictionary objectForKey:@"opensearch:Query"] objectForKey:@"startPage"], &currentPage) ||
+        !LFMParseUnsignedInteger([dictionary objectForKey:@"opensearch:totalResults"], &totalResults) ||
+        !LFMParseUnsignedInteger([dictionary objectForKey:@"opensearch:itemsPerPage"], &itemsPerPage))
+    {
+        return nil;
+    }
     
     self = [[LFMSearchQuery alloc] initWithPage:currentPage totalResults:totalResults itemsPerPage:itemsPerPage];
     
@@ -0,0 +1,95 @@
+//
+//  LFMSnapshot.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A compact, versioned binary encoding of `LFMTrack`, `LFMArtist`, `LFMAlbum`, `LFMTag` and `LFMWiki` objects, for persisting large amounts of them.
+ 
+ A snapshot starts with a fixed header and a table of offsets, so a snapshot read from a memory-mapped file only touches the pages of the objects that are actually decoded. Every string is stored once, in a length-prefixed table, and referenced by index from the records that use it; counts and numbers are stored as varints.
+ 
+ A track's album is held weakly and so isn't part of the track's record; save albums in the snapshot alongside their tracks instead. Subclasses such as `LFMScrobbleTrack` are saved and restored as their model class.
+ */
+NS_SWIFT_NAME(Snapshot)
+@interface LFMSnapshot : NSObject
+
+/**
+ Encodes models into a snapshot.
+ 
+ @param objects The tracks, artists, albums, tags and wikis to encode.
+ 
+ @return   The snapshot, which can be written to disk as is.
+ */
++ (NSData *)dataWithObjects:(NSArray *)objects NS_SWIFT_NAME(data(with:));
+
+/**
+ Initialises a snapshot from previously encoded data. The header and offset tables are validated straight away; the objects themselves are only decoded when asked for.
+ 
+ @param data    The snapshot. It isn't copied, so memory-mapped data stays mapped.
+ @param error   On return, an `NSFileReadCorruptFileError` error if the data isn't a snapshot or was written by a different version of the format.
+ 
+ @return   An `LFMSnapshot` object, or `nil` if the data couldn't be read.
+ */
+- (nullable instancetype)initWithData:(NSData *)data error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+/**
+ Initialises a snapshot by mapping a file into memory.
+ 
+ @param URL     The location of the snapshot.
+ @param error   On return, an error if the file couldn't be mapped or isn't a snapshot.
+ 
+ @return   An `LFMSnapshot` object, or `nil` if the file couldn't be read.
+ */
+- (nullable instancetype)initWithContentsOfURL:(NSURL *)URL error:(NSError **)error NS_SWIFT_NAME(init(contentsOf:));
+
+/** The amount of objects in the snapshot. */
+@property(nonatomic, readonly) NSUInteger count;
+
+/**
+ Decodes one object. Each call decodes a new instance.
+ 
+ @param index   The position of the object in the array the snapshot was created from.
+ 
+ @return   The object, or `nil` if its record is corrupt.
+ */
+- (nullable id)objectAtIndex:(NSUInteger)index;
+
+/**
+ Decodes every object in the snapshot.
+ 
+ @param error   On return, an `NSFileReadCorruptFileError` error if any record is corrupt.
+ 
+ @return   The objects in the order they were encoded in, or `nil` if a record is corrupt.
+ */
+- (nullable NSArray *)decodeAllObjectsWithError:(NSError **)error;
+
+- (instancetype) __unavailable init;
++ (instancetype) __unavailable new;
+
+@end
+
+NS_ASSUME_NONNULL_END
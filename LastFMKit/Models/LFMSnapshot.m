@@ -0,0 +1,224 @@
+//
+//  LFMSnapshot.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMSnapshot.h"
+#import "LFMSnapshotCoding.h"
+#import "LFMKit+Protected.h"
+
+/*
+ Layout, all integers little endian:
+ 
+     0   "LFMS"
+     4   uint16 format version
+     6   uint16 reserved, 0
+     8   uint32 amount of strings
+    12   uint32 amount of records
+    16   uint32 offset of every string, from the start of the snapshot
+         uint32 offset of every record, from the start of the snapshot
+         strings, each a varint byte length followed by UTF-8
+         records, each a kind byte followed by the model's fields
+ */
+static const uint8_t LFMSnapshotMagic[4] = {'L', 'F', 'M', 'S'};
+static const NSUInteger LFMSnapshotHeaderLength = 16;
+
+static NSError *LFMSnapshotCorruptError(NSString *reason) {
+    return [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError userInfo:@{NSLocalizedDescriptionKey : reason}];
+}
+
+static uint32_t LFMSnapshotReadUInt32(const uint8_t *bytes) {
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return CFSwapInt32LittleToHost(value);
+}
+
+static void LFMSnapshotAppendUInt32(NSMutableData *data, NSUInteger value) {
+    NSCAssert(value <= UINT32_MAX, @"Snapshots are limited to 4 GB.");
+    
+    uint32_t littleEndian = CFSwapInt32HostToLittle((uint32_t)value);
+    [data appendBytes:&littleEndian length:sizeof(littleEndian)];
+}
+
+@implementation LFMSnapshot {
+    NSData *_data;
+    NSUInteger _stringCount;
+    NSUInteger _count;
+    __strong NSString **_strings;
+}
+
++ (NSData *)dataWithObjects:(NSArray *)objects {
+    LFMSnapshotEncoder *encoder = [[LFMSnapshotEncoder alloc] init];
+    
+    for (id object in objects) {
+        [encoder encodeRootObject:object];
+    }
+    
+    NSArray<NSString *> *strings = encoder.strings;
+    NSMutableData *stringTable = [NSMutableData data];
+    NSUInteger stringTableOffset = LFMSnapshotHeaderLength + (strings.count + encoder.recordCount) * sizeof(uint32_t);
+    
+    NSMutableData *data = [NSMutableData dataWithBytes:LFMSnapshotMagic length:sizeof(LFMSnapshotMagic)];
+    uint16_t version = CFSwapInt16HostToLittle(LFMSnapshotFormatVersion), reserved = 0;
+    [data appendBytes:&version length:sizeof(version)];
+    [data appendBytes:&reserved length:sizeof(reserved)];
+    LFMSnapshotAppendUInt32(data, strings.count);
+    LFMSnapshotAppendUInt32(data, encoder.recordCount);
+    
+    for (NSString *string in strings) {
+        LFMSnapshotAppendUInt32(data, stringTableOffset + stringTable.length);
+        
+        NSData *UTF8 = [string dataUsingEncoding:NSUTF8StringEncoding];
+        uint8_t buffer[LFMSnapshotMaximumVarintLength];
+        [stringTable appendBytes:buffer length:LFMSnapshotWriteVarint(buffer, UTF8.length)];
+        [stringTable appendData:UTF8];
+    }
+    
+    NSUInteger recordsOffset = stringTableOffset + stringTable.length;
+    
+    for (NSUInteger i = 0; i < encoder.recordCount; i++) {
+        LFMSnapshotAppendUInt32(data, recordsOffset + [encoder offsetOfRecordAtIndex:i]);
+    }
+    
+    [data appendData:stringTable];
+    [data appendData:encoder.records];
+    
+    return data;
+}
+
+- (instancetype)initWithData:(NSData *)data error:(NSError **)error {
+    self = [super init];
+    
+    if (self) {
+        const uint8_t *bytes = data.bytes;
+        
+        if (data.length < LFMSnapshotHeaderLength || memcmp(bytes, LFMSnapshotMagic, sizeof(LFMSnapshotMagic)) != 0) {
+            if (error != NULL) *error = LFMSnapshotCorruptError(@"The data isn't a snapshot.");
+            return nil;
+        }
+        
+        uint16_t version;
+        memcpy(&version, bytes + 4, sizeof(version));
+        version = CFSwapInt16LittleToHost(version);
+        
+        if (version != LFMSnapshotFormatVersion) {
+            if (error != NULL) *error = LFMSnapshotCorruptError([NSString stringWithFormat:@"The snapshot was written in version %u of the format, which this version of LastFMKit can't read.", version]);
+            return nil;
+        }
+        
+        uint64_t stringCount = LFMSnapshotReadUInt32(bytes + 8);
+        uint64_t count = LFMSnapshotReadUInt32(bytes + 12);
+        
+        if (LFMSnapshotHeaderLength + (stringCount + count) * sizeof(uint32_t) > data.length) {
+            if (error != NULL) *error = LFMSnapshotCorruptError(@"The snapshot has been cut short.");
+            return nil;
+        }
+        
+        _data = data;
+        _stringCount = (NSUInteger)stringCount;
+        _count = (NSUInteger)count;
+        _strings = (__strong NSString **)calloc(MAX(_stringCount, 1), sizeof(NSString *));
+    }
+    
+    return self;
+}
+
+- (instancetype)initWithContentsOfURL:(NSURL *)URL error:(NSError **)error {
+    NSData *data = [NSData dataWithContentsOfURL:URL options:NSDataReadingMappedAlways error:error];
+    return data == nil ? nil : [self initWithData:data error:error];
+}
+
+- (void)dealloc {
+    for (NSUInteger i = 0; i < _stringCount; i++) {
+        _strings[i] = nil;
+    }
+    free(_strings);
+}
+
+- (NSUInteger)count {
+    return _count;
+}
+
+- (id)objectAtIndex:(NSUInteger)index {
+    if (index >= _count) {
+        [NSException raise:NSRangeException format:@"Index %lu is beyond the %lu objects in the snapshot.", (unsigned long)index, (unsigned long)_count];
+    }
+    
+    const uint8_t *bytes = _data.bytes;
+    NSUInteger offset = LFMSnapshotReadUInt32(bytes + LFMSnapshotHeaderLength + (_stringCount + index) * sizeof(uint32_t));
+    
+    if (offset >= _data.length) return nil;
+    
+    LFMSnapshotDecoder *decoder = [[LFMSnapshotDecoder alloc] initWithSnapshot:self bytes:bytes + offset length:_data.length - offset];
+    id object = [decoder decodeObjectOfClass:Nil];
+    
+    return decoder.isCorrupt ? nil : object;
+}
+
+- (NSArray *)decodeAllObjectsWithError:(NSError **)error {
+    __strong id *objects = (__strong id *)calloc(MAX(_count, 1), sizeof(id));
+    NSUInteger decoded = 0;
+    
+    for (; decoded < _count; decoded++) {
+        id object = [self objectAtIndex:decoded];
+        if (object == nil) break;
+        
+        objects[decoded] = object;
+    }
+    
+    NSArray *array = decoded == _count ? [NSArray arrayWithObjects:objects count:decoded] : nil;
+    
+    for (NSUInteger i = 0; i < decoded; i++) {
+        objects[i] = nil;
+    }
+    free(objects);
+    
+    if (array == nil && error != NULL) {
+        *error = LFMSnapshotCorruptError([NSString stringWithFormat:@"The record of object %lu is corrupt.", (unsigned long)decoded]);
+    }
+    
+    return array;
+}
+
+- (NSString *)stringAtIndex:(NSUInteger)index {
+    if (index >= _stringCount) return nil;
+    
+    @synchronized (self) {
+        NSString *string = _strings[index];
+        if (string != nil) return string;
+        
+        // Strings are decoded the first time a record refers to them and shared by every record after.
+        const uint8_t *bytes = _data.bytes;
+        NSUInteger position = LFMSnapshotReadUInt32(bytes + LFMSnapshotHeaderLength + index * sizeof(uint32_t));
+        uint64_t length = 0;
+        
+        if (!LFMSnapshotReadVarint(bytes, _data.length, &position, &length) || length > _data.length - position) return nil;
+        
+        string = [[NSString alloc] initWithBytes:bytes + position length:(NSUInteger)length encoding:NSUTF8StringEncoding];
+        _strings[index] = string;
+        
+        return string;
+    }
+}
+
+@end
@@ -45,17 +45,17 @@
         
         // Extra variables that are only obtained from certain api calls.
         NSURL *URL = [NSURL URLWithString:[dictionary objectForKey:@"url"]];
-        NSUInteger reach = [[dictionary objectForKey:@"reach"] unsignedIntegerValue];
-        NSUInteger total = [[dictionary objectForKey:@"total"] unsignedIntegerValue];
+        NSUInteger reach = LFMUnsignedIntegerValue([dictionary objectForKey:@"reach"]);
+        NSUInteger total = LFMUnsignedIntegerValue([dictionary objectForKey:@"total"]);
         BOOL streamable = [[dictionary objectForKey:@"streamable"] boolValue];
         LFMWiki *wiki = [[LFMWiki alloc] initFromDictionary:[dictionary objectForKey:@"wiki"]];
         
         if (name != nil) {
-            _name = name;
+            _name = name.internedString;
             
             _URL = URL;
-            _reach = isnan(reach) ? 0 : reach;
-            _total = isnan(total) ? 0 : total;
+            _reach = reach;
+            _total = total;
             _streamable = streamable;
             _wiki = wiki;
             
@@ -109,4 +109,32 @@
     return _wiki;
 }
 
+#pragma mark - LFMSnapshotCoding
+
+- (void)encodeWithSnapshotEncoder:(LFMSnapshotEncoder *)encoder {
+    [encoder encodeString:_name];
+    [encoder encodeURL:_URL];
+    [encoder encodeUnsignedInteger:_reach];
+    [encoder encodeUnsignedInteger:_total];
+    [encoder encodeBool:_streamable];
+    [encoder encodeObject:_wiki];
+}
+
+- (instancetype)initWithSnapshotDecoder:(LFMSnapshotDecoder *)decoder {
+    self = [super init];
+    
+    if (self) {
+        _name = [decoder decodeString];
+        _URL = [decoder decodeURL];
+        _reach = [decoder decodeUnsignedInteger];
+        _total = [decoder decodeUnsignedInteger];
+        _streamable = [decoder decodeBool];
+        _wiki = [decoder decodeObjectOfClass:[LFMWiki class]];
+        
+        if (_name == nil) return nil;
+    }
+    
+    return self;
+}
+
 @end
@@ -34,9 +34,7 @@
     self = [super initFromDictionary:dictionary];
     
     if (self) {
-        NSUInteger count = [[dictionary objectForKey:@"count"] unsignedIntegerValue];
-        
-        if (!isnan(count)) return self;
+        if (LFMParseUnsignedInteger([dictionary objectForKey:@"count"], &_count)) return self;
     }
     
     return nil;
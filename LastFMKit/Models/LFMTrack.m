@@ -42,6 +42,10 @@
     LFMAlbum * __weak _album;
     NSUInteger _listeners;
     NSUInteger _playCount;
+    
+    // The parts of the response nested models are built from the first time they are asked for.
+    id _tagsJSON;
+    NSDictionary *_wikiJSON;
 }
 
 - (instancetype)initFromDictionary:(NSDictionary *)dictionary {
@@ -51,29 +55,20 @@
         NSString *name = [dictionary objectForKey:@"name"];
         NSString *mbid = [dictionary objectForKey:@"mbid"];
         NSURL *URL = [NSURL URLWithString:[dictionary objectForKey:@"url"]];
-        NSUInteger listeners = [[dictionary objectForKey:@"listeners"] unsignedIntegerValue];
         
         if (name != nil &&
             mbid != nil &&
-            URL != nil &&
-            !isnan(listeners))
+            URL != nil)
         {
             // Advanced variables that are only aquired on a `getInfo` call to Track.
-            NSUInteger duration = [[dictionary objectForKey:@"duration"] unsignedIntegerValue];
-            NSUInteger playCount = [[dictionary objectForKey:@"playcount"] unsignedIntegerValue];
+            NSUInteger listeners = LFMUnsignedIntegerValue([dictionary objectForKey:@"listeners"]);
+            NSUInteger duration = LFMUnsignedIntegerValue([dictionary objectForKey:@"duration"]);
+            NSUInteger playCount = LFMUnsignedIntegerValue([dictionary objectForKey:@"playcount"]);
             BOOL streamable = [[[dictionary objectForKey:@"streamable"] objectForKey:@"fulltrack"] boolValue];
-            NSUInteger positionInAlbum = [[[[dictionary objectForKey:@"album"] objectForKey:@"@attr"] objectForKey:@"position"] unsignedIntegerValue];
+            NSUInteger positionInAlbum = LFMUnsignedIntegerValue([[[dictionary objectForKey:@"album"] objectForKey:@"@attr"] objectForKey:@"position"]);
             
             LFMArtist *artist = [[LFMArtist alloc] initFromDictionary:[dictionary objectForKey:@"artist"]];
             LFMAlbum *album = [[LFMAlbum alloc] initFromDictionary:[dictionary objectForKey:@"album"]];
-            LFMWiki *wiki = [[LFMWiki alloc] initFromDictionary:[dictionary objectForKey:@"wiki"]];
-            
-            NSMutableArray <LFMTag *> *tags = [NSMutableArray array];
-            
-            for (NSDictionary *tagDictionary in [[dictionary objectForKey:@"toptags"] objectForKey:@"tag"]) {
-                LFMTag *tag = [[LFMTag alloc] initFromDictionary:tagDictionary];
-                tag == nil ?: [tags addObject:tag];
-            }
             
             _name = name;
             _mbid = mbid;
@@ -85,7 +80,8 @@
             _positionInAlbum = positionInAlbum;
             _artist = artist;
             _album = album;
-            _wiki = wiki;
+            _wikiJSON = [dictionary objectForKey:@"wiki"];
+            _tagsJSON = [[dictionary objectForKey:@"toptags"] objectForKey:@"tag"];
             
             return self;
         }
@@ -151,11 +147,39 @@
 }
 
 - (NSArray<LFMTag *> *)tags {
-    return _tags;
+    @synchronized (self) {
+        if (_tags == nil) {
+            _tags = LFMModelArray([LFMTag class], _tagsJSON);
+            _tagsJSON = nil;
+        }
+        
+        return _tags;
+    }
+}
+
+- (void)setTags:(NSArray<LFMTag *> *)tags {
+    @synchronized (self) {
+        _tags = tags;
+        _tagsJSON = nil;
+    }
 }
 
 - (LFMWiki *)wiki {
-    return _wiki;
+    @synchronized (self) {
+        if (_wikiJSON != nil) {
+            _wiki = [[LFMWiki alloc] initFromDictionary:_wikiJSON];
+            _wikiJSON = nil;
+        }
+        
+        return _wiki;
+    }
+}
+
+- (void)setWiki:(LFMWiki *)wiki {
+    @synchronized (self) {
+        _wiki = wiki;
+        _wikiJSON = nil;
+    }
 }
 
 - (LFMAlbum *)album {
@@ -170,4 +194,43 @@
     return _playCount;
 }
 
+#pragma mark - LFMSnapshotCoding
+
+- (void)encodeWithSnapshotEncoder:(LFMSnapshotEncoder *)encoder {
+    // The album is only held weakly - by whoever owns it - so it isn't part of the track's record.
+    [encoder encodeString:_name];
+    [encoder encodeString:_mbid];
+    [encoder encodeURL:_URL];
+    [encoder encodeUnsignedInteger:_duration];
+    [encoder encodeBool:_streamable];
+    [encoder encodeObject:_artist];
+    [encoder encodeUnsignedInteger:_positionInAlbum];
+    [encoder encodeArrayOfObjects:self.tags];
+    [encoder encodeObject:self.wiki];
+    [encoder encodeUnsignedInteger:_listeners];
+    [encoder encodeUnsignedInteger:_playCount];
+}
+
+- (instancetype)initWithSnapshotDecoder:(LFMSnapshotDecoder *)decoder {
+    self = [super init];
+    
+    if (self) {
+        _name = [decoder decodeString];
+        _mbid = [decoder decodeString];
+        _URL = [decoder decodeURL];
+        _duration = [decoder decodeUnsignedInteger];
+        _streamable = [decoder decodeBool];
+        _artist = [decoder decodeObjectOfClass:[LFMArtist class]];
+        _positionInAlbum = [decoder decodeUnsignedInteger];
+        _tags = [decoder decodeArrayOfObjectsOfClass:[LFMTag class]];
+        _wiki = [decoder decodeObjectOfClass:[LFMWiki class]];
+        _listeners = [decoder decodeUnsignedInteger];
+        _playCount = [decoder decodeUnsignedInteger];
+        
+        if (_name == nil || _mbid == nil || _URL == nil) return nil;
+    }
+    
+    return self;
+}
+
 @end
@@ -29,7 +29,7 @@
 @implementation LFMUser {
     NSString *_userName;
     NSString *_realName;
-    NSDictionary<LFMImageSize, NSURL *> *_images;
+    LFMImageSet *_imageSet;
     NSURL *_URL;
     NSString *_country;
     NSUInteger _age;
@@ -48,28 +48,28 @@
         NSString *realName = [dictionary objectForKey:@"realname"];
         NSURL *URL = [NSURL URLWithString:[dictionary objectForKey:@"url"]];
         NSString *country = [dictionary objectForKey:@"country"];
-        NSUInteger age = [[dictionary objectForKey:@"age"] unsignedIntegerValue];
+        NSUInteger age = 0;
         LFMUserGender gender = [dictionary objectForKey:@"gender"];
         NSString *subscriberString = [dictionary objectForKey:@"subscriber"];
-        NSUInteger playCount = [[dictionary objectForKey:@"playcount"] unsignedIntegerValue];
-        NSUInteger playlistCount = [[dictionary objectForKey:@"playlists"] unsignedIntegerValue];
-        double registeredTime = [[[dictionary objectForKey:@"registered"] objectForKey:@"unixtime"] doubleValue];
-        NSDictionary *images = imageDictionaryFromArray([dictionary objectForKey:@"image"]);
+        NSUInteger playCount = 0;
+        NSUInteger playlistCount = 0;
+        NSTimeInterval registeredTime = 0;
+        LFMImageSet *imageSet = [LFMImageSet imageSetFromArray:[dictionary objectForKey:@"image"]];
         
         if (userName != nil &&
             realName != nil &&
             URL != nil &&
             country != nil &&
-            !isnan(age) &&
+            LFMParseUnsignedInteger([dictionary objectForKey:@"age"], &age) &&
             gender != nil &&
             subscriberString != nil &&
-            !isnan(playCount) &&
-            !isnan(playlistCount) &&
-            !isnan(registeredTime))
+            LFMParseUnsignedInteger([dictionary objectForKey:@"playcount"], &playCount) &&
+            LFMParseUnsignedInteger([dictionary objectForKey:@"playlists"], &playlistCount) &&
+            LFMParseTimestamp([[dictionary objectForKey:@"registered"] objectForKey:@"unixtime"], &registeredTime))
         {
             _userName = userName;
             _realName = realName;
-            _images = images;
+            _imageSet = imageSet;
             _URL = URL;
             _country = country;
             _age = age;
@@ -95,7 +95,7 @@
 }
 
 - (NSDictionary<LFMImageSize,NSURL *> *)images {
-    return _images;
+    return _imageSet.dictionary ?: @{};
 }
 
 - (NSURL *)URL {
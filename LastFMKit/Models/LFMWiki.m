@@ -24,6 +24,7 @@
 //
 
 #import "LFMWiki.h"
+#import "LFMKit+Protected.h"
 
 @implementation LFMWiki {
     NSDate *_publishedDate;
@@ -68,4 +69,26 @@
     return _content;
 }
 
+#pragma mark - LFMSnapshotCoding
+
+- (void)encodeWithSnapshotEncoder:(LFMSnapshotEncoder *)encoder {
+    [encoder encodeDouble:_publishedDate.timeIntervalSinceReferenceDate];
+    [encoder encodeString:_summary];
+    [encoder encodeString:_content];
+}
+
+- (instancetype)initWithSnapshotDecoder:(LFMSnapshotDecoder *)decoder {
+    self = [super init];
+    
+    if (self) {
+        _publishedDate = [NSDate dateWithTimeIntervalSinceReferenceDate:[decoder decodeDouble]];
+        _summary = [decoder decodeString];
+        _content = [decoder decodeString];
+        
+        if (_summary == nil || _content == nil) return nil;
+    }
+    
+    return self;
+}
+
 @end
@@ -0,0 +1,219 @@
+//
+//  LFMEndpoint.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The Last.fm API methods providers call through the endpoint table. Each one indexes its entry in `LFMEndpointTable`.
+ */
+typedef NS_ENUM(NSUInteger, LFMEndpointName) {
+    LFMEndpointAlbumAddTags,
+    LFMEndpointAlbumRemoveTag,
+    LFMEndpointAlbumGetInfo,
+    LFMEndpointAlbumGetTags,
+    LFMEndpointAlbumGetTopTags,
+    LFMEndpointAlbumSearch,
+    LFMEndpointArtistAddTags,
+    LFMEndpointArtistRemoveTag,
+    LFMEndpointArtistGetCorrection,
+    LFMEndpointArtistGetInfo,
+    LFMEndpointArtistGetSimilar,
+    LFMEndpointArtistGetTags,
+    LFMEndpointArtistGetTopAlbums,
+    LFMEndpointArtistGetTopTracks,
+    LFMEndpointArtistGetTopTags,
+    LFMEndpointArtistSearch,
+    LFMEndpointChartGetTopArtists,
+    LFMEndpointChartGetTopTags,
+    LFMEndpointChartGetTopTracks,
+    LFMEndpointGeoGetTopArtists,
+    LFMEndpointGeoGetTopTracks,
+    LFMEndpointLibraryGetArtists,
+    LFMEndpointTagGetInfo,
+    LFMEndpointTagGetTopTags,
+    LFMEndpointTagGetSimilar,
+    LFMEndpointTagGetTopAlbums,
+    LFMEndpointTagGetTopArtists,
+    LFMEndpointTagGetTopTracks,
+    LFMEndpointTrackUpdateNowPlaying,
+    LFMEndpointTrackLove,
+    LFMEndpointTrackUnlove,
+    LFMEndpointTrackSearch,
+    LFMEndpointTrackGetSimilar,
+    LFMEndpointTrackGetInfo,
+    LFMEndpointTrackGetCorrection,
+    LFMEndpointTrackAddTags,
+    LFMEndpointTrackRemoveTag,
+    LFMEndpointTrackGetTags,
+    LFMEndpointTrackGetTopTags,
+    LFMEndpointUserGetInfo,
+    LFMEndpointUserGetFriends,
+    LFMEndpointUserGetArtistTracks,
+    LFMEndpointUserGetLovedTracks,
+    LFMEndpointUserGetPersonalTags,
+    LFMEndpointUserGetRecentTracks,
+    LFMEndpointUserGetTopAlbums,
+    LFMEndpointUserGetTopArtists,
+    LFMEndpointUserGetTopTracks,
+    LFMEndpointUserGetTopTags,
+    LFMEndpointUserGetWeeklyAlbumChart,
+    LFMEndpointUserGetWeeklyArtistChart,
+    LFMEndpointUserGetWeeklyTrackChart,
+    LFMEndpointUserGetWeeklyChartList,
+    LFMEndpointCount
+};
+
+/** The HTTP method an endpoint is called with. `POST` endpoints send their parameters in the body. */
+typedef NS_ENUM(uint8_t, LFMEndpointHTTPMethod) {
+    LFMEndpointHTTPMethodGET,
+    LFMEndpointHTTPMethodPOST
+};
+
+/** When an endpoint's requests carry a session key and an api signature. */
+typedef NS_ENUM(uint8_t, LFMEndpointSigning) {
+    /** Never signed. */
+    LFMEndpointSigningNone,
+    /** Always signed, with the session key the request is made for. */
+    LFMEndpointSigningRequired,
+    /** Signed only if a session key is given; otherwise sent as a plain read. */
+    LFMEndpointSigningIfAuthenticated
+};
+
+/** What an endpoint's callback is called with besides the error. */
+typedef NS_ENUM(uint8_t, LFMEndpointResult) {
+    /** Nothing; the endpoint only reports success or failure. */
+    LFMEndpointResultNone,
+    /** A single model, built from the dictionary at `modelPath`. */
+    LFMEndpointResultModel,
+    /** An array of models, built from the list at `modelPath`. Never `nil`, even on failure. */
+    LFMEndpointResultList,
+    /** The decoded response itself, for endpoints whose models can only be picked out by the caller. */
+    LFMEndpointResultResponse
+};
+
+/** The most parameters an endpoint takes, not counting those every request carries. */
+#define LFMEndpointMaximumParameterCount 8
+
+/** The most keys leading from the root of a response to a model or query. */
+#define LFMEndpointMaximumPathLength 4
+
+/**
+ Describes one Last.fm API method: how its requests are built and how its responses are turned into models. Arrays of names are `nil` terminated unless full.
+ */
+typedef struct {
+    /** The name of the method, eg. "album.getInfo". */
+    __unsafe_unretained NSString *method;
+    LFMEndpointHTTPMethod HTTPMethod;
+    LFMEndpointSigning signing;
+    LFMEndpointResult result;
+    /** The names of the method's parameters, in the order their values are passed to `LFMEndpointRequest`. `method`, `format`, `api_key` and `sk` are added by the engine. */
+    __unsafe_unretained NSString *parameters[LFMEndpointMaximumParameterCount];
+    /** The keys leading to the model or list of models. */
+    __unsafe_unretained NSString *modelPath[LFMEndpointMaximumPathLength];
+    /** The name of the class the models are built as. */
+    const char *modelClass;
+    /** The keys leading to the dictionary the paging details are built from. */
+    __unsafe_unretained NSString *queryPath[LFMEndpointMaximumPathLength];
+    /** The name of the class the paging details are built as - `LFMQuery` or `LFMSearchQuery` - or `NULL` if the method isn't paged. */
+    const char *queryClass;
+} LFMEndpoint;
+
+/** Every endpoint, indexed by `LFMEndpointName`. */
+extern const LFMEndpoint LFMEndpointTable[LFMEndpointCount];
+
+/**
+ Packs the values of an endpoint's parameters into the array and count `LFMEndpointRequest` takes. Values may be `nil` - in which case the parameter is left out - strings, or numbers, which are sent as their `stringValue`. The array holds strong references, so values made in the argument list itself, such as boxed numbers, live as long as it does.
+ */
+#define LFMParameters(...) ((__strong id _Nullable []){__VA_ARGS__}), (sizeof((__unsafe_unretained id []){__VA_ARGS__}) / sizeof(id))
+
+/** The array and count for endpoints without parameters. */
+#define LFMNoParameters NULL, 0
+
+/**
+ The block an endpoint's data task completes with.
+ 
+ @param error   An `NSError` object if a network, decoding or server-side error occurred, is `nil` if there is no error.
+ @param result  The model, array of models or response, as set by the endpoint's `result`. On failure, lists are empty and everything else is `nil`.
+ @param query   The paging details, or `nil` if the endpoint isn't paged or the request failed.
+ */
+typedef void (^LFMEndpointCallback)(NSError * _Nullable error, id _Nullable result, id _Nullable query);
+
+/**
+ Builds the request for a call to an endpoint. `method`, `format` and `api_key` are always sent; `sk` and the api signature are sent as the endpoint's `signing` asks.
+ 
+ @param name        The endpoint to call.
+ @param values      The values of the endpoint's parameters, in the order of its `parameters`, made with `LFMParameters`. Pass `NULL` for endpoints without parameters.
+ @param valueCount  The number of values, which must be the number of the endpoint's `parameters`. Filled in by `LFMParameters`.
+ @param sessionKey  The key of the session the call is made for. Ignored by endpoints that are never signed.
+ 
+ @return   A `GET` request, or a `POST` request with the parameters in its body.
+ */
+NSURLRequest *LFMEndpointRequest(LFMEndpointName name, const __strong id _Nullable * _Nullable values, NSUInteger valueCount, NSString * _Nullable sessionKey);
+
+/**
+ Picks the result and paging details for an endpoint out of its decoded response.
+ 
+ @param name                The endpoint the response is for.
+ @param responseDictionary  The decoded response.
+ @param query               On return, the paging details, or `nil` if there are none. Pass `NULL` if they aren't needed.
+ 
+ @return   The result described by the endpoint's `result`.
+ */
+id _Nullable LFMEndpointDecodeResponse(LFMEndpointName name, NSDictionary *responseDictionary, id _Nullable * _Nullable query);
+
+/**
+ The endpoint's `modelPath` as an array, for streaming the list it leads to.
+ */
+NSArray<NSString *> *LFMEndpointModelPath(LFMEndpointName name);
+
+/**
+ Adapts the callback of a method that only reports success or failure to an `LFMEndpointCallback`.
+ 
+ @return   A block calling `block` with the error, or `nil` if `block` is `nil`.
+ */
+LFMEndpointCallback _Nullable LFMEndpointStatusCallback(void (^ _Nullable block)(NSError * _Nullable error));
+
+/**
+ Sends a request built for an endpoint through the shared `LFMClient` and decodes the response with `LFMEndpointDecodeResponse`.
+ 
+ @param name    The endpoint the request was built for.
+ @param request The request, from `LFMEndpointRequest`.
+ @param block   The block called upon completion. If `nil`, the response isn't decoded.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
+NSURLSessionDataTask *LFMEndpointDataTaskWithRequest(LFMEndpointName name, NSURLRequest *request, LFMEndpointCallback _Nullable block);
+
+/**
+ Builds a request for an endpoint and sends it through the shared `LFMClient`. The same as calling `LFMEndpointDataTaskWithRequest` with the request from `LFMEndpointRequest`.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
+NSURLSessionDataTask *LFMEndpointDataTask(LFMEndpointName name, const __strong id _Nullable * _Nullable values, NSUInteger valueCount, NSString * _Nullable sessionKey, LFMEndpointCallback _Nullable block);
+
+NS_ASSUME_NONNULL_END
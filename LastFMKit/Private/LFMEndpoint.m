@@ -0,0 +1,475 @@
+//
+//  LFMEndpoint.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+
+#import "LFMEndpoint.h"
+#import "LFMKit+Protected.h"
+#import "LFMAuth.h"
+#import <objc/runtime.h>
+
+/** The api every endpoint is called on. */
+static NSString * const LFMEndpointBaseURLString = @"https://ws.audioscrobbler.com/2.0";
+
+/** `method`, `format`, `api_key` and `sk`, which are sent on top of an endpoint's own parameters. */
+#define LFMEndpointCommonParameterCount 4
+
+const LFMEndpoint LFMEndpointTable[LFMEndpointCount] = {
+    [LFMEndpointAlbumAddTags] = {
+        .method = @"album.addTags", .HTTPMethod = LFMEndpointHTTPMethodPOST, .signing = LFMEndpointSigningRequired,
+        .parameters = {@"album", @"artist", @"tags"}
+    },
+    [LFMEndpointAlbumRemoveTag] = {
+        .method = @"album.removeTag", .HTTPMethod = LFMEndpointHTTPMethodPOST, .signing = LFMEndpointSigningRequired,
+        .parameters = {@"album", @"artist", @"tag"}
+    },
+    [LFMEndpointAlbumGetInfo] = {
+        .method = @"album.getInfo", .result = LFMEndpointResultModel,
+        .parameters = {@"album", @"artist", @"mbid", @"autocorrect", @"username", @"lang"},
+        .modelPath = {@"album"}, .modelClass = "LFMAlbum"
+    },
+    [LFMEndpointAlbumGetTags] = {
+        .method = @"album.getTags", .signing = LFMEndpointSigningIfAuthenticated, .result = LFMEndpointResultList,
+        .parameters = {@"album", @"artist", @"mbid", @"autocorrect", @"user"},
+        .modelPath = {@"tags", @"tag"}, .modelClass = "LFMTag"
+    },
+    [LFMEndpointAlbumGetTopTags] = {
+        .method = @"album.getTopTags", .result = LFMEndpointResultList,
+        .parameters = {@"album", @"artist", @"mbid", @"autocorrect"},
+        .modelPath = {@"toptags", @"tag"}, .modelClass = "LFMTopTag"
+    },
+    [LFMEndpointAlbumSearch] = {
+        .method = @"album.search", .result = LFMEndpointResultList,
+        .parameters = {@"album", @"limit", @"page"},
+        .modelPath = {@"results", @"albummatches", @"album"}, .modelClass = "LFMAlbum",
+        .queryPath = {@"results"}, .queryClass = "LFMSearchQuery"
+    },
+    [LFMEndpointArtistAddTags] = {
+        .method = @"artist.addTags", .HTTPMethod = LFMEndpointHTTPMethodPOST, .signing = LFMEndpointSigningRequired,
+        .parameters = {@"artist", @"tags"}
+    },
+    [LFMEndpointArtistRemoveTag] = {
+        .method = @"artist.removeTag", .HTTPMethod = LFMEndpointHTTPMethodPOST, .signing = LFMEndpointSigningRequired,
+        .parameters = {@"artist", @"tag"}
+    },
+    [LFMEndpointArtistGetCorrection] = {
+        .method = @"artist.getCorrection", .result = LFMEndpointResultModel,
+        .parameters = {@"artist"},
+        .modelPath = {@"corrections", @"correction", @"artist"}, .modelClass = "LFMArtist"
+    },
+    [LFMEndpointArtistGetInfo] = {
+        .method = @"artist.getInfo", .result = LFMEndpointResultModel,
+        .parameters = {@"artist", @"mbid", @"autocorrect", @"username", @"lang"},
+        .modelPath = {@"artist"}, .modelClass = "LFMArtist"
+    },
+    [LFMEndpointArtistGetSimilar] = {
+        .method = @"artist.getSimilar", .result = LFMEndpointResultList,
+        .parameters = {@"artist", @"mbid", @"autocorrect", @"limit"},
+        .modelPath = {@"similarartists", @"artist"}, .modelClass = "LFMArtist"
+    },
+    [LFMEndpointArtistGetTags] = {
+        .method = @"artist.getTags", .signing = LFMEndpointSigningIfAuthenticated, .result = LFMEndpointResultList,
+        .parameters = {@"artist", @"mbid", @"autocorrect", @"user"},
+        .modelPath = {@"tags", @"tag"}, .modelClass = "LFMTag"
+    },
+    [LFMEndpointArtistGetTopAlbums] = {
+        .method = @"artist.getTopAlbums", .result = LFMEndpointResultList,
+        .parameters = {@"artist", @"mbid", @"page", @"limit", @"autocorrect"},
+        .modelPath = {@"topalbums", @"album"}, .modelClass = "LFMAlbum",
+        .queryPath = {@"topalbums", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointArtistGetTopTracks] = {
+        .method = @"artist.getTopTracks", .result = LFMEndpointResultList,
+        .parameters = {@"artist", @"mbid", @"page", @"limit", @"autocorrect"},
+        .modelPath = {@"toptracks", @"track"}, .modelClass = "LFMTrack",
+        .queryPath = {@"toptracks", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointArtistGetTopTags] = {
+        .method = @"artist.getTopTags", .result = LFMEndpointResultList,
+        .parameters = {@"artist", @"mbid", @"autocorrect"},
+        .modelPath = {@"toptags", @"tag"}, .modelClass = "LFMTopTag"
+    },
+    [LFMEndpointArtistSearch] = {
+        .method = @"artist.search", .result = LFMEndpointResultList,
+        .parameters = {@"artist", @"limit", @"page"},
+        .modelPath = {@"results", @"artistmatches", @"artist"}, .modelClass = "LFMArtist",
+        .queryPath = {@"results"}, .queryClass = "LFMSearchQuery"
+    },
+    [LFMEndpointChartGetTopArtists] = {
+        .method = @"chart.getTopArtists", .result = LFMEndpointResultList,
+        .parameters = {@"limit", @"page"},
+        .modelPath = {@"artists", @"artist"}, .modelClass = "LFMArtist",
+        .queryPath = {@"artists", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointChartGetTopTags] = {
+        .method = @"chart.getTopTags", .result = LFMEndpointResultList,
+        .parameters = {@"limit", @"page"},
+        .modelPath = {@"tags", @"tag"}, .modelClass = "LFMTag",
+        .queryPath = {@"tags", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointChartGetTopTracks] = {
+        .method = @"chart.getTopTracks", .result = LFMEndpointResultList,
+        .parameters = {@"limit", @"page"},
+        .modelPath = {@"tracks", @"track"}, .modelClass = "LFMTrack",
+        .queryPath = {@"tracks", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointGeoGetTopArtists] = {
+        .method = @"geo.getTopArtists", .result = LFMEndpointResultList,
+        .parameters = {@"country", @"limit", @"page"},
+        .modelPath = {@"topartists", @"artist"}, .modelClass = "LFMArtist",
+        .queryPath = {@"topartists", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointGeoGetTopTracks] = {
+        .method = @"geo.getTopTracks", .result = LFMEndpointResultList,
+        .parameters = {@"location", @"country", @"limit", @"page"},
+        .modelPath = {@"toptracks", @"track"}, .modelClass = "LFMTrack",
+        .queryPath = {@"toptracks", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointLibraryGetArtists] = {
+        .method = @"library.getArtists", .result = LFMEndpointResultList,
+        .parameters = {@"user", @"limit", @"page"},
+        .modelPath = {@"artists", @"artist"}, .modelClass = "LFMArtist",
+        .queryPath = {@"artists", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointTagGetInfo] = {
+        .method = @"tag.getInfo", .result = LFMEndpointResultModel,
+        .parameters = {@"tag", @"lang"},
+        .modelPath = {@"tag"}, .modelClass = "LFMTag"
+    },
+    [LFMEndpointTagGetTopTags] = {
+        .method = @"tag.getTopTags", .result = LFMEndpointResultList,
+        .modelPath = {@"toptags", @"tag"}, .modelClass = "LFMTag"
+    },
+    [LFMEndpointTagGetSimilar] = {
+        .method = @"tag.getSimilar", .result = LFMEndpointResultList,
+        .parameters = {@"tag"},
+        .modelPath = {@"similartags", @"tag"}, .modelClass = "LFMTag"
+    },
+    [LFMEndpointTagGetTopAlbums] = {
+        .method = @"tag.getTopAlbums", .result = LFMEndpointResultList,
+        .parameters = {@"tag", @"limit", @"page"},
+        .modelPath = {@"albums", @"album"}, .modelClass = "LFMAlbum",
+        .queryPath = {@"albums", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointTagGetTopArtists] = {
+        .method = @"tag.getTopArtists", .result = LFMEndpointResultList,
+        .parameters = {@"tag", @"limit", @"page"},
+        .modelPath = {@"topartists", @"artist"}, .modelClass = "LFMArtist",
+        .queryPath = {@"topartists", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointTagGetTopTracks] = {
+        .method = @"tag.getTopTracks", .result = LFMEndpointResultList,
+        .parameters = {@"tag", @"limit", @"page"},
+        .modelPath = {@"tracks", @"track"}, .modelClass = "LFMTrack",
+        .queryPath = {@"tracks", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointTrackUpdateNowPlaying] = {
+        .method = @"track.updateNowPlaying", .HTTPMethod = LFMEndpointHTTPMethodPOST, .signing = LFMEndpointSigningRequired,
+        .parameters = {@"album", @"artist", @"track", @"trackNumber", @"duration", @"albumArtist", @"mbid"}
+    },
+    [LFMEndpointTrackLove] = {
+        .method = @"track.love", .HTTPMethod = LFMEndpointHTTPMethodPOST, .signing = LFMEndpointSigningRequired,
+        .parameters = {@"artist", @"track"}
+    },
+    [LFMEndpointTrackUnlove] = {
+        .method = @"track.unlove", .HTTPMethod = LFMEndpointHTTPMethodPOST, .signing = LFMEndpointSigningRequired,
+        .parameters = {@"artist", @"track"}
+    },
+    [LFMEndpointTrackSearch] = {
+        .method = @"track.search", .result = LFMEndpointResultList,
+        .parameters = {@"track", @"artist", @"limit", @"page"},
+        .modelPath = {@"results", @"trackmatches", @"track"}, .modelClass = "LFMTrack",
+        .queryPath = {@"results"}, .queryClass = "LFMSearchQuery"
+    },
+    [LFMEndpointTrackGetSimilar] = {
+        .method = @"track.getSimilar", .result = LFMEndpointResultList,
+        .parameters = {@"artist", @"track", @"mbid", @"autocorrect", @"limit"},
+        .modelPath = {@"similartracks", @"track"}, .modelClass = "LFMTrack"
+    },
+    [LFMEndpointTrackGetInfo] = {
+        .method = @"track.getInfo", .result = LFMEndpointResultModel,
+        .parameters = {@"artist", @"track", @"mbid", @"autocorrect", @"username"},
+        .modelPath = {@"track"}, .modelClass = "LFMTrack"
+    },
+    [LFMEndpointTrackGetCorrection] = {
+        .method = @"track.getCorrection", .result = LFMEndpointResultModel,
+        .parameters = {@"artist", @"track"},
+        .modelPath = {@"corrections", @"correction", @"track"}, .modelClass = "LFMTrack"
+    },
+    [LFMEndpointTrackAddTags] = {
+        .method = @"track.addTags", .HTTPMethod = LFMEndpointHTTPMethodPOST, .signing = LFMEndpointSigningRequired,
+        .parameters = {@"track", @"artist", @"tags"}
+    },
+    [LFMEndpointTrackRemoveTag] = {
+        .method = @"track.removeTag", .HTTPMethod = LFMEndpointHTTPMethodPOST, .signing = LFMEndpointSigningRequired,
+        .parameters = {@"track", @"artist", @"tag"}
+    },
+    [LFMEndpointTrackGetTags] = {
+        .method = @"track.getTags", .signing = LFMEndpointSigningIfAuthenticated, .result = LFMEndpointResultList,
+        .parameters = {@"track", @"artist", @"mbid", @"autocorrect", @"user"},
+        .modelPath = {@"tags", @"tag"}, .modelClass = "LFMTag"
+    },
+    [LFMEndpointTrackGetTopTags] = {
+        .method = @"track.getTopTags", .result = LFMEndpointResultList,
+        .parameters = {@"track", @"artist", @"mbid", @"autocorrect"},
+        .modelPath = {@"toptags", @"tag"}, .modelClass = "LFMTopTag"
+    },
+    [LFMEndpointUserGetInfo] = {
+        .method = @"user.getInfo", .result = LFMEndpointResultModel,
+        .parameters = {@"user"},
+        .modelPath = {@"user"}, .modelClass = "LFMUser"
+    },
+    [LFMEndpointUserGetFriends] = {
+        .method = @"user.getFriends", .result = LFMEndpointResultList,
+        .parameters = {@"recenttracks", @"limit", @"page", @"user"},
+        .modelPath = {@"friends", @"user"}, .modelClass = "LFMUser",
+        .queryPath = {@"friends", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointUserGetArtistTracks] = {
+        .method = @"user.getArtistTracks", .result = LFMEndpointResultList,
+        .parameters = {@"user", @"artist", @"page", @"startTimestamp", @"endTimestamp"},
+        .modelPath = {@"artisttracks", @"track"}, .modelClass = "LFMTrack",
+        .queryPath = {@"artisttracks", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointUserGetLovedTracks] = {
+        .method = @"user.getLovedTracks", .result = LFMEndpointResultList,
+        .parameters = {@"limit", @"page", @"user"},
+        .modelPath = {@"lovedtracks", @"track"}, .modelClass = "LFMTrack",
+        .queryPath = {@"lovedtracks", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointUserGetPersonalTags] = {
+        // Where the items are, and what they are, depends on the tagging type asked for.
+        .method = @"user.getPersonalTags", .result = LFMEndpointResultResponse,
+        .parameters = {@"tag", @"taggingtype", @"limit", @"page", @"user"},
+        .queryPath = {@"taggings", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointUserGetRecentTracks] = {
+        .method = @"user.getRecentTracks", .result = LFMEndpointResultList,
+        .parameters = {@"user", @"limit", @"page", @"extended", @"from", @"to"},
+        .modelPath = {@"recenttracks", @"track"}, .modelClass = "LFMTrack",
+        .queryPath = {@"recenttracks", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointUserGetTopAlbums] = {
+        .method = @"user.getTopAlbums", .result = LFMEndpointResultList,
+        .parameters = {@"user", @"limit", @"page", @"period"},
+        .modelPath = {@"topalbums", @"album"}, .modelClass = "LFMAlbum",
+        .queryPath = {@"topalbums", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointUserGetTopArtists] = {
+        .method = @"user.getTopArtists", .result = LFMEndpointResultList,
+        .parameters = {@"user", @"limit", @"page", @"period"},
+        .modelPath = {@"topartists", @"artist"}, .modelClass = "LFMArtist",
+        .queryPath = {@"topartists", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointUserGetTopTracks] = {
+        .method = @"user.getTopTracks", .result = LFMEndpointResultList,
+        .parameters = {@"user", @"limit", @"page", @"period"},
+        .modelPath = {@"toptracks", @"track"}, .modelClass = "LFMTrack",
+        .queryPath = {@"toptracks", @"@attr"}, .queryClass = "LFMQuery"
+    },
+    [LFMEndpointUserGetTopTags] = {
+        .method = @"user.getTopTags", .result = LFMEndpointResultList,
+        .parameters = {@"user", @"limit"},
+        .modelPath = {@"toptags", @"tag"}, .modelClass = "LFMTopTag"
+    },
+    [LFMEndpointUserGetWeeklyAlbumChart] = {
+        .method = @"user.getWeeklyAlbumChart", .result = LFMEndpointResultList,
+        .parameters = {@"user", @"from", @"to"},
+        .modelPath = {@"weeklyalbumchart", @"album"}, .modelClass = "LFMAlbum"
+    },
+    [LFMEndpointUserGetWeeklyArtistChart] = {
+        .method = @"user.getWeeklyArtistChart", .result = LFMEndpointResultList,
+        .parameters = {@"user", @"from", @"to"},
+        .modelPath = {@"weeklyartistchart", @"artist"}, .modelClass = "LFMArtist"
+    },
+    [LFMEndpointUserGetWeeklyTrackChart] = {
+        .method = @"user.getWeeklyTrackChart", .result = LFMEndpointResultList,
+        .parameters = {@"user", @"from", @"to"},
+        .modelPath = {@"weeklytrackchart", @"track"}, .modelClass = "LFMTrack"
+    },
+    [LFMEndpointUserGetWeeklyChartList] = {
+        .method = @"user.getWeeklyChartList", .result = LFMEndpointResultList,
+        .parameters = {@"user"},
+        .modelPath = {@"weeklychartlist", @"chart"}, .modelClass = "LFMChart"
+    }
+};
+
+/** The classes named by each endpoint's `modelClass` and `queryClass`, looked up once rather than on every response. */
+static __unsafe_unretained Class LFMEndpointModelClasses[LFMEndpointCount];
+static __unsafe_unretained Class LFMEndpointQueryClasses[LFMEndpointCount];
+
+static void LFMEndpointResolveClasses(void) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        for (NSUInteger i = 0; i < LFMEndpointCount; i++) {
+            const LFMEndpoint *endpoint = &LFMEndpointTable[i];
+            LFMEndpointModelClasses[i] = endpoint->modelClass == NULL ? Nil : objc_getClass(endpoint->modelClass);
+            LFMEndpointQueryClasses[i] = endpoint->queryClass == NULL ? Nil : objc_getClass(endpoint->queryClass);
+        }
+    });
+}
+
+/**
+ Follows `path` from the root of a response. Key paths aren't used because "@attr" would be taken for a collection operator.
+ 
+ @return   The object at the end of the path, or `nil` if any step of the way isn't a dictionary.
+ */
+static id LFMEndpointObjectAtPath(id JSON, __unsafe_unretained NSString * const path[LFMEndpointMaximumPathLength]) {
+    for (NSUInteger i = 0; i < LFMEndpointMaximumPathLength && path[i] != nil; i++) {
+        if (![JSON isKindOfClass:[NSDictionary class]]) return nil;
+        JSON = [JSON objectForKey:path[i]];
+    }
+    
+    return JSON;
+}
+
+static id LFMEndpointModelFromJSON(Class modelClass, id JSON) {
+    if (modelClass == Nil || ![JSON isKindOfClass:[NSDictionary class]]) return nil;
+    return [(id)[modelClass alloc] initFromDictionary:JSON];
+}
+
+/** Parameter values are sent as they are if they are strings, and as their `stringValue` otherwise. */
+static NSString *LFMEndpointParameterValue(id value) {
+    if (value == nil || [value isKindOfClass:[NSString class]]) return value;
+    
+    NSCAssert([value respondsToSelector:@selector(stringValue)], @"Parameter values must be strings or numbers.");
+    
+    return [value stringValue];
+}
+
+NSURLRequest *LFMEndpointRequest(LFMEndpointName name, const __strong id *values, NSUInteger valueCount, NSString *sessionKey) {
+    NSCAssert(name < LFMEndpointCount, @"Unknown endpoint.");
+    
+    static NSURLComponents *baseComponents;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        baseComponents = [NSURLComponents componentsWithString:LFMEndpointBaseURLString];
+    });
+    
+    const LFMEndpoint *endpoint = &LFMEndpointTable[name];
+    
+    NSUInteger parameterCount = 0;
+    while (parameterCount < LFMEndpointMaximumParameterCount && endpoint->parameters[parameterCount] != nil) parameterCount++;
+    
+    // Reading past the values given would run off the end of the caller's array.
+    NSCAssert(values == NULL ? valueCount == 0 : valueCount == parameterCount, @"%@ takes %tu parameters, not %tu.", endpoint->method, parameterCount, valueCount);
+    
+    BOOL isSigned = endpoint->signing == LFMEndpointSigningRequired || (endpoint->signing == LFMEndpointSigningIfAuthenticated && sessionKey != nil);
+    
+    // The items are gathered on the stack so that the array is created once, at exactly the right size. Parameters without a value are left out; they would be ignored by the signature and the response cache anyway.
+    NSURLQueryItem *items[LFMEndpointMaximumParameterCount + LFMEndpointCommonParameterCount];
+    NSUInteger count = 0;
+    
+    items[count++] = [NSURLQueryItem queryItemWithName:@"method" value:endpoint->method];
+    items[count++] = [NSURLQueryItem queryItemWithName:@"format" value:@"json"];
+    
+    for (NSUInteger i = 0; values != NULL && i < MIN(valueCount, parameterCount); i++) {
+        NSString *value = LFMEndpointParameterValue(values[i]);
+        if (value == nil) continue;
+        
+        items[count++] = [NSURLQueryItem queryItemWithName:endpoint->parameters[i] value:value];
+    }
+    
+    LFMAuth *auth = [LFMAuth sharedInstance];
+    items[count++] = [NSURLQueryItem queryItemWithName:@"api_key" value:auth.apiKey];
+    
+    if (isSigned && sessionKey != nil) {
+        items[count++] = [NSURLQueryItem queryItemWithName:@"sk" value:sessionKey];
+    }
+    
+    NSArray<NSURLQueryItem *> *queryItems = [NSArray arrayWithObjects:items count:count];
+    
+    NSURLComponents *components = [baseComponents copy];
+    components.queryItems = isSigned ? [auth appendingSignatureItemToQueryItems:queryItems] : queryItems;
+    
+    if (endpoint->HTTPMethod == LFMEndpointHTTPMethodGET) {
+        return [NSURLRequest requestWithURL:components.URL];
+    }
+    
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:baseComponents.URL];
+    
+    [request setHTTPMethod:@"POST"];
+    [request setHTTPBody:[components.query dataUsingEncoding:NSUTF8StringEncoding]];
+    
+    return request;
+}
+
+id LFMEndpointDecodeResponse(LFMEndpointName name, NSDictionary *responseDictionary, id *query) {
+    NSCAssert(name < LFMEndpointCount, @"Unknown endpoint.");
+    
+    LFMEndpointResolveClasses();
+    
+    const LFMEndpoint *endpoint = &LFMEndpointTable[name];
+    
+    if (query != NULL) {
+        Class queryClass = LFMEndpointQueryClasses[name];
+        *query = queryClass == Nil ? nil : LFMEndpointModelFromJSON(queryClass, LFMEndpointObjectAtPath(responseDictionary, endpoint->queryPath));
+    }
+    
+    switch (endpoint->result) {
+        case LFMEndpointResultNone:
+            return nil;
+        case LFMEndpointResultModel:
+            return LFMEndpointModelFromJSON(LFMEndpointModelClasses[name], LFMEndpointObjectAtPath(responseDictionary, endpoint->modelPath));
+        case LFMEndpointResultList:
+            return LFMModelArray(LFMEndpointModelClasses[name], LFMEndpointObjectAtPath(responseDictionary, endpoint->modelPath));
+        case LFMEndpointResultResponse:
+            return responseDictionary;
+    }
+}
+
+NSArray<NSString *> *LFMEndpointModelPath(LFMEndpointName name) {
+    NSCAssert(name < LFMEndpointCount, @"Unknown endpoint.");
+    
+    const LFMEndpoint *endpoint = &LFMEndpointTable[name];
+    NSUInteger length = 0;
+    
+    while (length < LFMEndpointMaximumPathLength && endpoint->modelPath[length] != nil) length++;
+    
+    return [NSArray arrayWithObjects:endpoint->modelPath count:length];
+}
+
+LFMEndpointCallback LFMEndpointStatusCallback(void (^block)(NSError *)) {
+    if (block == nil) return nil;
+    
+    return ^(NSError *error, id result, id query) {
+        block(error);
+    };
+}
+
+NSURLSessionDataTask *LFMEndpointDataTaskWithRequest(LFMEndpointName name, NSURLRequest *request, LFMEndpointCallback block) {
+    return [[LFMClient sharedClient] dataTaskWithRequest:request callback:^(NSError *error, NSDictionary *responseDictionary) {
+        if (block == nil) return;
+        if (error != nil) return block(error, LFMEndpointTable[name].result == LFMEndpointResultList ? @[] : nil, nil);
+        
+        id query = nil;
+        id result = LFMEndpointDecodeResponse(name, responseDictionary, &query);
+        
+        block(error, result, query);
+    }];
+}
+
+NSURLSessionDataTask *LFMEndpointDataTask(LFMEndpointName name, const __strong id *values, NSUInteger valueCount, NSString *sessionKey, LFMEndpointCallback block) {
+    return LFMEndpointDataTaskWithRequest(name, LFMEndpointRequest(name, values, valueCount, sessionKey), block);
+}
@@ -26,11 +26,22 @@
 #import <Foundation/Foundation.h>
 
 /**
- Validates valid response JSON for any server-side last.fm errors.
+ Decodes response JSON and validates it for any server-side last.fm errors. The response body is only decoded once so the resulting object should be used for building models instead of decoding `responseData` a second time.
  
- @param responseData    Unparsed JSON response data recieved from a call to any Last.fm API method.
- @param error           An error pointer. If there is a server side error, an `NSError` object will be created with the same code and message description as the server side error.
+ @param responseData        Unparsed JSON response data recieved from a call to any Last.fm API method.
+ @param responseDictionary  A dictionary pointer. If there is no error, this will be set to the decoded response JSON. Pass `NULL` if the response body is not needed.
+ @param error               An error pointer. If there is a server side error, an `NSError` object will be created with the same code and message description as the server side error.
  
  @return   Boolean indicating whether or not there is an error - i.e. returns `YES` when there is no error and `NO` when there is an error.
  */
-BOOL lfm_error_validate(NSData *responseData, NSError * *error);
+BOOL lfm_error_validate(NSData *responseData, NSDictionary * *responseDictionary, NSError * *error);
+
+/**
+ Validates an already decoded response for any server-side last.fm errors. Used for responses that are decoded incrementally as they arrive rather than in one go by `lfm_error_validate`.
+ 
+ @param JSON    The decoded response.
+ @param error   An error pointer. If there is a server side error, an `NSError` object will be created with the same code and message description as the server side error.
+ 
+ @return   Boolean indicating whether or not there is an error - i.e. returns `YES` when there is no error and `NO` when there is an error.
+ */
+BOOL lfm_error_validate_object(id JSON, NSError * *error);
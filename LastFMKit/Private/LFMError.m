@@ -24,16 +24,34 @@
 //
 
 #import "LFMError.h"
+#import "LFMNumberParsing.h"
 
-BOOL lfm_error_validate(NSData *responseData, NSError * *error) {
-    NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:responseData options:NSJSONReadingMutableContainers error:error];
+BOOL lfm_error_validate(NSData *responseData, NSDictionary * *responseDictionary, NSError * *error) {
+    NSDictionary *JSON = [NSJSONSerialization JSONObjectWithData:responseData options:0 error:error];
     
-    NSString *errorMessage = [responseDictionary objectForKey:@"message"];
-    NSUInteger errorCode = [[responseDictionary objectForKey:@"error"] unsignedIntegerValue];
+    if (JSON != nil) lfm_error_validate_object(JSON, error);
     
-    if (errorMessage != nil && !isnan(errorCode)) {
-        *error = [NSError errorWithDomain:@"fm.last.kit.error" code:errorCode userInfo:@{NSLocalizedDescriptionKey: errorMessage}];
+    if (responseDictionary != NULL) {
+        *responseDictionary = *error == nil ? JSON : nil;
     }
     
     return *error == nil ? YES : NO;
 }
+
+BOOL lfm_error_validate_object(id JSON, NSError * *error) {
+    if (![JSON isKindOfClass:[NSDictionary class]]) return YES;
+    
+    id errorValue = [JSON objectForKey:@"error"];
+    
+    if (errorValue == nil) return YES;
+    
+    // An error whose code can't be read is still an error; the body is not a model. It is reported with code 0, which no caller treats as retryable.
+    NSUInteger errorCode = 0;
+    LFMParseUnsignedInteger(errorValue, &errorCode);
+    
+    NSString *errorMessage = [JSON objectForKey:@"message"];
+    if (![errorMessage isKindOfClass:[NSString class]]) errorMessage = @"Last.fm returned an error without a readable description.";
+    
+    *error = [NSError errorWithDomain:@"fm.last.kit.error" code:errorCode userInfo:@{NSLocalizedDescriptionKey: errorMessage}];
+    return NO;
+}
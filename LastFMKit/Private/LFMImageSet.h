@@ -0,0 +1,67 @@
+//
+//  LFMImageSet.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+#import "LFMImageSize.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The images Last.fm sends for an artist, album or user, held in one slot per `LFMImageSize`. The URLs are kept as the strings they arrived as, and the `NSURL` objects and dictionary models hand out are only created the first time they are asked for.
+ 
+ A set is filled in while it is being built and never changed after, so models that describe the same entity can share one.
+ */
+@interface LFMImageSet : NSObject
+
+/**
+ Builds a set from the `image` array of a Last.fm response.
+ 
+ @param array   An array of image dictionaries obtained from the Last.fm api.
+ 
+ @return   The set, or `nil` if there were no images of a known size.
+ */
++ (nullable LFMImageSet *)imageSetFromArray:(nullable id)array;
+
+/**
+ Files a URL under a size. Only to be called while the set is being built.
+ 
+ @return   `NO` if the size isn't one of the `LFMImageSize` constants or the URL is empty, in which case nothing is filed.
+ */
+- (BOOL)setURLString:(NSString *)URLString forSize:(NSString *)size;
+
+/** The amount of sizes there is a URL for. */
+@property(readonly) NSUInteger count;
+
+/** The images keyed by size, as models hand them out. Created on first access. */
+@property(strong, readonly) NSDictionary<LFMImageSize, NSURL *> *dictionary;
+
+/**
+ Calls `block` with every size there is a URL for, from smallest to largest, and the URL as it was received.
+ */
+- (void)enumerateURLStringsUsingBlock:(void (NS_NOESCAPE ^)(LFMImageSize size, NSString *URLString))block;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,117 @@
+//
+//  LFMImageSet.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMImageSet.h"
+
+/** One slot for each of the `LFMImageSize` constants. */
+#define LFMImageSlotCount 5
+
+static LFMImageSize LFMImageSizeForSlot(NSUInteger slot) {
+    switch (slot) {
+        case 0: return LFMImageSizeSmall;
+        case 1: return LFMImageSizeMedium;
+        case 2: return LFMImageSizeLarge;
+        case 3: return LFMImageSizeExtraLarge;
+        default: return LFMImageSizeMega;
+    }
+}
+
+/** The slot a size is filed in, or `NSNotFound` for a size Last.fm may add in future. */
+static NSUInteger LFMImageSlotForSize(NSString *size) {
+    if (![size isKindOfClass:[NSString class]]) return NSNotFound;
+    
+    for (NSUInteger slot = 0; slot < LFMImageSlotCount; slot++) {
+        LFMImageSize constant = LFMImageSizeForSlot(slot);
+        if (size == constant || [size isEqualToString:constant]) return slot;
+    }
+    
+    return NSNotFound;
+}
+
+@implementation LFMImageSet {
+    NSString *_URLStrings[LFMImageSlotCount];
+    NSUInteger _count;
+    NSDictionary<LFMImageSize, NSURL *> *_dictionary;
+}
+
++ (LFMImageSet *)imageSetFromArray:(id)array {
+    if (![array isKindOfClass:[NSArray class]] || [array count] == 0) return nil;
+    
+    LFMImageSet *imageSet = [[LFMImageSet alloc] init];
+    
+    for (NSDictionary *imageDictionary in array) {
+        if (![imageDictionary isKindOfClass:[NSDictionary class]]) continue;
+        
+        [imageSet setURLString:[imageDictionary objectForKey:@"#text"] forSize:[imageDictionary objectForKey:@"size"]];
+    }
+    
+    return imageSet->_count == 0 ? nil : imageSet;
+}
+
+- (BOOL)setURLString:(NSString *)URLString forSize:(NSString *)size {
+    NSUInteger slot = LFMImageSlotForSize(size);
+    
+    if (slot == NSNotFound || ![URLString isKindOfClass:[NSString class]] || URLString.length == 0) return NO;
+    
+    if (_URLStrings[slot] == nil) _count++;
+    _URLStrings[slot] = URLString;
+    
+    return YES;
+}
+
+- (NSUInteger)count {
+    return _count;
+}
+
+- (NSDictionary<LFMImageSize, NSURL *> *)dictionary {
+    @synchronized (self) {
+        if (_dictionary != nil) return _dictionary;
+        
+        LFMImageSize sizes[LFMImageSlotCount];
+        NSURL *URLs[LFMImageSlotCount];
+        NSUInteger count = 0;
+        
+        for (NSUInteger slot = 0; slot < LFMImageSlotCount; slot++) {
+            NSURL *URL = _URLStrings[slot] == nil ? nil : [NSURL URLWithString:_URLStrings[slot]];
+            if (URL == nil) continue;
+            
+            sizes[count] = LFMImageSizeForSlot(slot);
+            URLs[count] = URL;
+            count++;
+        }
+        
+        _dictionary = [NSDictionary dictionaryWithObjects:URLs forKeys:sizes count:count];
+        
+        return _dictionary;
+    }
+}
+
+- (void)enumerateURLStringsUsingBlock:(void (NS_NOESCAPE ^)(LFMImageSize, NSString *))block {
+    for (NSUInteger slot = 0; slot < LFMImageSlotCount; slot++) {
+        if (_URLStrings[slot] != nil) block(LFMImageSizeForSlot(slot), _URLStrings[slot]);
+    }
+}
+
+@end
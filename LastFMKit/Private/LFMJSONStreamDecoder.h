@@ -0,0 +1,74 @@
+//
+//  LFMJSONStreamDecoder.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ An incremental JSON decoder that is fed a response body as it arrives from the network.
+ 
+ List responses are made up of a small envelope around one large array - `recenttracks.track`, for example. Rather than building that array, the decoder hands each of its elements to `itemHandler` as soon as the element's closing bracket has arrived and then lets go of it, so only one item is ever held in memory alongside the envelope. If the array holds a single item Last.fm sends it as an object rather than an array of one; it is handed to `itemHandler` all the same. In the decoded envelope the array is replaced by an empty one.
+ */
+@interface LFMJSONStreamDecoder : NSObject
+
+/**
+ Initialises a new `LFMJSONStreamDecoder` object.
+ 
+ @param itemPath    The keys leading from the root object to the array whose elements are streamed, eg. `@[@"recenttracks", @"track"]`.
+ @param itemHandler The block each element of the array is passed to, in order, on the thread that appended the data completing it.
+ 
+ @return   An `LFMJSONStreamDecoder` object.
+ */
+- (instancetype)initWithItemPath:(NSArray<NSString *> *)itemPath itemHandler:(void (^)(id item))itemHandler NS_DESIGNATED_INITIALIZER;
+
+/** The amount of items that have been passed to the item handler. */
+@property(nonatomic, readonly) NSUInteger itemCount;
+
+/**
+ Decodes as much of the body as has arrived. Tokens split across chunks are held back until the rest of them is appended.
+ 
+ @param data    The next chunk of the body.
+ @param error   On return, an error in `NSCocoaErrorDomain` if the body isn't valid JSON. Once an error has occurred every subsequent call fails.
+ 
+ @return   `YES` if the data could be decoded.
+ */
+- (BOOL)appendData:(NSData *)data error:(NSError * _Nullable * _Nullable)error;
+
+/**
+ Decodes whatever is left once the whole body has been appended.
+ 
+ @param error   On return, an error in `NSCocoaErrorDomain` if the body was cut short or isn't valid JSON.
+ 
+ @return   The decoded envelope, or `nil` if an error occurred.
+ */
+- (nullable id)finishDecodingWithError:(NSError * _Nullable * _Nullable)error;
+
+- (instancetype) __unavailable init;
++ (instancetype) __unavailable new;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,558 @@
+//
+//  LFMJSONStreamDecoder.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMJSONStreamDecoder.h"
+
+typedef NS_ENUM(NSInteger, LFMJSONFrameState) {
+    LFMJSONFrameStateKeyOrEnd,
+    LFMJSONFrameStateKey,
+    LFMJSONFrameStateColon,
+    LFMJSONFrameStateValue,
+    LFMJSONFrameStateValueOrEnd,
+    LFMJSONFrameStateCommaOrEnd
+};
+
+/** The amount of distinct short strings each decoder remembers. Must be a power of two. */
+static const NSUInteger LFMJSONInternTableSize = 256;
+
+/** Strings longer than this are assumed to be one-offs - names and URLs - and are never looked up. */
+static const NSUInteger LFMJSONInternMaximumLength = 24;
+
+/**
+ A short string already seen in the body. Keys and values such as image sizes repeat in every item, so they are looked up by their bytes instead of a new string being created each time.
+ */
+typedef struct {
+    uint32_t hash;
+    uint8_t length;
+    uint8_t bytes[LFMJSONInternMaximumLength];
+    CFStringRef string;
+} LFMJSONInternedString;
+
+/** Returned by the token parsers when the token continues past the end of the data appended so far. */
+static const NSUInteger LFMJSONNeedMoreData = NSNotFound;
+
+/**
+ An object or array that is still being decoded.
+ */
+@interface LFMJSONFrame : NSObject {
+    @package
+    id _container;
+    BOOL _isObject;
+    NSString *_key;
+    LFMJSONFrameState _state;
+    NSInteger _pathIndex;
+    BOOL _streamsElements;
+    BOOL _isItem;
+}
+
+@end
+
+@implementation LFMJSONFrame
+
+@end
+
+static NSError *LFMJSONStreamError(NSString *reason, NSUInteger offset) {
+    NSString *description = [NSString stringWithFormat:@"%@ around character %tu.", reason, offset];
+    return [NSError errorWithDomain:NSCocoaErrorDomain code:NSPropertyListReadCorruptError userInfo:@{NSLocalizedDescriptionKey: @"The data couldn’t be read because it isn’t in the correct format.", NSDebugDescriptionErrorKey: description}];
+}
+
+static inline BOOL LFMJSONIsWhitespace(uint8_t c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static inline int LFMJSONHexValue(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static void LFMJSONAppendCodePoint(NSMutableData *buffer, uint32_t codePoint) {
+    uint8_t bytes[4];
+    NSUInteger length;
+    
+    if (codePoint < 0x80) {
+        bytes[0] = codePoint;
+        length = 1;
+    } else if (codePoint < 0x800) {
+        bytes[0] = 0xC0 | (codePoint >> 6);
+        bytes[1] = 0x80 | (codePoint & 0x3F);
+        length = 2;
+    } else if (codePoint < 0x10000) {
+        bytes[0] = 0xE0 | (codePoint >> 12);
+        bytes[1] = 0x80 | ((codePoint >> 6) & 0x3F);
+        bytes[2] = 0x80 | (codePoint & 0x3F);
+        length = 3;
+    } else {
+        bytes[0] = 0xF0 | (codePoint >> 18);
+        bytes[1] = 0x80 | ((codePoint >> 12) & 0x3F);
+        bytes[2] = 0x80 | ((codePoint >> 6) & 0x3F);
+        bytes[3] = 0x80 | (codePoint & 0x3F);
+        length = 4;
+    }
+    
+    [buffer appendBytes:bytes length:length];
+}
+
+@implementation LFMJSONStreamDecoder {
+    NSArray<NSString *> *_itemPath;
+    void (^_itemHandler)(id item);
+    NSUInteger _itemCount;
+    NSMutableArray<LFMJSONFrame *> *_stack;
+    NSMutableData *_pendingData;
+    NSUInteger _offset;
+    id _root;
+    BOOL _rootDecoded;
+    NSError *_error;
+    LFMJSONInternedString *_internTable;
+}
+
+- (instancetype)initWithItemPath:(NSArray<NSString *> *)itemPath itemHandler:(void (^)(id))itemHandler {
+    NSAssert(itemPath.count > 0, @"The item path must lead to an array inside the root object.");
+    
+    self = [super init];
+    
+    if (self) {
+        _itemPath = [itemPath copy];
+        _itemHandler = [itemHandler copy];
+        _stack = [NSMutableArray array];
+        _pendingData = [NSMutableData data];
+        _internTable = calloc(LFMJSONInternTableSize, sizeof(LFMJSONInternedString));
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    for (NSUInteger i = 0; i < LFMJSONInternTableSize; i++) {
+        if (_internTable[i].string != NULL) CFRelease(_internTable[i].string);
+    }
+    free(_internTable);
+}
+
+- (NSUInteger)itemCount {
+    return _itemCount;
+}
+
+- (BOOL)appendData:(NSData *)data error:(NSError **)error {
+    if (_error == nil) {
+        if (_pendingData.length == 0) {
+            // The common case: nothing was held back, so the chunk can be decoded without being copied.
+            NSUInteger consumed = [self decodeBytes:data.bytes length:data.length final:NO];
+            
+            if (_error == nil && consumed < data.length) {
+                [_pendingData appendBytes:(const uint8_t *)data.bytes + consumed length:data.length - consumed];
+            }
+        } else {
+            [_pendingData appendData:data];
+            
+            NSUInteger consumed = [self decodeBytes:_pendingData.bytes length:_pendingData.length final:NO];
+            
+            if (_error == nil) [_pendingData replaceBytesInRange:NSMakeRange(0, consumed) withBytes:NULL length:0];
+        }
+    }
+    
+    if (_error != nil && error != NULL) *error = _error;
+    
+    return _error == nil;
+}
+
+- (id)finishDecodingWithError:(NSError **)error {
+    if (_error == nil) {
+        NSUInteger consumed = [self decodeBytes:_pendingData.bytes length:_pendingData.length final:YES];
+        
+        if (_error == nil && (consumed < _pendingData.length || !_rootDecoded)) {
+            _error = LFMJSONStreamError(@"Unexpected end of data", _offset + consumed);
+        }
+        
+        _pendingData = nil;
+    }
+    
+    if (_error != nil && error != NULL) *error = _error;
+    
+    return _error == nil ? _root : nil;
+}
+
+#pragma mark - Tokens
+
+/**
+ Decodes every complete token in `bytes` and returns how many bytes were used. Whatever is left over is the start of a token that hasn't finished arriving. Sets `_error` on failure.
+ */
+- (NSUInteger)decodeBytes:(const uint8_t *)bytes length:(NSUInteger)length final:(BOOL)final {
+    NSUInteger position = 0;
+    BOOL needsMoreData = NO;
+    
+    while (_error == nil && !needsMoreData) {
+        while (position < length && LFMJSONIsWhitespace(bytes[position])) position++;
+        
+        if (position == length) break;
+        
+        if (_rootDecoded) {
+            _error = LFMJSONStreamError(@"Garbage at end", _offset + position);
+            break;
+        }
+        
+        uint8_t c = bytes[position];
+        LFMJSONFrame *frame = _stack.lastObject;
+        NSUInteger end = position + 1;
+        
+        switch (c) {
+            case '{':
+            case '[':
+                if (![self expectsValue]) break;
+                [self beginContainerIsObject:c == '{'];
+                position = end;
+                continue;
+            case '}':
+                if (frame == nil || !frame->_isObject || (frame->_state != LFMJSONFrameStateKeyOrEnd && frame->_state != LFMJSONFrameStateCommaOrEnd)) break;
+                [self endContainer];
+                position = end;
+                continue;
+            case ']':
+                if (frame == nil || frame->_isObject || (frame->_state != LFMJSONFrameStateValueOrEnd && frame->_state != LFMJSONFrameStateCommaOrEnd)) break;
+                [self endContainer];
+                position = end;
+                continue;
+            case ':':
+                if (frame == nil || frame->_state != LFMJSONFrameStateColon) break;
+                frame->_state = LFMJSONFrameStateValue;
+                position = end;
+                continue;
+            case ',':
+                if (frame == nil || frame->_state != LFMJSONFrameStateCommaOrEnd) break;
+                frame->_state = frame->_isObject ? LFMJSONFrameStateKey : LFMJSONFrameStateValue;
+                position = end;
+                continue;
+            case '"': {
+                BOOL expectsKey = frame != nil && (frame->_state == LFMJSONFrameStateKeyOrEnd || frame->_state == LFMJSONFrameStateKey);
+                if (!expectsKey && ![self expectsValue]) break;
+                
+                NSString *string = nil;
+                end = [self decodeStringInBytes:bytes length:length from:position string:&string];
+                
+                if (end == LFMJSONNeedMoreData) {
+                    if (final) _error = LFMJSONStreamError(@"Unterminated string", _offset + position);
+                    needsMoreData = YES;
+                    break;
+                }
+                if (string == nil) break;
+                
+                if (expectsKey) {
+                    frame->_key = string;
+                    frame->_state = LFMJSONFrameStateColon;
+                } else {
+                    [self addValue:string];
+                }
+                position = end;
+                continue;
+            }
+            case 't':
+            case 'f':
+            case 'n': {
+                if (![self expectsValue]) break;
+                
+                const char *literal = c == 't' ? "true" : (c == 'f' ? "false" : "null");
+                NSUInteger literalLength = strlen(literal);
+                
+                if (length - position < literalLength) {
+                    if (final) _error = LFMJSONStreamError(@"Unexpected end of data", _offset + position);
+                    needsMoreData = YES;
+                    break;
+                }
+                if (memcmp(bytes + position, literal, literalLength) != 0) break;
+                
+                [self addValue:c == 't' ? @YES : (c == 'f' ? @NO : [NSNull null])];
+                position += literalLength;
+                continue;
+            }
+            default: {
+                if (c != '-' && (c < '0' || c > '9')) break;
+                if (![self expectsValue]) break;
+                
+                while (end < length && strchr("0123456789+-.eE", bytes[end]) != NULL && bytes[end] != '\0') end++;
+                
+                // A number running up to the end of the data might have more digits still to come.
+                if (end == length && !final) {
+                    needsMoreData = YES;
+                    break;
+                }
+                
+                NSNumber *number = [self decodeNumberInBytes:bytes + position length:end - position];
+                if (number == nil) break;
+                
+                [self addValue:number];
+                position = end;
+                continue;
+            }
+        }
+        
+        // Every valid token continues the loop, so reaching here means the byte wasn't expected.
+        if (_error == nil && !needsMoreData) _error = LFMJSONStreamError([NSString stringWithFormat:@"Unexpected character '%c'", c], _offset + position);
+    }
+    
+    _offset += position;
+    return position;
+}
+
+/**
+ Decodes the string starting at the quote at `start` and returns the position after its closing quote, or `LFMJSONNeedMoreData` if the closing quote hasn't arrived. Sets `_error` and leaves `string` `nil` if the string is malformed.
+ */
+- (NSUInteger)decodeStringInBytes:(const uint8_t *)bytes length:(NSUInteger)length from:(NSUInteger)start string:(NSString * *)string {
+    NSUInteger position = start + 1;
+    BOOL escaped = NO;
+    
+    while (position < length) {
+        uint8_t c = bytes[position];
+        if (c == '"') break;
+        if (c == '\\') {
+            escaped = YES;
+            position++;
+        }
+        position++;
+    }
+    
+    if (position >= length) return LFMJSONNeedMoreData;
+    
+    if (!escaped) {
+        *string = [self stringWithBytes:bytes + start + 1 length:position - start - 1];
+    } else {
+        *string = [self unescapeBytes:bytes + start + 1 length:position - start - 1 offset:_offset + start + 1];
+    }
+    
+    if (*string == nil && _error == nil) _error = LFMJSONStreamError(@"Invalid UTF-8 in string", _offset + start);
+    
+    return position + 1;
+}
+
+- (NSString *)stringWithBytes:(const uint8_t *)bytes length:(NSUInteger)length {
+    if (length > LFMJSONInternMaximumLength) return [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+    
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (NSUInteger i = 0; i < length; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    
+    LFMJSONInternedString *entry = &_internTable[hash & (LFMJSONInternTableSize - 1)];
+    
+    if (entry->string != NULL && entry->hash == hash && entry->length == length && memcmp(entry->bytes, bytes, length) == 0) {
+        return (__bridge NSString *)entry->string;
+    }
+    
+    NSString *string = [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+    
+    // Collisions simply replace the older string; the table is a cache, not a set.
+    if (string != nil) {
+        if (entry->string != NULL) CFRelease(entry->string);
+        entry->hash = hash;
+        entry->length = length;
+        memcpy(entry->bytes, bytes, length);
+        entry->string = (CFStringRef)CFBridgingRetain(string);
+    }
+    
+    return string;
+}
+
+- (NSString *)unescapeBytes:(const uint8_t *)bytes length:(NSUInteger)length offset:(NSUInteger)offset {
+    NSMutableData *buffer = [NSMutableData dataWithCapacity:length];
+    NSUInteger position = 0;
+    
+    while (position < length) {
+        NSUInteger run = position;
+        while (run < length && bytes[run] != '\\') run++;
+        
+        [buffer appendBytes:bytes + position length:run - position];
+        if (run == length) break;
+        
+        uint8_t escape = bytes[run + 1];
+        position = run + 2;
+        
+        switch (escape) {
+            case '"': [buffer appendBytes:"\"" length:1]; break;
+            case '\\': [buffer appendBytes:"\\" length:1]; break;
+            case '/': [buffer appendBytes:"/" length:1]; break;
+            case 'b': [buffer appendBytes:"\b" length:1]; break;
+            case 'f': [buffer appendBytes:"\f" length:1]; break;
+            case 'n': [buffer appendBytes:"\n" length:1]; break;
+            case 'r': [buffer appendBytes:"\r" length:1]; break;
+            case 't': [buffer appendBytes:"\t" length:1]; break;
+            case 'u': {
+                uint32_t codePoint = 0;
+                
+                if (![self decodeHexQuadInBytes:bytes length:length from:position value:&codePoint]) {
+                    _error = LFMJSONStreamError(@"Invalid unicode escape", offset + run);
+                    return nil;
+                }
+                position += 4;
+                
+                // Characters outside the basic multilingual plane are escaped as a surrogate pair.
+                if (codePoint >= 0xD800 && codePoint < 0xDC00) {
+                    uint32_t lowSurrogate = 0;
+                    
+                    if (position + 6 > length || bytes[position] != '\\' || bytes[position + 1] != 'u' ||
+                        ![self decodeHexQuadInBytes:bytes length:length from:position + 2 value:&lowSurrogate] ||
+                        lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF) {
+                        _error = LFMJSONStreamError(@"Unpaired surrogate", offset + run);
+                        return nil;
+                    }
+                    
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+                    position += 6;
+                } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                    _error = LFMJSONStreamError(@"Unpaired surrogate", offset + run);
+                    return nil;
+                }
+                
+                LFMJSONAppendCodePoint(buffer, codePoint);
+                break;
+            }
+            default:
+                _error = LFMJSONStreamError(@"Invalid escape sequence", offset + run);
+                return nil;
+        }
+    }
+    
+    return [[NSString alloc] initWithData:buffer encoding:NSUTF8StringEncoding];
+}
+
+- (BOOL)decodeHexQuadInBytes:(const uint8_t *)bytes length:(NSUInteger)length from:(NSUInteger)position value:(uint32_t *)value {
+    if (position + 4 > length) return NO;
+    
+    uint32_t result = 0;
+    for (NSUInteger i = 0; i < 4; i++) {
+        int digit = LFMJSONHexValue(bytes[position + i]);
+        if (digit < 0) return NO;
+        result = (result << 4) | digit;
+    }
+    
+    *value = result;
+    return YES;
+}
+
+- (NSNumber *)decodeNumberInBytes:(const uint8_t *)bytes length:(NSUInteger)length {
+    char buffer[64];
+    
+    if (length >= sizeof(buffer)) {
+        _error = LFMJSONStreamError(@"Number too long", _offset);
+        return nil;
+    }
+    
+    memcpy(buffer, bytes, length);
+    buffer[length] = '\0';
+    
+    BOOL integral = strpbrk(buffer, ".eE") == NULL;
+    char *end = NULL;
+    errno = 0;
+    
+    if (integral) {
+        long long value = strtoll(buffer, &end, 10);
+        if (*end == '\0' && errno == 0) return @(value);
+    }
+    
+    errno = 0;
+    double value = strtod(buffer, &end);
+    
+    if (*end != '\0' || length == 0 || buffer[length - 1] == '.') {
+        _error = LFMJSONStreamError(@"Invalid number", _offset);
+        return nil;
+    }
+    
+    return @(value);
+}
+
+#pragma mark - Structure
+
+- (BOOL)expectsValue {
+    LFMJSONFrame *frame = _stack.lastObject;
+    
+    if (frame == nil) return !_rootDecoded;
+    
+    return frame->_state == LFMJSONFrameStateValue || frame->_state == LFMJSONFrameStateValueOrEnd;
+}
+
+- (void)beginContainerIsObject:(BOOL)isObject {
+    LFMJSONFrame *parent = _stack.lastObject;
+    LFMJSONFrame *frame = [[LFMJSONFrame alloc] init];
+    
+    frame->_isObject = isObject;
+    frame->_state = isObject ? LFMJSONFrameStateKeyOrEnd : LFMJSONFrameStateValueOrEnd;
+    frame->_pathIndex = -1;
+    
+    if (parent == nil) {
+        frame->_pathIndex = 0;
+    } else if (parent->_isObject && parent->_pathIndex >= 0 && [parent->_key isEqualToString:_itemPath[parent->_pathIndex]]) {
+        if (parent->_pathIndex + 1 < (NSInteger)_itemPath.count) {
+            frame->_pathIndex = parent->_pathIndex + 1;
+        } else if (isObject) {
+            frame->_isItem = YES;
+        } else {
+            frame->_streamsElements = YES;
+        }
+    }
+    
+    // A streamed array never holds on to its elements.
+    if (!frame->_streamsElements) {
+        frame->_container = isObject ? [NSMutableDictionary dictionary] : [NSMutableArray array];
+    }
+    
+    [_stack addObject:frame];
+}
+
+- (void)endContainer {
+    LFMJSONFrame *frame = _stack.lastObject;
+    [_stack removeLastObject];
+    
+    if (frame->_isItem) {
+        [self emitItem:[frame->_container copy]];
+    }
+    
+    // Finished containers are handed out immutable and exactly sized.
+    [self addValue:frame->_streamsElements || frame->_isItem ? @[] : [frame->_container copy]];
+}
+
+- (void)addValue:(id)value {
+    LFMJSONFrame *frame = _stack.lastObject;
+    
+    if (frame == nil) {
+        _root = value;
+        _rootDecoded = YES;
+    } else if (frame->_streamsElements) {
+        [self emitItem:value];
+    } else if (frame->_isObject) {
+        [frame->_container setObject:value forKey:frame->_key];
+        frame->_key = nil;
+    } else {
+        [frame->_container addObject:value];
+    }
+    
+    if (frame != nil) frame->_state = LFMJSONFrameStateCommaOrEnd;
+}
+
+- (void)emitItem:(id)item {
+    _itemCount++;
+    _itemHandler(item);
+}
+
+@end
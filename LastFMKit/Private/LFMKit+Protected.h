@@ -33,17 +33,62 @@
 #import "LFMSession.h"
 #import "LFMQuery.h"
 #import "LFMChart.h"
+#import "LFMScrobbleResult.h"
+#import "LFMClient.h"
+#import "LFMResponseCache.h"
+#import "LFMRateLimiter.h"
+#import "LFMRequestScheduler.h"
+#import "LFMCatalogue.h"
+#import "LFMTrackProvider.h"
+#import "LFMNowPlayingController.h"
+#import "LFMIdentityMap.h"
+#import "LFMSnapshot.h"
+#import "LFMSnapshotCoding.h"
+#import "LFMModelDecoding.h"
+#import "LFMEndpoint.h"
+#import "LFMNumberParsing.h"
+#import "LFMImageSet.h"
+#import "NSString+Interning.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
-@interface LFMAlbum()
+/**
+ A model `LFMIdentityMap` can share instances of.
+ */
+@protocol LFMIdentifiableModel <NSObject>
 
+/** The entity's MusicBrainz id, which may be empty. */
+@property(strong, nonatomic, readonly) NSString *mbid;
+
+/**
+ Copies the details `model` has and the receiver is missing - or has older versions of - into the receiver. Called on the shared instance when the same entity has been decoded again.
+ 
+ @param model   A freshly decoded instance of the same class, not yet seen by any other thread.
+ */
+- (void)mergeDetailsFromModel:(id)model;
+
+@end
+
+@interface LFMAlbum() <LFMIdentifiableModel, LFMSnapshotCoding>
+
+/** The album's images as they were received, which `images` is created from on first access. */
+@property(strong, readonly, nullable) LFMImageSet *imageSet;
+
+/**
+ Decodes an album. If there is a shared `LFMIdentityMap`, the shared instance of the album is returned instead, with the details of `dictionary` merged into it.
+ */
 - (nullable instancetype)initFromDictionary:(NSDictionary *)dictionary;
 
 @end
 
-@interface LFMArtist()
+@interface LFMArtist() <LFMIdentifiableModel, LFMSnapshotCoding>
 
+/** The artist's images as they were received, which `images` is created from on first access. */
+@property(strong, readonly, nullable) LFMImageSet *imageSet;
+
+/**
+ Decodes an artist. If there is a shared `LFMIdentityMap`, the shared instance of the artist is returned instead, with the details of `dictionary` merged into it.
+ */
 - (nullable instancetype)initFromDictionary:(NSDictionary *)dictionary;
 
 @end
@@ -54,19 +99,19 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
-@interface LFMTrack()
+@interface LFMTrack() <LFMSnapshotCoding>
 
 - (nullable instancetype)initFromDictionary:(NSDictionary *)dictionary;
 
 @end
 
-@interface LFMWiki()
+@interface LFMWiki() <LFMSnapshotCoding>
 
 - (nullable instancetype)initFromDictionary:(NSDictionary *)dictionary;
 
 @end
 
-@interface LFMTag()
+@interface LFMTag() <LFMSnapshotCoding>
 
 - (nullable instancetype)initFromDictionary:(NSDictionary *)dictionary;
 
@@ -100,4 +145,216 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+@interface LFMScrobbleResult()
+
+- (nullable instancetype)initWithTrack:(LFMScrobbleTrack *)track fromDictionary:(NSDictionary *)dictionary;
+
+@end
+
+/**
+ The callback every request made through `LFMClient` completes with.
+ 
+ @param error               An `NSError` object if a network, decoding or server-side error occurred, is `nil` if there is no error.
+ @param responseDictionary  The decoded response JSON. The body is only decoded once, so this should be used directly for building models.
+ */
+typedef void (^LFMResponseCallback)(NSError * _Nullable error, NSDictionary * _Nullable responseDictionary);
+
+@interface LFMClient()
+
+/**
+ Sends a Last.fm API request on the client's session. The response is validated for server-side errors and decoded once before `block` is called.
+ 
+ `GET` requests identical to one that is already outstanding are not sent again: `block` is attached to the outstanding request and called with the same decoded response. Every caller is handed a task of its own; cancelling one detaches only that caller, and the outstanding request is cancelled once no caller is left waiting on it.
+ 
+ Requests that go to the network wait for a token from the client's `rateLimiter` before they are sent. Requests that fail with a transient error - Last.fm errors 11, 16 and 29 or an HTTP 429 status - are retried on a new data task after a back off.
+ 
+ @param request The request to be sent.
+ @param block   The block called upon completion.
+ 
+ @return   A data task that stands for every attempt at the request. It is not a task of the client's session: it is running until `block` has been called, `-resume` and `-suspend` do nothing, and cancelling it cancels the attempt in progress and any retries.
+ */
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request callback:(LFMResponseCallback)block;
+
+/**
+ Sends a request whose response is decoded as it arrives. Each element of the array at `itemPath` is passed to `itemHandler` as soon as it has been received, on the session's delegate queue, and is not kept; `block` is then called with the rest of the response, in which the array is empty.
+ 
+ Streamed requests are scheduled and rate limited like any other, but are never cached or coalesced. They are only retried if they fail before any item has been handed out.
+ 
+ @param request     The request to be sent.
+ @param itemPath    The keys leading from the root object to the array whose elements are streamed.
+ @param itemHandler The block each element is passed to.
+ @param block       The block called upon completion.
+ 
+ @return   A data task that stands for every attempt at the request, as with `-dataTaskWithRequest:callback:`.
+ */
+- (NSURLSessionDataTask *)streamingDataTaskWithRequest:(NSURLRequest *)request
+                                              itemPath:(NSArray<NSString *> *)itemPath
+                                           itemHandler:(void (^)(id item))itemHandler
+                                              callback:(LFMResponseCallback)block;
+
+/**
+ Creates a data task for a request that has been answered without going to the network, such as one found in the client's `catalogue`. `block` is called on the session's delegate queue, as the callback of a request would have been, with a cancellation error if the task was cancelled first.
+ 
+ @param request The request that has been answered.
+ @param block   The block that calls the provider's callback with the answer, or with the error.
+ 
+ @return   The `NSURLSessionDataTask` object standing in for the web request.
+ */
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request answeredWithBlock:(void (^)(NSError * _Nullable error))block;
+
+/**
+ Builds the key identifying a request: its method name and every parameter sorted by name, excluding the api signature. Two requests with the same key are interchangeable, so the key is used both to coalesce identical in-flight requests and to look responses up in the cache.
+ 
+ @param request The request to be sent.
+ @param method  On return, the name of the Last.fm API method the request calls.
+ 
+ @return   The key, or `nil` if the request isn't a `GET` request and so can't be shared.
+ */
++ (nullable NSString *)keyForRequest:(NSURLRequest *)request method:(NSString * _Nullable * _Nonnull)method;
+
+@end
+
+@interface LFMTrackProvider()
+
+/**
+ Notifies Last.fm that the user of a particular session has started listening to a track. Identical to the public method, which calls this with the shared session's key.
+ 
+ @param sessionKey  The key of the session the update is made for.
+ 
+ @return   The `NSURLSessionDataTask` object from the web request.
+ */
++ (NSURLSessionDataTask *)updateNowPlayingWithTrackNamed:(NSString *)trackName
+                                           byArtistNamed:(NSString *)artistName
+                                            onAlbumNamed:(nullable NSString *)albumName
+                                         positionInAlbum:(nullable NSNumber *)trackNumber
+                                    withAlbumArtistNamed:(nullable NSString *)albumArtist
+                                           trackDuration:(nullable NSNumber *)duration
+                                           musicBrainzId:(nullable NSString *)mbid
+                                              sessionKey:(nullable NSString *)sessionKey
+                                                callback:(void (^_Nullable)(NSError * _Nullable))block;
+
+@end
+
+@interface LFMNowPlayingController()
+
+/**
+ Discards every controller's pending update for any of `tracks`, so that it isn't sent after the tracks have been scrobbled. Called by `LFMTrackProvider` before a scrobble request is made.
+ 
+ @param tracks      The tracks about to be scrobbled.
+ @param sessionKey  The key of the session they are scrobbled for.
+ */
++ (void)tracksWillBeScrobbled:(NSArray<LFMScrobbleTrack *> *)tracks sessionKey:(nullable NSString *)sessionKey;
+
+@end
+
+@interface LFMIdentityMap()
+
+/**
+ Returns the shared instance of the entity `model` was decoded for, merging `model`'s details into it, or files `model` as the shared instance if there is none yet.
+ 
+ @param model   A freshly decoded artist or album.
+ @param kind    The kind of entity, which keeps artists and albums with the same name apart.
+ @param name    The name the entity is identified by when it has no MusicBrainz id.
+ */
+- (id)canonicalModel:(id<LFMIdentifiableModel>)model kind:(NSString *)kind name:(NSString *)name;
+
+@end
+
+@interface LFMSnapshot()
+
+/**
+ Returns a string from the snapshot's string table, decoding it the first time it is asked for.
+ 
+ @param index   The index of the string in the table.
+ 
+ @return   The string, or `nil` if its entry in the table is corrupt.
+ */
+- (nullable NSString *)stringAtIndex:(NSUInteger)index;
+
+@end
+
+@interface LFMRateLimiter()
+
+/**
+ Calls `handler` once a token is available for `apiKey`. Handlers waiting on the same key are called in the order they asked for a token.
+ 
+ @param apiKey  The API key the request is made with, or `nil` if it couldn't be determined.
+ @param handler The block that starts the request. It is called synchronously if a token is available straight away, otherwise on a private queue.
+ */
+- (void)acquireTokenForAPIKey:(nullable NSString *)apiKey handler:(dispatch_block_t)handler;
+
+/**
+ As `acquireTokenForAPIKey:handler:`, but a request that is cancelled while it waits gives up its place without taking a token.
+ 
+ @param apiKey      The API key the request is made with, or `nil` if it couldn't be determined.
+ @param isCancelled A block returning whether the request has been cancelled, checked with the limiter's lock held whenever waiting requests are let through. Pass `nil` if the request can't be cancelled.
+ @param handler     The block that starts the request, or finds it cancelled. It is called synchronously if a token is available straight away or the request is already cancelled, otherwise on a private queue.
+ */
+- (void)acquireTokenForAPIKey:(nullable NSString *)apiKey isCancelled:(BOOL (^ _Nullable)(void))isCancelled handler:(dispatch_block_t)handler;
+
+/**
+ Stops handing out tokens for `apiKey` until `interval` has passed. Called when Last.fm reports that the rate limit has been exceeded despite the limiter.
+ 
+ @param apiKey      The API key the rate limit was exceeded for, or `nil` if it couldn't be determined.
+ @param interval    How long to wait before tokens are handed out again.
+ */
+- (void)pauseAPIKey:(nullable NSString *)apiKey forTimeInterval:(NSTimeInterval)interval;
+
+@end
+
+/**
+ Ties every attempt at one request to the scheduler and priority class it was made with, and to its place in line for superseding. Obtained from `-[LFMRequestScheduler ticketForRequestToMethod:]` when the request is made.
+ */
+@interface LFMRequestTicket : NSObject
+
+/**
+ Queues an attempt at the request. `handler` is called - synchronously if a slot is free, otherwise on whichever thread frees one - once the attempt may be started. Attempts at a request that has been superseded are cancelled instead.
+ 
+ @param dataTask    The suspended data task for the attempt.
+ @param handler     The block that starts the data task.
+ */
+- (void)scheduleDataTask:(NSURLSessionDataTask *)dataTask handler:(dispatch_block_t)handler;
+
+/**
+ Frees the slot held by an attempt, or removes it from the queue if it was cancelled before it started. Calling this more than once for a data task has no effect.
+ 
+ @param dataTask    The data task for the attempt.
+ */
+- (void)dataTaskDidComplete:(NSURLSessionDataTask *)dataTask;
+
+@end
+
+@interface LFMRequestScheduler()
+
+/**
+ Makes a ticket for a new request, cancelling earlier requests to the same method if the method cancels superseded requests. The ticket's class is the one set by an enclosing `+performRequestsWithPriority:usingBlock:` on this thread or, failing that, the one set for `method`.
+ 
+ @param method  The name of the Last.fm API method the request calls, or `nil` if it couldn't be determined.
+ */
+- (LFMRequestTicket *)ticketForRequestToMethod:(nullable NSString *)method;
+
+@end
+
+@interface LFMResponseCache()
+
+/**
+ Looks a response up in memory and, failing that, on disk. Memory hits call back synchronously; disk lookups call back on the cache's disk queue.
+ 
+ @param key     The key returned from `+[LFMClient keyForRequest:method:]`.
+ @param block   The block called with the decoded response, or `nil` if there was no valid response stored.
+ */
+- (void)lookupResponseForKey:(NSString *)key callback:(void (^)(NSDictionary * _Nullable responseDictionary))block;
+
+/**
+ Stores a validated response in memory and, if the cache has a disk path, writes its raw body to disk in the background.
+ 
+ @param responseDictionary  The decoded response.
+ @param data                The raw response body.
+ @param key                 The key returned from `+[LFMClient keyForRequest:method:]`.
+ @param method              The name of the Last.fm API method the response is for.
+ */
+- (void)storeResponse:(NSDictionary *)responseDictionary data:(NSData *)data forKey:(NSString *)key method:(NSString *)method;
+
+@end
+
 NS_ASSUME_NONNULL_END
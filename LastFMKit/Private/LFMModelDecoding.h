@@ -0,0 +1,56 @@
+//
+//  LFMModelDecoding.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Builds models from a list in a Last.fm response. Dictionaries the model can't be built from are skipped. Long lists - such as 1000 item pages - are decoded concurrently across all cores; the call still returns only once every model has been built.
+ 
+ @param modelClass  The class of the models, which must implement `initFromDictionary:`.
+ @param JSON        The decoded list. Last.fm sends a list of one as the item itself rather than an array, so a dictionary is treated as a list of one; anything else as an empty list.
+ 
+ @return   An immutable array holding exactly the models that could be built, in the order of the list.
+ */
+NSArray *LFMModelArray(Class modelClass, id _Nullable JSON);
+
+/**
+ Builds models from a list in a Last.fm response, either one after another on the calling thread or concurrently in batches on the global queue.
+ 
+ @param modelClass      The class of the models, which must implement `initFromDictionary:` in a way that is safe to call from several threads at once.
+ @param JSON            The decoded list, treated as in `LFMModelArray`.
+ @param concurrently    Whether the list should be decoded concurrently. The models are in the order of the list either way.
+ 
+ @return   An immutable array holding exactly the models that could be built, in the order of the list.
+ */
+NSArray *LFMDecodeModels(Class modelClass, id _Nullable JSON, BOOL concurrently);
+
+/**
+ Normalises a name for matching entities against each other: surrounding whitespace is removed and case and width are folded, so "Ariana Grande " and "ariana grande" match.
+ */
+NSString *LFMNormalizedName(NSString *name);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,97 @@
+//
+//  LFMModelDecoding.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMModelDecoding.h"
+#import "LFMKit+Protected.h"
+
+/** Lists shorter than this are decoded on the calling thread; spreading them out costs more than it saves. */
+static const NSUInteger LFMConcurrentDecodingThreshold = 64;
+
+/** The amount of consecutive items one worker decodes at a time. */
+static const NSUInteger LFMConcurrentDecodingStride = 16;
+
+static id LFMModelFromJSON(Class modelClass, id dictionary) {
+    if (![dictionary isKindOfClass:[NSDictionary class]]) return nil;
+    return [(id)[modelClass alloc] initFromDictionary:dictionary];
+}
+
+NSArray *LFMModelArray(Class modelClass, id JSON) {
+    NSUInteger count = [JSON isKindOfClass:[NSArray class]] ? [JSON count] : 0;
+    return LFMDecodeModels(modelClass, JSON, count >= LFMConcurrentDecodingThreshold);
+}
+
+NSArray *LFMDecodeModels(Class modelClass, id JSON, BOOL concurrently) {
+    if ([JSON isKindOfClass:[NSDictionary class]]) JSON = @[JSON];
+    if (![JSON isKindOfClass:[NSArray class]] || [JSON count] == 0) return @[];
+    
+    NSArray *dictionaries = JSON;
+    NSUInteger count = dictionaries.count;
+    
+    // Models are gathered in a plain buffer so that the array can be created once, at exactly the right size. Each item has its own slot, so workers never write to the same memory and the order of the list is kept.
+    __strong id *models = (__strong id *)calloc(count, sizeof(id));
+    
+    if (concurrently) {
+        size_t iterations = (count + LFMConcurrentDecodingStride - 1) / LFMConcurrentDecodingStride;
+        
+        dispatch_apply(iterations, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration) {
+            @autoreleasepool {
+                NSUInteger end = MIN(count, (iteration + 1) * LFMConcurrentDecodingStride);
+                
+                for (NSUInteger i = iteration * LFMConcurrentDecodingStride; i < end; i++) {
+                    models[i] = LFMModelFromJSON(modelClass, dictionaries[i]);
+                }
+            }
+        });
+    } else {
+        for (NSUInteger i = 0; i < count; i++) {
+            models[i] = LFMModelFromJSON(modelClass, dictionaries[i]);
+        }
+    }
+    
+    // Close the gaps left by items the model couldn't be built from.
+    NSUInteger built = 0;
+    for (NSUInteger i = 0; i < count; i++) {
+        if (models[i] == nil) continue;
+        if (i != built) {
+            models[built] = models[i];
+            models[i] = nil;
+        }
+        built++;
+    }
+    
+    NSArray *array = [NSArray arrayWithObjects:models count:built];
+    
+    for (NSUInteger i = 0; i < built; i++) {
+        models[i] = nil;
+    }
+    free(models);
+    
+    return array;
+}
+
+NSString *LFMNormalizedName(NSString *name) {
+    NSString *trimmed = [name stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+    return [trimmed stringByFoldingWithOptions:NSCaseInsensitiveSearch | NSWidthInsensitiveSearch locale:nil];
+}
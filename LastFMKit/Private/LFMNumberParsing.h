@@ -0,0 +1,57 @@
+//
+//  LFMNumberParsing.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Parses a count, such as `listeners` or `page`, from a Last.fm response. Last.fm sends most numbers as strings of decimal digits, and some - such as error codes - as JSON numbers; both are accepted.
+ 
+ @param value   The value from the response.
+ @param result  On return, the number, if there is one. Left untouched otherwise.
+ 
+ @return   `NO` if the value is absent - `nil`, `NSNull` or an empty string - or isn't a whole number that fits in an `NSUInteger`. Signs, whitespace, fractions and out of range values are rejected rather than wrapped or truncated.
+ */
+BOOL LFMParseUnsignedInteger(id _Nullable value, NSUInteger *result);
+
+/**
+ Parses a count from a Last.fm response for a field that may be left out, such as the `playcount` that is only sent by `getInfo` calls.
+ 
+ @return   The number, or 0 if the value is absent or invalid.
+ */
+NSUInteger LFMUnsignedIntegerValue(id _Nullable value);
+
+/**
+ Parses a Unix timestamp, such as a scrobble's `uts` or a chart's `from`, from a Last.fm response.
+ 
+ @param value   The value from the response: a string of decimal digits or a non-negative JSON number.
+ @param result  On return, the seconds since 1970, if the value is a timestamp. Left untouched otherwise.
+ 
+ @return   `NO` if the value is absent or isn't a timestamp.
+ */
+BOOL LFMParseTimestamp(id _Nullable value, NSTimeInterval *result);
+
+NS_ASSUME_NONNULL_END
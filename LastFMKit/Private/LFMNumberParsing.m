@@ -0,0 +1,112 @@
+//
+//  LFMNumberParsing.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMNumberParsing.h"
+
+/** The most digits a 64 bit count can have. */
+static const CFIndex LFMMaximumDigitCount = 20;
+
+/** Parses a string made of nothing but ASCII digits, without going through `NSScanner` or the locale. */
+static BOOL LFMParseDigits(CFStringRef string, uint64_t *result) {
+    CFIndex length = CFStringGetLength(string);
+    if (length == 0 || length > LFMMaximumDigitCount) return NO;
+    
+    // Short numbers are usually tagged pointers, which have no buffer to borrow, so they are copied out.
+    UInt8 buffer[LFMMaximumDigitCount];
+    CFIndex usedLength = 0;
+    
+    if (CFStringGetBytes(string, CFRangeMake(0, length), kCFStringEncodingASCII, 0, false, buffer, sizeof(buffer), &usedLength) != length) return NO;
+    
+    uint64_t value = 0;
+    
+    for (CFIndex i = 0; i < usedLength; i++) {
+        unsigned digit = buffer[i] - '0';
+        
+        if (digit > 9) return NO;
+        if (value > (UINT64_MAX - digit) / 10) return NO;
+        
+        value = value * 10 + digit;
+    }
+    
+    *result = value;
+    return YES;
+}
+
+/** Reads a JSON number, rejecting booleans, negative numbers and anything that isn't whole. */
+static BOOL LFMParseNumber(NSNumber *number, uint64_t *result) {
+    CFNumberRef cfNumber = (__bridge CFNumberRef)number;
+    if (CFGetTypeID(cfNumber) == CFBooleanGetTypeID()) return NO;
+    
+    if (CFNumberIsFloatType(cfNumber)) {
+        double value = number.doubleValue;
+        if (!(value >= 0 && value < 18446744073709551616.0) || value != floor(value)) return NO;
+        
+        *result = (uint64_t)value;
+        return YES;
+    }
+    
+    long long value = number.longLongValue;
+    if (value < 0) return NO;
+    
+    *result = (uint64_t)value;
+    return YES;
+}
+
+static BOOL LFMParseUnsignedInteger64(id value, uint64_t *result) {
+    if ([value isKindOfClass:[NSString class]]) return LFMParseDigits((__bridge CFStringRef)value, result);
+    if ([value isKindOfClass:[NSNumber class]]) return LFMParseNumber(value, result);
+    
+    return NO;
+}
+
+BOOL LFMParseUnsignedInteger(id value, NSUInteger *result) {
+    uint64_t parsed;
+    if (!LFMParseUnsignedInteger64(value, &parsed) || parsed > NSUIntegerMax) return NO;
+    
+    *result = (NSUInteger)parsed;
+    return YES;
+}
+
+NSUInteger LFMUnsignedIntegerValue(id value) {
+    NSUInteger result = 0;
+    LFMParseUnsignedInteger(value, &result);
+    return result;
+}
+
+BOOL LFMParseTimestamp(id value, NSTimeInterval *result) {
+    if ([value isKindOfClass:[NSNumber class]] && CFNumberIsFloatType((__bridge CFNumberRef)value)) {
+        double seconds = [value doubleValue];
+        if (!(seconds >= 0) || isinf(seconds)) return NO;
+        
+        *result = seconds;
+        return YES;
+    }
+    
+    uint64_t seconds;
+    if (!LFMParseUnsignedInteger64(value, &seconds)) return NO;
+    
+    *result = (NSTimeInterval)seconds;
+    return YES;
+}
@@ -0,0 +1,162 @@
+//
+//  LFMSnapshotCoding.h
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+#import "LFMImageSize.h"
+
+@class LFMImageSet;
+
+@class LFMSnapshot;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The version of the snapshot format written by `LFMSnapshotEncoder`. Bump it whenever a model's fields or their order change; snapshots of other versions are rejected rather than misread.
+ */
+extern const uint16_t LFMSnapshotFormatVersion;
+
+/** The most bytes a varint can take up. */
+#define LFMSnapshotMaximumVarintLength 10
+
+/**
+ Writes `value` as an unsigned LEB128 varint: seven bits per byte, least significant first, with the top bit set on every byte but the last.
+ 
+ @return   The amount of bytes written to `buffer`.
+ */
+NSUInteger LFMSnapshotWriteVarint(uint8_t buffer[_Nonnull LFMSnapshotMaximumVarintLength], uint64_t value);
+
+/**
+ Reads a varint, advancing `position` past it.
+ 
+ @return   `NO` if the varint runs past `length` or doesn't fit in 64 bits.
+ */
+BOOL LFMSnapshotReadVarint(const uint8_t *bytes, NSUInteger length, NSUInteger *position, uint64_t *value);
+
+/**
+ Writes the records of a snapshot. Integers are written as unsigned LEB128 varints, strings as indexes into a table shared by every record - so a name repeated across a million records is stored once - and nested models as records of their own, preceded by their kind.
+ */
+@interface LFMSnapshotEncoder : NSObject
+
+/** The strings referenced by the records so far, in the order of their indexes. */
+@property(strong, nonatomic, readonly) NSArray<NSString *> *strings;
+
+/** The records encoded so far, one after another. */
+@property(strong, nonatomic, readonly) NSData *records;
+
+/** The amount of records encoded so far. */
+@property(nonatomic, readonly) NSUInteger recordCount;
+
+/**
+ Returns where a record starts.
+ 
+ @param index   The position of the record, in the order they were encoded.
+ 
+ @return   The offset of the record from the start of `records`.
+ */
+- (NSUInteger)offsetOfRecordAtIndex:(NSUInteger)index;
+
+/**
+ Encodes a model as a new record.
+ 
+ @param object  A track, artist, album, tag or wiki.
+ */
+- (void)encodeRootObject:(id)object;
+
+- (void)encodeUnsignedInteger:(NSUInteger)value;
+
+- (void)encodeBool:(BOOL)value;
+
+- (void)encodeDouble:(double)value;
+
+- (void)encodeString:(nullable NSString *)string;
+
+- (void)encodeURL:(nullable NSURL *)URL;
+
+- (void)encodeImages:(nullable LFMImageSet *)images;
+
+/**
+ Encodes a model as a nested record. A model that is already being encoded further up - similar artists can refer back to each other once they are shared by an `LFMIdentityMap` - is encoded as `nil` to break the cycle.
+ 
+ @param object  A track, artist, album, tag or wiki, or `nil`.
+ */
+- (void)encodeObject:(nullable id)object;
+
+/** Encodes the amount of models in `objects` followed by each of them as a nested record. */
+- (void)encodeArrayOfObjects:(NSArray *)objects;
+
+@end
+
+/**
+ Reads one record of a snapshot. Every read is bounds checked; once anything has been read that doesn't fit the format the decoder is `corrupt` and all further reads return `nil`, 0 or `NO`.
+ */
+@interface LFMSnapshotDecoder : NSObject
+
+/**
+ @param snapshot    The snapshot the record's strings are looked up in.
+ @param bytes       The start of the record. The bytes must stay valid - which they do for as long as the snapshot is alive - while the record is decoded.
+ @param length      The amount of bytes from `bytes` to the end of the snapshot.
+ */
+- (instancetype)initWithSnapshot:(LFMSnapshot *)snapshot bytes:(const uint8_t *)bytes length:(NSUInteger)length NS_DESIGNATED_INITIALIZER;
+
+@property(nonatomic, readonly, getter=isCorrupt) BOOL corrupt;
+
+- (NSUInteger)decodeUnsignedInteger;
+
+- (BOOL)decodeBool;
+
+- (double)decodeDouble;
+
+- (nullable NSString *)decodeString;
+
+- (nullable NSURL *)decodeURL;
+
+- (nullable LFMImageSet *)decodeImages;
+
+/**
+ Decodes a nested record.
+ 
+ @param objectClass The class the record must be of, or `Nil` for any model class.
+ */
+- (nullable id)decodeObjectOfClass:(nullable Class)objectClass;
+
+- (NSArray *)decodeArrayOfObjectsOfClass:(Class)objectClass;
+
+- (instancetype) __unavailable init;
++ (instancetype) __unavailable new;
+
+@end
+
+/**
+ Implemented by every model that can be part of a snapshot, in the manner of `NSCoding`.
+ */
+@protocol LFMSnapshotCoding <NSObject>
+
+- (void)encodeWithSnapshotEncoder:(LFMSnapshotEncoder *)encoder;
+
+- (nullable instancetype)initWithSnapshotDecoder:(LFMSnapshotDecoder *)decoder;
+
+@end
+
+NS_ASSUME_NONNULL_END
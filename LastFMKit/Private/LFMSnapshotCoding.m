@@ -0,0 +1,380 @@
+//
+//  LFMSnapshotCoding.m
+//  LastFMKit
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMSnapshotCoding.h"
+#import "LFMKit+Protected.h"
+
+const uint16_t LFMSnapshotFormatVersion = 1;
+
+/** How deeply records may be nested before a snapshot is considered corrupt. Real models are nested at most four deep. */
+static const NSUInteger LFMSnapshotMaximumDepth = 32;
+
+/**
+ The kind written before every record. The values are part of the format and must never be reused.
+ */
+typedef NS_ENUM(uint8_t, LFMSnapshotKind) {
+    LFMSnapshotKindNil = 0,
+    LFMSnapshotKindTag = 1,
+    LFMSnapshotKindWiki = 2,
+    LFMSnapshotKindArtist = 3,
+    LFMSnapshotKindAlbum = 4,
+    LFMSnapshotKindTrack = 5
+};
+
+static LFMSnapshotKind LFMSnapshotKindOfObject(id object) {
+    if ([object isKindOfClass:[LFMTrack class]]) return LFMSnapshotKindTrack;
+    if ([object isKindOfClass:[LFMArtist class]]) return LFMSnapshotKindArtist;
+    if ([object isKindOfClass:[LFMAlbum class]]) return LFMSnapshotKindAlbum;
+    if ([object isKindOfClass:[LFMTag class]]) return LFMSnapshotKindTag;
+    if ([object isKindOfClass:[LFMWiki class]]) return LFMSnapshotKindWiki;
+    
+    return LFMSnapshotKindNil;
+}
+
+static Class LFMSnapshotClassForKind(LFMSnapshotKind kind) {
+    switch (kind) {
+        case LFMSnapshotKindTrack:
+            return [LFMTrack class];
+        case LFMSnapshotKindArtist:
+            return [LFMArtist class];
+        case LFMSnapshotKindAlbum:
+            return [LFMAlbum class];
+        case LFMSnapshotKindTag:
+            return [LFMTag class];
+        case LFMSnapshotKindWiki:
+            return [LFMWiki class];
+        default:
+            return Nil;
+    }
+}
+
+NSUInteger LFMSnapshotWriteVarint(uint8_t buffer[LFMSnapshotMaximumVarintLength], uint64_t value) {
+    NSUInteger length = 0;
+    
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        buffer[length++] = value == 0 ? byte : byte | 0x80;
+    } while (value != 0);
+    
+    return length;
+}
+
+BOOL LFMSnapshotReadVarint(const uint8_t *bytes, NSUInteger length, NSUInteger *position, uint64_t *value) {
+    uint64_t result = 0;
+    NSUInteger offset = *position;
+    
+    for (NSUInteger shift = 0; shift < 64; shift += 7) {
+        if (offset >= length) return NO;
+        
+        uint8_t byte = bytes[offset++];
+        
+        // The tenth byte may only hold the one bit that is left.
+        if (shift == 63 && byte > 1) return NO;
+        
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        
+        if ((byte & 0x80) == 0) {
+            *position = offset;
+            *value = result;
+            return YES;
+        }
+    }
+    
+    return NO;
+}
+
+@implementation LFMSnapshotEncoder {
+    NSMutableData *_records;
+    NSMutableData *_recordOffsets;
+    NSMutableArray<NSString *> *_strings;
+    NSMutableDictionary<NSString *, NSNumber *> *_stringIndexes;
+    NSHashTable *_objectsBeingEncoded;
+}
+
+- (instancetype)init {
+    self = [super init];
+    
+    if (self) {
+        _records = [NSMutableData data];
+        _recordOffsets = [NSMutableData data];
+        _strings = [NSMutableArray array];
+        _stringIndexes = [NSMutableDictionary dictionary];
+        _objectsBeingEncoded = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    }
+    
+    return self;
+}
+
+- (NSArray<NSString *> *)strings {
+    return _strings;
+}
+
+- (NSData *)records {
+    return _records;
+}
+
+- (NSUInteger)recordCount {
+    return _recordOffsets.length / sizeof(NSUInteger);
+}
+
+- (NSUInteger)offsetOfRecordAtIndex:(NSUInteger)index {
+    return ((const NSUInteger *)_recordOffsets.bytes)[index];
+}
+
+- (void)encodeRootObject:(id)object {
+    NSAssert(LFMSnapshotKindOfObject(object) != LFMSnapshotKindNil, @"Only tracks, artists, albums, tags and wikis can be part of a snapshot.");
+    
+    NSUInteger offset = _records.length;
+    [_recordOffsets appendBytes:&offset length:sizeof(offset)];
+    
+    [self encodeObject:object];
+}
+
+- (void)encodeUnsignedInteger:(NSUInteger)value {
+    uint8_t buffer[LFMSnapshotMaximumVarintLength];
+    [_records appendBytes:buffer length:LFMSnapshotWriteVarint(buffer, value)];
+}
+
+- (void)encodeBool:(BOOL)value {
+    uint8_t byte = value ? 1 : 0;
+    [_records appendBytes:&byte length:1];
+}
+
+- (void)encodeDouble:(double)value {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bits = CFSwapInt64HostToLittle(bits);
+    
+    [_records appendBytes:&bits length:sizeof(bits)];
+}
+
+- (void)encodeString:(NSString *)string {
+    if (string == nil) return [self encodeUnsignedInteger:0];
+    
+    NSNumber *index = _stringIndexes[string];
+    
+    if (index == nil) {
+        string = [string copy];
+        index = @(_strings.count);
+        
+        [_strings addObject:string];
+        _stringIndexes[string] = index;
+    }
+    
+    // 0 stands for nil, so indexes are stored one up.
+    [self encodeUnsignedInteger:index.unsignedIntegerValue + 1];
+}
+
+- (void)encodeURL:(NSURL *)URL {
+    [self encodeString:URL.absoluteString];
+}
+
+- (void)encodeImages:(LFMImageSet *)images {
+    [self encodeUnsignedInteger:images.count];
+    
+    [images enumerateURLStringsUsingBlock:^(LFMImageSize size, NSString *URLString) {
+        [self encodeString:size];
+        [self encodeString:URLString];
+    }];
+}
+
+- (void)encodeObject:(id<LFMSnapshotCoding>)object {
+    LFMSnapshotKind kind = object == nil || [_objectsBeingEncoded containsObject:object] ? LFMSnapshotKindNil : LFMSnapshotKindOfObject(object);
+    
+    uint8_t byte = kind;
+    [_records appendBytes:&byte length:1];
+    
+    if (kind == LFMSnapshotKindNil) return;
+    
+    [_objectsBeingEncoded addObject:object];
+    [object encodeWithSnapshotEncoder:self];
+    [_objectsBeingEncoded removeObject:object];
+}
+
+- (void)encodeArrayOfObjects:(NSArray *)objects {
+    [self encodeUnsignedInteger:objects.count];
+    
+    for (id object in objects) {
+        [self encodeObject:object];
+    }
+}
+
+@end
+
+@implementation LFMSnapshotDecoder {
+    LFMSnapshot *_snapshot;
+    const uint8_t *_bytes;
+    NSUInteger _length;
+    NSUInteger _position;
+    NSUInteger _depth;
+    BOOL _corrupt;
+}
+
+- (instancetype)initWithSnapshot:(LFMSnapshot *)snapshot bytes:(const uint8_t *)bytes length:(NSUInteger)length {
+    self = [super init];
+    
+    if (self) {
+        _snapshot = snapshot;
+        _bytes = bytes;
+        _length = length;
+    }
+    
+    return self;
+}
+
+- (BOOL)isCorrupt {
+    return _corrupt;
+}
+
+- (NSUInteger)decodeUnsignedInteger {
+    uint64_t value = 0;
+    
+    if (_corrupt || !LFMSnapshotReadVarint(_bytes, _length, &_position, &value) || value > NSUIntegerMax) {
+        _corrupt = YES;
+        return 0;
+    }
+    
+    return (NSUInteger)value;
+}
+
+- (BOOL)decodeBool {
+    if (_corrupt || _position >= _length || _bytes[_position] > 1) {
+        _corrupt = YES;
+        return NO;
+    }
+    
+    return _bytes[_position++] == 1;
+}
+
+- (double)decodeDouble {
+    uint64_t bits;
+    
+    if (_corrupt || _length - _position < sizeof(bits)) {
+        _corrupt = YES;
+        return 0;
+    }
+    
+    memcpy(&bits, _bytes + _position, sizeof(bits));
+    _position += sizeof(bits);
+    bits = CFSwapInt64LittleToHost(bits);
+    
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    
+    return value;
+}
+
+- (NSString *)decodeString {
+    NSUInteger index = [self decodeUnsignedInteger];
+    if (index == 0) return nil;
+    
+    NSString *string = [_snapshot stringAtIndex:index - 1];
+    if (string == nil) _corrupt = YES;
+    
+    return string;
+}
+
+- (NSURL *)decodeURL {
+    NSString *string = [self decodeString];
+    return string == nil ? nil : [NSURL URLWithString:string];
+}
+
+- (LFMImageSet *)decodeImages {
+    NSUInteger count = [self decodeUnsignedInteger];
+    
+    // Every image takes at least two bytes, which keeps a corrupt count from running far past the end.
+    if (count == 0 || count > (_length - _position) / 2) {
+        if (count != 0) _corrupt = YES;
+        return nil;
+    }
+    
+    LFMImageSet *images = [[LFMImageSet alloc] init];
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        NSString *size = [self decodeString];
+        NSString *URLString = [self decodeString];
+        
+        if (size != nil && URLString != nil) [images setURLString:URLString forSize:size];
+    }
+    
+    return images.count == 0 ? nil : images;
+}
+
+- (id)decodeObjectOfClass:(Class)objectClass {
+    if (_corrupt || _position >= _length) {
+        _corrupt = YES;
+        return nil;
+    }
+    
+    LFMSnapshotKind kind = _bytes[_position++];
+    if (kind == LFMSnapshotKindNil) return nil;
+    
+    Class kindClass = LFMSnapshotClassForKind(kind);
+    
+    if (kindClass == Nil || (objectClass != Nil && kindClass != objectClass) || _depth >= LFMSnapshotMaximumDepth) {
+        _corrupt = YES;
+        return nil;
+    }
+    
+    _depth++;
+    id object = [(id<LFMSnapshotCoding>)[kindClass alloc] initWithSnapshotDecoder:self];
+    _depth--;
+    
+    // A record missing the fields its model requires is as unusable as one that runs off the end.
+    if (object == nil) _corrupt = YES;
+    
+    return _corrupt ? nil : object;
+}
+
+- (NSArray *)decodeArrayOfObjectsOfClass:(Class)objectClass {
+    NSUInteger count = [self decodeUnsignedInteger];
+    
+    // Every object takes at least a byte.
+    if (count == 0 || count > _length - _position) {
+        if (count != 0) _corrupt = YES;
+        return @[];
+    }
+    
+    __strong id *objects = (__strong id *)calloc(count, sizeof(id));
+    NSUInteger decoded = 0;
+    
+    for (NSUInteger i = 0; i < count && !_corrupt; i++) {
+        // Objects left out to break a cycle were encoded as nil.
+        id object = [self decodeObjectOfClass:objectClass];
+        if (object != nil) objects[decoded++] = object;
+    }
+    
+    NSArray *array = _corrupt ? @[] : [NSArray arrayWithObjects:objects count:decoded];
+    
+    for (NSUInteger i = 0; i < decoded; i++) {
+        objects[i] = nil;
+    }
+    free(objects);
+    
+    return array;
+}
+
+@end
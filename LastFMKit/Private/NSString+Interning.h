@@ -1,5 +1,5 @@
 //
-//  NSString+UnsignedIntegerValue.h
+//  NSString+Interning.h
 //  LastFMKit
 //
 //  Copyright © 2017 Mark Bourke.
@@ -25,8 +25,11 @@
 
 #import <Foundation/Foundation.h>
 
-@interface NSString (UnsignedIntegerValue)
+@interface NSString (Interning)
 
-@property(readonly) NSUInteger unsignedIntegerValue;
+/**
+ A single shared instance of every string equal to the receiver, so that values repeated throughout a response - artist and tag names, for example - are only kept in memory once however many models hold them. Interned strings are released when nothing else holds them.
+ */
+@property(readonly) NSString *internedString;
 
 @end
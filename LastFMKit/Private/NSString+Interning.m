@@ -1,5 +1,5 @@
 //
-//  NSString+UnsignedIntegerValue.m
+//  NSString+Interning.m
 //  LastFMKit
 //
 //  Copyright © 2017 Mark Bourke.
@@ -23,12 +23,28 @@
 //  THE SOFTWARE
 //
 
-#import "NSString+UnsignedIntegerValue.h"
+#import "NSString+Interning.h"
 
-@implementation NSString (UnsignedIntegerValue)
+@implementation NSString (Interning)
 
-- (NSUInteger)unsignedIntegerValue {
-    return (NSUInteger)[self integerValue];
+- (NSString *)internedString {
+    static NSHashTable<NSString *> *internedStrings;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        internedStrings = [NSHashTable weakObjectsHashTable];
+    });
+    
+    @synchronized (internedStrings) {
+        NSString *internedString = [internedStrings member:self];
+        
+        if (internedString == nil) {
+            // Mutable strings must not be shared.
+            internedString = [self copy];
+            [internedStrings addObject:internedString];
+        }
+        
+        return internedString;
+    }
 }
 
 @end
@@ -38,6 +38,7 @@ FOUNDATION_EXPORT const unsigned char LastFMKitVersionString[];
 #import <LastFMKit/LFMUser.h>
 #import <LastFMKit/LFMTrack.h>
 #import <LastFMKit/LFMScrobbleTrack.h>
+#import <LastFMKit/LFMScrobbleResult.h>
 #import <LastFMKit/LFMTag.h>
 #import <LastFMKit/LFMTopTag.h>
 #import <LastFMKit/LFMWiki.h>
@@ -45,6 +46,8 @@ FOUNDATION_EXPORT const unsigned char LastFMKitVersionString[];
 #import <LastFMKit/LFMQuery.h>
 #import <LastFMKit/LFMSearchQuery.h>
 #import <LastFMKit/LFMChart.h>
+#import <LastFMKit/LFMIdentityMap.h>
+#import <LastFMKit/LFMSnapshot.h>
 
 #pragma mark - Methods
 
@@ -56,8 +59,18 @@ FOUNDATION_EXPORT const unsigned char LastFMKitVersionString[];
 #import <LastFMKit/LFMTagProvider.h>
 #import <LastFMKit/LFMTrackProvider.h>
 #import <LastFMKit/LFMUserProvider.h>
+#import <LastFMKit/LFMClient.h>
+#import <LastFMKit/LFMResponseCache.h>
+#import <LastFMKit/LFMCatalogue.h>
+#import <LastFMKit/LFMScrobbleQueue.h>
+#import <LastFMKit/LFMNowPlayingController.h>
+#import <LastFMKit/LFMPager.h>
+#import <LastFMKit/LFMHistoryExporter.h>
+#import <LastFMKit/LFMRateLimiter.h>
+#import <LastFMKit/LFMRequestScheduler.h>
 
 #pragma mark - Authentication
 
 #import <LastFMKit/LFMSession.h>
 #import <LastFMKit/LFMAuth.h>
+#import <LastFMKit/LFMSessionRegistry.h>
@@ -0,0 +1,48 @@
+//
+//  LFMAllocationCounter.h
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The heap allocations made while a block ran.
+ */
+typedef struct {
+    /** The amount of `malloc`, `calloc` and `realloc` calls, on any thread. */
+    NSUInteger allocations;
+    
+    /** The amount of bytes those calls asked for. */
+    NSUInteger bytes;
+} LFMAllocationStatistics;
+
+/**
+ Counts every heap allocation made while `block` runs by installing a malloc logger - the hook Instruments' allocations tool uses - for its duration. Blocks being counted must not be run concurrently.
+ 
+ @param block   The block to measure.
+ */
+LFMAllocationStatistics LFMCountAllocations(NS_NOESCAPE dispatch_block_t block);
+
+NS_ASSUME_NONNULL_END
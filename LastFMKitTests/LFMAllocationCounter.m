@@ -0,0 +1,58 @@
+//
+//  LFMAllocationCounter.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMAllocationCounter.h"
+#import <stdatomic.h>
+
+// Exported by libmalloc and called on every allocation and free while set. See libmalloc's stack_logging.h.
+typedef void (LFMMallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t framesToSkip);
+extern LFMMallocLogger *malloc_logger;
+
+static const uint32_t LFMMallocLogTypeAllocate = 2;
+static const uint32_t LFMMallocLogTypeDeallocate = 4;
+
+static atomic_ulong allocationCount;
+static atomic_ulong allocatedBytes;
+
+static void LFMCountingMallocLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t framesToSkip) {
+    if ((type & LFMMallocLogTypeAllocate) == 0) return;
+    
+    atomic_fetch_add(&allocationCount, 1);
+    
+    // For a reallocation the second argument is the old pointer and the third the new size.
+    atomic_fetch_add(&allocatedBytes, (type & LFMMallocLogTypeDeallocate) ? arg3 : arg2);
+}
+
+LFMAllocationStatistics LFMCountAllocations(dispatch_block_t block) {
+    atomic_store(&allocationCount, 0);
+    atomic_store(&allocatedBytes, 0);
+    
+    LFMMallocLogger *previousLogger = malloc_logger;
+    malloc_logger = LFMCountingMallocLogger;
+    block();
+    malloc_logger = previousLogger;
+    
+    return (LFMAllocationStatistics){atomic_load(&allocationCount), atomic_load(&allocatedBytes)};
+}
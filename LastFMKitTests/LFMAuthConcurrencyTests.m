@@ -0,0 +1,139 @@
+//
+//  LFMAuthConcurrencyTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+
+@interface LFMAuth (Testing)
+
+- (void)setSession:(nullable LFMSession *)session;
+- (id)credentials;
+
+@end
+
+@interface LFMAuthConcurrencyTests : XCTestCase
+
+@end
+
+@implementation LFMAuthConcurrencyTests {
+    LFMAuth *_auth;
+    NSArray<LFMSession *> *_sessions;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Warc-performSelector-leaks"
+    _auth = [[LFMAuth alloc] performSelector:NSSelectorFromString(@"init")];
+#pragma clang diagnostic pop
+    _auth.apiKey = @"bc15dd6972bc0f7c952273b34d253a6a";
+    _auth.apiSecret = @"d46ca773c61a3907c0b19c777c5bcf20";
+    
+    _sessions = @[[[LFMSession alloc] initWithSessionKey:@"d580d57f32848f5dcf574d1ce18d78b2" userName:@"mourke" userIsSubscriber:NO],
+                  [[LFMSession alloc] initWithSessionKey:@"5a4d8b2f1c3e6d7f8a9b0c1d2e3f4a5b" userName:@"ariana" userIsSubscriber:YES]];
+    (void)_auth.session; // Let the keychain read finish so it doesn't replace the sessions set below.
+}
+
+- (void)tearDown {
+    [_auth removeSession];
+    
+    [super tearDown];
+}
+
+/** Builds and signs a love request the way `LFMTrackProvider` does. */
+static void LFMSignLoveRequest(LFMAuth *auth) {
+    NSArray *queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"track.love"],
+                            [NSURLQueryItem queryItemWithName:@"artist" value:@"Ariana Grande"],
+                            [NSURLQueryItem queryItemWithName:@"track" value:@"Be Alright"],
+                            [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
+                            [NSURLQueryItem queryItemWithName:@"api_key" value:auth.apiKey],
+                            [NSURLQueryItem queryItemWithName:@"sk" value:auth.session.sessionKey]];
+    [auth appendingSignatureItemToQueryItems:queryItems];
+}
+
+- (void)testSessionChangesAreSafeWhileSigning {
+    LFMAuth *auth = _auth;
+    NSArray<LFMSession *> *sessions = _sessions;
+    
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+        for (NSUInteger i = 0; i < 10000; i++) {
+            if (thread == 0) {
+                // Every change is also written to the keychain, so don't queue up thousands of writes.
+                if (i % 100 == 0) [auth setSession:sessions[(i / 100) % 2]];
+            } else {
+                LFMSession *session = auth.session;
+                XCTAssertTrue(session == nil || [sessions containsObject:session]);
+                LFMSignLoveRequest(auth);
+            }
+        }
+    });
+}
+
+- (void)testReplacedCredentialsAreReleased {
+    __weak id replaced;
+    
+    @autoreleasepool {
+        replaced = [_auth credentials];
+        [_auth setSession:_sessions[0]];
+    }
+    
+    XCTAssertNil(replaced);
+    XCTAssertEqualObjects(_auth.session, _sessions[0]);
+}
+
+- (void)testSigningThroughputScalesWithThreads {
+    LFMAuth *auth = _auth;
+    NSArray<LFMSession *> *sessions = _sessions;
+    NSUInteger requestsPerThread = 20000;
+    [auth setSession:sessions[0]];
+    
+    for (NSUInteger threads = 1; threads <= 16; threads *= 2) {
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        
+        dispatch_apply(threads, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+            for (NSUInteger i = 0; i < requestsPerThread; i++) {
+                // An occasional sign in or out, as an app would make, while every other thread keeps signing.
+                if (thread == 0 && i % 1000 == 0) [auth setSession:sessions[(i / 1000) % 2]];
+                
+                LFMSignLoveRequest(auth);
+            }
+        });
+        
+        CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+        NSLog(@"Signing on %tu threads: %.0f requests per second", threads, threads * requestsPerThread / elapsed);
+    }
+    
+    [self measureBlock:^{
+        dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+            for (NSUInteger i = 0; i < 10000; i++) {
+                LFMSignLoveRequest(auth);
+            }
+        });
+    }];
+}
+
+@end
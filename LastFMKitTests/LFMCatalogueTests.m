@@ -0,0 +1,234 @@
+//
+//  LFMCatalogueTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import <LastFMKit/LFMModelDecoding.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
+
+@interface LFMCatalogueTests : XCTestCase
+
+@end
+
+@implementation LFMCatalogueTests {
+    LFMArtist *_artist;
+    LFMAlbum *_album;
+    LFMTrack *_track;
+    NSArray<LFMArtist *> *_artists;
+    LFMCatalogue *_catalogue;
+    LFMClient *_previousClient;
+    LFMClient *_client;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+    
+    NSDictionary *artistInfo = [[NSJSONSerialization JSONObjectWithData:LFMFixtureArtistInfo() options:0 error:nil] objectForKey:@"artist"];
+    NSArray *trackList = [[[NSJSONSerialization JSONObjectWithData:LFMFixtureRecentTracksPage(1, 1, 1) options:0 error:nil] objectForKey:@"recenttracks"] objectForKey:@"track"];
+    NSArray *artistList = [[[NSJSONSerialization JSONObjectWithData:LFMFixtureTopArtistsPage(1000) options:0 error:nil] objectForKey:@"artists"] objectForKey:@"artist"];
+    
+    NSMutableDictionary *trackInfo = [trackList[0] mutableCopy];
+    NSMutableDictionary *trackArtist = [trackInfo[@"artist"] mutableCopy];
+    trackArtist[@"streamable"] = @"0";
+    trackInfo[@"artist"] = trackArtist;
+    
+    _artist = LFMModelArray([LFMArtist class], artistInfo).firstObject;
+    _track = LFMModelArray([LFMTrack class], trackInfo).firstObject;
+    _album = LFMModelArray([LFMAlbum class], @{@"name" : @"Dangerous Woman",
+                                               @"artist" : @"Ariana Grande",
+                                               @"mbid" : @"ed0ee2bf-5e9e-4a8f-b1a0-0b0b1c7d1a3d",
+                                               @"url" : @"https://www.last.fm/music/Ariana+Grande/Dangerous+Woman",
+                                               @"streamable" : @"0",
+                                               @"listeners" : @"412310"}).firstObject;
+    _artists = LFMModelArray([LFMArtist class], artistList);
+    
+    NSArray *objects = [@[_artist, _album, _track] arrayByAddingObjectsFromArray:_artists];
+    _catalogue = [[LFMCatalogue alloc] initWithData:[LFMCatalogue dataWithObjects:objects] error:nil];
+    
+    [LFMStubURLProtocol reset];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureArtistInfo();
+    }];
+    
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    _client.catalogue = _catalogue;
+    [LFMClient setSharedClient:_client];
+}
+
+- (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+    
+    [super tearDown];
+}
+
+- (void)testLookupByName {
+    XCTAssertNotNil(_track.artist);
+    XCTAssertEqual(_catalogue.count, 1003);
+    
+    XCTAssertEqualObjects([_catalogue artistNamed:@"Ariana Grande" withMusicBrainzId:nil].URL, _artist.URL);
+    XCTAssertEqualObjects([_catalogue albumNamed:@"Dangerous Woman" byArtistNamed:@"Ariana Grande" withMusicBrainzId:nil].URL, _album.URL);
+    XCTAssertEqualObjects([_catalogue trackNamed:_track.name byArtistNamed:@"Ariana Grande" withMusicBrainzId:nil].URL, _track.URL);
+    XCTAssertEqual([_catalogue artistNamed:@"Artist 999" withMusicBrainzId:nil].listeners, _artists[999].listeners);
+}
+
+- (void)testNamesAreNormalised {
+    XCTAssertNotNil([_catalogue artistNamed:@"  ariana GRANDE\n" withMusicBrainzId:nil]);
+    XCTAssertNotNil([_catalogue artistNamed:@"ＡＲＩＡＮＡ ＧＲＡＮＤＥ" withMusicBrainzId:nil]);
+    XCTAssertNotNil([_catalogue albumNamed:@"dangerous woman" byArtistNamed:@"ariana grande" withMusicBrainzId:nil]);
+}
+
+- (void)testLookupByMusicBrainzId {
+    XCTAssertEqualObjects([_catalogue artistNamed:nil withMusicBrainzId:@"F4FDBB4C-E4B7-47A0-B83B-D91BBFCFA387"].name, @"Ariana Grande");
+    XCTAssertEqualObjects([_catalogue albumNamed:nil byArtistNamed:nil withMusicBrainzId:_album.mbid].name, @"Dangerous Woman");
+    XCTAssertEqualObjects([_catalogue trackNamed:nil byArtistNamed:nil withMusicBrainzId:_track.mbid].name, _track.name);
+    
+    // The id is tried first and isn't second-guessed by the name.
+    XCTAssertNil([_catalogue artistNamed:@"Ariana Grande" withMusicBrainzId:@"00000000-0000-0000-0000-000000000000"]);
+}
+
+- (void)testMisses {
+    XCTAssertNil([_catalogue artistNamed:@"Selena Gomez" withMusicBrainzId:nil]);
+    XCTAssertNil([_catalogue albumNamed:@"Dangerous Woman" byArtistNamed:@"Selena Gomez" withMusicBrainzId:nil]);
+    XCTAssertNil([_catalogue albumNamed:@"Ariana Grande" byArtistNamed:@"Ariana Grande" withMusicBrainzId:nil]);
+    XCTAssertNil([_catalogue trackNamed:@"Dangerous Woman" byArtistNamed:@"Ariana Grande" withMusicBrainzId:nil]);
+    
+    // Kinds are indexed separately.
+    XCTAssertNil([_catalogue albumNamed:nil byArtistNamed:nil withMusicBrainzId:_artist.mbid]);
+}
+
+- (void)testEmptyCatalogue {
+    LFMCatalogue *catalogue = [[LFMCatalogue alloc] initWithData:[LFMCatalogue dataWithObjects:@[]] error:nil];
+    
+    XCTAssertEqual(catalogue.count, 0);
+    XCTAssertNil([catalogue artistNamed:@"Ariana Grande" withMusicBrainzId:nil]);
+}
+
+- (void)testMappedFile {
+    NSURL *URL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]];
+    XCTAssertTrue([[LFMCatalogue dataWithObjects:_artists] writeToURL:URL atomically:YES]);
+    
+    NSError *error = nil;
+    LFMCatalogue *catalogue = [[LFMCatalogue alloc] initWithContentsOfURL:URL error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssertEqual(catalogue.count, 1000);
+    XCTAssertEqualObjects([catalogue artistNamed:@"Artist 500" withMusicBrainzId:nil].name, @"Artist 500");
+    
+    [[NSFileManager defaultManager] removeItemAtURL:URL error:nil];
+}
+
+- (void)testInvalidData {
+    NSError *error = nil;
+    
+    XCTAssertNil([[LFMCatalogue alloc] initWithData:[@"Not a catalogue" dataUsingEncoding:NSUTF8StringEncoding] error:&error]);
+    XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain);
+    XCTAssertEqual(error.code, NSFileReadCorruptFileError);
+    
+    NSData *data = [LFMCatalogue dataWithObjects:@[_artist]];
+    
+    for (NSUInteger length = 0; length < data.length; length += 7) {
+        LFMCatalogue *catalogue = [[LFMCatalogue alloc] initWithData:[data subdataWithRange:NSMakeRange(0, length)] error:nil];
+        
+        // Cut short in the records, a catalogue can still be opened but the entry isn't found.
+        XCTAssertNil([catalogue artistNamed:@"Ariana Grande" withMusicBrainzId:nil]);
+    }
+}
+
+- (void)testProviderIsAnsweredFromCatalogue {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Artist info"];
+    
+    NSURLSessionDataTask *dataTask = [LFMArtistProvider getInfoOnArtistNamed:@"ariana grande" withMusicBrainzId:nil autoCorrect:YES forUser:nil languageCode:nil callback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(artist.name, @"Ariana Grande");
+        XCTAssertEqual(artist.similarArtists.count, 5);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual(dataTask.state, NSURLSessionTaskStateCompleted);
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 0);
+}
+
+- (void)testPerUserRequestGoesToNetwork {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Artist info"];
+    
+    [LFMArtistProvider getInfoOnArtistNamed:@"Ariana Grande" withMusicBrainzId:nil autoCorrect:YES forUser:@"mourke" languageCode:nil callback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 1);
+}
+
+- (void)testOpeningPerformance {
+    NSMutableArray<LFMArtist *> *artists = [NSMutableArray arrayWithCapacity:100 * _artists.count];
+    
+    for (NSUInteger i = 0; i < 100; i++) {
+        for (NSDictionary *artist in [[[NSJSONSerialization JSONObjectWithData:LFMFixtureTopArtistsPage(1000) options:0 error:nil] objectForKey:@"artists"] objectForKey:@"artist"]) {
+            NSMutableDictionary *renamed = [artist mutableCopy];
+            renamed[@"name"] = [NSString stringWithFormat:@"%@ %tu", artist[@"name"], i];
+            [artists addObject:LFMModelArray([LFMArtist class], renamed).firstObject];
+        }
+    }
+    
+    NSURL *URL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]];
+    XCTAssertTrue([[LFMCatalogue dataWithObjects:artists] writeToURL:URL atomically:YES]);
+    
+    // Opening reads nothing but the header, so it costs the same for 100,000 entries as for one.
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 100; i++) {
+            @autoreleasepool {
+                LFMCatalogue *catalogue = [[LFMCatalogue alloc] initWithContentsOfURL:URL error:nil];
+                XCTAssertEqual(catalogue.count, 100000);
+                XCTAssertNotNil([catalogue artistNamed:@"Artist 999 99" withMusicBrainzId:nil]);
+            }
+        }
+    }];
+    
+    [[NSFileManager defaultManager] removeItemAtURL:URL error:nil];
+}
+
+- (void)testLookupPerformance {
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10000; i++) {
+            @autoreleasepool {
+                XCTAssertNotNil([self->_catalogue artistNamed:[NSString stringWithFormat:@"Artist %tu", i % 1000] withMusicBrainzId:nil]);
+            }
+        }
+    }];
+}
+
+@end
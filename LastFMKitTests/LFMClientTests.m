@@ -0,0 +1,200 @@
+//
+//  LFMClientTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
+
+@interface LFMClientTests : XCTestCase
+
+@end
+
+@implementation LFMClientTests {
+    LFMClient *_previousClient;
+    LFMClient *_client;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+    
+    [LFMStubURLProtocol reset];
+    
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    [LFMClient setSharedClient:_client];
+}
+
+- (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+    
+    [super tearDown];
+}
+
+- (void)testProvidersRouteThroughSharedClient {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Artist info"];
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureArtistInfo();
+    }];
+    
+    NSURLSessionDataTask *dataTask = [LFMArtistProvider getInfoOnArtistNamed:@"Ariana Grande" withMusicBrainzId:nil autoCorrect:YES forUser:nil languageCode:nil callback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(artist.name, @"Ariana Grande");
+        XCTAssertEqual(artist.similarArtists.count, 5);
+        [expectation fulfill];
+    }];
+    
+    XCTAssertNotNil(dataTask);
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 1);
+}
+
+- (void)testServerErrorsAreSurfaced {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Artist info"];
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureError(6);
+    }];
+    
+    [LFMArtistProvider getInfoOnArtistNamed:@"Ariana Grande" withMusicBrainzId:nil autoCorrect:YES forUser:nil languageCode:nil callback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        XCTAssertEqual(error.code, 6);
+        XCTAssertNil(artist);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void)testConcurrentIdenticalRequestsAreCoalesced {
+    const NSUInteger callers = 100;
+    NSMutableArray<XCTestExpectation *> *expectations = [NSMutableArray arrayWithCapacity:callers];
+    NSMutableSet<NSURLSessionDataTask *> *dataTasks = [NSMutableSet set];
+    
+    for (NSUInteger i = 0; i < callers; i++) {
+        [expectations addObject:[self expectationWithDescription:[NSString stringWithFormat:@"Caller %tu", i]]];
+    }
+    
+    [LFMStubURLProtocol setResponseDelay:0.5];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureArtistInfo();
+    }];
+    
+    dispatch_apply(callers, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        NSURLSessionDataTask *dataTask = [LFMArtistProvider getInfoOnArtistNamed:@"Ariana Grande" withMusicBrainzId:nil autoCorrect:YES forUser:nil languageCode:nil callback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+            XCTAssertNil(error);
+            XCTAssertEqualObjects(artist.name, @"Ariana Grande");
+            [expectations[i] fulfill];
+        }];
+        
+        @synchronized (dataTasks) {
+            [dataTasks addObject:dataTask];
+        }
+    });
+    
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 1);
+    XCTAssertEqual(dataTasks.count, callers);
+}
+
+- (void)testCancellingOneCoalescedCallerLeavesTheOthers {
+    XCTestExpectation *cancelledExpectation = [self expectationWithDescription:@"Cancelled caller"];
+    XCTestExpectation *waitingExpectation = [self expectationWithDescription:@"Waiting caller"];
+    
+    [LFMStubURLProtocol setResponseDelay:0.5];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureArtistInfo();
+    }];
+    
+    NSURLSessionDataTask *cancelledTask = [LFMArtistProvider getInfoOnArtistNamed:@"Ariana Grande" withMusicBrainzId:nil autoCorrect:YES forUser:nil languageCode:nil callback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        XCTAssertEqual(error.code, NSURLErrorCancelled);
+        XCTAssertNil(artist);
+        [cancelledExpectation fulfill];
+    }];
+    [LFMArtistProvider getInfoOnArtistNamed:@"Ariana Grande" withMusicBrainzId:nil autoCorrect:YES forUser:nil languageCode:nil callback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(artist.name, @"Ariana Grande");
+        [waitingExpectation fulfill];
+    }];
+    
+    [cancelledTask cancel];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 1);
+}
+
+- (void)testDifferentRequestsAreNotCoalesced {
+    XCTestExpectation *firstExpectation = [self expectationWithDescription:@"First artist"];
+    XCTestExpectation *secondExpectation = [self expectationWithDescription:@"Second artist"];
+    
+    [LFMStubURLProtocol setResponseDelay:0.2];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureArtistInfo();
+    }];
+    
+    [LFMArtistProvider getInfoOnArtistNamed:@"Ariana Grande" withMusicBrainzId:nil autoCorrect:YES forUser:nil languageCode:nil callback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        [firstExpectation fulfill];
+    }];
+    [LFMArtistProvider getInfoOnArtistNamed:@"Ariana Grande" withMusicBrainzId:nil autoCorrect:NO forUser:nil languageCode:nil callback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        [secondExpectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 2);
+}
+
+- (void)testResumingTheReturnedTaskSendsNothing {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Artist info"];
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureArtistInfo();
+    }];
+    
+    NSURLSessionDataTask *dataTask = [LFMArtistProvider getInfoOnArtistNamed:@"Ariana Grande" withMusicBrainzId:nil autoCorrect:YES forUser:nil languageCode:nil callback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    
+    XCTAssertEqual(dataTask.state, NSURLSessionTaskStateRunning);
+    [dataTask resume];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual(dataTask.state, NSURLSessionTaskStateCompleted);
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 1);
+}
+
+@end
@@ -0,0 +1,195 @@
+//
+//  LFMEndpointTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import <LastFMKit/LFMEndpoint.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
+
+@interface LFMEndpointTests : XCTestCase
+
+@end
+
+@implementation LFMEndpointTests {
+    LFMClient *_previousClient;
+    LFMClient *_client;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+    
+    [LFMStubURLProtocol reset];
+    
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    [LFMClient setSharedClient:_client];
+}
+
+- (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+    
+    [super tearDown];
+}
+
+static NSDictionary<NSString *, NSString *> *LFMParametersOfQuery(NSString *query) {
+    NSURLComponents *components = [[NSURLComponents alloc] init];
+    components.percentEncodedQuery = query;
+    
+    NSMutableDictionary<NSString *, NSString *> *parameters = [NSMutableDictionary dictionary];
+    
+    for (NSURLQueryItem *item in components.queryItems) {
+        parameters[item.name] = item.value ?: @"";
+    }
+    
+    return parameters;
+}
+
+- (void)testTableDescribesEveryEndpoint {
+    NSMutableSet<NSString *> *methods = [NSMutableSet set];
+    
+    for (NSUInteger i = 0; i < LFMEndpointCount; i++) {
+        const LFMEndpoint *endpoint = &LFMEndpointTable[i];
+        
+        XCTAssertNotNil(endpoint->method, @"Endpoint %tu has no method.", i);
+        XCTAssertFalse([methods containsObject:endpoint->method], @"%@ is in the table twice.", endpoint->method);
+        [methods addObject:endpoint->method ?: @""];
+        
+        if (endpoint->signing == LFMEndpointSigningRequired) {
+            XCTAssertEqual(endpoint->HTTPMethod, LFMEndpointHTTPMethodPOST, @"%@ changes data and must be posted.", endpoint->method);
+        }
+        
+        if (endpoint->result == LFMEndpointResultModel || endpoint->result == LFMEndpointResultList) {
+            XCTAssertNotNil(endpoint->modelPath[0], @"%@ has no model path.", endpoint->method);
+            XCTAssertNotNil(NSClassFromString(@(endpoint->modelClass)), @"%@ names an unknown model class.", endpoint->method);
+        }
+        
+        if (endpoint->queryClass != NULL) {
+            XCTAssertNotNil(endpoint->queryPath[0], @"%@ has no query path.", endpoint->method);
+            XCTAssertNotNil(NSClassFromString(@(endpoint->queryClass)), @"%@ names an unknown query class.", endpoint->method);
+        }
+    }
+}
+
+- (void)testRequestsLeaveOutParametersWithoutAValue {
+    NSURLRequest *request = LFMEndpointRequest(LFMEndpointArtistGetInfo, LFMParameters(@"Ariana Grande", nil, @YES, nil, nil), nil);
+    NSDictionary<NSString *, NSString *> *parameters = LFMParametersOfQuery(request.URL.query);
+    
+    XCTAssertEqualObjects(request.HTTPMethod, @"GET");
+    XCTAssertEqualObjects(parameters, (@{@"method" : @"artist.getInfo",
+                                         @"format" : @"json",
+                                         @"artist" : @"Ariana Grande",
+                                         @"autocorrect" : @"1",
+                                         @"api_key" : @"bc15dd6972bc0f7c952273b34d253a6a"}));
+}
+
+- (void)testSignedEndpointsArePostedWithTheSessionKey {
+    NSURLRequest *request = LFMEndpointRequest(LFMEndpointTrackLove, LFMParameters(@"Ariana Grande", @"Be Alright"), @"0123456789abcdef0123456789abcdef");
+    NSDictionary<NSString *, NSString *> *parameters = LFMParametersOfQuery([[NSString alloc] initWithData:request.HTTPBody encoding:NSUTF8StringEncoding]);
+    
+    XCTAssertEqualObjects(request.HTTPMethod, @"POST");
+    XCTAssertNil(request.URL.query);
+    XCTAssertEqualObjects(parameters[@"method"], @"track.love");
+    XCTAssertEqualObjects(parameters[@"track"], @"Be Alright");
+    XCTAssertEqualObjects(parameters[@"sk"], @"0123456789abcdef0123456789abcdef");
+    XCTAssertEqual(parameters[@"api_sig"].length, 32);
+}
+
+- (void)testReadsAreOnlySignedWhenThereIsASession {
+    NSURLRequest *anonymous = LFMEndpointRequest(LFMEndpointTrackGetTags, LFMParameters(@"Be Alright", @"Ariana Grande", nil, @NO, @"mourke"), nil);
+    NSURLRequest *authenticated = LFMEndpointRequest(LFMEndpointTrackGetTags, LFMParameters(@"Be Alright", @"Ariana Grande", nil, @NO, nil), @"0123456789abcdef0123456789abcdef");
+    
+    XCTAssertNil(LFMParametersOfQuery(anonymous.URL.query)[@"api_sig"]);
+    XCTAssertEqualObjects(LFMParametersOfQuery(anonymous.URL.query)[@"user"], @"mourke");
+    XCTAssertEqualObjects(authenticated.HTTPMethod, @"GET");
+    XCTAssertNotNil(LFMParametersOfQuery(authenticated.URL.query)[@"api_sig"]);
+}
+
+- (void)testRequestsMustGiveEveryParameter {
+    XCTAssertThrows(LFMEndpointRequest(LFMEndpointTrackLove, LFMParameters(@"Ariana Grande"), nil));
+}
+
+- (void)testTagsAreDecodedFromTheTagList {
+    NSDictionary *response = @{@"tags" : @{@"tag" : @[@{@"name" : @"pop", @"url" : @"https://www.last.fm/tag/pop"},
+                                                      @{@"name" : @"dance", @"url" : @"https://www.last.fm/tag/dance"}],
+                                           @"@attr" : @{@"artist" : @"Ariana Grande", @"track" : @"Be Alright"}}};
+    
+    NSArray<LFMTag *> *tags = LFMEndpointDecodeResponse(LFMEndpointTrackGetTags, response, NULL);
+    
+    XCTAssertEqualObjects([tags valueForKey:@"name"], (@[@"pop", @"dance"]));
+}
+
+- (void)testPagedEndpointsCallBackWithModelsAndQuery {
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureRecentTracksPage(50, 3, 500);
+    }];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Recent tracks"];
+    
+    [LFMUserProvider getRecentTracksForUserNamed:@"mourke" itemsPerPage:50 onPage:3 fromStartDate:nil toEndDate:nil callback:^(NSError *error, NSArray<LFMTrack *> *tracks, LFMQuery *query) {
+        XCTAssertNil(error);
+        XCTAssertEqual(tracks.count, 50);
+        XCTAssertEqual(query.currentPage, 3);
+        XCTAssertEqual(query.totalResults, 500);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void)testFailedListsCallBackWithAnEmptyArray {
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureError(6);
+    }];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Similar artists"];
+    
+    [LFMArtistProvider getArtistsSimilarToArtistNamed:@"Ariana Grande" withMusicBrainzId:nil autoCorrect:YES limit:10 callback:^(NSError *error, NSArray<LFMArtist *> *artists) {
+        XCTAssertNotNil(error);
+        XCTAssertEqualObjects(artists, @[]);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void)testRequestBuildingPerformance {
+    [self measureBlock:^{
+        @autoreleasepool {
+            for (NSUInteger i = 0; i < 10000; i++) {
+                LFMEndpointRequest(LFMEndpointUserGetRecentTracks, LFMParameters(@"mourke", @200, @(i), @"1", nil, nil), nil);
+            }
+        }
+    }];
+}
+
+@end
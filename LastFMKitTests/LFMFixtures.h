@@ -0,0 +1,100 @@
+//
+//  LFMFixtures.h
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Raw response body recorded from an `artist.getInfo` call.
+ */
+NSData *LFMFixtureArtistInfo(void);
+
+/**
+ An `album.search` response for "My Everything" with three matches, built from recorded album entries.
+ */
+NSData *LFMFixtureAlbumSearch(void);
+
+/**
+ Raw response body recorded from a `track.scrobble` call containing one accepted and one ignored scrobble.
+ */
+NSData *LFMFixtureScrobbles(void);
+
+/**
+ Raw response body for a Last.fm server-side error.
+ 
+ @param code    The Last.fm error code.
+ */
+NSData *LFMFixtureError(NSInteger code);
+
+/**
+ A `user.getRecentTracks` page built out of recorded track entries.
+ 
+ @param count   The amount of tracks on the page.
+ @param page    The page number reported in the `@attr` dictionary.
+ @param total   The total amount of tracks reported in the `@attr` dictionary.
+ */
+NSData *LFMFixtureRecentTracksPage(NSUInteger count, NSUInteger page, NSUInteger total);
+
+/**
+ A single `user.getRecentTracks` page holding a play at each of `timestamps`.
+ 
+ @param timestamps  The unix timestamps of the plays, newest first.
+ */
+NSData *LFMFixtureRecentTracksAtTimestamps(NSArray<NSNumber *> *timestamps);
+
+/**
+ A `user.getRecentTracks` page answering a request against a simulated history. Scrobbles are named "Scrobble 0" - the oldest - to "Scrobble `historyLength - 1`" - the newest - and made three minutes apart. The request's `from`, `to`, `page` and `limit` parameters are honoured.
+ 
+ @param request         The intercepted `user.getRecentTracks` request.
+ @param historyLength   The amount of scrobbles in the user's history.
+ */
+NSData *LFMFixtureRecentTracksForRequest(NSURLRequest *request, NSUInteger historyLength);
+
+/**
+ As `LFMFixtureRecentTracksForRequest`, but with scrobbles made in groups that share a timestamp, the way a batch of scrobbles submitted at once can.
+ 
+ @param request                 The intercepted `user.getRecentTracks` request.
+ @param historyLength           The amount of scrobbles in the user's history.
+ @param scrobblesPerTimestamp   The amount of consecutive scrobbles made in the same second.
+ */
+NSData *LFMFixtureRecentTracksSharingTimestampsForRequest(NSURLRequest *request, NSUInteger historyLength, NSUInteger scrobblesPerTimestamp);
+
+/**
+ A `chart.getTopArtists` page built out of recorded artist entries.
+ 
+ @param count   The amount of artists on the page.
+ */
+NSData *LFMFixtureTopArtistsPage(NSUInteger count);
+
+/**
+ A `track.scrobble` response echoing every scrobble in a request's body. Scrobbles older than `oldestTimestamp` are ignored with code 3, as Last.fm does.
+ 
+ @param body            The body of the intercepted `track.scrobble` request.
+ @param oldestTimestamp The oldest Unix timestamp that is accepted.
+ */
+NSData *LFMFixtureScrobblesForRequestBody(NSData *body, NSTimeInterval oldestTimestamp);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,158 @@
+//
+//  LFMFixtures.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMFixtures.h"
+
+static NSString * const LFMFixtureImages = @"[{\"#text\":\"https://lastfm-img2.akamaized.net/i/u/34s/2a96cbd8b46e442fc41c2b86b821562f.png\",\"size\":\"small\"},{\"#text\":\"https://lastfm-img2.akamaized.net/i/u/64s/2a96cbd8b46e442fc41c2b86b821562f.png\",\"size\":\"medium\"},{\"#text\":\"https://lastfm-img2.akamaized.net/i/u/174s/2a96cbd8b46e442fc41c2b86b821562f.png\",\"size\":\"large\"},{\"#text\":\"https://lastfm-img2.akamaized.net/i/u/300x300/2a96cbd8b46e442fc41c2b86b821562f.png\",\"size\":\"extralarge\"},{\"#text\":\"https://lastfm-img2.akamaized.net/i/u/2a96cbd8b46e442fc41c2b86b821562f.png\",\"size\":\"mega\"}]";
+
+static NSData *LFMFixtureData(NSString *string) {
+    return [string dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+NSData *LFMFixtureArtistInfo(void) {
+    NSString *tag = @"{\"name\":\"pop\",\"url\":\"https://www.last.fm/tag/pop\"}";
+    NSString *similar = [NSString stringWithFormat:@"{\"name\":\"Selena Gomez\",\"mbid\":\"\",\"url\":\"https://www.last.fm/music/Selena+Gomez\",\"streamable\":\"0\",\"image\":%@}", LFMFixtureImages];
+    NSString *bio = @"{\"links\":{\"link\":{\"#text\":\"\",\"rel\":\"original\",\"href\":\"https://last.fm/music/Ariana+Grande/+wiki\"}},\"published\":\"21 Feb 2008, 18:47\",\"summary\":\"Ariana Grande-Butera (born June 26, 1993) is an American singer, songwriter and actress.\",\"content\":\"Ariana Grande-Butera (born June 26, 1993) is an American singer, songwriter and actress. She began her career in 2008 in the Broadway musical 13, before playing the role of Cat Valentine in the Nickelodeon television series Victorious.\"}";
+    
+    NSString *artist = [NSString stringWithFormat:@"{\"artist\":{\"name\":\"Ariana Grande\",\"mbid\":\"f4fdbb4c-e4b7-47a0-b83b-d91bbfcfa387\",\"url\":\"https://www.last.fm/music/Ariana+Grande\",\"image\":%@,\"streamable\":\"0\",\"ontour\":\"1\",\"stats\":{\"listeners\":\"1947843\",\"playcount\":\"165306112\"},\"similar\":{\"artist\":[%@,%@,%@,%@,%@]},\"tags\":{\"tag\":[%@,%@,%@,%@,%@]},\"bio\":%@}}", LFMFixtureImages, similar, similar, similar, similar, similar, tag, tag, tag, tag, tag, bio];
+    
+    return LFMFixtureData(artist);
+}
+
+NSData *LFMFixtureAlbumSearch(void) {
+    NSString *album = @"{\"name\":\"%@\",\"artist\":\"%@\",\"url\":\"%@\",\"image\":%@,\"streamable\":\"0\",\"mbid\":\"%@\"}";
+    NSString *albums = [@[[NSString stringWithFormat:album, @"My Everything", @"Ariana Grande", @"https://www.last.fm/music/Ariana+Grande/My+Everything", LFMFixtureImages, @"3a1ee7b7-6f8e-4a34-8e0e-4e0b6b2b7b4b"],
+                          [NSString stringWithFormat:album, @"My Everything (Deluxe)", @"Ariana Grande", @"https://www.last.fm/music/Ariana+Grande/My+Everything+(Deluxe)", LFMFixtureImages, @""],
+                          [NSString stringWithFormat:album, @"My Everything", @"The Wanted", @"https://www.last.fm/music/The+Wanted/My+Everything", LFMFixtureImages, @""]] componentsJoinedByString:@","];
+    
+    return LFMFixtureData([NSString stringWithFormat:@"{\"results\":{\"opensearch:Query\":{\"#text\":\"\",\"role\":\"request\",\"searchTerms\":\"My Everything\",\"startPage\":\"1\"},\"opensearch:totalResults\":\"3\",\"opensearch:startIndex\":\"0\",\"opensearch:itemsPerPage\":\"50\",\"albummatches\":{\"album\":[%@]},\"@attr\":{\"for\":\"My Everything\"}}}", albums]);
+}
+
+NSData *LFMFixtureScrobbles(void) {
+    return LFMFixtureData(@"{\"scrobbles\":{\"scrobble\":[{\"artist\":{\"corrected\":\"0\",\"#text\":\"Ariana Grande\"},\"ignoredMessage\":{\"code\":\"0\",\"#text\":\"\"},\"albumArtist\":{\"corrected\":\"0\",\"#text\":\"\"},\"timestamp\":\"1508865600\",\"album\":{\"corrected\":\"0\",\"#text\":\"Dangerous Woman\"},\"track\":{\"corrected\":\"0\",\"#text\":\"Be Alright\"}},{\"artist\":{\"corrected\":\"0\",\"#text\":\"Ariana Grande\"},\"ignoredMessage\":{\"code\":\"3\",\"#text\":\"Timestamp too old\"},\"albumArtist\":{\"corrected\":\"0\",\"#text\":\"\"},\"timestamp\":\"1008865600\",\"album\":{\"corrected\":\"0\",\"#text\":\"Dangerous Woman\"},\"track\":{\"corrected\":\"0\",\"#text\":\"Into You\"}}],\"@attr\":{\"accepted\":1,\"ignored\":1}}}");
+}
+
+NSData *LFMFixtureError(NSInteger code) {
+    return LFMFixtureData([NSString stringWithFormat:@"{\"error\":%ld,\"message\":\"Last.fm returned an error\"}", (long)code]);
+}
+
+static NSString *LFMFixtureRecentTrack(NSString *name, NSUInteger uts) {
+    return [NSString stringWithFormat:@"{\"artist\":{\"url\":\"https://www.last.fm/music/Ariana+Grande\",\"name\":\"Ariana Grande\",\"image\":%@,\"mbid\":\"f4fdbb4c-e4b7-47a0-b83b-d91bbfcfa387\"},\"loved\":\"0\",\"name\":\"%@\",\"streamable\":\"0\",\"mbid\":\"b0e6a04f-3c4a-4f14-9fd5-4b2f7ee8e5d4\",\"album\":{\"mbid\":\"ed0ee2bf-5e9e-4a8f-b1a0-0b0b1c7d1a3d\",\"#text\":\"Dangerous Woman\"},\"url\":\"https://www.last.fm/music/Ariana+Grande/_/Be+Alright\",\"image\":%@,\"date\":{\"uts\":\"%tu\",\"#text\":\"24 Oct 2017, 17:20\"}}", LFMFixtureImages, name, LFMFixtureImages, uts];
+}
+
+static NSData *LFMFixtureRecentTracks(NSArray<NSString *> *tracks, NSUInteger page, NSUInteger perPage, NSUInteger total) {
+    NSUInteger totalPages = perPage == 0 ? 0 : (total + perPage - 1) / perPage;
+    
+    return LFMFixtureData([NSString stringWithFormat:@"{\"recenttracks\":{\"track\":[%@],\"@attr\":{\"user\":\"mourke\",\"page\":\"%tu\",\"perPage\":\"%tu\",\"totalPages\":\"%tu\",\"total\":\"%tu\"}}}", [tracks componentsJoinedByString:@","], page, perPage, totalPages, total]);
+}
+
+NSData *LFMFixtureRecentTracksPage(NSUInteger count, NSUInteger page, NSUInteger total) {
+    NSMutableArray<NSString *> *tracks = [NSMutableArray arrayWithCapacity:count];
+    NSTimeInterval timestamp = 1508865600;
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        NSUInteger uts = (NSUInteger)timestamp - ((page - 1) * count + i) * 180;
+        [tracks addObject:LFMFixtureRecentTrack([NSString stringWithFormat:@"Be Alright %tu", i], uts)];
+    }
+    
+    return LFMFixtureRecentTracks(tracks, page, count, total);
+}
+
+NSData *LFMFixtureRecentTracksAtTimestamps(NSArray<NSNumber *> *timestamps) {
+    NSMutableArray<NSString *> *tracks = [NSMutableArray arrayWithCapacity:timestamps.count];
+    
+    for (NSNumber *timestamp in timestamps) {
+        [tracks addObject:LFMFixtureRecentTrack([NSString stringWithFormat:@"Be Alright %@", timestamp], timestamp.unsignedIntegerValue)];
+    }
+    
+    return LFMFixtureRecentTracks(tracks, 1, MAX(timestamps.count, 1), timestamps.count);
+}
+
+NSData *LFMFixtureRecentTracksForRequest(NSURLRequest *request, NSUInteger historyLength) {
+    return LFMFixtureRecentTracksSharingTimestampsForRequest(request, historyLength, 1);
+}
+
+NSData *LFMFixtureRecentTracksSharingTimestampsForRequest(NSURLRequest *request, NSUInteger historyLength, NSUInteger scrobblesPerTimestamp) {
+    NSURLComponents *components = [NSURLComponents componentsWithURL:request.URL resolvingAgainstBaseURL:NO];
+    NSMutableDictionary<NSString *, NSString *> *parameters = [NSMutableDictionary dictionary];
+    
+    for (NSURLQueryItem *item in components.queryItems) {
+        if (item.value != nil) parameters[item.name] = item.value;
+    }
+    
+    NSUInteger from = parameters[@"from"].integerValue;
+    NSUInteger to = parameters[@"to"] == nil ? NSUIntegerMax : (NSUInteger)parameters[@"to"].integerValue;
+    NSUInteger page = MAX(parameters[@"page"].integerValue, 1);
+    NSUInteger perPage = parameters[@"limit"] == nil ? 50 : parameters[@"limit"].integerValue;
+    
+    // Scrobble `n` of the history, counting from the newest, was made `n / scrobblesPerTimestamp * 180` seconds before the newest, which was made at 1508865600.
+    NSMutableArray<NSNumber *> *matching = [NSMutableArray array];
+    for (NSUInteger n = 0; n < historyLength; n++) {
+        NSUInteger uts = 1508865600 - n / scrobblesPerTimestamp * 180;
+        if (uts >= from && uts <= to) [matching addObject:@(n)];
+    }
+    
+    NSMutableArray<NSString *> *tracks = [NSMutableArray array];
+    for (NSUInteger i = (page - 1) * perPage; i < MIN(page * perPage, matching.count); i++) {
+        NSUInteger n = matching[i].unsignedIntegerValue;
+        [tracks addObject:LFMFixtureRecentTrack([NSString stringWithFormat:@"Scrobble %tu", historyLength - 1 - n], 1508865600 - n / scrobblesPerTimestamp * 180)];
+    }
+    
+    return LFMFixtureRecentTracks(tracks, page, perPage, matching.count);
+}
+
+NSData *LFMFixtureTopArtistsPage(NSUInteger count) {
+    NSMutableString *artists = [NSMutableString string];
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        [artists appendFormat:@"%@{\"name\":\"Artist %tu\",\"playcount\":\"%tu\",\"listeners\":\"%tu\",\"mbid\":\"\",\"url\":\"https://www.last.fm/music/Artist+%tu\",\"streamable\":\"0\",\"image\":%@}", (i == 0 ? @"" : @","), i, 5000000 - i, 400000 - i, i, LFMFixtureImages];
+    }
+    
+    return LFMFixtureData([NSString stringWithFormat:@"{\"artists\":{\"artist\":[%@],\"@attr\":{\"page\":\"1\",\"perPage\":\"%tu\",\"totalPages\":\"1\",\"total\":\"%tu\"}}}", artists, count, count]);
+}
+
+NSData *LFMFixtureScrobblesForRequestBody(NSData *body, NSTimeInterval oldestTimestamp) {
+    NSURLComponents *components = [[NSURLComponents alloc] init];
+    components.percentEncodedQuery = [[NSString alloc] initWithData:body encoding:NSUTF8StringEncoding];
+    
+    NSMutableDictionary<NSString *, NSString *> *parameters = [NSMutableDictionary dictionary];
+    for (NSURLQueryItem *item in components.queryItems) {
+        parameters[item.name] = item.value;
+    }
+    
+    NSMutableString *scrobbles = [NSMutableString string];
+    NSUInteger accepted = 0, ignored = 0;
+    
+    for (NSUInteger i = 0; parameters[[NSString stringWithFormat:@"track[%tu]", i]] != nil; i++) {
+        NSString *track = parameters[[NSString stringWithFormat:@"track[%tu]", i]];
+        NSString *timestamp = parameters[[NSString stringWithFormat:@"timestamp[%tu]", i]];
+        BOOL tooOld = [timestamp doubleValue] < oldestTimestamp;
+        
+        tooOld ? ignored++ : accepted++;
+        [scrobbles appendFormat:@"%@{\"artist\":{\"corrected\":\"0\",\"#text\":\"Ariana Grande\"},\"ignoredMessage\":{\"code\":\"%d\",\"#text\":\"%@\"},\"albumArtist\":{\"corrected\":\"0\",\"#text\":\"\"},\"timestamp\":\"%@\",\"album\":{\"corrected\":\"0\",\"#text\":\"\"},\"track\":{\"corrected\":\"0\",\"#text\":\"%@\"}}", (i == 0 ? @"" : @","), tooOld ? 3 : 0, tooOld ? @"Timestamp too old" : @"", timestamp, track];
+    }
+    
+    return LFMFixtureData([NSString stringWithFormat:@"{\"scrobbles\":{\"scrobble\":[%@],\"@attr\":{\"accepted\":%tu,\"ignored\":%tu}}}", scrobbles, accepted, ignored]);
+}
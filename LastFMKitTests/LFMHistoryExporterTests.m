@@ -0,0 +1,214 @@
+//
+//  LFMHistoryExporterTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
+
+static const NSUInteger LFMHistoryLength = 1000;
+
+@interface LFMHistoryExporterTests : XCTestCase
+
+@end
+
+@implementation LFMHistoryExporterTests {
+    LFMClient *_previousClient;
+    LFMClient *_client;
+    NSString *_checkpointPath;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+    
+    [LFMStubURLProtocol reset];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureRecentTracksForRequest(request, LFMHistoryLength);
+    }];
+    
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    [LFMClient setSharedClient:_client];
+    
+    _checkpointPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+}
+
+- (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+    [[NSFileManager defaultManager] removeItemAtPath:_checkpointPath error:nil];
+    
+    [super tearDown];
+}
+
+- (LFMHistoryExporter *)exporter {
+    LFMHistoryExporter *exporter = [[LFMHistoryExporter alloc] initWithUserName:@"mourke" checkpointPath:_checkpointPath];
+    exporter.itemsPerPage = 100;
+    exporter.requestsPerSecond = 1000;
+    return exporter;
+}
+
+- (NSError *)runExporter:(LFMHistoryExporter *)exporter collectingNamesInto:(NSMutableArray<NSString *> *)names {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Export"];
+    __block NSError *exportError = nil;
+    
+    [exporter exportWithPageHandler:^(NSArray<LFMScrobbleTrack *> *scrobbles) {
+        for (LFMScrobbleTrack *scrobble in scrobbles) {
+            [names addObject:scrobble.name];
+        }
+    } completion:^(NSError * _Nullable error) {
+        exportError = error;
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    
+    return exportError;
+}
+
+- (NSArray<NSString *> *)namesOfScrobblesInRange:(NSRange)range {
+    NSMutableArray<NSString *> *names = [NSMutableArray arrayWithCapacity:range.length];
+    for (NSUInteger i = range.location; i < NSMaxRange(range); i++) {
+        [names addObject:[NSString stringWithFormat:@"Scrobble %tu", i]];
+    }
+    return names;
+}
+
+- (void)testHistoryIsExportedOldestFirst {
+    LFMHistoryExporter *exporter = [self exporter];
+    NSMutableArray<NSString *> *names = [NSMutableArray array];
+    
+    [LFMStubURLProtocol setResponseDelay:0.02];
+    
+    XCTAssertNil([self runExporter:exporter collectingNamesInto:names]);
+    XCTAssertEqualObjects(names, [self namesOfScrobblesInRange:NSMakeRange(0, LFMHistoryLength)]);
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 10);
+}
+
+- (void)testRequestRateIsLimited {
+    LFMHistoryExporter *exporter = [self exporter];
+    exporter.requestsPerSecond = 20;
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    
+    XCTAssertNil([self runExporter:exporter collectingNamesInto:[NSMutableArray array]]);
+    
+    // Ten requests at twenty a second: the last one can't start before 0.45 seconds in.
+    XCTAssertGreaterThanOrEqual(CFAbsoluteTimeGetCurrent() - start, 0.45);
+}
+
+- (void)testInterruptedExportResumesFromCheckpoint {
+    NSMutableArray<NSString *> *names = [NSMutableArray array];
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        // The fourth oldest page fails.
+        if ([request.URL.query containsString:@"page=7&"]) return LFMFixtureError(8);
+        return LFMFixtureRecentTracksForRequest(request, LFMHistoryLength);
+    }];
+    
+    LFMHistoryExporter *exporter = [self exporter];
+    exporter.maximumConcurrentRequests = 1;
+    
+    XCTAssertEqual([self runExporter:exporter collectingNamesInto:names].code, 8);
+    XCTAssertEqualObjects(names, [self namesOfScrobblesInRange:NSMakeRange(0, 300)]);
+    
+    [LFMStubURLProtocol reset];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureRecentTracksForRequest(request, LFMHistoryLength);
+    }];
+    
+    XCTAssertNil([self runExporter:[self exporter] collectingNamesInto:names]);
+    XCTAssertEqualObjects(names, [self namesOfScrobblesInRange:NSMakeRange(0, LFMHistoryLength)]);
+    // The 700 scrobbles left, and the last one handed over, which is fetched again to find the second it was made in.
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 8);
+}
+
+- (void)testResumingDoesNotSkipScrobblesSharingTheLastTimestamp {
+    NSMutableArray<NSString *> *names = [NSMutableArray array];
+    
+    // With 75 scrobbles a page, the oldest page holds 25 and its newest scrobble shares its second with the oldest of the next page.
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        if ([request.URL.query containsString:@"page=13&"]) return LFMFixtureError(8);
+        return LFMFixtureRecentTracksSharingTimestampsForRequest(request, LFMHistoryLength, 2);
+    }];
+    
+    LFMHistoryExporter *exporter = [self exporter];
+    exporter.itemsPerPage = 75;
+    exporter.maximumConcurrentRequests = 1;
+    
+    XCTAssertEqual([self runExporter:exporter collectingNamesInto:names].code, 8);
+    XCTAssertEqualObjects(names, [self namesOfScrobblesInRange:NSMakeRange(0, 25)]);
+    
+    [LFMStubURLProtocol reset];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureRecentTracksSharingTimestampsForRequest(request, LFMHistoryLength, 2);
+    }];
+    
+    exporter = [self exporter];
+    exporter.itemsPerPage = 75;
+    
+    XCTAssertNil([self runExporter:exporter collectingNamesInto:names]);
+    XCTAssertEqualObjects(names, [self namesOfScrobblesInRange:NSMakeRange(0, LFMHistoryLength)]);
+}
+
+- (void)testExportCancelledStraightAwayFinishesCancelled {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Export"];
+    
+    NSProgress *progress = [[self exporter] exportWithPageHandler:^(NSArray<LFMScrobbleTrack *> *scrobbles) {
+        XCTFail(@"No page should be handed over.");
+    } completion:^(NSError * _Nullable error) {
+        XCTAssertEqualObjects(error.domain, NSURLErrorDomain);
+        XCTAssertEqual(error.code, NSURLErrorCancelled);
+        [expectation fulfill];
+    }];
+    // Usually lands before the export has started on the exporter's queue.
+    [progress cancel];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void)testFinishedExportOnlyFetchesNewScrobbles {
+    NSMutableArray<NSString *> *names = [NSMutableArray array];
+    
+    XCTAssertNil([self runExporter:[self exporter] collectingNamesInto:names]);
+    XCTAssertEqual(names.count, LFMHistoryLength);
+    
+    [names removeAllObjects];
+    [LFMStubURLProtocol reset];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureRecentTracksForRequest(request, LFMHistoryLength);
+    }];
+    
+    XCTAssertNil([self runExporter:[self exporter] collectingNamesInto:names]);
+    XCTAssertEqual(names.count, 0);
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 1);
+}
+
+@end
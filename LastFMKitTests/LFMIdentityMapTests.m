@@ -0,0 +1,194 @@
+//
+//  LFMIdentityMapTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import <LastFMKit/LFMModelDecoding.h>
+#import "LFMFixtures.h"
+
+@interface LFMIdentityMapTests : XCTestCase
+
+@end
+
+@implementation LFMIdentityMapTests {
+    LFMIdentityMap *_previousMap;
+    LFMIdentityMap *_map;
+    NSDictionary *_artistInfo;
+    NSDictionary *_artistRow;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    _previousMap = [LFMIdentityMap sharedMap];
+    _map = [[LFMIdentityMap alloc] init];
+    [LFMIdentityMap setSharedMap:_map];
+    
+    _artistInfo = [[NSJSONSerialization JSONObjectWithData:LFMFixtureArtistInfo() options:0 error:nil] objectForKey:@"artist"];
+    
+    // The same artist as it appears in lists: no statistics, tags, similar artists or biography, and only one image.
+    _artistRow = @{@"name" : @"ariana grande",
+                   @"mbid" : @"",
+                   @"url" : @"https://www.last.fm/music/Ariana+Grande",
+                   @"streamable" : @"0",
+                   @"image" : @[@{@"#text" : @"https://lastfm-img2.akamaized.net/i/u/34s/a.png", @"size" : @"small"}]};
+}
+
+- (void)tearDown {
+    [LFMIdentityMap setSharedMap:_previousMap];
+    
+    [super tearDown];
+}
+
+- (NSArray *)rows:(NSDictionary *)row count:(NSUInteger)count {
+    NSMutableArray *rows = [NSMutableArray arrayWithCapacity:count];
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        [rows addObject:row];
+    }
+    
+    return [rows copy];
+}
+
+- (void)testRowsShareOneInstance {
+    NSArray<LFMArtist *> *artists = LFMModelArray([LFMArtist class], [self rows:_artistRow count:1000]);
+    
+    XCTAssertEqual(artists.count, 1000);
+    XCTAssertEqual(_map.count, 1);
+    
+    for (LFMArtist *artist in artists) {
+        XCTAssertEqual(artist, artists.firstObject);
+    }
+}
+
+- (void)testInstancesAreNotSharedWithoutMap {
+    [LFMIdentityMap setSharedMap:nil];
+    
+    NSArray<LFMArtist *> *artists = LFMModelArray([LFMArtist class], [self rows:_artistRow count:2]);
+    
+    XCTAssertNotEqual(artists[0], artists[1]);
+    XCTAssertEqual(_map.count, 0);
+}
+
+- (void)testDetailedResponseIsMergedIntoSharedInstance {
+    LFMArtist *row = LFMModelArray([LFMArtist class], _artistRow).firstObject;
+    
+    XCTAssertEqual(row.mbid.length, 0);
+    XCTAssertEqual(row.listeners, 0);
+    XCTAssertEqual(row.similarArtists.count, 0);
+    XCTAssertNil(row.wiki);
+    
+    LFMArtist *info = LFMModelArray([LFMArtist class], _artistInfo).firstObject;
+    
+    XCTAssertEqual(info, row);
+    XCTAssertEqualObjects(row.mbid, @"f4fdbb4c-e4b7-47a0-b83b-d91bbfcfa387");
+    XCTAssertEqual(row.listeners, 1947843);
+    XCTAssertTrue(row.isOnTour);
+    XCTAssertEqual(row.images.count, 5);
+    XCTAssertEqual(row.similarArtists.count, 5);
+    XCTAssertEqual(row.tags.count, 5);
+    XCTAssertNotNil(row.wiki);
+    
+    // Once an artist has its MusicBrainz id, a leaner row doesn't take details away again.
+    XCTAssertEqual(LFMModelArray([LFMArtist class], _artistRow).firstObject, row);
+    XCTAssertEqual(row.listeners, 1947843);
+    XCTAssertEqual(row.images.count, 5);
+    XCTAssertEqual(_map.count, 1);
+}
+
+- (void)testDifferentMusicBrainzIDsAreKeptApart {
+    NSMutableDictionary *first = [_artistRow mutableCopy];
+    first[@"name"] = @"Nirvana";
+    first[@"mbid"] = @"5b11f4ce-a62d-471e-81fc-a69a8278c7da";
+    
+    NSMutableDictionary *second = [first mutableCopy];
+    second[@"mbid"] = @"9282c8b4-ca0b-4c6b-b7e3-4f7762dfc4d6";
+    
+    NSArray<LFMArtist *> *artists = LFMModelArray([LFMArtist class], @[[first copy], [second copy], [first copy]]);
+    
+    XCTAssertNotEqual(artists[0], artists[1]);
+    XCTAssertEqual(artists[0], artists[2]);
+}
+
+- (void)testArtistsAndAlbumsWithTheSameNameAreKeptApart {
+    NSDictionary *album = @{@"name" : @"Ariana Grande", @"artist" : @"Ariana Grande", @"mbid" : @"", @"url" : @"https://www.last.fm/music/Ariana+Grande/Ariana+Grande", @"streamable" : @"0"};
+    
+    LFMAlbum *first = LFMModelArray([LFMAlbum class], album).firstObject;
+    LFMArtist *artist = LFMModelArray([LFMArtist class], _artistRow).firstObject;
+    LFMAlbum *second = LFMModelArray([LFMAlbum class], album).firstObject;
+    
+    XCTAssertNotNil(artist);
+    XCTAssertEqual(first, second);
+    XCTAssertEqual(_map.count, 2);
+}
+
+- (void)testReleasedInstancesAreForgotten {
+    @autoreleasepool {
+        NSArray<LFMArtist *> *artists = LFMModelArray([LFMArtist class], [self rows:_artistRow count:10]);
+        XCTAssertEqual(artists.count, 10);
+        XCTAssertEqual(_map.count, 1);
+    }
+    
+    XCTAssertEqual(_map.count, 0);
+}
+
+- (void)testConcurrentDecodingSharesOneInstance {
+    NSMutableArray *rows = [[self rows:_artistRow count:500] mutableCopy];
+    [rows addObjectsFromArray:[self rows:_artistInfo count:500]];
+    
+    NSArray<LFMArtist *> *artists = LFMDecodeModels([LFMArtist class], [rows copy], YES);
+    
+    XCTAssertEqual(artists.count, 1000);
+    XCTAssertEqual([NSSet setWithArray:artists].count, 1);
+    XCTAssertEqual(artists.firstObject.listeners, 1947843);
+}
+
+- (void)testLiveInstancesPerThousandRows {
+    NSArray *rows = [self rows:_artistRow count:1000];
+    
+    [LFMIdentityMap setSharedMap:nil];
+    NSArray<LFMArtist *> *unshared = LFMDecodeModels([LFMArtist class], rows, NO);
+    
+    [LFMIdentityMap setSharedMap:_map];
+    NSArray<LFMArtist *> *shared = LFMDecodeModels([LFMArtist class], rows, NO);
+    
+    XCTAssertEqual([NSSet setWithArray:unshared].count, 1000);
+    XCTAssertEqual([NSSet setWithArray:shared].count, 1);
+}
+
+- (void)testSharedDecodingPerformance {
+    NSArray *rows = [self rows:_artistRow count:1000];
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            @autoreleasepool {
+                XCTAssertEqual(LFMDecodeModels([LFMArtist class], rows, NO).count, 1000);
+            }
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,168 @@
+//
+//  LFMJSONStreamDecoderTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import <LastFMKit/LFMJSONStreamDecoder.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
+
+@interface LFMJSONStreamDecoderTests : XCTestCase
+
+@end
+
+@implementation LFMJSONStreamDecoderTests {
+    LFMClient *_previousClient;
+    LFMClient *_client;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+    
+    [LFMStubURLProtocol reset];
+    
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    [LFMClient setSharedClient:_client];
+}
+
+- (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+    
+    [super tearDown];
+}
+
+- (id)decodeData:(NSData *)data itemPath:(NSArray<NSString *> *)itemPath chunkSize:(NSUInteger)chunkSize items:(NSMutableArray *)items error:(NSError **)error {
+    LFMJSONStreamDecoder *decoder = [[LFMJSONStreamDecoder alloc] initWithItemPath:itemPath itemHandler:^(id item) {
+        [items addObject:item];
+    }];
+    
+    for (NSUInteger offset = 0; offset < data.length; offset += chunkSize) {
+        if (![decoder appendData:[data subdataWithRange:NSMakeRange(offset, MIN(chunkSize, data.length - offset))] error:error]) return nil;
+    }
+    
+    return [decoder finishDecodingWithError:error];
+}
+
+- (void)testItemsMatchWholeBodyDecoding {
+    NSData *data = LFMFixtureRecentTracksPage(200, 1, 1000);
+    NSDictionary *expected = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    
+    for (NSNumber *chunkSize in @[@1, @7, @64, @4096, @(data.length)]) {
+        NSMutableArray *items = [NSMutableArray array];
+        NSError *error = nil;
+        NSDictionary *envelope = [self decodeData:data itemPath:@[@"recenttracks", @"track"] chunkSize:chunkSize.unsignedIntegerValue items:items error:&error];
+        
+        XCTAssertNil(error, @"Chunk size %@", chunkSize);
+        XCTAssertEqualObjects(items, expected[@"recenttracks"][@"track"], @"Chunk size %@", chunkSize);
+        XCTAssertEqualObjects(envelope[@"recenttracks"][@"@attr"], expected[@"recenttracks"][@"@attr"]);
+        XCTAssertEqualObjects(envelope[@"recenttracks"][@"track"], @[]);
+    }
+}
+
+- (void)testSingleItemIsSentAsAnObject {
+    NSData *data = [@"{\"artists\":{\"artist\":{\"name\":\"Ariana Grande\"},\"@attr\":{\"page\":\"1\"}}}" dataUsingEncoding:NSUTF8StringEncoding];
+    NSMutableArray *items = [NSMutableArray array];
+    
+    NSDictionary *envelope = [self decodeData:data itemPath:@[@"artists", @"artist"] chunkSize:3 items:items error:nil];
+    
+    XCTAssertEqualObjects(items, @[@{@"name": @"Ariana Grande"}]);
+    XCTAssertEqualObjects(envelope[@"artists"][@"@attr"][@"page"], @"1");
+}
+
+- (void)testScalarsAndEscapes {
+    NSData *data = [@"{\"a\":{\"b\":[\"\\u00e9\\ud83c\\udfb5 \\\"q\\\" \\\\n\\/\", \"ü\", 12, -2.5e3, 9223372036854775807, true, false, null, {\"c\":[]}]}}" dataUsingEncoding:NSUTF8StringEncoding];
+    NSMutableArray *items = [NSMutableArray array];
+    NSError *error = nil;
+    
+    [self decodeData:data itemPath:@[@"a", @"b"] chunkSize:1 items:items error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(items, (@[@"é🎵 \"q\" \\n/", @"ü", @12, @(-2500.0), @(LLONG_MAX), @YES, @NO, [NSNull null], @{@"c": @[]}]));
+}
+
+- (void)testMalformedBodiesFail {
+    NSArray<NSString *> *bodies = @[@"{\"a\":{\"b\":[1,}}", @"{\"a\":{\"b\":[1]}", @"{\"a\" 1}", @"{\"a\":tru}", @"{\"a\":\"\\x\"}", @"{\"a\":1} 2"];
+    
+    for (NSString *body in bodies) {
+        NSError *error = nil;
+        id envelope = [self decodeData:[body dataUsingEncoding:NSUTF8StringEncoding] itemPath:@[@"a", @"b"] chunkSize:2 items:[NSMutableArray array] error:&error];
+        
+        XCTAssertNil(envelope, @"%@", body);
+        XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain, @"%@", body);
+    }
+}
+
+- (void)testTracksArriveBeforeTheBodyHasFinished {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Recent tracks"];
+    NSMutableArray<LFMTrack *> *tracks = [NSMutableArray array];
+    __block CFAbsoluteTime firstTrackTime = 0;
+    
+    NSData *data = LFMFixtureRecentTracksPage(100, 1, 100);
+    [LFMStubURLProtocol setResponseChunkSize:data.length / 10 interval:0.05];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return data;
+    }];
+    
+    [LFMUserProvider streamRecentTracksForUserNamed:@"mourke" itemsPerPage:100 onPage:1 fromStartDate:nil toEndDate:nil trackHandler:^(LFMTrack *track) {
+        if (tracks.count == 0) firstTrackTime = CFAbsoluteTimeGetCurrent();
+        [tracks addObject:track];
+    } callback:^(NSError * _Nullable error, LFMQuery * _Nullable query) {
+        XCTAssertNil(error);
+        XCTAssertEqual(query.totalResults, 100);
+        XCTAssertEqual(tracks.count, 100);
+        XCTAssertEqualObjects(tracks.firstObject.name, @"Be Alright 0");
+        XCTAssertGreaterThan(CFAbsoluteTimeGetCurrent() - firstTrackTime, 0.2, @"The first track should be handed over while the rest is still downloading.");
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void)testStreamedServerErrorsAreSurfaced {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Library artists"];
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureError(6);
+    }];
+    
+    [LFMLibraryProvider streamArtistsForUserNamed:@"mourke" itemsPerPage:1000 onPage:1 artistHandler:^(LFMArtist *artist) {
+        XCTFail(@"No artists should be handed over.");
+    } callback:^(NSError * _Nullable error, LFMQuery * _Nullable query) {
+        XCTAssertEqual(error.code, 6);
+        XCTAssertNil(query);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+@end
@@ -0,0 +1,371 @@
+//
+//  LFMModelDecodingTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import <LastFMKit/LFMModelDecoding.h>
+#import <LastFMKit/LFMImageSet.h>
+#import "LFMAllocationCounter.h"
+#import "LFMFixtures.h"
+
+@interface LFMTrack (Testing)
+
+- (nullable instancetype)initFromDictionary:(NSDictionary *)dictionary;
+
+@end
+
+@interface LFMModelDecodingTests : XCTestCase
+
+@end
+
+@implementation LFMModelDecodingTests {
+    NSData *_page;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    _page = LFMFixtureRecentTracksPage(1000, 1, 1000);
+}
+
+/** Decodes the page the way every provider did before models were built into exactly sized, immutable arrays. */
+static NSArray<LFMTrack *> *LFMDecodeTracksWithMutableContainers(NSData *data) {
+    NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:nil];
+    NSMutableArray<LFMTrack *> *tracks = [NSMutableArray array];
+    
+    for (NSDictionary *trackDictionary in [[responseDictionary objectForKey:@"recenttracks"] objectForKey:@"track"]) {
+        LFMTrack *track = [[LFMTrack alloc] initFromDictionary:trackDictionary];
+        track ? [tracks addObject:track] : nil;
+    }
+    
+    return tracks;
+}
+
+static NSArray<LFMTrack *> *LFMDecodeTracks(NSData *data) {
+    NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    return LFMModelArray([LFMTrack class], [[responseDictionary objectForKey:@"recenttracks"] objectForKey:@"track"]);
+}
+
+- (void)testModelArrayKeepsOrderAndSkipsInvalidItems {
+    NSDictionary *valid = [[[NSJSONSerialization JSONObjectWithData:_page options:0 error:nil] objectForKey:@"recenttracks"] objectForKey:@"track"][0];
+    NSArray *list = @[valid, @{@"name" : @"Missing everything else"}, @"Not a dictionary", valid];
+    
+    NSArray<LFMTrack *> *tracks = LFMModelArray([LFMTrack class], list);
+    
+    XCTAssertEqual(tracks.count, 2);
+    XCTAssertEqualObjects(tracks.firstObject.name, [valid objectForKey:@"name"]);
+    XCTAssertFalse([tracks isKindOfClass:[NSMutableArray class]]);
+}
+
+- (void)testModelArrayTreatsDictionaryAsListOfOne {
+    NSDictionary *valid = [[[NSJSONSerialization JSONObjectWithData:_page options:0 error:nil] objectForKey:@"recenttracks"] objectForKey:@"track"][0];
+    
+    XCTAssertEqual(LFMModelArray([LFMTrack class], valid).count, 1);
+    XCTAssertEqual(LFMModelArray([LFMTrack class], nil).count, 0);
+    XCTAssertEqual(LFMModelArray([LFMTrack class], @"").count, 0);
+}
+
+- (void)testDecodingMatchesMutableContainerDecoding {
+    NSArray<LFMTrack *> *expected = LFMDecodeTracksWithMutableContainers(_page);
+    NSArray<LFMTrack *> *tracks = LFMDecodeTracks(_page);
+    
+    XCTAssertEqual(tracks.count, 1000);
+    XCTAssertEqual(tracks.count, expected.count);
+    
+    for (NSUInteger i = 0; i < tracks.count; i++) {
+        XCTAssertEqualObjects(tracks[i].name, expected[i].name);
+        XCTAssertEqualObjects(tracks[i].URL, expected[i].URL);
+    }
+}
+
+- (void)testConcurrentDecodingKeepsOrder {
+    NSMutableArray *list = [[[[NSJSONSerialization JSONObjectWithData:_page options:0 error:nil] objectForKey:@"recenttracks"] objectForKey:@"track"] mutableCopy];
+    
+    // Items that can't be decoded mustn't leave holes or shift the ones around them out of order.
+    for (NSUInteger i = 0; i < list.count; i += 37) {
+        list[i] = @{@"name" : @"Missing everything else"};
+    }
+    
+    NSArray<LFMTrack *> *serial = LFMDecodeModels([LFMTrack class], [list copy], NO);
+    NSArray<LFMTrack *> *concurrent = LFMDecodeModels([LFMTrack class], [list copy], YES);
+    
+    XCTAssertEqual(serial.count, 1000 - 28);
+    XCTAssertEqual(concurrent.count, serial.count);
+    
+    for (NSUInteger i = 0; i < serial.count; i++) {
+        XCTAssertEqualObjects(concurrent[i].name, serial[i].name);
+    }
+}
+
+- (void)testImageSizesAndTagNamesAreShared {
+    NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:LFMFixtureTopArtistsPage(2) options:0 error:nil];
+    NSArray<LFMArtist *> *artists = LFMModelArray([LFMArtist class], [[responseDictionary objectForKey:@"artists"] objectForKey:@"artist"]);
+    
+    XCTAssertEqual(artists.count, 2);
+    XCTAssertEqual(artists[0].images.count, artists[1].images.count);
+    
+    // Every artist's images should be keyed by the same few string instances.
+    NSArray<LFMImageSize> *keys = artists[1].images.allKeys;
+    for (LFMImageSize size in artists[0].images) {
+        XCTAssertEqual(keys[[keys indexOfObject:size]], size);
+    }
+    
+    NSArray<LFMTag *> *first = LFMModelArray([LFMTag class], @[@{@"name" : [@"pop" mutableCopy], @"url" : @"https://www.last.fm/tag/pop"}]);
+    NSArray<LFMTag *> *second = LFMModelArray([LFMTag class], @[@{@"name" : [@"pop" mutableCopy], @"url" : @"https://www.last.fm/tag/pop"}]);
+    
+    XCTAssertEqual(first.firstObject.name, second.firstObject.name);
+}
+
+- (void)testImageSetMatchesImageDictionary {
+    NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:LFMFixtureTopArtistsPage(1) options:0 error:nil];
+    NSArray *images = [[[[responseDictionary objectForKey:@"artists"] objectForKey:@"artist"] firstObject] objectForKey:@"image"];
+    LFMImageSet *imageSet = [LFMImageSet imageSetFromArray:images];
+    
+    XCTAssertEqual(imageSet.count, 5);
+    XCTAssertEqualObjects(imageSet.dictionary, imageDictionaryFromArray(images));
+    XCTAssertEqual(imageSet.dictionary, imageSet.dictionary);
+    
+    // Sizes Last.fm may add in future and missing images have no slot.
+    imageSet = [LFMImageSet imageSetFromArray:@[@{@"#text" : @"", @"size" : @"small"}, @{@"#text" : @"https://lastfm-img2.akamaized.net/i/u/2a96cbd8b46e442fc41c2b86b821562f.png", @"size" : @""}]];
+    XCTAssertNil(imageSet);
+    
+    LFMArtist *artist = LFMModelArray([LFMArtist class], @{@"name" : @"Ariana Grande", @"mbid" : @"", @"url" : @"https://www.last.fm/music/Ariana+Grande", @"streamable" : @"0"}).firstObject;
+    XCTAssertEqualObjects(artist.images, @{});
+}
+
+- (void)testImageAllocationsPerThousandArtists {
+    NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:LFMFixtureTopArtistsPage(1000) options:0 error:nil];
+    NSArray *list = [[responseDictionary objectForKey:@"artists"] objectForKey:@"artist"];
+    
+    LFMAllocationStatistics dictionaryStatistics = LFMCountAllocations(^{
+        @autoreleasepool {
+            for (NSDictionary *artist in list) {
+                imageDictionaryFromArray([artist objectForKey:@"image"]);
+            }
+        }
+    });
+    LFMAllocationStatistics imageSetStatistics = LFMCountAllocations(^{
+        @autoreleasepool {
+            for (NSDictionary *artist in list) {
+                [LFMImageSet imageSetFromArray:[artist objectForKey:@"image"]];
+            }
+        }
+    });
+    LFMAllocationStatistics pageStatistics = LFMCountAllocations(^{
+        @autoreleasepool {
+            XCTAssertEqual(LFMModelArray([LFMArtist class], list).count, 1000);
+        }
+    });
+    
+    NSLog(@"Building images dictionaries for 1000 artists: %lu allocations, %lu bytes", (unsigned long)dictionaryStatistics.allocations, (unsigned long)dictionaryStatistics.bytes);
+    NSLog(@"Building image sets for 1000 artists: %lu allocations, %lu bytes", (unsigned long)imageSetStatistics.allocations, (unsigned long)imageSetStatistics.bytes);
+    NSLog(@"Decoding a 1000 artist chart page: %lu allocations, %lu bytes", (unsigned long)pageStatistics.allocations, (unsigned long)pageStatistics.bytes);
+    
+    // One object per artist, against a dictionary and five URLs.
+    XCTAssertLessThanOrEqual(imageSetStatistics.allocations, 1000 + 10);
+    XCTAssertLessThan(imageSetStatistics.allocations * 5, dictionaryStatistics.allocations);
+}
+
+- (void)testNestedModelsAreBuiltOnFirstAccess {
+    NSDictionary *dictionary = [[NSJSONSerialization JSONObjectWithData:LFMFixtureArtistInfo() options:0 error:nil] objectForKey:@"artist"];
+    LFMArtist *artist = LFMModelArray([LFMArtist class], dictionary).firstObject;
+    
+    XCTAssertEqual(artist.similarArtists.count, 5);
+    XCTAssertEqualObjects(artist.similarArtists.firstObject.name, @"Selena Gomez");
+    XCTAssertEqual(artist.tags.count, 5);
+    XCTAssertNotNil(artist.wiki);
+    
+    XCTAssertEqual(artist.similarArtists, artist.similarArtists);
+    XCTAssertEqual(artist.tags, artist.tags);
+    XCTAssertEqual(artist.wiki, artist.wiki);
+}
+
+- (void)testConcurrentFirstAccessBuildsNestedModelsOnce {
+    NSDictionary *dictionary = [[NSJSONSerialization JSONObjectWithData:LFMFixtureArtistInfo() options:0 error:nil] objectForKey:@"artist"];
+    
+    for (NSUInteger attempt = 0; attempt < 50; attempt++) {
+        LFMArtist *artist = LFMModelArray([LFMArtist class], dictionary).firstObject;
+        NSMutableSet *tags = [NSMutableSet set];
+        NSMutableSet *wikis = [NSMutableSet set];
+        
+        dispatch_apply(8, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration) {
+            NSValue *tagsPointer = [NSValue valueWithNonretainedObject:artist.tags];
+            NSValue *wikiPointer = [NSValue valueWithNonretainedObject:artist.wiki];
+            
+            @synchronized (tags) {
+                [tags addObject:tagsPointer];
+                [wikis addObject:wikiPointer];
+            }
+        });
+        
+        XCTAssertEqual(tags.count, 1);
+        XCTAssertEqual(wikis.count, 1);
+    }
+}
+
+- (void)testAllocationsPerThousandTracks {
+    NSData *page = _page;
+    __block NSUInteger count = 0;
+    
+    LFMAllocationStatistics mutableStatistics = LFMCountAllocations(^{
+        @autoreleasepool {
+            count += LFMDecodeTracksWithMutableContainers(page).count;
+        }
+    });
+    LFMAllocationStatistics immutableStatistics = LFMCountAllocations(^{
+        @autoreleasepool {
+            count += LFMDecodeTracks(page).count;
+        }
+    });
+    
+    NSLog(@"Decoding 1000 tracks with mutable containers: %lu allocations, %lu bytes", (unsigned long)mutableStatistics.allocations, (unsigned long)mutableStatistics.bytes);
+    NSLog(@"Decoding 1000 tracks into immutable containers: %lu allocations, %lu bytes", (unsigned long)immutableStatistics.allocations, (unsigned long)immutableStatistics.bytes);
+    
+    XCTAssertEqual(count, 2000);
+    XCTAssertLessThanOrEqual(immutableStatistics.allocations, mutableStatistics.allocations);
+    XCTAssertLessThanOrEqual(immutableStatistics.bytes, mutableStatistics.bytes);
+}
+
+- (void)testMutableContainerDecodingPerformance {
+    NSData *page = _page;
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            @autoreleasepool {
+                XCTAssertEqual(LFMDecodeTracksWithMutableContainers(page).count, 1000);
+            }
+        }
+    }];
+}
+
+- (void)testImmutableDecodingPerformance {
+    NSData *page = _page;
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            @autoreleasepool {
+                XCTAssertEqual(LFMDecodeTracks(page).count, 1000);
+            }
+        }
+    }];
+}
+
+- (void)testSerialBatchDecodingPerformance {
+    NSArray *tracks = [[[NSJSONSerialization JSONObjectWithData:_page options:0 error:nil] objectForKey:@"recenttracks"] objectForKey:@"track"];
+    NSArray *artists = [[[NSJSONSerialization JSONObjectWithData:LFMFixtureTopArtistsPage(1000) options:0 error:nil] objectForKey:@"artists"] objectForKey:@"artist"];
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            @autoreleasepool {
+                XCTAssertEqual(LFMDecodeModels([LFMTrack class], tracks, NO).count, 1000);
+                XCTAssertEqual(LFMDecodeModels([LFMArtist class], artists, NO).count, 1000);
+            }
+        }
+    }];
+}
+
+- (void)testConcurrentBatchDecodingPerformance {
+    NSArray *tracks = [[[NSJSONSerialization JSONObjectWithData:_page options:0 error:nil] objectForKey:@"recenttracks"] objectForKey:@"track"];
+    NSArray *artists = [[[NSJSONSerialization JSONObjectWithData:LFMFixtureTopArtistsPage(1000) options:0 error:nil] objectForKey:@"artists"] objectForKey:@"artist"];
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            @autoreleasepool {
+                XCTAssertEqual(LFMDecodeModels([LFMTrack class], tracks, YES).count, 1000);
+                XCTAssertEqual(LFMDecodeModels([LFMArtist class], artists, YES).count, 1000);
+            }
+        }
+    }];
+}
+
+/** A page of artists as detailed as `artist.getInfo` returns them, with similar artists, tags and a biography each. */
+static NSArray *LFMDetailedArtistList(NSUInteger count) {
+    NSDictionary *dictionary = [[NSJSONSerialization JSONObjectWithData:LFMFixtureArtistInfo() options:0 error:nil] objectForKey:@"artist"];
+    NSMutableArray *list = [NSMutableArray arrayWithCapacity:count];
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        [list addObject:dictionary];
+    }
+    
+    return [list copy];
+}
+
+- (void)testLazyHydrationAllocations {
+    NSArray *list = LFMDetailedArtistList(1000);
+    
+    LFMAllocationStatistics eagerStatistics = LFMCountAllocations(^{
+        @autoreleasepool {
+            for (LFMArtist *artist in LFMDecodeModels([LFMArtist class], list, NO)) {
+                [artist similarArtists];
+                [artist tags];
+                [artist wiki];
+            }
+        }
+    });
+    LFMAllocationStatistics lazyStatistics = LFMCountAllocations(^{
+        @autoreleasepool {
+            LFMDecodeModels([LFMArtist class], list, NO);
+        }
+    });
+    
+    NSLog(@"Decoding 1000 detailed artists and building their nested models: %lu allocations, %lu bytes", (unsigned long)eagerStatistics.allocations, (unsigned long)eagerStatistics.bytes);
+    NSLog(@"Decoding 1000 detailed artists without reading their nested models: %lu allocations, %lu bytes", (unsigned long)lazyStatistics.allocations, (unsigned long)lazyStatistics.bytes);
+    
+    XCTAssertLessThan(lazyStatistics.allocations, eagerStatistics.allocations);
+    XCTAssertLessThan(lazyStatistics.bytes, eagerStatistics.bytes);
+}
+
+/** Baseline: every nested model is built, which is what decoding used to do whether or not it was read. */
+- (void)testEagerHydrationPerformance {
+    NSArray *list = LFMDetailedArtistList(1000);
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            @autoreleasepool {
+                for (LFMArtist *artist in LFMDecodeModels([LFMArtist class], list, NO)) {
+                    XCTAssertEqual(artist.similarArtists.count + artist.tags.count, 10);
+                    XCTAssertNotNil(artist.wiki);
+                }
+            }
+        }
+    }];
+}
+
+- (void)testLazyHydrationPerformance {
+    NSArray *list = LFMDetailedArtistList(1000);
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            @autoreleasepool {
+                for (LFMArtist *artist in LFMDecodeModels([LFMArtist class], list, NO)) {
+                    XCTAssertNotNil(artist.name);
+                }
+            }
+        }
+    }];
+}
+
+@end
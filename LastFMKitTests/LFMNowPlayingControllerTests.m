@@ -0,0 +1,217 @@
+//
+//  LFMNowPlayingControllerTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
+
+@interface LFMArtist (Testing)
+
+- (nullable instancetype)initFromDictionary:(NSDictionary *)dictionary;
+
+@end
+
+@interface LFMNowPlayingControllerTests : XCTestCase
+
+@end
+
+@implementation LFMNowPlayingControllerTests {
+    LFMClient *_previousClient;
+    LFMClient *_client;
+    NSMutableArray<NSString *> *_bodies;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+    
+    NSMutableArray<NSString *> *bodies = [NSMutableArray array];
+    _bodies = bodies;
+    
+    [LFMStubURLProtocol reset];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        NSData *body = [LFMStubURLProtocol bodyOfRequest:request];
+        NSString *string = [[NSString alloc] initWithData:body encoding:NSUTF8StringEncoding];
+        
+        @synchronized (bodies) {
+            [bodies addObject:string];
+        }
+        
+        if ([string containsString:@"method=track.scrobble"]) return LFMFixtureScrobblesForRequestBody(body, 0);
+        
+        return [@"{\"nowplaying\":{}}" dataUsingEncoding:NSUTF8StringEncoding];
+    }];
+    
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    [LFMClient setSharedClient:_client];
+}
+
+- (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+    
+    [super tearDown];
+}
+
+- (void)updateController:(LFMNowPlayingController *)controller withTrackNamed:(NSString *)trackName callback:(void (^)(NSError *))block {
+    [controller updateNowPlayingWithTrackNamed:trackName
+                                 byArtistNamed:@"Ariana Grande"
+                                  onAlbumNamed:@"Dangerous Woman"
+                               positionInAlbum:nil
+                          withAlbumArtistNamed:nil
+                                 trackDuration:@180
+                                 musicBrainzId:nil
+                                      callback:block];
+}
+
+- (void)testRapidUpdatesAreCoalescedIntoTheFirstAndLast {
+    LFMNowPlayingController *controller = [[LFMNowPlayingController alloc] initWithMinimumInterval:0.5];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Updates"];
+    expectation.expectedFulfillmentCount = 5;
+    
+    NSMutableArray<NSNumber *> *cancelled = [NSMutableArray array];
+    
+    for (NSUInteger i = 0; i < 5; i++) {
+        [self updateController:controller withTrackNamed:[NSString stringWithFormat:@"Track %tu", i] callback:^(NSError *error) {
+            if ([error.domain isEqualToString:NSURLErrorDomain] && error.code == NSURLErrorCancelled) {
+                @synchronized (cancelled) {
+                    [cancelled addObject:@(i)];
+                }
+            } else {
+                XCTAssertNil(error);
+            }
+            [expectation fulfill];
+        }];
+        
+        // Let the first update go out before the rest are made.
+        if (i == 0) [NSThread sleepForTimeInterval:0.1];
+    }
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 2);
+    XCTAssertEqualObjects([cancelled sortedArrayUsingSelector:@selector(compare:)], (@[@1, @2, @3]));
+    XCTAssertTrue([_bodies[0] containsString:@"track=Track%200"]);
+    XCTAssertTrue([_bodies[1] containsString:@"track=Track%204"]);
+}
+
+- (void)testUpdatesAreSpacedByTheMinimumInterval {
+    LFMNowPlayingController *controller = [[LFMNowPlayingController alloc] initWithMinimumInterval:0.5];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Updates"];
+    expectation.expectedFulfillmentCount = 2;
+    
+    NSMutableArray<NSNumber *> *times = [NSMutableArray array];
+    void (^callback)(NSError *) = ^(NSError *error) {
+        XCTAssertNil(error);
+        @synchronized (times) {
+            [times addObject:@(CFAbsoluteTimeGetCurrent())];
+        }
+        [expectation fulfill];
+    };
+    
+    [self updateController:controller withTrackNamed:@"Be Alright" callback:callback];
+    [NSThread sleepForTimeInterval:0.1];
+    [self updateController:controller withTrackNamed:@"Into You" callback:callback];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertGreaterThanOrEqual(times[1].doubleValue - times[0].doubleValue, 0.4);
+}
+
+- (void)testSessionsAreCoalescedIndependently {
+    LFMNowPlayingController *controller = [[LFMNowPlayingController alloc] initWithMinimumInterval:10];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Updates"];
+    expectation.expectedFulfillmentCount = 2;
+    
+    for (NSUInteger user = 1; user <= 2; user++) {
+        LFMSession *session = [[LFMSession alloc] initWithSessionKey:[NSString stringWithFormat:@"%032tx", user] userName:[NSString stringWithFormat:@"user%tu", user] userIsSubscriber:NO];
+        
+        [controller updateNowPlayingWithTrackNamed:@"Be Alright"
+                                     byArtistNamed:@"Ariana Grande"
+                                      onAlbumNamed:nil
+                                   positionInAlbum:nil
+                              withAlbumArtistNamed:nil
+                                     trackDuration:nil
+                                     musicBrainzId:nil
+                                        forSession:session
+                                          callback:^(NSError *error) {
+            XCTAssertNil(error);
+            [expectation fulfill];
+        }];
+    }
+    
+    // Neither update waits for the interval, because each is the first for its session.
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    
+    XCTAssertEqual(_bodies.count, 2);
+    XCTAssertNotEqual([_bodies[0] containsString:[NSString stringWithFormat:@"sk=%032x", 1]], [_bodies[1] containsString:[NSString stringWithFormat:@"sk=%032x", 1]]);
+    XCTAssertNotEqual([_bodies[0] containsString:[NSString stringWithFormat:@"sk=%032x", 2]], [_bodies[1] containsString:[NSString stringWithFormat:@"sk=%032x", 2]]);
+}
+
+- (void)testScrobblingDiscardsThePendingUpdateForTheTrack {
+    LFMNowPlayingController *controller = [[LFMNowPlayingController alloc] initWithMinimumInterval:0.5];
+    XCTestExpectation *sent = [self expectationWithDescription:@"Sent"];
+    XCTestExpectation *discarded = [self expectationWithDescription:@"Discarded"];
+    XCTestExpectation *scrobbled = [self expectationWithDescription:@"Scrobbled"];
+    
+    [self updateController:controller withTrackNamed:@"Be Alright" callback:^(NSError *error) {
+        XCTAssertNil(error);
+        [sent fulfill];
+    }];
+    [NSThread sleepForTimeInterval:0.1];
+    
+    // Names are matched the way the identity map matches them.
+    [self updateController:controller withTrackNamed:@"into you " callback:^(NSError *error) {
+        XCTAssertEqualObjects(error.domain, NSURLErrorDomain);
+        XCTAssertEqual(error.code, NSURLErrorCancelled);
+        [discarded fulfill];
+    }];
+    
+    NSDictionary *artistDictionary = [[NSJSONSerialization JSONObjectWithData:LFMFixtureArtistInfo() options:0 error:nil] objectForKey:@"artist"];
+    LFMArtist *artist = [[LFMArtist alloc] initFromDictionary:artistDictionary];
+    LFMTrack *track = [[LFMTrack alloc] initWithName:@"Into You" artist:artist musicBrainzID:@"" album:nil positionInAlbum:0 URL:[NSURL URLWithString:@"https://www.last.fm/music/Ariana+Grande/_/Into+You"] duration:180 streamable:NO tags:@[] wiki:nil listeners:0 playCount:0];
+    LFMScrobbleTrack *scrobbleTrack = [[LFMScrobbleTrack alloc] initFromTrack:track withTimestamp:[NSDate date] chosenByUser:YES];
+    
+    [LFMTrackProvider scrobbleTracks:@[scrobbleTrack] callback:^(NSError *error) {
+        [scrobbled fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    // Give the discarded update's flush the chance to run; it must not send anything.
+    [NSThread sleepForTimeInterval:0.6];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 2);
+    XCTAssertTrue([_bodies[0] containsString:@"track=Be%20Alright"]);
+    XCTAssertTrue([_bodies[1] containsString:@"method=track.scrobble"]);
+}
+
+@end
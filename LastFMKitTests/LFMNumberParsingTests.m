@@ -0,0 +1,184 @@
+//
+//  LFMNumberParsingTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import <LastFMKit/LFMNumberParsing.h>
+#import <LastFMKit/LFMError.h>
+
+@interface LFMQuery (Testing)
+
+- (nullable instancetype)initFromDictionary:(NSDictionary *)dictionary;
+
+@end
+
+@interface LFMSession (Testing)
+
+- (nullable instancetype)initFromDictionary:(NSDictionary *)dictionary;
+
+@end
+
+@interface LFMNumberParsingTests : XCTestCase
+
+@end
+
+@implementation LFMNumberParsingTests
+
+- (void)testValidCounts {
+    NSUInteger value = 42;
+    
+    XCTAssertTrue(LFMParseUnsignedInteger(@"0", &value));
+    XCTAssertEqual(value, 0);
+    XCTAssertTrue(LFMParseUnsignedInteger(@"165306112", &value));
+    XCTAssertEqual(value, 165306112);
+    XCTAssertTrue(LFMParseUnsignedInteger(@"007", &value));
+    XCTAssertEqual(value, 7);
+    XCTAssertTrue(LFMParseUnsignedInteger(@6, &value));
+    XCTAssertEqual(value, 6);
+    XCTAssertTrue(LFMParseUnsignedInteger(@3.0, &value));
+    XCTAssertEqual(value, 3);
+    XCTAssertTrue(LFMParseUnsignedInteger([NSString stringWithFormat:@"%lu", (unsigned long)NSUIntegerMax], &value));
+    XCTAssertEqual(value, NSUIntegerMax);
+}
+
+- (void)testAbsentIsToldApartFromZero {
+    NSUInteger value = 42;
+    
+    XCTAssertFalse(LFMParseUnsignedInteger(nil, &value));
+    XCTAssertFalse(LFMParseUnsignedInteger([NSNull null], &value));
+    XCTAssertFalse(LFMParseUnsignedInteger(@"", &value));
+    XCTAssertEqual(value, 42);
+    
+    XCTAssertEqual(LFMUnsignedIntegerValue(nil), 0);
+    XCTAssertEqual(LFMUnsignedIntegerValue(@"12"), 12);
+}
+
+- (void)testInvalidCountsAreRejected {
+    NSUInteger value = 42;
+    
+    for (id invalid in @[@"-1", @"+1", @" 1", @"1 ", @"1.5", @"1e3", @"12a", @"abc", @"١٢", @"123456789012345678901", @"18446744073709551616", @-1, @1.5, @(INFINITY), @(NAN), @YES, @[@"1"], @{@"#text" : @"1"}]) {
+        XCTAssertFalse(LFMParseUnsignedInteger(invalid, &value), @"%@", invalid);
+    }
+    
+    XCTAssertEqual(value, 42);
+}
+
+- (void)testTimestamps {
+    NSTimeInterval timestamp = 0;
+    
+    XCTAssertTrue(LFMParseTimestamp(@"1508865600", &timestamp));
+    XCTAssertEqual(timestamp, 1508865600);
+    XCTAssertTrue(LFMParseTimestamp(@1508865600.5, &timestamp));
+    XCTAssertEqual(timestamp, 1508865600.5);
+    
+    XCTAssertFalse(LFMParseTimestamp(nil, &timestamp));
+    XCTAssertFalse(LFMParseTimestamp(@"", &timestamp));
+    XCTAssertFalse(LFMParseTimestamp(@"-1", &timestamp));
+    XCTAssertFalse(LFMParseTimestamp(@"24 Oct 2017, 17:20", &timestamp));
+    XCTAssertFalse(LFMParseTimestamp(@(-1.5), &timestamp));
+    XCTAssertEqual(timestamp, 1508865600.5);
+}
+
+- (void)testQueryRequiresEveryCount {
+    LFMQuery *query = [[LFMQuery alloc] initFromDictionary:@{@"page" : @"2", @"perPage" : @"50", @"total" : @"0"}];
+    
+    XCTAssertEqual(query.currentPage, 2);
+    XCTAssertEqual(query.itemsPerPage, 50);
+    XCTAssertEqual(query.totalResults, 0);
+    
+    XCTAssertNil([[LFMQuery alloc] initFromDictionary:@{@"page" : @"2", @"perPage" : @"50"}]);
+    XCTAssertNil([[LFMQuery alloc] initFromDictionary:@{@"page" : @"-2", @"perPage" : @"50", @"total" : @"0"}]);
+}
+
+- (void)testSessionSubscriberIsOptional {
+    LFMSession *session = [[LFMSession alloc] initFromDictionary:@{@"name" : @"mourke", @"key" : @"d580d57f32848f5dcf574d1ce18d78b2"}];
+    
+    XCTAssertNotNil(session);
+    XCTAssertFalse(session.userIsSubscriber);
+    
+    session = [[LFMSession alloc] initFromDictionary:@{@"name" : @"mourke", @"key" : @"d580d57f32848f5dcf574d1ce18d78b2", @"subscriber" : @"1"}];
+    XCTAssertTrue(session.userIsSubscriber);
+    
+    XCTAssertNil([[LFMSession alloc] initFromDictionary:@{@"name" : @"mourke", @"key" : @"d580d57f32848f5dcf574d1ce18d78b2", @"subscriber" : @"yes"}]);
+}
+
+- (void)testErrorRequiresCode {
+    NSError *error = nil;
+    
+    XCTAssertFalse(lfm_error_validate_object(@{@"error" : @6, @"message" : @"Artist not found"}, &error));
+    XCTAssertEqual(error.code, 6);
+    
+    error = nil;
+    XCTAssertTrue(lfm_error_validate_object(@{@"message" : @"Not an error"}, &error));
+    XCTAssertNil(error);
+}
+
+- (void)testErrorWithUnreadableCodeIsStillAnError {
+    NSError *error = nil;
+    
+    XCTAssertFalse(lfm_error_validate_object(@{@"error" : @"six", @"message" : @"Artist not found"}, &error));
+    XCTAssertEqual(error.code, 0);
+    XCTAssertEqualObjects(error.localizedDescription, @"Artist not found");
+    
+    error = nil;
+    XCTAssertFalse(lfm_error_validate_object(@{@"error" : [NSNull null]}, &error));
+    XCTAssertNotNil(error);
+    
+    error = nil;
+    XCTAssertFalse(lfm_error_validate_object(@{@"error" : @6}, &error));
+    XCTAssertEqual(error.code, 6);
+}
+
+- (void)testParsingPerformance {
+    NSArray<NSString *> *fields = @[@"0", @"1", @"42", @"1947843", @"165306112", @"1508865600", @"50", @"412310"];
+    
+    [self measureBlock:^{
+        NSUInteger sum = 0;
+        
+        for (NSUInteger i = 0; i < 1000000; i++) {
+            sum += LFMUnsignedIntegerValue(fields[i & 7]);
+        }
+        
+        XCTAssertGreaterThan(sum, 0);
+    }];
+}
+
+/** Baseline: what every count field went through before. */
+- (void)testIntegerValuePerformance {
+    NSArray<NSString *> *fields = @[@"0", @"1", @"42", @"1947843", @"165306112", @"1508865600", @"50", @"412310"];
+    
+    [self measureBlock:^{
+        NSUInteger sum = 0;
+        
+        for (NSUInteger i = 0; i < 1000000; i++) {
+            sum += (NSUInteger)[fields[i & 7] integerValue];
+        }
+        
+        XCTAssertGreaterThan(sum, 0);
+    }];
+}
+
+@end
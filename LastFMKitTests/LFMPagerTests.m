@@ -0,0 +1,193 @@
+//
+//  LFMPagerTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
+
+static NSUInteger LFMRequestedPage(NSURLRequest *request) {
+    NSURLComponents *components = [NSURLComponents componentsWithURL:request.URL resolvingAgainstBaseURL:NO];
+    for (NSURLQueryItem *item in components.queryItems) {
+        if ([item.name isEqualToString:@"page"]) return item.value.integerValue;
+    }
+    return 1;
+}
+
+@interface LFMPagerTests : XCTestCase
+
+@end
+
+@implementation LFMPagerTests {
+    LFMClient *_previousClient;
+    LFMClient *_client;
+    NSMutableArray<NSNumber *> *_requestedPages;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+    
+    NSMutableArray<NSNumber *> *requestedPages = _requestedPages = [NSMutableArray array];
+    
+    [LFMStubURLProtocol reset];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        NSUInteger page = LFMRequestedPage(request);
+        
+        @synchronized (requestedPages) {
+            [requestedPages addObject:@(page)];
+        }
+        
+        // 115 tracks, 50 per page.
+        return LFMFixtureRecentTracksPage(page < 3 ? 50 : 15, page, 115);
+    }];
+    
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    [LFMClient setSharedClient:_client];
+}
+
+- (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+    
+    [super tearDown];
+}
+
+- (void)testPagerStopsAtTotalResults {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Enumeration"];
+    LFMPager<LFMTrack *> *pager = [LFMUserProvider pagerForRecentTracksForUserNamed:@"mourke" itemsPerPage:50 fromStartDate:nil toEndDate:nil prefetchLimit:2];
+    __block NSUInteger count = 0;
+    
+    [pager enumerateItemsUsingBlock:^(LFMTrack *track, BOOL *stop) {
+        count++;
+    } completion:^(NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual(count, 115);
+    XCTAssertEqual(pager.query.totalResults, 115);
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 3);
+}
+
+- (void)testPagesAreDeliveredInOrder {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Enumeration"];
+    LFMPager<LFMTrack *> *pager = [LFMUserProvider pagerForRecentTracksForUserNamed:@"mourke" itemsPerPage:50 fromStartDate:nil toEndDate:nil prefetchLimit:3];
+    NSMutableArray<NSString *> *names = [NSMutableArray array];
+    
+    [LFMStubURLProtocol setResponseDelay:0.05];
+    
+    [pager enumerateItemsUsingBlock:^(LFMTrack *track, BOOL *stop) {
+        [names addObject:track.name];
+    } completion:^(NSError * _Nullable error) {
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual(names.count, 115);
+    XCTAssertEqualObjects(names[0], @"Be Alright 0");
+    XCTAssertEqualObjects(names[50], @"Be Alright 0");
+    XCTAssertEqualObjects(names[114], @"Be Alright 14");
+}
+
+- (void)testPrefetchIsBounded {
+    XCTestExpectation *firstPage = [self expectationWithDescription:@"First page"];
+    LFMPager<LFMTrack *> *pager = [LFMUserProvider pagerForRecentTracksForUserNamed:@"mourke" itemsPerPage:50 fromStartDate:nil toEndDate:nil prefetchLimit:1];
+    
+    [pager nextPageWithCallback:^(NSError * _Nullable error, NSArray<LFMTrack *> * _Nullable items) {
+        XCTAssertEqual(items.count, 50);
+        [firstPage fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    // Give the prefetched page time to arrive; nothing beyond it should be requested while it sits unconsumed.
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.3]];
+    
+    @synchronized (_requestedPages) {
+        XCTAssertEqualObjects(_requestedPages, (@[@1, @2]));
+    }
+    
+    [pager cancel];
+}
+
+- (void)testStoppingCancelsPrefetchedPages {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Enumeration"];
+    LFMPager<LFMTrack *> *pager = [LFMUserProvider pagerForRecentTracksForUserNamed:@"mourke" itemsPerPage:50 fromStartDate:nil toEndDate:nil prefetchLimit:1];
+    __block NSUInteger count = 0;
+    
+    [pager enumerateItemsUsingBlock:^(LFMTrack *track, BOOL *stop) {
+        *stop = ++count == 10;
+    } completion:^(NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTestExpectation *cancelled = [self expectationWithDescription:@"Cancelled"];
+    
+    [pager nextPageWithCallback:^(NSError * _Nullable error, NSArray<LFMTrack *> * _Nullable items) {
+        XCTAssertEqual(error.code, NSURLErrorCancelled);
+        XCTAssertNil(items);
+        [cancelled fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual(count, 10);
+}
+
+- (void)testErrorEndsPaging {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Enumeration"];
+    LFMPager<LFMTrack *> *pager = [LFMUserProvider pagerForRecentTracksForUserNamed:@"mourke" itemsPerPage:50 fromStartDate:nil toEndDate:nil prefetchLimit:2];
+    __block NSUInteger count = 0;
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        NSUInteger page = LFMRequestedPage(request);
+        return page == 2 ? LFMFixtureError(8) : LFMFixtureRecentTracksPage(page < 3 ? 50 : 15, page, 115);
+    }];
+    
+    [pager enumerateItemsUsingBlock:^(LFMTrack *track, BOOL *stop) {
+        count++;
+    } completion:^(NSError * _Nullable error) {
+        XCTAssertEqual(error.code, 8);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual(count, 50);
+}
+
+@end
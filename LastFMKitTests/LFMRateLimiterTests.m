@@ -0,0 +1,264 @@
+//
+//  LFMRateLimiterTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
+
+@interface LFMRateLimiter (Testing)
+
+- (void)acquireTokenForAPIKey:(nullable NSString *)apiKey handler:(dispatch_block_t)handler;
+- (void)acquireTokenForAPIKey:(nullable NSString *)apiKey isCancelled:(BOOL (^ _Nullable)(void))isCancelled handler:(dispatch_block_t)handler;
+- (void)pauseAPIKey:(nullable NSString *)apiKey forTimeInterval:(NSTimeInterval)interval;
+
+@end
+
+@interface LFMRateLimiterTests : XCTestCase
+
+@end
+
+@implementation LFMRateLimiterTests {
+    LFMClient *_previousClient;
+    LFMClient *_client;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+    
+    [LFMStubURLProtocol reset];
+    
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    _client.retryDelay = 0.01;
+    [LFMClient setSharedClient:_client];
+}
+
+- (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+    
+    [super tearDown];
+}
+
+- (void)getArtistInfoWithCallback:(void (^)(NSError * _Nullable error, LFMArtist * _Nullable artist))callback {
+    [LFMArtistProvider getInfoOnArtistNamed:@"Ariana Grande" withMusicBrainzId:nil autoCorrect:YES forUser:nil languageCode:nil callback:callback];
+}
+
+- (void)testRateLimitExceededIsRetried {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Artist info"];
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return [LFMStubURLProtocol requestCount] == 1 ? LFMFixtureError(29) : LFMFixtureArtistInfo();
+    }];
+    
+    [self getArtistInfoWithCallback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(artist.name, @"Ariana Grande");
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 2);
+}
+
+- (void)testTooManyRequestsStatusIsRetried {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Artist info"];
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        if ([LFMStubURLProtocol requestCount] == 1) {
+            *statusCode = 429;
+            return [NSData data];
+        }
+        return LFMFixtureArtistInfo();
+    }];
+    
+    [self getArtistInfoWithCallback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        XCTAssertNil(error);
+        XCTAssertNotNil(artist);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 2);
+}
+
+- (void)testTransientErrorsAreRetriedUntilRetriesRunOut {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Artist info"];
+    
+    _client.maximumRetryCount = 2;
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return [LFMStubURLProtocol requestCount] % 2 == 1 ? LFMFixtureError(16) : LFMFixtureError(11);
+    }];
+    
+    [self getArtistInfoWithCallback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        XCTAssertEqual(error.code, 16);
+        XCTAssertNil(artist);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 3);
+}
+
+- (void)testCancellingDuringBackOffStopsTheRetry {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Artist info"];
+    
+    _client.retryDelay = 0.5;
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureError(16);
+    }];
+    
+    NSURLSessionDataTask *dataTask = [LFMArtistProvider getInfoOnArtistNamed:@"Ariana Grande" withMusicBrainzId:nil autoCorrect:YES forUser:nil languageCode:nil callback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        XCTAssertEqualObjects(error.domain, NSURLErrorDomain);
+        XCTAssertEqual(error.code, NSURLErrorCancelled);
+        [expectation fulfill];
+    }];
+    
+    // Let the first attempt fail, then cancel while the retry waits out its back off.
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:5.0];
+    while ([LFMStubURLProtocol requestCount] == 0 && [deadline timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    [dataTask cancel];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 1);
+}
+
+- (void)testPermanentErrorsAreNotRetried {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Artist info"];
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureError(6);
+    }];
+    
+    [self getArtistInfoWithCallback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        XCTAssertEqual(error.code, 6);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 1);
+}
+
+- (void)testLimiterSpacesRequestsAfterBurst {
+    LFMRateLimiter *rateLimiter = [[LFMRateLimiter alloc] initWithRequestsPerSecond:20 burst:2];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Tokens"];
+    expectation.expectedFulfillmentCount = 6;
+    
+    NSMutableArray<NSNumber *> *order = [NSMutableArray array];
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    
+    for (NSUInteger i = 0; i < 6; i++) {
+        [rateLimiter acquireTokenForAPIKey:@"key" handler:^{
+            @synchronized (order) {
+                [order addObject:@(i)];
+            }
+            [expectation fulfill];
+        }];
+    }
+    
+    XCTAssertEqual(order.count, 2, @"The burst should be handed out straight away.");
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertGreaterThanOrEqual(CFAbsoluteTimeGetCurrent() - start, 0.19);
+    XCTAssertEqualObjects(order, (@[@0, @1, @2, @3, @4, @5]));
+}
+
+- (void)testCancelledWaitersTakeNoToken {
+    LFMRateLimiter *rateLimiter = [[LFMRateLimiter alloc] initWithRequestsPerSecond:5 burst:1];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Tokens"];
+    expectation.expectedFulfillmentCount = 4;
+    
+    __block BOOL cancelled = NO;
+    __block CFAbsoluteTime startedAt = 0;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    
+    [rateLimiter acquireTokenForAPIKey:@"key" handler:^{}];
+    
+    // Superseded while it waits; it should be let go without using up the next token.
+    for (NSUInteger i = 0; i < 3; i++) {
+        [rateLimiter acquireTokenForAPIKey:@"key" isCancelled:^BOOL{ return cancelled; } handler:^{
+            [expectation fulfill];
+        }];
+    }
+    cancelled = YES;
+    
+    [rateLimiter acquireTokenForAPIKey:@"key" isCancelled:^BOOL{ return NO; } handler:^{
+        startedAt = CFAbsoluteTimeGetCurrent();
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    // One token is refilled every 0.2 seconds; had the cancelled requests taken theirs, this one would have waited 0.8.
+    XCTAssertLessThan(startedAt - start, 0.5);
+}
+
+- (void)testKeysHaveTheirOwnBuckets {
+    LFMRateLimiter *rateLimiter = [[LFMRateLimiter alloc] initWithRequestsPerSecond:1 burst:1];
+    __block NSUInteger started = 0;
+    
+    [rateLimiter setRequestsPerSecond:10 burst:3 forAPIKey:@"generous"];
+    
+    for (NSUInteger i = 0; i < 3; i++) {
+        [rateLimiter acquireTokenForAPIKey:@"generous" handler:^{ started++; }];
+        [rateLimiter acquireTokenForAPIKey:@"strict" handler:^{ started++; }];
+    }
+    
+    XCTAssertEqual(started, 4);
+}
+
+- (void)testPausedKeyHandsOutNoTokens {
+    LFMRateLimiter *rateLimiter = [[LFMRateLimiter alloc] initWithRequestsPerSecond:100 burst:10];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Token"];
+    __block BOOL started = NO;
+    
+    [rateLimiter pauseAPIKey:@"key" forTimeInterval:0.2];
+    [rateLimiter acquireTokenForAPIKey:@"key" handler:^{
+        started = YES;
+        [expectation fulfill];
+    }];
+    
+    XCTAssertFalse(started);
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+@end
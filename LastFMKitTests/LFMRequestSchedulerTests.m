@@ -0,0 +1,174 @@
+//
+//  LFMRequestSchedulerTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
+
+static NSData *LFMSearchResults(void) {
+    return [@"{\"results\":{\"trackmatches\":{\"track\":[]}}}" dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+@interface LFMRequestSchedulerTests : XCTestCase
+
+@end
+
+@implementation LFMRequestSchedulerTests {
+    LFMClient *_previousClient;
+    LFMClient *_client;
+    LFMRequestScheduler *_scheduler;
+    NSMutableArray<NSString *> *_requestedMethods;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+    
+    [LFMStubURLProtocol reset];
+    
+    _scheduler = [[LFMRequestScheduler alloc] init];
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    _client.requestScheduler = _scheduler;
+    [LFMClient setSharedClient:_client];
+    
+    NSMutableArray<NSString *> *requestedMethods = [NSMutableArray array];
+    _requestedMethods = requestedMethods;
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        NSURLComponents *components = [NSURLComponents componentsWithURL:request.URL resolvingAgainstBaseURL:NO];
+        NSString *method = [components.queryItems filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"name == 'method'"]].firstObject.value;
+        
+        @synchronized (requestedMethods) {
+            [requestedMethods addObject:method];
+        }
+        
+        return [method isEqualToString:@"track.search"] ? LFMSearchResults() : LFMFixtureTopArtistsPage(5);
+    }];
+}
+
+- (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+    
+    [super tearDown];
+}
+
+- (void)testDefaultPriorities {
+    XCTAssertEqual([_scheduler priorityForMethod:@"track.search"], LFMRequestPriorityInteractive);
+    XCTAssertEqual([_scheduler priorityForMethod:@"track.updateNowPlaying"], LFMRequestPriorityInteractive);
+    XCTAssertEqual([_scheduler priorityForMethod:@"auth.getMobileSession"], LFMRequestPriorityInteractive);
+    XCTAssertEqual([_scheduler priorityForMethod:@"chart.getTopArtists"], LFMRequestPriorityNormal);
+    
+    [_scheduler setPriority:LFMRequestPriorityBackground forMethod:@"chart.*"];
+    [_scheduler setPriority:LFMRequestPriorityNormal forMethod:@"chart.getTopTags"];
+    
+    XCTAssertEqual([_scheduler priorityForMethod:@"chart.getTopArtists"], LFMRequestPriorityBackground);
+    XCTAssertEqual([_scheduler priorityForMethod:@"chart.getTopTags"], LFMRequestPriorityNormal);
+}
+
+- (void)testInteractiveRequestsAreNotHeldUpByBackgroundRequests {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Requests"];
+    expectation.expectedFulfillmentCount = 4;
+    
+    [_scheduler setMaximumConcurrentRequests:1 forPriority:LFMRequestPriorityBackground];
+    [LFMStubURLProtocol setResponseDelay:0.2];
+    
+    [LFMRequestScheduler performRequestsWithPriority:LFMRequestPriorityBackground usingBlock:^{
+        for (NSUInteger page = 1; page <= 3; page++) {
+            [LFMChartProvider getTopArtistsOnPage:page itemsPerPage:5 callback:^(NSError * _Nullable error, NSArray<LFMArtist *> *artists, LFMQuery * _Nullable query) {
+                XCTAssertNil(error);
+                [expectation fulfill];
+            }];
+        }
+    }];
+    
+    [LFMTrackProvider searchForTrackNamed:@"Into You" byArtistNamed:nil itemsPerPage:30 onPage:1 callback:^(NSError * _Nullable error, NSArray<LFMTrack *> *tracks, LFMSearchQuery * _Nullable searchQuery) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqualObjects(_requestedMethods, (@[@"chart.getTopArtists", @"track.search", @"chart.getTopArtists", @"chart.getTopArtists"]));
+}
+
+- (void)testSupersededRequestsAreCancelled {
+    NSArray<NSString *> *queries = @[@"I", @"In", @"Into", @"Into Y", @"Into You"];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Searches"];
+    expectation.expectedFulfillmentCount = queries.count;
+    
+    NSMutableArray<NSString *> *completedQueries = [NSMutableArray array];
+    
+    [_scheduler setMaximumConcurrentRequests:1 forPriority:LFMRequestPriorityInteractive];
+    [_scheduler setCancelsSupersededRequests:YES forMethod:@"track.search"];
+    [LFMStubURLProtocol setResponseDelay:0.2];
+    
+    for (NSString *query in queries) {
+        [LFMTrackProvider searchForTrackNamed:query byArtistNamed:nil itemsPerPage:30 onPage:1 callback:^(NSError * _Nullable error, NSArray<LFMTrack *> *tracks, LFMSearchQuery * _Nullable searchQuery) {
+            if (error == nil) {
+                @synchronized (completedQueries) {
+                    [completedQueries addObject:query];
+                }
+            } else {
+                XCTAssertEqual(error.code, NSURLErrorCancelled);
+            }
+            [expectation fulfill];
+        }];
+    }
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqualObjects(completedQueries, @[@"Into You"]);
+    XCTAssertLessThanOrEqual([LFMStubURLProtocol requestCount], 2, @"Queued searches should be cancelled without being sent.");
+}
+
+- (void)testCancellingAClass {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Requests"];
+    expectation.expectedFulfillmentCount = 3;
+    
+    [_scheduler setMaximumConcurrentRequests:1 forPriority:LFMRequestPriorityBackground];
+    [LFMStubURLProtocol setResponseDelay:0.2];
+    
+    [LFMRequestScheduler performRequestsWithPriority:LFMRequestPriorityBackground usingBlock:^{
+        for (NSUInteger page = 1; page <= 3; page++) {
+            [LFMChartProvider getTopArtistsOnPage:page itemsPerPage:5 callback:^(NSError * _Nullable error, NSArray<LFMArtist *> *artists, LFMQuery * _Nullable query) {
+                XCTAssertEqual(error.code, NSURLErrorCancelled);
+                [expectation fulfill];
+            }];
+        }
+    }];
+    
+    [_scheduler cancelRequestsWithPriority:LFMRequestPriorityBackground];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+@end
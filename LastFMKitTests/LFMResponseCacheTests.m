@@ -0,0 +1,204 @@
+//
+//  LFMResponseCacheTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
+
+@interface LFMResponseCacheTests : XCTestCase
+
+@end
+
+@implementation LFMResponseCacheTests {
+    LFMClient *_previousClient;
+    LFMClient *_client;
+    LFMResponseCache *_cache;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+    
+    [LFMStubURLProtocol reset];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureArtistInfo();
+    }];
+    
+    _cache = [[LFMResponseCache alloc] initWithMemoryCapacity:2 diskPath:nil];
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    _client.responseCache = _cache;
+    [LFMClient setSharedClient:_client];
+}
+
+- (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+    
+    [super tearDown];
+}
+
+- (void)getInfoOnArtistNamed:(NSString *)name {
+    XCTestExpectation *expectation = [self expectationWithDescription:name];
+    
+    [LFMArtistProvider getInfoOnArtistNamed:name withMusicBrainzId:nil autoCorrect:YES forUser:nil languageCode:nil callback:^(NSError * _Nullable error, LFMArtist * _Nullable artist) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(artist.name, @"Ariana Grande");
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void)testRepeatedRequestIsServedFromMemory {
+    [self getInfoOnArtistNamed:@"Ariana Grande"];
+    [self getInfoOnArtistNamed:@"Ariana Grande"];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 1);
+    XCTAssertEqual(_cache.hitCount, 1);
+    XCTAssertEqual(_cache.missCount, 1);
+}
+
+- (void)testLeastRecentlyUsedResponseIsEvicted {
+    [self getInfoOnArtistNamed:@"A"];
+    [self getInfoOnArtistNamed:@"B"];
+    [self getInfoOnArtistNamed:@"A"];
+    [self getInfoOnArtistNamed:@"C"];
+    [self getInfoOnArtistNamed:@"A"];
+    [self getInfoOnArtistNamed:@"B"];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 4);
+    XCTAssertEqual(_cache.hitCount, 2);
+}
+
+- (void)testMethodWithoutTimeToLiveIsNotCached {
+    [_cache setTimeToLive:0 forMethod:@"artist.getInfo"];
+    
+    [self getInfoOnArtistNamed:@"Ariana Grande"];
+    [self getInfoOnArtistNamed:@"Ariana Grande"];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 2);
+    XCTAssertEqual(_cache.hitCount + _cache.missCount, 0);
+}
+
+- (void)testTimeToLiveTable {
+    XCTAssertEqual([_cache timeToLiveForMethod:@"chart.getTopArtists"], 3 * 60 * 60);
+    XCTAssertEqual([_cache timeToLiveForMethod:@"user.getRecentTracks"], 10);
+    XCTAssertEqual([_cache timeToLiveForMethod:@"album.getTags"], 60);
+    
+    [_cache setTimeToLive:30 forMethod:@"chart.*"];
+    
+    XCTAssertEqual([_cache timeToLiveForMethod:@"chart.getTopTracks"], 30);
+}
+
+- (void)testResponsesArePersistedToDisk {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    _client.responseCache = [[LFMResponseCache alloc] initWithMemoryCapacity:0 diskPath:path];
+    
+    [self getInfoOnArtistNamed:@"Ariana Grande"];
+    
+    // A fresh cache over the same directory simulates a relaunch.
+    LFMResponseCache *relaunchedCache = [[LFMResponseCache alloc] initWithMemoryCapacity:0 diskPath:path];
+    _client.responseCache = relaunchedCache;
+    
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:5.0];
+    while ([[NSFileManager defaultManager] contentsOfDirectoryAtPath:path error:nil].count == 0 && [deadline timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    
+    [self getInfoOnArtistNamed:@"Ariana Grande"];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 1);
+    XCTAssertEqual(relaunchedCache.hitCount, 1);
+    
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+- (void)writeResponseFileNamed:(NSString *)name toPath:(NSString *)path expiringIn:(NSTimeInterval)timeToLive writtenAt:(NSDate *)date {
+    CFAbsoluteTime expiryTime = CFAbsoluteTimeGetCurrent() + timeToLive;
+    NSMutableData *file = [NSMutableData dataWithBytes:&expiryTime length:sizeof(expiryTime)];
+    [file appendData:LFMFixtureArtistInfo()];
+    
+    NSString *filePath = [path stringByAppendingPathComponent:name];
+    [file writeToFile:filePath atomically:YES];
+    [[NSFileManager defaultManager] setAttributes:@{NSFileModificationDate: date} ofItemAtPath:filePath error:nil];
+}
+
+- (NSArray<NSString *> *)filesAtPath:(NSString *)path onceThereAreAtMost:(NSUInteger)count {
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:5.0];
+    NSArray<NSString *> *files;
+    
+    while ((files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:path error:nil]).count > count && [deadline timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    
+    return [files sortedArrayUsingSelector:@selector(compare:)];
+}
+
+- (void)testExpiredResponsesAreSweptOnLaunch {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [[NSFileManager defaultManager] createDirectoryAtPath:path withIntermediateDirectories:YES attributes:nil error:nil];
+    
+    [self writeResponseFileNamed:@"expired" toPath:path expiringIn:-60 writtenAt:[NSDate date]];
+    [self writeResponseFileNamed:@"valid" toPath:path expiringIn:60 writtenAt:[NSDate date]];
+    
+    LFMResponseCache *cache = [[LFMResponseCache alloc] initWithMemoryCapacity:0 diskPath:path];
+    
+    XCTAssertEqualObjects([self filesAtPath:path onceThereAreAtMost:1], @[@"valid"]);
+    XCTAssertEqual(cache.diskCapacity, 20 * 1024 * 1024);
+    
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+- (void)testDiskStoreIsTrimmedToCapacity {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [[NSFileManager defaultManager] createDirectoryAtPath:path withIntermediateDirectories:YES attributes:nil error:nil];
+    
+    NSUInteger fileSize = sizeof(CFAbsoluteTime) + LFMFixtureArtistInfo().length;
+    
+    for (NSUInteger i = 0; i < 5; i++) {
+        [self writeResponseFileNamed:[NSString stringWithFormat:@"response%tu", i] toPath:path expiringIn:60 writtenAt:[NSDate dateWithTimeIntervalSinceNow:(double)i - 10]];
+    }
+    
+    // Room for two and a half responses; the three written longest ago go.
+    LFMResponseCache *cache = [[LFMResponseCache alloc] initWithMemoryCapacity:0 diskCapacity:fileSize * 5 / 2 diskPath:path];
+    
+    XCTAssertEqualObjects([self filesAtPath:path onceThereAreAtMost:2], (@[@"response3", @"response4"]));
+    
+    // A write over capacity trims the store down to three quarters of it, which holds a single response.
+    _client.responseCache = cache;
+    [self getInfoOnArtistNamed:@"Ariana Grande"];
+    
+    XCTAssertEqual([self filesAtPath:path onceThereAreAtMost:1].count, 1);
+    
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+@end
@@ -0,0 +1,97 @@
+//
+//  LFMResponseDecodingTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import <LastFMKit/LFMError.h>
+#import "LFMFixtures.h"
+
+@interface LFMResponseDecodingTests : XCTestCase
+
+@end
+
+@implementation LFMResponseDecodingTests {
+    NSArray<NSData *> *_fixtures;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    _fixtures = @[LFMFixtureArtistInfo(), LFMFixtureRecentTracksPage(200, 1, 200), LFMFixtureTopArtistsPage(200)];
+}
+
+- (void)testValidationReturnsDecodedResponse {
+    NSError *error = nil;
+    NSDictionary *responseDictionary = nil;
+    
+    XCTAssertTrue(lfm_error_validate(LFMFixtureArtistInfo(), &responseDictionary, &error));
+    XCTAssertNil(error);
+    XCTAssertEqualObjects([[responseDictionary objectForKey:@"artist"] objectForKey:@"name"], @"Ariana Grande");
+}
+
+- (void)testValidationReportsServerError {
+    NSError *error = nil;
+    NSDictionary *responseDictionary = nil;
+    
+    XCTAssertFalse(lfm_error_validate(LFMFixtureError(29), &responseDictionary, &error));
+    XCTAssertEqual(error.code, 29);
+    XCTAssertNil(responseDictionary);
+}
+
+/**
+ Baseline: validating the body and then decoding it a second time to build models, which is what every completion handler used to do.
+ */
+- (void)testDoubleDecodePerformance {
+    NSArray<NSData *> *fixtures = _fixtures;
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 20; i++) {
+            for (NSData *data in fixtures) {
+                NSError *error = nil;
+                lfm_error_validate(data, NULL, &error);
+                NSDictionary *responseDictionary = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&error];
+                XCTAssertNotNil(responseDictionary);
+            }
+        }
+    }];
+}
+
+- (void)testSinglePassDecodePerformance {
+    NSArray<NSData *> *fixtures = _fixtures;
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 20; i++) {
+            for (NSData *data in fixtures) {
+                NSError *error = nil;
+                NSDictionary *responseDictionary = nil;
+                lfm_error_validate(data, &responseDictionary, &error);
+                XCTAssertNotNil(responseDictionary);
+            }
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,184 @@
+//
+//  LFMScrobbleBatchingTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
+
+static const NSTimeInterval LFMOldestAcceptedTimestamp = 1500000000;
+
+@interface LFMScrobbleBatchingTests : XCTestCase
+
+@end
+
+@implementation LFMScrobbleBatchingTests {
+    LFMClient *_previousClient;
+    LFMClient *_client;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+    
+    [LFMStubURLProtocol reset];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureScrobblesForRequestBody([LFMStubURLProtocol bodyOfRequest:request], LFMOldestAcceptedTimestamp);
+    }];
+    
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    [LFMClient setSharedClient:_client];
+}
+
+- (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+    
+    [super tearDown];
+}
+
+- (NSArray<LFMScrobbleTrack *> *)tracksWithCount:(NSUInteger)count startingAt:(NSTimeInterval)timestamp {
+    NSMutableArray<LFMScrobbleTrack *> *tracks = [NSMutableArray arrayWithCapacity:count];
+    NSURL *URL = [NSURL URLWithString:@"https://www.last.fm/music/Ariana+Grande/_/Be+Alright"];
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        LFMTrack *track = [[LFMTrack alloc] initWithName:[NSString stringWithFormat:@"Track %tu", i] artist:nil musicBrainzID:@"" album:nil positionInAlbum:0 URL:URL duration:180 streamable:NO tags:@[] wiki:nil listeners:0 playCount:0];
+        NSDate *date = [NSDate dateWithTimeIntervalSince1970:timestamp + i * 180];
+        [tracks addObject:[[LFMScrobbleTrack alloc] initFromTrack:track withTimestamp:date chosenByUser:YES]];
+    }
+    
+    return tracks;
+}
+
+- (void)testTracksAreSplitIntoBatchesOfFifty {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Scrobbles"];
+    NSArray<LFMScrobbleTrack *> *tracks = [self tracksWithCount:120 startingAt:1508865600];
+    
+    NSProgress *progress = [LFMTrackProvider scrobbleTracks:tracks maximumConcurrentBatches:2 callback:^(NSError * _Nullable error, NSArray<LFMScrobbleResult *> * _Nonnull results) {
+        XCTAssertNil(error);
+        XCTAssertEqual(results.count, tracks.count);
+        
+        [results enumerateObjectsUsingBlock:^(LFMScrobbleResult *result, NSUInteger idx, BOOL *stop) {
+            XCTAssertEqual(result.track, tracks[idx]);
+            XCTAssertTrue(result.wasAccepted);
+        }];
+        
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 3);
+    XCTAssertEqual(progress.completedUnitCount, 120);
+}
+
+- (void)testIgnoredScrobblesAreReported {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Scrobbles"];
+    NSArray<LFMScrobbleTrack *> *tracks = [self tracksWithCount:10 startingAt:LFMOldestAcceptedTimestamp - 5 * 180];
+    
+    [LFMTrackProvider scrobbleTracks:tracks maximumConcurrentBatches:1 callback:^(NSError * _Nullable error, NSArray<LFMScrobbleResult *> * _Nonnull results) {
+        XCTAssertNil(error);
+        XCTAssertEqual(results.count, 10);
+        
+        for (NSUInteger i = 0; i < results.count; i++) {
+            XCTAssertEqual(results[i].wasAccepted, i >= 5);
+            XCTAssertEqual(results[i].ignoredReason, i < 5 ? LFMScrobbleIgnoredReasonTimestampTooOld : LFMScrobbleIgnoredReasonNone);
+        }
+        
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void)testBatchesArePipelined {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Scrobbles"];
+    NSArray<LFMScrobbleTrack *> *tracks = [self tracksWithCount:400 startingAt:1508865600];
+    
+    [LFMStubURLProtocol setResponseDelay:0.25];
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    
+    [LFMTrackProvider scrobbleTracks:tracks maximumConcurrentBatches:4 callback:^(NSError * _Nullable error, NSArray<LFMScrobbleResult *> * _Nonnull results) {
+        XCTAssertNil(error);
+        XCTAssertEqual(results.count, tracks.count);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+    
+    // 8 batches, 4 at a time: two round trips rather than eight.
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 8);
+    XCTAssertGreaterThanOrEqual(elapsed, 0.5);
+    XCTAssertLessThan(elapsed, 8 * 0.25);
+}
+
+- (void)testFailedBatchStopsSubmission {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Scrobbles"];
+    NSArray<LFMScrobbleTrack *> *tracks = [self tracksWithCount:200 startingAt:1508865600];
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureError(9);
+    }];
+    
+    [LFMTrackProvider scrobbleTracks:tracks maximumConcurrentBatches:1 callback:^(NSError * _Nullable error, NSArray<LFMScrobbleResult *> * _Nonnull results) {
+        XCTAssertEqual(error.code, 9);
+        XCTAssertEqual(results.count, 0);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 1);
+}
+
+- (void)testTimestampsAreSentAsUnixTime {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Scrobble"];
+    __block NSString *body = nil;
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        NSData *data = [LFMStubURLProtocol bodyOfRequest:request];
+        body = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+        return LFMFixtureScrobblesForRequestBody(data, LFMOldestAcceptedTimestamp);
+    }];
+    
+    [LFMTrackProvider scrobbleTracks:[self tracksWithCount:1 startingAt:1508865600] callback:^(NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertTrue([body containsString:@"=1508865600&"]);
+}
+
+@end
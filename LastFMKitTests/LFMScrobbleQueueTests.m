@@ -0,0 +1,329 @@
+//
+//  LFMScrobbleQueueTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+#import <sys/resource.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
+
+@interface LFMScrobbleQueueTests : XCTestCase
+
+@end
+
+@interface LFMAuth (Testing)
+
+- (void)setSession:(nullable LFMSession *)session;
+
+@end
+
+@implementation LFMScrobbleQueueTests {
+    LFMClient *_previousClient;
+    LFMClient *_client;
+    NSString *_journalPath;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+    
+    [LFMStubURLProtocol reset];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureScrobblesForRequestBody([LFMStubURLProtocol bodyOfRequest:request], 0);
+    }];
+    
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    [LFMClient setSharedClient:_client];
+    
+    _journalPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+}
+
+- (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+    [[NSFileManager defaultManager] removeItemAtPath:_journalPath error:nil];
+    
+    [super tearDown];
+}
+
+- (NSArray<LFMScrobbleTrack *> *)tracksWithCount:(NSUInteger)count {
+    NSMutableArray<LFMScrobbleTrack *> *tracks = [NSMutableArray arrayWithCapacity:count];
+    NSURL *URL = [NSURL URLWithString:@"https://www.last.fm/music/Ariana+Grande/_/Be+Alright"];
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        LFMTrack *track = [[LFMTrack alloc] initWithName:[NSString stringWithFormat:@"Track %tu", i] artist:nil musicBrainzID:@"" album:nil positionInAlbum:i URL:URL duration:180 streamable:NO tags:@[] wiki:nil listeners:0 playCount:0];
+        NSDate *date = [NSDate dateWithTimeIntervalSince1970:1508865600 + i * 180];
+        [tracks addObject:[[LFMScrobbleTrack alloc] initFromTrack:track withTimestamp:date chosenByUser:YES]];
+    }
+    
+    return tracks;
+}
+
+- (LFMScrobbleQueue *)openQueue {
+    NSError *error = nil;
+    LFMScrobbleQueue *queue = [[LFMScrobbleQueue alloc] initWithJournalPath:_journalPath error:&error];
+    XCTAssertNotNil(queue, @"%@", error);
+    return queue;
+}
+
+- (void)drainQueue:(LFMScrobbleQueue *)queue expectingError:(BOOL)expectingError {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Drain"];
+    
+    [queue drainWithCallback:^(NSError * _Nullable error, NSArray<LFMScrobbleResult *> * _Nonnull results) {
+        if (expectingError) {
+            XCTAssertNotNil(error);
+        } else {
+            XCTAssertNil(error);
+        }
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+}
+
+- (void)testEnqueuedScrobblesSurviveReopening {
+    @autoreleasepool {
+        LFMScrobbleQueue *queue = [self openQueue];
+        [queue enqueueTracks:[self tracksWithCount:75]];
+        XCTAssertTrue([queue synchronizeWithError:nil]);
+        XCTAssertEqual(queue.count, 75);
+    }
+    
+    XCTAssertEqual([self openQueue].count, 75);
+}
+
+- (void)testDrainSendsBatchesOfFiftyInOrder {
+    LFMScrobbleQueue *queue = [self openQueue];
+    NSArray<LFMScrobbleTrack *> *tracks = [self tracksWithCount:120];
+    [queue enqueueTracks:tracks];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Drain"];
+    
+    [queue drainWithCallback:^(NSError * _Nullable error, NSArray<LFMScrobbleResult *> * _Nonnull results) {
+        XCTAssertNil(error);
+        XCTAssertEqual(results.count, 120);
+        
+        [results enumerateObjectsUsingBlock:^(LFMScrobbleResult *result, NSUInteger idx, BOOL *stop) {
+            XCTAssertEqualObjects(result.track.name, tracks[idx].name);
+            XCTAssertEqualObjects(result.track.timestamp, tracks[idx].timestamp);
+            XCTAssertEqual(result.track.positionInAlbum, idx);
+        }];
+        
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 3);
+    XCTAssertEqual(queue.count, 0);
+}
+
+- (void)testFailedBatchStaysQueued {
+    __block NSUInteger requests = 0;
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        if (++requests == 2) return LFMFixtureError(9);
+        return LFMFixtureScrobblesForRequestBody([LFMStubURLProtocol bodyOfRequest:request], 0);
+    }];
+    
+    @autoreleasepool {
+        LFMScrobbleQueue *queue = [self openQueue];
+        [queue enqueueTracks:[self tracksWithCount:120]];
+        [self drainQueue:queue expectingError:YES];
+        XCTAssertEqual(queue.count, 70);
+    }
+    
+    // Only the acknowledged batch is dropped when the journal is replayed, so nothing is sent twice.
+    LFMScrobbleQueue *queue = [self openQueue];
+    XCTAssertEqual(queue.count, 70);
+    
+    [self drainQueue:queue expectingError:NO];
+    
+    XCTAssertEqual(queue.count, 0);
+    XCTAssertEqual(requests, 4);
+}
+
+- (void)testTornRecordIsDiscarded {
+    @autoreleasepool {
+        LFMScrobbleQueue *queue = [self openQueue];
+        [queue enqueueTracks:[self tracksWithCount:10]];
+        XCTAssertTrue([queue synchronizeWithError:nil]);
+    }
+    
+    // Simulate a crash part way through writing an eleventh record.
+    NSFileHandle *handle = [NSFileHandle fileHandleForWritingAtPath:_journalPath];
+    [handle seekToEndOfFile];
+    [handle writeData:[NSData dataWithBytes:"\x40\x00\x00\x00\x12\x34" length:6]];
+    [handle closeFile];
+    
+    LFMScrobbleQueue *queue = [self openQueue];
+    XCTAssertEqual(queue.count, 10);
+    
+    [queue enqueueTracks:[self tracksWithCount:1]];
+    [self drainQueue:queue expectingError:NO];
+    
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 1);
+}
+
+- (void)testScrobblesThatCannotBeWrittenStayQueued {
+    struct rlimit limit;
+    getrlimit(RLIMIT_FSIZE, &limit);
+    void (*previousHandler)(int) = signal(SIGXFSZ, SIG_IGN);
+    
+    @autoreleasepool {
+        LFMScrobbleQueue *queue = [self openQueue];
+        [queue enqueueTracks:[self tracksWithCount:10]];
+        XCTAssertTrue([queue synchronizeWithError:nil]);
+        
+        // Writes past the limit fail with EFBIG, the way they would on a full disk.
+        unsigned long long size = [[[NSFileManager defaultManager] attributesOfItemAtPath:_journalPath error:nil] fileSize];
+        struct rlimit full = {size + 100, limit.rlim_max};
+        setrlimit(RLIMIT_FSIZE, &full);
+        
+        [queue enqueueTracks:[self tracksWithCount:10]];
+        
+        NSError *error = nil;
+        XCTAssertFalse([queue synchronizeWithError:&error]);
+        XCTAssertEqualObjects(error.domain, NSPOSIXErrorDomain);
+        XCTAssertEqual(queue.count, 20);
+        XCTAssertEqual([[[NSFileManager defaultManager] attributesOfItemAtPath:_journalPath error:nil] fileSize], size);
+        
+        setrlimit(RLIMIT_FSIZE, &limit);
+        XCTAssertTrue([queue synchronizeWithError:nil]);
+    }
+    
+    signal(SIGXFSZ, previousHandler);
+    
+    XCTAssertEqual([self openQueue].count, 20);
+}
+
+- (void)testBatchSentBeforeACrashIsReconciled {
+    NSArray<LFMScrobbleTrack *> *tracks = [self tracksWithCount:60];
+    NSMutableArray<NSNumber *> *recordedTimestamps = [NSMutableArray array];
+    __block NSUInteger scrobbleRequests = 0;
+    __block NSUInteger recentTracksRequests = 0;
+    
+    // Last.fm recorded every scrobble of the first batch.
+    for (NSUInteger i = 0; i < 50; i++) {
+        [recordedTimestamps insertObject:@((NSUInteger)tracks[i].timestamp.timeIntervalSince1970) atIndex:0];
+    }
+    
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        if ([request.URL.query containsString:@"user.getRecentTracks"]) {
+            recentTracksRequests++;
+            return LFMFixtureRecentTracksAtTimestamps(recordedTimestamps);
+        }
+        
+        // The first batch is recorded, but its response is lost.
+        if (++scrobbleRequests == 1) return [NSData data];
+        
+        NSData *body = [LFMStubURLProtocol bodyOfRequest:request];
+        XCTAssertFalse([[[NSString alloc] initWithData:body encoding:NSUTF8StringEncoding] containsString:@"track%5B10%5D"]);
+        return LFMFixtureScrobblesForRequestBody(body, 0);
+    }];
+    
+    LFMSession *previousSession = [LFMAuth sharedInstance].session;
+    [[LFMAuth sharedInstance] setSession:[[LFMSession alloc] initWithSessionKey:@"d580d57f32848f5dcf574d1ce18d78b2" userName:@"mourke" userIsSubscriber:NO]];
+    
+    @autoreleasepool {
+        LFMScrobbleQueue *queue = [self openQueue];
+        [queue enqueueTracks:tracks];
+        [self drainQueue:queue expectingError:YES];
+        XCTAssertEqual(queue.count, 60);
+    }
+    
+    LFMScrobbleQueue *queue = [self openQueue];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Drain"];
+    
+    [queue drainWithCallback:^(NSError * _Nullable error, NSArray<LFMScrobbleResult *> * _Nonnull results) {
+        XCTAssertNil(error);
+        XCTAssertEqual(results.count, 10);
+        XCTAssertEqualObjects(results.firstObject.track.timestamp, tracks[50].timestamp);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    
+    [[LFMAuth sharedInstance] setSession:previousSession];
+    
+    // The first batch was looked up instead of being sent again; only the scrobbles queued after it were sent.
+    XCTAssertEqual(recentTracksRequests, 1);
+    XCTAssertEqual(scrobbleRequests, 2);
+    XCTAssertEqual(queue.count, 0);
+    XCTAssertEqual([self openQueue].count, 0);
+}
+
+- (void)testAcknowledgedRecordsAreCompacted {
+    LFMScrobbleQueue *queue = [self openQueue];
+    [queue enqueueTracks:[self tracksWithCount:5000]];
+    XCTAssertTrue([queue synchronizeWithError:nil]);
+    
+    unsigned long long uncompactedSize = [[[NSFileManager defaultManager] attributesOfItemAtPath:_journalPath error:nil] fileSize];
+    
+    [self drainQueue:queue expectingError:NO];
+    
+    unsigned long long compactedSize = [[[NSFileManager defaultManager] attributesOfItemAtPath:_journalPath error:nil] fileSize];
+    
+    XCTAssertLessThan(compactedSize, uncompactedSize / 10);
+    XCTAssertEqual([self openQueue].count, 0);
+}
+
+- (void)testEnqueuePerformance {
+    NSArray<LFMScrobbleTrack *> *tracks = [self tracksWithCount:20000];
+    
+    [self measureBlock:^{
+        [[NSFileManager defaultManager] removeItemAtPath:self->_journalPath error:nil];
+        
+        LFMScrobbleQueue *queue = [self openQueue];
+        for (LFMScrobbleTrack *track in tracks) {
+            [queue enqueueTrack:track];
+        }
+        XCTAssertTrue([queue synchronizeWithError:nil]);
+    }];
+}
+
+- (void)testReplayPerformance {
+    @autoreleasepool {
+        LFMScrobbleQueue *queue = [self openQueue];
+        NSArray<LFMScrobbleTrack *> *tracks = [self tracksWithCount:10000];
+        
+        for (NSUInteger i = 0; i < 100; i++) {
+            [queue enqueueTracks:tracks];
+        }
+        XCTAssertTrue([queue synchronizeWithError:nil]);
+    }
+    
+    // 1,000,000 entries.
+    [self measureBlock:^{
+        XCTAssertEqual([self openQueue].count, 1000000);
+    }];
+}
+
+@end
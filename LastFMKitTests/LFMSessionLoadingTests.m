@@ -0,0 +1,118 @@
+//
+//  LFMSessionLoadingTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+
+@interface LFMSession (Testing)
+
+- (nullable instancetype)initFromDictionary:(NSDictionary *)dictionary;
++ (nullable LFMSession *)loadFromKeychain;
+
+@end
+
+@interface LFMAuth (Testing)
+
+- (void)setSession:(nullable LFMSession *)session;
+
+@end
+
+/** A new `LFMAuth`, as the `sharedInstance` is when the app launches. */
+static LFMAuth *LFMNewAuth(void) {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Warc-performSelector-leaks"
+    LFMAuth *auth = [[LFMAuth alloc] performSelector:NSSelectorFromString(@"init")];
+#pragma clang diagnostic pop
+    auth.apiKey = @"bc15dd6972bc0f7c952273b34d253a6a";
+    auth.apiSecret = @"d46ca773c61a3907c0b19c777c5bcf20";
+    return auth;
+}
+
+@interface LFMSessionLoadingTests : XCTestCase
+
+@end
+
+@implementation LFMSessionLoadingTests {
+    NSArray<NSURLQueryItem *> *_queryItems;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    _queryItems = @[[NSURLQueryItem queryItemWithName:@"method" value:@"artist.getInfo"],
+                    [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
+                    [NSURLQueryItem queryItemWithName:@"artist" value:@"Ariana Grande"],
+                    [NSURLQueryItem queryItemWithName:@"api_key" value:@"bc15dd6972bc0f7c952273b34d253a6a"]];
+}
+
+- (void)testSessionSetBeforeTheKeychainAnswersIsKept {
+    LFMAuth *auth = LFMNewAuth();
+    LFMSession *session = [[LFMSession alloc] initFromDictionary:@{@"name": @"mourke", @"key": @"d580d57f32848f5dcf574d1ce18d78b2", @"subscriber": @"0"}];
+    
+    [auth setSession:session];
+    
+    XCTAssertEqual(auth.session, session);
+    XCTAssertTrue(auth.userHasAuthenticated);
+    
+    [auth removeSession];
+}
+
+- (void)testSessionIsOnlyReadFromTheKeychainOnce {
+    LFMAuth *auth = LFMNewAuth();
+    
+    XCTAssertEqual(auth.session, auth.session);
+}
+
+- (void)testTimeToFirstRequest {
+    __block CFAbsoluteTime synchronousTime = 0;
+    __block CFAbsoluteTime lazyTime = 0;
+    
+    for (NSUInteger i = 0; i < 100; i++) {
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        LFMAuth *auth = LFMNewAuth();
+        [LFMSession loadFromKeychain]; // What launching used to wait for before the first request could be signed.
+        [auth appendingSignatureItemToQueryItems:_queryItems];
+        synchronousTime += CFAbsoluteTimeGetCurrent() - start;
+        
+        start = CFAbsoluteTimeGetCurrent();
+        auth = LFMNewAuth();
+        [auth appendingSignatureItemToQueryItems:_queryItems];
+        lazyTime += CFAbsoluteTimeGetCurrent() - start;
+        
+        // Let the background read finish so it doesn't slow the next iteration down.
+        (void)auth.session;
+    }
+    
+    NSLog(@"Time to first request reading the keychain up front: %.3f ms", synchronousTime * 10);
+    NSLog(@"Time to first request reading the keychain in the background: %.3f ms", lazyTime * 10);
+    
+    [self measureBlock:^{
+        LFMAuth *auth = LFMNewAuth();
+        [auth appendingSignatureItemToQueryItems:self->_queryItems];
+    }];
+}
+
+@end
@@ -0,0 +1,194 @@
+//
+//  LFMSessionRegistryTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
+
+@interface LFMSessionRegistryTests : XCTestCase
+
+@end
+
+@implementation LFMSessionRegistryTests {
+    LFMClient *_previousClient;
+    LFMClient *_client;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+    
+    [LFMStubURLProtocol reset];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureScrobblesForRequestBody([LFMStubURLProtocol bodyOfRequest:request], 0);
+    }];
+    
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    [LFMClient setSharedClient:_client];
+}
+
+- (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+    
+    [super tearDown];
+}
+
+- (LFMSession *)sessionForUser:(NSUInteger)user {
+    return [[LFMSession alloc] initWithSessionKey:[NSString stringWithFormat:@"%032tx", user] userName:[NSString stringWithFormat:@"user%tu", user] userIsSubscriber:NO];
+}
+
+- (void)testSessionsAreKeyedByUserName {
+    LFMSessionRegistry *registry = [[LFMSessionRegistry alloc] init];
+    LFMSession *session = [self sessionForUser:1];
+    LFMSession *replacement = [self sessionForUser:1];
+    
+    [registry setSession:session];
+    XCTAssertEqual([registry sessionForUserName:@"user1"], session);
+    XCTAssertNil([registry sessionForUserName:@"user2"]);
+    
+    [registry setSession:replacement];
+    XCTAssertEqual([registry sessionForUserName:@"user1"], replacement);
+    XCTAssertEqual(registry.count, 1);
+    
+    [registry removeSessionForUserName:@"user1"];
+    XCTAssertNil([registry sessionForUserName:@"user1"]);
+    XCTAssertEqual(registry.count, 0);
+}
+
+- (void)testConcurrentRegistrationAndLookup {
+    LFMSessionRegistry *registry = [[LFMSessionRegistry alloc] init];
+    
+    dispatch_apply(10000, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t user) {
+        [registry setSession:[self sessionForUser:user]];
+        XCTAssertEqualObjects([registry sessionForUserName:[NSString stringWithFormat:@"user%zu", user]].sessionKey, ([NSString stringWithFormat:@"%032zx", user]));
+    });
+    
+    XCTAssertEqual(registry.count, 10000);
+}
+
+- (void)testScrobblesAreSignedWithTheSessionPassedIn {
+    LFMSessionRegistry *registry = [[LFMSessionRegistry alloc] init];
+    [registry setSession:[self sessionForUser:1]];
+    [registry setSession:[self sessionForUser:2]];
+    
+    NSURL *URL = [NSURL URLWithString:@"https://www.last.fm/music/Ariana+Grande/_/Be+Alright"];
+    LFMTrack *track = [[LFMTrack alloc] initWithName:@"Be Alright" artist:nil musicBrainzID:@"" album:nil positionInAlbum:0 URL:URL duration:180 streamable:NO tags:@[] wiki:nil listeners:0 playCount:0];
+    LFMScrobbleTrack *scrobbleTrack = [[LFMScrobbleTrack alloc] initFromTrack:track withTimestamp:[NSDate date] chosenByUser:YES];
+    
+    NSMutableSet<NSString *> *sessionKeys = [NSMutableSet set];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        NSData *body = [LFMStubURLProtocol bodyOfRequest:request];
+        NSURLComponents *components = [[NSURLComponents alloc] init];
+        components.percentEncodedQuery = [[NSString alloc] initWithData:body encoding:NSUTF8StringEncoding];
+        
+        for (NSURLQueryItem *item in components.queryItems) {
+            if (![item.name isEqualToString:@"sk"]) continue;
+            @synchronized (sessionKeys) {
+                [sessionKeys addObject:item.value];
+            }
+        }
+        
+        return LFMFixtureScrobblesForRequestBody(body, 0);
+    }];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Scrobbles"];
+    expectation.expectedFulfillmentCount = 2;
+    
+    for (NSString *userName in @[@"user1", @"user2"]) {
+        [LFMTrackProvider scrobbleTracks:@[scrobbleTrack] maximumConcurrentBatches:1 forSession:[registry sessionForUserName:userName] callback:^(NSError *error, NSArray<LFMScrobbleResult *> *results) {
+            XCTAssertNil(error);
+            XCTAssertEqual(results.count, 1);
+            [expectation fulfill];
+        }];
+    }
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqualObjects(sessionKeys, ([NSSet setWithObjects:[self sessionForUser:1].sessionKey, [self sessionForUser:2].sessionKey, nil]));
+}
+
+- (void)testTagsAreSignedWithTheSessionPassedIn {
+    LFMSession *session = [self sessionForUser:3];
+    LFMTag *tag = [[LFMTag alloc] initWithName:@"pop"];
+    
+    NSMutableArray<NSString *> *sessionKeys = [NSMutableArray array];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        NSURLComponents *components = [[NSURLComponents alloc] init];
+        components.percentEncodedQuery = [[NSString alloc] initWithData:[LFMStubURLProtocol bodyOfRequest:request] encoding:NSUTF8StringEncoding];
+        
+        for (NSURLQueryItem *item in components.queryItems) {
+            if (![item.name isEqualToString:@"sk"]) continue;
+            @synchronized (sessionKeys) {
+                [sessionKeys addObject:item.value];
+            }
+        }
+        
+        return [@"{}" dataUsingEncoding:NSUTF8StringEncoding];
+    }];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Tags"];
+    expectation.expectedFulfillmentCount = 4;
+    void (^callback)(NSError *) = ^(NSError *error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    };
+    
+    [LFMArtistProvider addTags:@[tag] toArtistNamed:@"Ariana Grande" forSession:session callback:callback];
+    [LFMArtistProvider removeTag:tag fromArtistNamed:@"Ariana Grande" forSession:session callback:callback];
+    [LFMAlbumProvider addTags:@[tag] toAlbumNamed:@"Dangerous Woman" byArtistNamed:@"Ariana Grande" forSession:session callback:callback];
+    [LFMAlbumProvider removeTag:tag fromAlbumNamed:@"Dangerous Woman" byArtistNamed:@"Ariana Grande" forSession:session callback:callback];
+    
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    
+    XCTAssertEqualObjects(sessionKeys, (@[session.sessionKey, session.sessionKey, session.sessionKey, session.sessionKey]));
+}
+
+- (void)testLookupPerformance {
+    LFMSessionRegistry *registry = [[LFMSessionRegistry alloc] init];
+    NSMutableArray<NSString *> *userNames = [NSMutableArray arrayWithCapacity:10000];
+    
+    for (NSUInteger user = 0; user < 10000; user++) {
+        LFMSession *session = [self sessionForUser:user];
+        [registry setSession:session];
+        [userNames addObject:session.userName];
+    }
+    
+    [self measureBlock:^{
+        dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+            for (NSUInteger i = 0; i < 100000; i++) {
+                [registry sessionForUserName:userNames[(i * 7 + thread) % userNames.count]];
+            }
+        });
+    }];
+}
+
+@end
@@ -0,0 +1,159 @@
+//
+//  LFMSignatureTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import "LFMAllocationCounter.h"
+
+@interface LFMSignatureTests : XCTestCase
+
+@end
+
+@implementation LFMSignatureTests
+
+- (void)setUp {
+    [super setUp];
+    
+    [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
+    [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+}
+
+- (NSString *)signatureForParameters:(NSArray<NSArray<NSString *> *> *)parameters {
+    NSMutableArray<NSURLQueryItem *> *queryItems = [NSMutableArray array];
+    
+    for (NSArray<NSString *> *parameter in parameters) {
+        [queryItems addObject:[NSURLQueryItem queryItemWithName:parameter[0] value:parameter.count > 1 ? parameter[1] : nil]];
+    }
+    
+    NSURLQueryItem *item = [[LFMAuth sharedInstance] signatureItemForQueryItems:queryItems];
+    XCTAssertEqualObjects(item.name, @"api_sig");
+    
+    return item.value;
+}
+
+- (void)testMobileSessionSignature {
+    NSString *signature = [self signatureForParameters:@[@[@"method", @"auth.getMobileSession"],
+                                                         @[@"format", @"json"],
+                                                         @[@"username", @"mourke"],
+                                                         @[@"password", @"password"],
+                                                         @[@"api_key", @"bc15dd6972bc0f7c952273b34d253a6a"]]];
+    
+    XCTAssertEqualObjects(signature, @"02BBA7C5CE9770BF8CFBF9190CC6CD2A");
+}
+
+- (void)testParametersAreSortedByCodeUnit {
+    // "albumArtist[0]" sorts before "album[0]" because 'A' comes before '['; a case-insensitive comparison puts it after.
+    NSString *signature = [self signatureForParameters:@[@[@"method", @"track.scrobble"],
+                                                         @[@"artist[0]", @"Ariana Grande"],
+                                                         @[@"track[0]", @"Be Alright"],
+                                                         @[@"timestamp[0]", @"1508865600"],
+                                                         @[@"album[0]", @"Dangerous Woman"],
+                                                         @[@"albumArtist[0]", @"Ariana Grande"],
+                                                         @[@"api_key", @"bc15dd6972bc0f7c952273b34d253a6a"],
+                                                         @[@"sk", @"d580d57f32848f5dcf574d1ce18d78b2"]]];
+    
+    XCTAssertEqualObjects(signature, @"3F2183EE24FE9AFE512C86FF87D13D0E");
+}
+
+- (void)testNonASCIIValuesAreSignedAsUTF8 {
+    NSString *signature = [self signatureForParameters:@[@[@"method", @"track.love"],
+                                                         @[@"artist", @"Beyoncé"],
+                                                         @[@"track", [@"Déjà Vu" precomposedStringWithCanonicalMapping]],
+                                                         @[@"api_key", @"bc15dd6972bc0f7c952273b34d253a6a"],
+                                                         @[@"sk", @"d580d57f32848f5dcf574d1ce18d78b2"]]];
+    
+    XCTAssertEqualObjects(signature, @"C2EB1BA1CCF4CB60FAFDB743CD5810D8");
+}
+
+- (void)testMissingAndRepeatedParameters {
+    NSString *expected = [self signatureForParameters:@[@[@"method", @"auth.getMobileSession"],
+                                                        @[@"username", @"mourke"],
+                                                        @[@"password", @"password"],
+                                                        @[@"api_key", @"bc15dd6972bc0f7c952273b34d253a6a"]]];
+    
+    // Parameters without a value aren't signed, and one given twice is signed with the value given last.
+    NSString *signature = [self signatureForParameters:@[@[@"method", @"auth.getMobileSession"],
+                                                         @[@"username", @"someone else"],
+                                                         @[@"lang"],
+                                                         @[@"username", @"mourke"],
+                                                         @[@"password", @"password"],
+                                                         @[@"api_key", @"bc15dd6972bc0f7c952273b34d253a6a"]]];
+    
+    XCTAssertEqualObjects(signature, expected);
+    XCTAssertEqualObjects(signature, @"02BBA7C5CE9770BF8CFBF9190CC6CD2A");
+}
+
+- (NSArray<NSURLQueryItem *> *)scrobbleOfFiftyTracks {
+    NSMutableArray<NSURLQueryItem *> *queryItems = [NSMutableArray arrayWithObjects:[NSURLQueryItem queryItemWithName:@"method" value:@"track.scrobble"],
+                                                    [NSURLQueryItem queryItemWithName:@"format" value:@"json"],
+                                                    [NSURLQueryItem queryItemWithName:@"api_key" value:@"bc15dd6972bc0f7c952273b34d253a6a"],
+                                                    [NSURLQueryItem queryItemWithName:@"sk" value:@"d580d57f32848f5dcf574d1ce18d78b2"], nil];
+    
+    for (NSUInteger i = 0; i < 50; i++) {
+        [queryItems addObject:[NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"artist[%tu]", i] value:@"Ariana Grande"]];
+        [queryItems addObject:[NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"track[%tu]", i] value:[NSString stringWithFormat:@"Track %tu", i]]];
+        [queryItems addObject:[NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"timestamp[%tu]", i] value:[NSString stringWithFormat:@"%tu", 1508865600 + i * 200]]];
+        [queryItems addObject:[NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"album[%tu]", i] value:@"Dangerous Woman"]];
+        [queryItems addObject:[NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"albumArtist[%tu]", i] value:@"Ariana Grande"]];
+        [queryItems addObject:[NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"trackNumber[%tu]", i] value:[NSString stringWithFormat:@"%tu", i + 1]]];
+        [queryItems addObject:[NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"duration[%tu]", i] value:@"200"]];
+        [queryItems addObject:[NSURLQueryItem queryItemWithName:[NSString stringWithFormat:@"chosenByUser[%tu]", i] value:@"1"]];
+    }
+    
+    return queryItems;
+}
+
+- (void)testSigningAllocations {
+    NSArray<NSURLQueryItem *> *queryItems = [self scrobbleOfFiftyTracks];
+    LFMAuth *auth = [LFMAuth sharedInstance];
+    [auth signatureItemForQueryItems:queryItems];
+    
+    LFMAllocationStatistics statistics = LFMCountAllocations(^{
+        @autoreleasepool {
+            [auth signatureItemForQueryItems:queryItems];
+        }
+    });
+    
+    NSLog(@"Signing a scrobble of 50 tracks: %lu allocations, %lu bytes", (unsigned long)statistics.allocations, (unsigned long)statistics.bytes);
+    
+    // The signature string and its query item; nothing per parameter.
+    XCTAssertLessThan(statistics.allocations, 10);
+}
+
+- (void)testSigningPerformance {
+    NSArray<NSURLQueryItem *> *queryItems = [self scrobbleOfFiftyTracks];
+    LFMAuth *auth = [LFMAuth sharedInstance];
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 1000; i++) {
+            @autoreleasepool {
+                XCTAssertEqual([auth signatureItemForQueryItems:queryItems].value.length, 32);
+            }
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,321 @@
+//
+//  LFMSnapshotTests.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <XCTest/XCTest.h>
+
+#import <LastFMKit/LastFMKit.h>
+#import <LastFMKit/LFMModelDecoding.h>
+#import "LFMFixtures.h"
+
+@interface LFMSnapshotTests : XCTestCase
+
+@end
+
+@implementation LFMSnapshotTests {
+    NSDictionary *_artistInfo;
+    NSArray *_artistList;
+    NSArray *_trackList;
+}
+
+- (void)setUp {
+    [super setUp];
+    
+    _artistInfo = [[NSJSONSerialization JSONObjectWithData:LFMFixtureArtistInfo() options:0 error:nil] objectForKey:@"artist"];
+    _artistList = [[[NSJSONSerialization JSONObjectWithData:LFMFixtureTopArtistsPage(1000) options:0 error:nil] objectForKey:@"artists"] objectForKey:@"artist"];
+    _trackList = [[[NSJSONSerialization JSONObjectWithData:LFMFixtureRecentTracksPage(1000, 1, 1000) options:0 error:nil] objectForKey:@"recenttracks"] objectForKey:@"track"];
+}
+
+- (void)assertArtist:(LFMArtist *)artist equalToArtist:(LFMArtist *)expected {
+    XCTAssertEqualObjects(artist.name, expected.name);
+    XCTAssertEqualObjects(artist.mbid, expected.mbid);
+    XCTAssertEqualObjects(artist.URL, expected.URL);
+    XCTAssertEqualObjects(artist.images, expected.images);
+    XCTAssertEqual(artist.isStreamable, expected.isStreamable);
+    XCTAssertEqual(artist.isOnTour, expected.isOnTour);
+    XCTAssertEqual(artist.listeners, expected.listeners);
+    XCTAssertEqual(artist.playCount, expected.playCount);
+    XCTAssertEqual(artist.similarArtists.count, expected.similarArtists.count);
+    XCTAssertEqualObjects([artist.tags valueForKey:@"name"], [expected.tags valueForKey:@"name"]);
+    XCTAssertEqualObjects(artist.wiki.summary, expected.wiki.summary);
+    XCTAssertEqualObjects(artist.wiki.content, expected.wiki.content);
+    XCTAssertEqualObjects(artist.wiki.publishedDate, expected.wiki.publishedDate);
+    
+    for (NSUInteger i = 0; i < MIN(artist.similarArtists.count, expected.similarArtists.count); i++) {
+        [self assertArtist:artist.similarArtists[i] equalToArtist:expected.similarArtists[i]];
+    }
+}
+
+- (void)testArtistRoundTrip {
+    LFMArtist *artist = LFMModelArray([LFMArtist class], _artistInfo).firstObject;
+    
+    NSError *error = nil;
+    LFMSnapshot *snapshot = [[LFMSnapshot alloc] initWithData:[LFMSnapshot dataWithObjects:@[artist]] error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssertEqual(snapshot.count, 1);
+    [self assertArtist:[snapshot objectAtIndex:0] equalToArtist:artist];
+}
+
+- (void)testMixedRoundTrip {
+    LFMTrack *track = LFMModelArray([LFMTrack class], _trackList).firstObject;
+    LFMArtist *artist = LFMModelArray([LFMArtist class], _artistInfo).firstObject;
+    LFMAlbum *album = LFMModelArray([LFMAlbum class], @{@"name" : @"Dangerous Woman",
+                                                        @"artist" : @"Ariana Grande",
+                                                        @"mbid" : @"",
+                                                        @"url" : @"https://www.last.fm/music/Ariana+Grande/Dangerous+Woman",
+                                                        @"streamable" : @"0",
+                                                        @"listeners" : @"412310",
+                                                        @"tracks" : @{@"track" : @[_trackList[0], _trackList[1]]},
+                                                        @"tags" : @{@"tag" : @[@{@"name" : @"pop"}]}}).firstObject;
+    LFMTag *tag = [LFMTag tagWithName:@"Ariana Grande"];
+    
+    NSArray *objects = @[track, artist, album, tag, artist.wiki];
+    NSArray *decoded = [[[LFMSnapshot alloc] initWithData:[LFMSnapshot dataWithObjects:objects] error:nil] decodeAllObjectsWithError:nil];
+    
+    XCTAssertEqual(decoded.count, objects.count);
+    
+    LFMTrack *decodedTrack = decoded[0];
+    XCTAssertTrue([decodedTrack isKindOfClass:[LFMTrack class]]);
+    XCTAssertEqualObjects(decodedTrack.name, track.name);
+    XCTAssertEqualObjects(decodedTrack.mbid, track.mbid);
+    XCTAssertEqualObjects(decodedTrack.URL, track.URL);
+    XCTAssertEqual(decodedTrack.duration, track.duration);
+    XCTAssertEqual(decodedTrack.tags.count, 0);
+    
+    [self assertArtist:decoded[1] equalToArtist:artist];
+    
+    LFMAlbum *decodedAlbum = decoded[2];
+    XCTAssertEqualObjects(decodedAlbum.name, album.name);
+    XCTAssertEqualObjects(decodedAlbum.artist, album.artist);
+    XCTAssertEqual(decodedAlbum.listeners, 412310);
+    XCTAssertEqualObjects([decodedAlbum.tracks valueForKey:@"name"], [album.tracks valueForKey:@"name"]);
+    XCTAssertEqualObjects([decodedAlbum.tags valueForKey:@"name"], @[@"pop"]);
+    
+    XCTAssertEqualObjects([decoded[3] name], @"Ariana Grande");
+    XCTAssertNil([decoded[3] URL]);
+    XCTAssertEqualObjects([decoded[4] summary], artist.wiki.summary);
+}
+
+- (void)testRepeatedStringsAreStoredOnce {
+    NSArray<LFMArtist *> *artists = LFMModelArray([LFMArtist class], _artistList);
+    NSData *one = [LFMSnapshot dataWithObjects:@[artists[0]]];
+    NSData *thousand = [LFMSnapshot dataWithObjects:artists];
+    
+    // Every artist has the same five image URLs, which are only stored the first time.
+    XCTAssertLessThan(thousand.length, one.length * 1000 / 4);
+    
+    LFMSnapshot *snapshot = [[LFMSnapshot alloc] initWithData:thousand error:nil];
+    NSDictionary<LFMImageSize, NSURL *> *first = [[snapshot objectAtIndex:0] images];
+    NSDictionary<LFMImageSize, NSURL *> *last = [[snapshot objectAtIndex:999] images];
+    
+    // Decoded strings are shared by every record that refers to them.
+    XCTAssertEqualObjects(first, last);
+    NSArray<LFMImageSize> *keys = last.allKeys;
+    for (LFMImageSize size in first) {
+        XCTAssertEqual(keys[[keys indexOfObject:size]], size);
+    }
+}
+
+- (void)testMappedFileRoundTrip {
+    NSArray<LFMArtist *> *artists = LFMModelArray([LFMArtist class], _artistList);
+    NSURL *URL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    
+    XCTAssertTrue([[LFMSnapshot dataWithObjects:artists] writeToURL:URL atomically:YES]);
+    
+    NSError *error = nil;
+    LFMSnapshot *snapshot = [[LFMSnapshot alloc] initWithContentsOfURL:URL error:&error];
+    
+    XCTAssertNil(error);
+    XCTAssertEqual(snapshot.count, 1000);
+    [self assertArtist:[snapshot objectAtIndex:512] equalToArtist:artists[512]];
+    
+    [[NSFileManager defaultManager] removeItemAtURL:URL error:nil];
+}
+
+- (void)testCyclesAreBroken {
+    [LFMIdentityMap setSharedMap:[[LFMIdentityMap alloc] init]];
+    
+    NSDictionary *first = @{@"name" : @"Ariana Grande", @"mbid" : @"", @"url" : @"https://www.last.fm/music/Ariana+Grande", @"streamable" : @"0"};
+    NSDictionary *second = @{@"name" : @"Selena Gomez", @"mbid" : @"", @"url" : @"https://www.last.fm/music/Selena+Gomez", @"streamable" : @"0"};
+    
+    NSMutableDictionary *firstInfo = [first mutableCopy];
+    firstInfo[@"similar"] = @{@"artist" : @[second]};
+    NSMutableDictionary *secondInfo = [second mutableCopy];
+    secondInfo[@"similar"] = @{@"artist" : @[first]};
+    
+    LFMArtist *artist = LFMModelArray([LFMArtist class], [firstInfo copy]).firstObject;
+    LFMArtist *similar = LFMModelArray([LFMArtist class], [secondInfo copy]).firstObject;
+    
+    XCTAssertEqual(artist.similarArtists.firstObject, similar);
+    XCTAssertEqual(similar.similarArtists.firstObject, artist);
+    
+    [LFMIdentityMap setSharedMap:nil];
+    
+    LFMArtist *decoded = [[[LFMSnapshot alloc] initWithData:[LFMSnapshot dataWithObjects:@[artist]] error:nil] objectAtIndex:0];
+    
+    XCTAssertEqualObjects(decoded.similarArtists.firstObject.name, @"Selena Gomez");
+    XCTAssertEqual(decoded.similarArtists.firstObject.similarArtists.count, 0);
+}
+
+- (void)testInvalidDataIsRejected {
+    NSError *error = nil;
+    
+    XCTAssertNil([[LFMSnapshot alloc] initWithData:LFMFixtureArtistInfo() error:&error]);
+    XCTAssertEqual(error.code, NSFileReadCorruptFileError);
+    
+    NSMutableData *data = [[LFMSnapshot dataWithObjects:LFMModelArray([LFMArtist class], _artistList)] mutableCopy];
+    
+    uint16_t version = CFSwapInt16HostToLittle(2);
+    NSMutableData *futureVersion = [data mutableCopy];
+    [futureVersion replaceBytesInRange:NSMakeRange(4, sizeof(version)) withBytes:&version];
+    error = nil;
+    XCTAssertNil([[LFMSnapshot alloc] initWithData:futureVersion error:&error]);
+    XCTAssertEqual(error.code, NSFileReadCorruptFileError);
+    
+    error = nil;
+    XCTAssertNil([[LFMSnapshot alloc] initWithData:[data subdataWithRange:NSMakeRange(0, 100)] error:&error]);
+    XCTAssertEqual(error.code, NSFileReadCorruptFileError);
+}
+
+- (void)testTruncatedRecordsAreReportedAsCorrupt {
+    NSData *data = [LFMSnapshot dataWithObjects:LFMModelArray([LFMArtist class], _artistList)];
+    LFMSnapshot *snapshot = [[LFMSnapshot alloc] initWithData:[data subdataWithRange:NSMakeRange(0, data.length - 10)] error:nil];
+    
+    XCTAssertNotNil(snapshot);
+    XCTAssertNotNil([snapshot objectAtIndex:0]);
+    XCTAssertNil([snapshot objectAtIndex:999]);
+    
+    NSError *error = nil;
+    XCTAssertNil([snapshot decodeAllObjectsWithError:&error]);
+    XCTAssertEqual(error.code, NSFileReadCorruptFileError);
+}
+
+- (void)testEveryTruncationIsHandled {
+    LFMArtist *artist = LFMModelArray([LFMArtist class], _artistInfo).firstObject;
+    NSData *data = [LFMSnapshot dataWithObjects:@[artist]];
+    
+    for (NSUInteger length = 0; length < data.length; length++) {
+        LFMSnapshot *snapshot = [[LFMSnapshot alloc] initWithData:[data subdataWithRange:NSMakeRange(0, length)] error:nil];
+        XCTAssertNil([snapshot decodeAllObjectsWithError:nil]);
+    }
+}
+
+#pragma mark - Size and speed compared to NSKeyedArchiver and JSON
+
+- (void)testEncodedSizes {
+    NSArray *dictionaries = [_artistList arrayByAddingObjectsFromArray:_trackList];
+    NSArray *models = [LFMModelArray([LFMArtist class], _artistList) arrayByAddingObjectsFromArray:LFMModelArray([LFMTrack class], _trackList)];
+    
+    NSUInteger snapshotLength = [LFMSnapshot dataWithObjects:models].length;
+    NSUInteger archiveLength = [NSKeyedArchiver archivedDataWithRootObject:dictionaries].length;
+    NSUInteger JSONLength = [NSJSONSerialization dataWithJSONObject:dictionaries options:0 error:nil].length;
+    
+    NSLog(@"1000 artists and 1000 tracks: snapshot %lu bytes, NSKeyedArchiver %lu bytes, JSON %lu bytes", (unsigned long)snapshotLength, (unsigned long)archiveLength, (unsigned long)JSONLength);
+    
+    XCTAssertLessThan(snapshotLength, archiveLength);
+    XCTAssertLessThan(snapshotLength, JSONLength);
+}
+
+- (void)testSnapshotEncodingPerformance {
+    NSArray *models = [LFMModelArray([LFMArtist class], _artistList) arrayByAddingObjectsFromArray:LFMModelArray([LFMTrack class], _trackList)];
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            @autoreleasepool {
+                XCTAssertGreaterThan([LFMSnapshot dataWithObjects:models].length, 0);
+            }
+        }
+    }];
+}
+
+- (void)testSnapshotDecodingPerformance {
+    NSArray *models = [LFMModelArray([LFMArtist class], _artistList) arrayByAddingObjectsFromArray:LFMModelArray([LFMTrack class], _trackList)];
+    NSData *data = [LFMSnapshot dataWithObjects:models];
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            @autoreleasepool {
+                XCTAssertEqual([[[LFMSnapshot alloc] initWithData:data error:nil] decodeAllObjectsWithError:nil].count, 2000);
+            }
+        }
+    }];
+}
+
+/** Baseline: the models' response dictionaries, which is the closest `NSKeyedArchiver` can get as the models don't adopt `NSCoding`. */
+- (void)testKeyedArchiverEncodingPerformance {
+    NSArray *dictionaries = [_artistList arrayByAddingObjectsFromArray:_trackList];
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            @autoreleasepool {
+                XCTAssertGreaterThan([NSKeyedArchiver archivedDataWithRootObject:dictionaries].length, 0);
+            }
+        }
+    }];
+}
+
+- (void)testKeyedArchiverDecodingPerformance {
+    NSData *data = [NSKeyedArchiver archivedDataWithRootObject:[_artistList arrayByAddingObjectsFromArray:_trackList]];
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            @autoreleasepool {
+                NSArray *dictionaries = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+                NSArray *artists = LFMDecodeModels([LFMArtist class], [dictionaries subarrayWithRange:NSMakeRange(0, 1000)], NO);
+                NSArray *tracks = LFMDecodeModels([LFMTrack class], [dictionaries subarrayWithRange:NSMakeRange(1000, 1000)], NO);
+                XCTAssertEqual(artists.count + tracks.count, 2000);
+            }
+        }
+    }];
+}
+
+- (void)testJSONEncodingPerformance {
+    NSArray *dictionaries = [_artistList arrayByAddingObjectsFromArray:_trackList];
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            @autoreleasepool {
+                XCTAssertGreaterThan([NSJSONSerialization dataWithJSONObject:dictionaries options:0 error:nil].length, 0);
+            }
+        }
+    }];
+}
+
+- (void)testJSONDecodingPerformance {
+    NSData *data = [NSJSONSerialization dataWithJSONObject:[_artistList arrayByAddingObjectsFromArray:_trackList] options:0 error:nil];
+    
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            @autoreleasepool {
+                NSArray *dictionaries = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+                NSArray *artists = LFMDecodeModels([LFMArtist class], [dictionaries subarrayWithRange:NSMakeRange(0, 1000)], NO);
+                NSArray *tracks = LFMDecodeModels([LFMTrack class], [dictionaries subarrayWithRange:NSMakeRange(1000, 1000)], NO);
+                XCTAssertEqual(artists.count + tracks.count, 2000);
+            }
+        }
+    }];
+}
+
+@end
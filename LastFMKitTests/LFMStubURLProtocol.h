@@ -0,0 +1,68 @@
+//
+//  LFMStubURLProtocol.h
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Builds the response body for a stubbed request.
+ 
+ @param request     The request that was intercepted.
+ @param statusCode  The HTTP status code of the response. Defaults to 200.
+ */
+typedef NSData * _Nullable (^LFMStubResponder)(NSURLRequest *request, NSInteger *statusCode);
+
+/**
+ An `NSURLProtocol` that answers every request locally so that tests never touch the network. Install it on a client using `sessionConfiguration`.
+ */
+@interface LFMStubURLProtocol : NSURLProtocol
+
+/** A configuration with this protocol installed. */
++ (NSURLSessionConfiguration *)sessionConfiguration;
+
+/** Sets the block used to answer requests. */
++ (void)setResponder:(nullable LFMStubResponder)responder;
+
+/** Sets how long every response is held back for before being delivered. */
++ (void)setResponseDelay:(NSTimeInterval)delay;
+
+/** Splits every response body into chunks of `chunkSize` bytes delivered `interval` apart. Pass 0 to deliver bodies in one go. */
++ (void)setResponseChunkSize:(NSUInteger)chunkSize interval:(NSTimeInterval)interval;
+
+/** The amount of requests that have reached the protocol since the last call to `reset`. */
++ (NSUInteger)requestCount;
+
+/** Removes the responder, delay and chunking and sets the request count back to 0. */
++ (void)reset;
+
+/**
+ Reads the body of a request. `NSURLSession` hands bodies to protocols as a stream, so `HTTPBody` is always `nil` here.
+ */
++ (NSData *)bodyOfRequest:(NSURLRequest *)request;
+
+@end
+
+NS_ASSUME_NONNULL_END
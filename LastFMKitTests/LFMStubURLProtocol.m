@@ -0,0 +1,162 @@
+//
+//  LFMStubURLProtocol.m
+//  LastFMKitTests
+//
+//  Copyright © 2017 Mark Bourke.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE
+//
+
+#import "LFMStubURLProtocol.h"
+
+static LFMStubResponder stubResponder;
+static NSTimeInterval stubResponseDelay;
+static NSUInteger stubRequestCount;
+static NSUInteger stubChunkSize;
+static NSTimeInterval stubChunkInterval;
+
+@implementation LFMStubURLProtocol
+
++ (NSURLSessionConfiguration *)sessionConfiguration {
+    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+    configuration.protocolClasses = @[self];
+    return configuration;
+}
+
++ (void)setResponder:(LFMStubResponder)responder {
+    @synchronized (self) {
+        stubResponder = [responder copy];
+    }
+}
+
++ (void)setResponseDelay:(NSTimeInterval)delay {
+    @synchronized (self) {
+        stubResponseDelay = delay;
+    }
+}
+
++ (void)setResponseChunkSize:(NSUInteger)chunkSize interval:(NSTimeInterval)interval {
+    @synchronized (self) {
+        stubChunkSize = chunkSize;
+        stubChunkInterval = interval;
+    }
+}
+
++ (NSUInteger)requestCount {
+    @synchronized (self) {
+        return stubRequestCount;
+    }
+}
+
++ (void)reset {
+    @synchronized (self) {
+        stubResponder = nil;
+        stubResponseDelay = 0;
+        stubRequestCount = 0;
+        stubChunkSize = 0;
+        stubChunkInterval = 0;
+    }
+}
+
++ (NSData *)bodyOfRequest:(NSURLRequest *)request {
+    if (request.HTTPBody != nil) return request.HTTPBody;
+    
+    NSInputStream *stream = request.HTTPBodyStream;
+    NSMutableData *body = [NSMutableData data];
+    uint8_t buffer[4096];
+    
+    [stream open];
+    while ([stream hasBytesAvailable]) {
+        NSInteger length = [stream read:buffer maxLength:sizeof(buffer)];
+        if (length <= 0) break;
+        [body appendBytes:buffer length:length];
+    }
+    [stream close];
+    
+    return body;
+}
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+    return YES;
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+    return request;
+}
+
+- (void)startLoading {
+    LFMStubResponder responder;
+    NSTimeInterval delay;
+    
+    @synchronized ([LFMStubURLProtocol class]) {
+        stubRequestCount++;
+        responder = stubResponder;
+        delay = stubResponseDelay;
+    }
+    
+    // Client callbacks have to be made on the thread loading was started on, so the delay is scheduled on its run loop.
+    [self performSelector:@selector(finishLoadingWithResponder:) withObject:responder afterDelay:delay];
+}
+
+- (void)finishLoadingWithResponder:(LFMStubResponder)responder {
+    NSInteger statusCode = 200;
+    NSData *data = responder == nil ? nil : responder(self.request, &statusCode);
+    
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.request.URL statusCode:statusCode HTTPVersion:@"HTTP/1.1" headerFields:@{@"Content-Type": @"application/json"}];
+    
+    NSUInteger chunkSize;
+    NSTimeInterval chunkInterval;
+    
+    @synchronized ([LFMStubURLProtocol class]) {
+        chunkSize = stubChunkSize;
+        chunkInterval = stubChunkInterval;
+    }
+    
+    [self.client URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+    
+    if (data == nil || chunkSize == 0) {
+        if (data != nil) [self.client URLProtocol:self didLoadData:data];
+        [self.client URLProtocolDidFinishLoading:self];
+        return;
+    }
+    
+    NSMutableArray<NSData *> *chunks = [NSMutableArray array];
+    for (NSUInteger offset = 0; offset < data.length; offset += chunkSize) {
+        [chunks addObject:[data subdataWithRange:NSMakeRange(offset, MIN(chunkSize, data.length - offset))]];
+    }
+    
+    [self deliverChunks:@[chunks, @(chunkInterval)]];
+}
+
+- (void)deliverChunks:(NSArray *)arguments {
+    NSMutableArray<NSData *> *chunks = arguments[0];
+    
+    if (chunks.count == 0) return [self.client URLProtocolDidFinishLoading:self];
+    
+    [self.client URLProtocol:self didLoadData:chunks.firstObject];
+    [chunks removeObjectAtIndex:0];
+    
+    [self performSelector:@selector(deliverChunks:) withObject:arguments afterDelay:[arguments[1] doubleValue]];
+}
+
+- (void)stopLoading {
+    [NSObject cancelPreviousPerformRequestsWithTarget:self];
+}
+
+@end
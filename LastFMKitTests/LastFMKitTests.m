@@ -26,21 +26,39 @@
 #import <XCTest/XCTest.h>
 
 #import <LastFMKit/LastFMKit.h>
+#import "LFMFixtures.h"
+#import "LFMStubURLProtocol.h"
 
 @interface LastFMKitTests: XCTestCase
 
 @end
 
-@implementation LastFMKitTests
+@implementation LastFMKitTests {
+    LFMClient *_previousClient;
+    LFMClient *_client;
+}
 
 - (void)setUp {
     [super setUp];
 
     [[LFMAuth sharedInstance] setApiKey:@"bc15dd6972bc0f7c952273b34d253a6a"];
     [[LFMAuth sharedInstance] setApiSecret:@"d46ca773c61a3907c0b19c777c5bcf20"];
+
+    [LFMStubURLProtocol reset];
+    [LFMStubURLProtocol setResponder:^NSData *(NSURLRequest *request, NSInteger *statusCode) {
+        return LFMFixtureAlbumSearch();
+    }];
+
+    _previousClient = [LFMClient sharedClient];
+    _client = [[LFMClient alloc] initWithSessionConfiguration:[LFMStubURLProtocol sessionConfiguration]];
+    [LFMClient setSharedClient:_client];
 }
 
 - (void)tearDown {
+    [LFMClient setSharedClient:_previousClient];
+    [_client invalidateAndCancel];
+    [LFMStubURLProtocol reset];
+
     [super tearDown];
 }
 
@@ -51,10 +69,14 @@
         XCTAssertNil(error, @"Failed to create session %@", error);
         XCTAssertFalse(albums.count == 0, @"Search results were empty");
         XCTAssertNotNil(searchQuery, @"Search failed.");
+        XCTAssertEqualObjects(albums.firstObject.name, @"My Everything");
+        XCTAssertEqualObjects(searchQuery.searchQuery, @"My Everything");
         [expectation fulfill];
     }];
 
     [self waitForExpectationsWithTimeout:5.0 handler:nil];
+
+    XCTAssertEqual([LFMStubURLProtocol requestCount], 1);
 }
 
 @end